@@ -0,0 +1,217 @@
+#include "./command_list.hpp"
+#include "./state_cache.hpp"
+
+#include <cstring>
+#ifdef __EMSCRIPTEN__
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+namespace {
+uint32_t toWord(float v) {
+  uint32_t word;
+  ::memcpy(&word, &v, sizeof(word));
+  return word;
+}
+
+uint32_t toWord(int32_t v) { return static_cast<uint32_t>(v); }
+
+float toFloat(uint32_t word) {
+  float v;
+  ::memcpy(&v, &word, sizeof(v));
+  return v;
+}
+
+GLint toInt(uint32_t word) { return static_cast<GLint>(word); }
+} // namespace
+
+namespace hello::gl {
+enum class CommandList::Op : uint32_t {
+  ClearColor,
+  ClearDepth,
+  Clear,
+  Viewport,
+  BindFramebuffer,
+  BindBuffer,
+  BindVertexArray,
+  UseProgram,
+  ActiveTexture,
+  BindTexture,
+  Uniform1i,
+  Uniform1f,
+  Uniform2f,
+  Uniform3f,
+  Uniform4f,
+  DrawArrays,
+  DrawElements,
+};
+
+void CommandList::record(Op op, std::initializer_list<uint32_t> args) {
+  words.push_back(static_cast<uint32_t>(op));
+  words.insert(words.end(), args);
+  ++commandCount;
+}
+
+void CommandList::clearColor(float r, float g, float b, float a) {
+  record(Op::ClearColor, {toWord(r), toWord(g), toWord(b), toWord(a)});
+}
+
+void CommandList::clearDepth(float depth) {
+  record(Op::ClearDepth, {toWord(depth)});
+}
+
+void CommandList::clear(uint32_t mask) { record(Op::Clear, {mask}); }
+
+void CommandList::viewport(int32_t x, int32_t y, int32_t width,
+                           int32_t height) {
+  record(Op::Viewport, {toWord(x), toWord(y), toWord(width), toWord(height)});
+}
+
+void CommandList::bindFramebuffer(uint32_t target, uint32_t framebuffer) {
+  record(Op::BindFramebuffer, {target, framebuffer});
+}
+
+void CommandList::bindBuffer(uint32_t target, uint32_t buffer) {
+  record(Op::BindBuffer, {target, buffer});
+}
+
+void CommandList::bindVertexArray(uint32_t array) {
+  record(Op::BindVertexArray, {array});
+}
+
+void CommandList::useProgram(uint32_t program) {
+  record(Op::UseProgram, {program});
+}
+
+void CommandList::activeTexture(uint32_t texture) {
+  record(Op::ActiveTexture, {texture});
+}
+
+void CommandList::bindTexture(uint32_t target, uint32_t texture) {
+  record(Op::BindTexture, {target, texture});
+}
+
+void CommandList::uniform1i(int32_t location, int32_t v0) {
+  record(Op::Uniform1i, {toWord(location), toWord(v0)});
+}
+
+void CommandList::uniform1f(int32_t location, float v0) {
+  record(Op::Uniform1f, {toWord(location), toWord(v0)});
+}
+
+void CommandList::uniform2f(int32_t location, float v0, float v1) {
+  record(Op::Uniform2f, {toWord(location), toWord(v0), toWord(v1)});
+}
+
+void CommandList::uniform3f(int32_t location, float v0, float v1, float v2) {
+  record(Op::Uniform3f,
+         {toWord(location), toWord(v0), toWord(v1), toWord(v2)});
+}
+
+void CommandList::uniform4f(int32_t location, float v0, float v1, float v2,
+                            float v3) {
+  record(Op::Uniform4f, {toWord(location), toWord(v0), toWord(v1),
+                         toWord(v2), toWord(v3)});
+}
+
+void CommandList::drawArrays(uint32_t mode, int32_t first, int32_t count) {
+  record(Op::DrawArrays, {mode, toWord(first), toWord(count)});
+}
+
+void CommandList::drawElements(uint32_t mode, int32_t count, uint32_t type,
+                               uint32_t offset) {
+  record(Op::DrawElements, {mode, toWord(count), type, offset});
+}
+
+void CommandList::reset() {
+  words.clear();
+  commandCount = 0;
+}
+
+void CommandList::execute(StateCache &cache) const {
+  auto p = words.data();
+  const auto end = p + words.size();
+  while (p < end) {
+    const auto op = static_cast<Op>(*p++);
+    switch (op) {
+    case Op::ClearColor:
+      cache.clearColor(toFloat(p[0]), toFloat(p[1]), toFloat(p[2]),
+                       toFloat(p[3]));
+      p += 4;
+      break;
+    case Op::ClearDepth:
+#ifdef __EMSCRIPTEN__
+      glClearDepthf(toFloat(p[0]));
+#else
+      glClearDepth(toFloat(p[0]));
+#endif
+      p += 1;
+      break;
+    case Op::Clear:
+      glClear(p[0]);
+      p += 1;
+      break;
+    case Op::Viewport:
+      cache.viewport(toInt(p[0]), toInt(p[1]), toInt(p[2]), toInt(p[3]));
+      p += 4;
+      break;
+    case Op::BindFramebuffer:
+      cache.bindFramebuffer(p[0], p[1]);
+      p += 2;
+      break;
+    case Op::BindBuffer:
+      cache.bindBuffer(p[0], p[1]);
+      p += 2;
+      break;
+    case Op::BindVertexArray:
+      cache.bindVertexArray(p[0]);
+      p += 1;
+      break;
+    case Op::UseProgram:
+      cache.useProgram(p[0]);
+      p += 1;
+      break;
+    case Op::ActiveTexture:
+      cache.activeTexture(p[0]);
+      p += 1;
+      break;
+    case Op::BindTexture:
+      cache.bindTexture(p[0], p[1]);
+      p += 2;
+      break;
+    case Op::Uniform1i:
+      glUniform1i(toInt(p[0]), toInt(p[1]));
+      p += 2;
+      break;
+    case Op::Uniform1f:
+      glUniform1f(toInt(p[0]), toFloat(p[1]));
+      p += 2;
+      break;
+    case Op::Uniform2f:
+      glUniform2f(toInt(p[0]), toFloat(p[1]), toFloat(p[2]));
+      p += 3;
+      break;
+    case Op::Uniform3f:
+      glUniform3f(toInt(p[0]), toFloat(p[1]), toFloat(p[2]), toFloat(p[3]));
+      p += 4;
+      break;
+    case Op::Uniform4f:
+      glUniform4f(toInt(p[0]), toFloat(p[1]), toFloat(p[2]), toFloat(p[3]),
+                  toFloat(p[4]));
+      p += 5;
+      break;
+    case Op::DrawArrays:
+      glDrawArrays(p[0], toInt(p[1]), toInt(p[2]));
+      p += 3;
+      break;
+    case Op::DrawElements:
+      glDrawElements(p[0], toInt(p[1]), p[2],
+                     reinterpret_cast<const void *>(
+                         static_cast<uintptr_t>(p[3])));
+      p += 4;
+      break;
+    }
+  }
+}
+} // namespace hello::gl
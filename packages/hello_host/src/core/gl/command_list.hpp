@@ -0,0 +1,58 @@
+#ifndef __GL_COMMAND_LIST_HPP__
+#define __GL_COMMAND_LIST_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace hello::gl {
+class StateCache;
+
+// GL calls recorded as a flat stream of 32 bit words, an opcode followed by
+// its arguments, and replayed by execute() in one go. a list stores object
+// names rather than objects, so it can be recorded once and executed every
+// frame for as long as those objects live.
+class CommandList {
+public:
+  void clearColor(float r, float g, float b, float a);
+  void clearDepth(float depth);
+  void clear(uint32_t mask);
+  void viewport(int32_t x, int32_t y, int32_t width, int32_t height);
+
+  void bindFramebuffer(uint32_t target, uint32_t framebuffer);
+  void bindBuffer(uint32_t target, uint32_t buffer);
+  void bindVertexArray(uint32_t array);
+  void useProgram(uint32_t program);
+  void activeTexture(uint32_t texture);
+  void bindTexture(uint32_t target, uint32_t texture);
+
+  void uniform1i(int32_t location, int32_t v0);
+  void uniform1f(int32_t location, float v0);
+  void uniform2f(int32_t location, float v0, float v1);
+  void uniform3f(int32_t location, float v0, float v1, float v2);
+  void uniform4f(int32_t location, float v0, float v1, float v2, float v3);
+
+  void drawArrays(uint32_t mode, int32_t first, int32_t count);
+  // `offset` is the byte offset into the bound element array buffer
+  void drawElements(uint32_t mode, int32_t count, uint32_t type,
+                    uint32_t offset);
+
+  // replays every command in recording order on the current context.
+  // binds, clear color and viewport go through `cache`.
+  void execute(StateCache &cache) const;
+  void reset();
+
+  size_t getCommandCount() const { return commandCount; }
+  size_t getByteSize() const { return words.size() * sizeof(uint32_t); }
+
+private:
+  enum class Op : uint32_t;
+
+  void record(Op op, std::initializer_list<uint32_t> args);
+
+  std::vector<uint32_t> words;
+  size_t commandCount = 0;
+};
+} // namespace hello::gl
+#endif
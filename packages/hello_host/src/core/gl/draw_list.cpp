@@ -0,0 +1,167 @@
+#include "./draw_list.hpp"
+#include "./extensions.hpp"
+
+#include <cmath>
+
+namespace {
+size_t getIndexSize(GLenum type) {
+  switch (type) {
+  case GL_UNSIGNED_BYTE:
+    return 1;
+  case GL_UNSIGNED_SHORT:
+    return 2;
+  case GL_UNSIGNED_INT:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+// indices per primitive of the modes whose primitives stand alone, or 0
+// for strips, fans and loops, which join the ranges of separate draws.
+uint32_t getPrimitiveSize(GLenum mode) {
+  switch (mode) {
+  case GL_POINTS:
+    return 1;
+  case GL_LINES:
+    return 2;
+  case GL_TRIANGLES:
+    return 3;
+  default:
+    return 0;
+  }
+}
+
+// `last` must end on a whole primitive, or merging would pair its leftover
+// indices with the first of `next`.
+bool isContinued(uint32_t primitiveSize,
+                 const hello::gl::DrawElementsCommand &last,
+                 const hello::gl::DrawElementsCommand &next) {
+  return primitiveSize > 0 && last.count % primitiveSize == 0 &&
+         last.firstIndex + last.count == next.firstIndex &&
+         last.baseVertex == next.baseVertex &&
+         last.instanceCount == next.instanceCount &&
+         last.baseInstance == next.baseInstance;
+}
+
+void drawElements(GLenum mode, GLenum type, size_t indexSize,
+                  const hello::gl::DrawElementsCommand &command) {
+  const auto count = static_cast<GLsizei>(command.count);
+  const auto indices =
+      reinterpret_cast<const void *>(command.firstIndex * indexSize);
+  const auto instanceCount = static_cast<GLsizei>(command.instanceCount);
+  if (command.instanceCount == 1 && command.baseVertex == 0) {
+    glDrawElements(mode, count, type, indices);
+  } else if (command.instanceCount == 1) {
+    hello::gl::drawElementsBaseVertex(mode, count, type, indices,
+                                      command.baseVertex);
+  } else if (command.baseVertex == 0) {
+    hello::gl::drawElementsInstanced(mode, count, type, indices,
+                                     instanceCount);
+  } else {
+    hello::gl::drawElementsInstancedBaseVertex(mode, count, type, indices,
+                                               instanceCount,
+                                               command.baseVertex);
+  }
+}
+} // namespace
+
+namespace hello::gl {
+size_t DrawList::add(const DrawElementsCommand &command) {
+  commands.push_back(command);
+  bounds.push_back({{0.0f, 0.0f, 0.0f}, -1.0f});
+  return commands.size() - 1;
+}
+
+void DrawList::clear() {
+  commands.clear();
+  bounds.clear();
+  packed.clear();
+}
+
+void DrawList::setBounds(size_t index, const float center[3], float radius) {
+  bounds[index] = {{center[0], center[1], center[2]}, radius};
+}
+
+size_t DrawList::build(const float *viewProjection) {
+  packed.clear();
+  if (viewProjection == nullptr) {
+    packed = commands;
+    return packed.size();
+  }
+
+  // the six clip planes w +- x, w +- y, w +- z as rows of the matrix,
+  // normalized so that distances compare with the radius
+  float planes[6][4];
+  const auto m = viewProjection;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      planes[i * 2][j] = m[j * 4 + 3] + m[j * 4 + i];
+      planes[i * 2 + 1][j] = m[j * 4 + 3] - m[j * 4 + i];
+    }
+  }
+  for (auto &plane : planes) {
+    const auto length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] +
+                                  plane[2] * plane[2]);
+    if (length > 0.0f) {
+      for (auto &value : plane) {
+        value /= length;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < commands.size(); ++i) {
+    const auto &sphere = bounds[i];
+    auto visible = true;
+    if (sphere.radius >= 0.0f) {
+      for (const auto &plane : planes) {
+        const auto distance = plane[0] * sphere.center[0] +
+                              plane[1] * sphere.center[1] +
+                              plane[2] * sphere.center[2] + plane[3];
+        if (distance < -sphere.radius) {
+          visible = false;
+          break;
+        }
+      }
+    }
+    if (visible) {
+      packed.push_back(commands[i]);
+    }
+  }
+  return packed.size();
+}
+
+DrawResult DrawList::draw(uint32_t mode, uint32_t type) const {
+  const auto indexSize = getIndexSize(type);
+  if (indexSize == 0) {
+    return DrawResult::BadIndexType;
+  }
+  const auto &extensions = getExtensions();
+  for (const auto &command : packed) {
+    if (command.baseInstance != 0) {
+      return DrawResult::NeedsBaseInstance;
+    }
+    if (command.baseVertex != 0 && !extensions.baseVertex) {
+      return DrawResult::NeedsBaseVertex;
+    }
+    if (command.instanceCount > 1 && !extensions.instancing) {
+      return DrawResult::NeedsInstancing;
+    }
+  }
+
+  const auto primitiveSize = getPrimitiveSize(mode);
+  for (size_t i = 0; i < packed.size();) {
+    auto command = packed[i];
+    for (++i; i < packed.size(); ++i) {
+      if (!isContinued(primitiveSize, command, packed[i])) {
+        break;
+      }
+      command.count += packed[i].count;
+    }
+    if (command.count > 0 && command.instanceCount > 0) {
+      drawElements(mode, type, indexSize, command);
+    }
+  }
+  return DrawResult::Drawn;
+}
+} // namespace hello::gl
@@ -0,0 +1,75 @@
+#ifndef __GL_DRAW_LIST_HPP__
+#define __GL_DRAW_LIST_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hello::gl {
+// the record glDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER
+struct DrawElementsCommand {
+  uint32_t count;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  uint32_t baseInstance;
+};
+
+// why DrawList::draw() drew nothing
+enum class DrawResult {
+  Drawn,
+  // `type` is not GL_UNSIGNED_BYTE, _SHORT or _INT
+  BadIndexType,
+  // glDrawElements* cannot offset instances; only indirect draws can
+  NeedsBaseInstance,
+  NeedsBaseVertex,
+  NeedsInstancing,
+};
+
+// indexed draws out of shared vertex and index buffers, each with an
+// optional bounding sphere. build() culls them against a view frustum and
+// packs the survivors as indirect commands, for one upload and one
+// multiDrawElementsIndirect, or one native loop in draw() where indirect
+// draws are missing.
+class DrawList {
+public:
+  // returns the index of the draw, which is never culled until it has
+  // bounds
+  size_t add(const DrawElementsCommand &command);
+  void clear();
+  // a sphere in the space the matrix given to build() transforms from,
+  // usually world space
+  void setBounds(size_t index, const float center[3], float radius);
+
+  // packs every draw, or with a column-major view-projection matrix only
+  // those whose sphere reaches into the frustum. returns getDrawCount().
+  size_t build(const float *viewProjection);
+
+  // glDrawElements* for the packed draws, with indices of `type` from the
+  // bound element array buffer. with points, lines or triangles,
+  // neighbours that continue each other's index range after a whole number
+  // of primitives become one call. nothing is drawn unless every draw can
+  // be, and the result names the first obstacle.
+  DrawResult draw(uint32_t mode, uint32_t type) const;
+
+  size_t getCount() const { return commands.size(); }
+  size_t getDrawCount() const { return packed.size(); }
+  size_t getStride() const { return sizeof(DrawElementsCommand); }
+  size_t getByteSize() const {
+    return packed.size() * sizeof(DrawElementsCommand);
+  }
+  const DrawElementsCommand *getData() const { return packed.data(); }
+
+private:
+  struct Sphere {
+    float center[3];
+    // negative for a draw without bounds
+    float radius;
+  };
+
+  std::vector<DrawElementsCommand> commands;
+  std::vector<Sphere> bounds;
+  std::vector<DrawElementsCommand> packed;
+};
+} // namespace hello::gl
+#endif
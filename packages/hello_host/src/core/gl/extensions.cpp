@@ -0,0 +1,453 @@
+#include "./extensions.hpp"
+
+#include <cstring>
+
+#ifdef __EMSCRIPTEN__
+#define GL_GLEXT_PROTOTYPES
+#include <GLES2/gl2ext.h>
+#include <emscripten/html5.h>
+
+// implemented by the WebGL 2 library as gl.getBufferSubData
+extern "C" void glGetBufferSubData(GLenum target, GLintptr offset,
+                                   GLsizeiptr size, void *data);
+#endif
+
+namespace {
+hello::gl::Extensions extensions = {};
+
+#ifndef __EMSCRIPTEN__
+typedef GLsync(APIENTRYP PFNFENCESYNC)(GLenum condition, GLbitfield flags);
+typedef GLenum(APIENTRYP PFNCLIENTWAITSYNC)(GLsync sync, GLbitfield flags,
+                                            GLuint64 timeout);
+typedef void(APIENTRYP PFNDELETESYNC)(GLsync sync);
+typedef void(APIENTRYP PFNBUFFERSTORAGE)(GLenum target, GLsizeiptr size,
+                                         const void *data, GLbitfield flags);
+typedef void(APIENTRYP PFNCOPYBUFFERSUBDATA)(GLenum readTarget,
+                                             GLenum writeTarget,
+                                             GLintptr readOffset,
+                                             GLintptr writeOffset,
+                                             GLsizeiptr size);
+typedef void(APIENTRYP PFNDRAWELEMENTSBASEVERTEX)(GLenum mode, GLsizei count,
+                                                  GLenum type,
+                                                  const void *indices,
+                                                  GLint baseVertex);
+typedef void(APIENTRYP PFNDRAWELEMENTSINSTANCEDBASEVERTEX)(
+    GLenum mode, GLsizei count, GLenum type, const void *indices,
+    GLsizei instanceCount, GLint baseVertex);
+typedef void(APIENTRYP PFNDRAWARRAYSINSTANCED)(GLenum mode, GLint first,
+                                               GLsizei count,
+                                               GLsizei instanceCount);
+typedef void(APIENTRYP PFNDRAWELEMENTSINSTANCED)(GLenum mode, GLsizei count,
+                                                 GLenum type,
+                                                 const void *indices,
+                                                 GLsizei instanceCount);
+typedef void(APIENTRYP PFNVERTEXATTRIBDIVISOR)(GLuint index, GLuint divisor);
+typedef GLuint(APIENTRYP PFNGETUNIFORMBLOCKINDEX)(GLuint program,
+                                                  const GLchar *name);
+typedef void(APIENTRYP PFNGETACTIVEUNIFORMBLOCKIV)(GLuint program,
+                                                   GLuint blockIndex,
+                                                   GLenum pname,
+                                                   GLint *params);
+typedef void(APIENTRYP PFNGETACTIVEUNIFORMSIV)(GLuint program, GLsizei count,
+                                               const GLuint *indices,
+                                               GLenum pname, GLint *params);
+typedef void(APIENTRYP PFNUNIFORMBLOCKBINDING)(GLuint program,
+                                               GLuint blockIndex,
+                                               GLuint binding);
+typedef void(APIENTRYP PFNQUERYCOUNTER)(GLuint id, GLenum target);
+typedef void(APIENTRYP PFNGETQUERYOBJECTUI64V)(GLuint id, GLenum pname,
+                                               GLuint64 *params);
+typedef void(APIENTRYP PFNDRAWARRAYSINDIRECT)(GLenum mode,
+                                              const void *indirect);
+typedef void(APIENTRYP PFNDRAWELEMENTSINDIRECT)(GLenum mode, GLenum type,
+                                                const void *indirect);
+typedef void(APIENTRYP PFNMULTIDRAWARRAYSINDIRECT)(GLenum mode,
+                                                   const void *indirect,
+                                                   GLsizei drawCount,
+                                                   GLsizei stride);
+typedef void(APIENTRYP PFNMULTIDRAWELEMENTSINDIRECT)(GLenum mode,
+                                                     GLenum type,
+                                                     const void *indirect,
+                                                     GLsizei drawCount,
+                                                     GLsizei stride);
+
+PFNFENCESYNC pFenceSync = nullptr;
+PFNCLIENTWAITSYNC pClientWaitSync = nullptr;
+PFNDELETESYNC pDeleteSync = nullptr;
+PFNBUFFERSTORAGE pBufferStorage = nullptr;
+PFNCOPYBUFFERSUBDATA pCopyBufferSubData = nullptr;
+PFNDRAWELEMENTSBASEVERTEX pDrawElementsBaseVertex = nullptr;
+PFNDRAWELEMENTSINSTANCEDBASEVERTEX pDrawElementsInstancedBaseVertex = nullptr;
+PFNDRAWARRAYSINSTANCED pDrawArraysInstanced = nullptr;
+PFNDRAWELEMENTSINSTANCED pDrawElementsInstanced = nullptr;
+PFNVERTEXATTRIBDIVISOR pVertexAttribDivisor = nullptr;
+PFNGETUNIFORMBLOCKINDEX pGetUniformBlockIndex = nullptr;
+PFNGETACTIVEUNIFORMBLOCKIV pGetActiveUniformBlockiv = nullptr;
+PFNGETACTIVEUNIFORMSIV pGetActiveUniformsiv = nullptr;
+PFNUNIFORMBLOCKBINDING pUniformBlockBinding = nullptr;
+PFNQUERYCOUNTER pQueryCounter = nullptr;
+PFNGETQUERYOBJECTUI64V pGetQueryObjectui64v = nullptr;
+PFNDRAWARRAYSINDIRECT pDrawArraysIndirect = nullptr;
+PFNDRAWELEMENTSINDIRECT pDrawElementsIndirect = nullptr;
+PFNMULTIDRAWARRAYSINDIRECT pMultiDrawArraysIndirect = nullptr;
+PFNMULTIDRAWELEMENTSINDIRECT pMultiDrawElementsIndirect = nullptr;
+
+bool hasVersion(int major, int minor) {
+  GLint contextMajor = 0;
+  GLint contextMinor = 0;
+  glGetIntegerv(GL_MAJOR_VERSION, &contextMajor);
+  glGetIntegerv(GL_MINOR_VERSION, &contextMinor);
+  return contextMajor > major ||
+         (contextMajor == major && contextMinor >= minor);
+}
+
+bool hasExtension(const char *name) {
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; ++i) {
+    auto extension = reinterpret_cast<const char *>(
+        glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+    if (extension != nullptr && ::strcmp(extension, name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+T lookup(void *(*getProcAddress)(const char *), const char *name) {
+  return reinterpret_cast<T>(getProcAddress(name));
+}
+#endif
+} // namespace
+
+namespace hello::gl {
+void loadExtensions(void *(*getProcAddress)(const char *)) {
+#ifdef __EMSCRIPTEN__
+  (void)getProcAddress;
+  extensions.sync = true;
+  extensions.bufferStorage = false;
+  extensions.copyBuffer = true;
+  extensions.baseVertex = false;
+  extensions.instancing = true;
+  extensions.uniformBuffer = true;
+  // WebGL hides the timer behind an extension that has to be enabled
+  auto context = emscripten_webgl_get_current_context();
+  extensions.timerQuery =
+      context != 0 && emscripten_webgl_enable_extension(
+                          context, "EXT_disjoint_timer_query_webgl2");
+  extensions.drawIndirect = false;
+  extensions.multiDrawIndirect = false;
+#else
+  pFenceSync = lookup<PFNFENCESYNC>(getProcAddress, "glFenceSync");
+  pClientWaitSync =
+      lookup<PFNCLIENTWAITSYNC>(getProcAddress, "glClientWaitSync");
+  pDeleteSync = lookup<PFNDELETESYNC>(getProcAddress, "glDeleteSync");
+  pBufferStorage =
+      lookup<PFNBUFFERSTORAGE>(getProcAddress, "glBufferStorage");
+  pCopyBufferSubData =
+      lookup<PFNCOPYBUFFERSUBDATA>(getProcAddress, "glCopyBufferSubData");
+  pDrawElementsBaseVertex = lookup<PFNDRAWELEMENTSBASEVERTEX>(
+      getProcAddress, "glDrawElementsBaseVertex");
+  pDrawElementsInstancedBaseVertex =
+      lookup<PFNDRAWELEMENTSINSTANCEDBASEVERTEX>(
+          getProcAddress, "glDrawElementsInstancedBaseVertex");
+  pDrawArraysInstanced =
+      lookup<PFNDRAWARRAYSINSTANCED>(getProcAddress, "glDrawArraysInstanced");
+  pDrawElementsInstanced = lookup<PFNDRAWELEMENTSINSTANCED>(
+      getProcAddress, "glDrawElementsInstanced");
+  pVertexAttribDivisor =
+      lookup<PFNVERTEXATTRIBDIVISOR>(getProcAddress, "glVertexAttribDivisor");
+  pGetUniformBlockIndex = lookup<PFNGETUNIFORMBLOCKINDEX>(
+      getProcAddress, "glGetUniformBlockIndex");
+  pGetActiveUniformBlockiv = lookup<PFNGETACTIVEUNIFORMBLOCKIV>(
+      getProcAddress, "glGetActiveUniformBlockiv");
+  pGetActiveUniformsiv =
+      lookup<PFNGETACTIVEUNIFORMSIV>(getProcAddress, "glGetActiveUniformsiv");
+  pUniformBlockBinding =
+      lookup<PFNUNIFORMBLOCKBINDING>(getProcAddress, "glUniformBlockBinding");
+  pQueryCounter = lookup<PFNQUERYCOUNTER>(getProcAddress, "glQueryCounter");
+  pGetQueryObjectui64v = lookup<PFNGETQUERYOBJECTUI64V>(
+      getProcAddress, "glGetQueryObjectui64v");
+  pDrawArraysIndirect =
+      lookup<PFNDRAWARRAYSINDIRECT>(getProcAddress, "glDrawArraysIndirect");
+  pDrawElementsIndirect = lookup<PFNDRAWELEMENTSINDIRECT>(
+      getProcAddress, "glDrawElementsIndirect");
+  pMultiDrawArraysIndirect = lookup<PFNMULTIDRAWARRAYSINDIRECT>(
+      getProcAddress, "glMultiDrawArraysIndirect");
+  pMultiDrawElementsIndirect = lookup<PFNMULTIDRAWELEMENTSINDIRECT>(
+      getProcAddress, "glMultiDrawElementsIndirect");
+
+  extensions.sync = (hasVersion(3, 2) || hasExtension("GL_ARB_sync")) &&
+                    pFenceSync != nullptr && pClientWaitSync != nullptr &&
+                    pDeleteSync != nullptr;
+  extensions.bufferStorage =
+      (hasVersion(4, 4) || hasExtension("GL_ARB_buffer_storage")) &&
+      pBufferStorage != nullptr;
+  extensions.copyBuffer =
+      (hasVersion(3, 1) || hasExtension("GL_ARB_copy_buffer")) &&
+      pCopyBufferSubData != nullptr;
+  extensions.baseVertex =
+      (hasVersion(3, 2) ||
+       hasExtension("GL_ARB_draw_elements_base_vertex")) &&
+      pDrawElementsBaseVertex != nullptr &&
+      pDrawElementsInstancedBaseVertex != nullptr;
+  extensions.instancing =
+      (hasVersion(3, 3) || (hasExtension("GL_ARB_draw_instanced") &&
+                            hasExtension("GL_ARB_instanced_arrays"))) &&
+      pDrawArraysInstanced != nullptr && pDrawElementsInstanced != nullptr &&
+      pVertexAttribDivisor != nullptr;
+  extensions.uniformBuffer =
+      (hasVersion(3, 1) || hasExtension("GL_ARB_uniform_buffer_object")) &&
+      pGetUniformBlockIndex != nullptr &&
+      pGetActiveUniformBlockiv != nullptr &&
+      pGetActiveUniformsiv != nullptr && pUniformBlockBinding != nullptr;
+  extensions.timerQuery =
+      (hasVersion(3, 3) || hasExtension("GL_ARB_timer_query")) &&
+      pQueryCounter != nullptr && pGetQueryObjectui64v != nullptr;
+  extensions.drawIndirect =
+      (hasVersion(4, 0) || hasExtension("GL_ARB_draw_indirect")) &&
+      pDrawArraysIndirect != nullptr && pDrawElementsIndirect != nullptr;
+  extensions.multiDrawIndirect =
+      extensions.drawIndirect &&
+      (hasVersion(4, 3) || hasExtension("GL_ARB_multi_draw_indirect")) &&
+      pMultiDrawArraysIndirect != nullptr &&
+      pMultiDrawElementsIndirect != nullptr;
+#endif
+}
+
+const Extensions &getExtensions() { return extensions; }
+
+GLsync fenceSync() {
+#ifdef __EMSCRIPTEN__
+  return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#else
+  return extensions.sync ? pFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)
+                         : nullptr;
+#endif
+}
+
+GLenum clientWaitSync(GLsync sync, GLuint64 timeout) {
+#ifdef __EMSCRIPTEN__
+  return glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+#else
+  return pClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+#endif
+}
+
+void deleteSync(GLsync sync) {
+#ifdef __EMSCRIPTEN__
+  glDeleteSync(sync);
+#else
+  pDeleteSync(sync);
+#endif
+}
+
+void bufferStorage(GLenum target, GLsizeiptr size, const void *data,
+                   GLbitfield flags) {
+#ifndef __EMSCRIPTEN__
+  pBufferStorage(target, size, data, flags);
+#else
+  (void)target;
+  (void)size;
+  (void)data;
+  (void)flags;
+#endif
+}
+
+void copyBufferSubData(GLenum readTarget, GLenum writeTarget,
+                       GLintptr readOffset, GLintptr writeOffset,
+                       GLsizeiptr size) {
+#ifdef __EMSCRIPTEN__
+  glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+#else
+  pCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+#endif
+}
+
+void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type,
+                            const void *indices, GLint baseVertex) {
+#ifndef __EMSCRIPTEN__
+  pDrawElementsBaseVertex(mode, count, type, indices, baseVertex);
+#else
+  (void)mode;
+  (void)count;
+  (void)type;
+  (void)indices;
+  (void)baseVertex;
+#endif
+}
+
+void drawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type,
+                                     const void *indices,
+                                     GLsizei instanceCount, GLint baseVertex) {
+#ifndef __EMSCRIPTEN__
+  pDrawElementsInstancedBaseVertex(mode, count, type, indices, instanceCount,
+                                   baseVertex);
+#else
+  (void)mode;
+  (void)count;
+  (void)type;
+  (void)indices;
+  (void)instanceCount;
+  (void)baseVertex;
+#endif
+}
+
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                         GLsizei instanceCount) {
+#ifdef __EMSCRIPTEN__
+  glDrawArraysInstanced(mode, first, count, instanceCount);
+#else
+  pDrawArraysInstanced(mode, first, count, instanceCount);
+#endif
+}
+
+void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type,
+                           const void *indices, GLsizei instanceCount) {
+#ifdef __EMSCRIPTEN__
+  glDrawElementsInstanced(mode, count, type, indices, instanceCount);
+#else
+  pDrawElementsInstanced(mode, count, type, indices, instanceCount);
+#endif
+}
+
+void vertexAttribDivisor(GLuint index, GLuint divisor) {
+#ifdef __EMSCRIPTEN__
+  glVertexAttribDivisor(index, divisor);
+#else
+  pVertexAttribDivisor(index, divisor);
+#endif
+}
+
+GLuint getUniformBlockIndex(GLuint program, const GLchar *name) {
+#ifdef __EMSCRIPTEN__
+  return glGetUniformBlockIndex(program, name);
+#else
+  return pGetUniformBlockIndex(program, name);
+#endif
+}
+
+void getActiveUniformBlockiv(GLuint program, GLuint blockIndex, GLenum pname,
+                             GLint *params) {
+#ifdef __EMSCRIPTEN__
+  glGetActiveUniformBlockiv(program, blockIndex, pname, params);
+#else
+  pGetActiveUniformBlockiv(program, blockIndex, pname, params);
+#endif
+}
+
+void getActiveUniformsiv(GLuint program, GLsizei count, const GLuint *indices,
+                         GLenum pname, GLint *params) {
+#ifdef __EMSCRIPTEN__
+  glGetActiveUniformsiv(program, count, indices, pname, params);
+#else
+  pGetActiveUniformsiv(program, count, indices, pname, params);
+#endif
+}
+
+void uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) {
+#ifdef __EMSCRIPTEN__
+  glUniformBlockBinding(program, blockIndex, binding);
+#else
+  pUniformBlockBinding(program, blockIndex, binding);
+#endif
+}
+
+void multiDrawArrays(GLenum mode, const GLint *firsts, const GLsizei *counts,
+                     GLsizei drawCount) {
+#ifdef __EMSCRIPTEN__
+  for (GLsizei i = 0; i < drawCount; ++i) {
+    glDrawArrays(mode, firsts[i], counts[i]);
+  }
+#else
+  glMultiDrawArrays(mode, firsts, counts, drawCount);
+#endif
+}
+
+void multiDrawElements(GLenum mode, const GLsizei *counts, GLenum type,
+                       const void *const *indices, GLsizei drawCount) {
+#ifdef __EMSCRIPTEN__
+  for (GLsizei i = 0; i < drawCount; ++i) {
+    glDrawElements(mode, counts[i], type, indices[i]);
+  }
+#else
+  glMultiDrawElements(mode, counts, type, indices, drawCount);
+#endif
+}
+
+void drawArraysIndirect(GLenum mode, const void *indirect) {
+#ifndef __EMSCRIPTEN__
+  pDrawArraysIndirect(mode, indirect);
+#else
+  (void)mode;
+  (void)indirect;
+#endif
+}
+
+void drawElementsIndirect(GLenum mode, GLenum type, const void *indirect) {
+#ifndef __EMSCRIPTEN__
+  pDrawElementsIndirect(mode, type, indirect);
+#else
+  (void)mode;
+  (void)type;
+  (void)indirect;
+#endif
+}
+
+void multiDrawArraysIndirect(GLenum mode, const void *indirect,
+                             GLsizei drawCount, GLsizei stride) {
+#ifndef __EMSCRIPTEN__
+  pMultiDrawArraysIndirect(mode, indirect, drawCount, stride);
+#else
+  (void)mode;
+  (void)indirect;
+  (void)drawCount;
+  (void)stride;
+#endif
+}
+
+void multiDrawElementsIndirect(GLenum mode, GLenum type, const void *indirect,
+                               GLsizei drawCount, GLsizei stride) {
+#ifndef __EMSCRIPTEN__
+  pMultiDrawElementsIndirect(mode, type, indirect, drawCount, stride);
+#else
+  (void)mode;
+  (void)type;
+  (void)indirect;
+  (void)drawCount;
+  (void)stride;
+#endif
+}
+
+void getBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                      void *data) {
+  glGetBufferSubData(target, offset, size, data);
+}
+
+void queryCounter(GLuint id, GLenum target) {
+#ifdef __EMSCRIPTEN__
+  glQueryCounterEXT(id, target);
+#else
+  pQueryCounter(id, target);
+#endif
+}
+
+void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params) {
+#ifdef __EMSCRIPTEN__
+  glGetQueryObjectui64vEXT(id, pname, params);
+#else
+  pGetQueryObjectui64v(id, pname, params);
+#endif
+}
+
+bool timerDisjoint() {
+#ifdef __EMSCRIPTEN__
+  GLint disjoint = 0;
+  glGetIntegerv(GL_GPU_DISJOINT, &disjoint);
+  return disjoint != 0;
+#else
+  return false;
+#endif
+}
+} // namespace hello::gl
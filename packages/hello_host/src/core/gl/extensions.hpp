@@ -0,0 +1,154 @@
+#ifndef __GL_EXTENSIONS_HPP__
+#define __GL_EXTENSIONS_HPP__
+
+#ifdef __EMSCRIPTEN__
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+// enums of the features below, past the GL 3.0 loader
+#ifndef GL_COPY_READ_BUFFER
+#define GL_COPY_READ_BUFFER 0x8F36
+#endif
+#ifndef GL_COPY_WRITE_BUFFER
+#define GL_COPY_WRITE_BUFFER 0x8F37
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11
+#define GL_UNIFORM_BUFFER_BINDING 0x8A28
+#define GL_MAX_UNIFORM_BUFFER_BINDINGS 0x8A2F
+#define GL_MAX_UNIFORM_BLOCK_SIZE 0x8A30
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+#define GL_UNIFORM_TYPE 0x8A37
+#define GL_UNIFORM_SIZE 0x8A38
+#define GL_UNIFORM_OFFSET 0x8A3B
+#define GL_UNIFORM_ARRAY_STRIDE 0x8A3C
+#define GL_UNIFORM_MATRIX_STRIDE 0x8A3D
+#define GL_UNIFORM_IS_ROW_MAJOR 0x8A3E
+#define GL_UNIFORM_BLOCK_DATA_SIZE 0x8A40
+#define GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS 0x8A42
+#define GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES 0x8A43
+#define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+#ifndef GL_GPU_DISJOINT
+#define GL_GPU_DISJOINT 0x8FBB
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#define GL_DRAW_INDIRECT_BUFFER_BINDING 0x8F43
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911A
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911C
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911D
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace hello::gl {
+// features past the GL 3.0 loader. desktop drivers hand out pointers for
+// any name, so a feature only counts when the context's version or
+// extension list promises it. GLES3 builds call the core functions.
+struct Extensions {
+  // GL 3.2 or ARB_sync, always on GLES3
+  bool sync;
+  // GL 4.4 or ARB_buffer_storage, never on GLES3 / WebGL
+  bool bufferStorage;
+  // GL 3.1 or ARB_copy_buffer, always on GLES3
+  bool copyBuffer;
+  // GL 3.2 or ARB_draw_elements_base_vertex, never on GLES3 / WebGL. this
+  // includes the instanced variant when `instancing` is there too.
+  bool baseVertex;
+  // instanced draws and attribute divisors: GL 3.3, or ARB_draw_instanced
+  // with ARB_instanced_arrays, always on GLES3
+  bool instancing;
+  // uniform block queries and bindings: GL 3.1 or ARB_uniform_buffer_object,
+  // always on GLES3
+  bool uniformBuffer;
+  // GL_TIME_ELAPSED / GL_TIMESTAMP queries: GL 3.3 or ARB_timer_query,
+  // EXT_disjoint_timer_query_webgl2 on the web
+  bool timerQuery;
+  // draws whose parameters come from GL_DRAW_INDIRECT_BUFFER: GL 4.0 or
+  // ARB_draw_indirect, never on WebGL
+  bool drawIndirect;
+  // many indirect draws in one call: GL 4.3 or ARB_multi_draw_indirect,
+  // never on WebGL
+  bool multiDrawIndirect;
+};
+
+// looks the entry points up for the current context. call it after
+// gladLoadGLLoader, again for every new context.
+void loadExtensions(void *(*getProcAddress)(const char *));
+const Extensions &getExtensions();
+
+GLsync fenceSync();
+GLenum clientWaitSync(GLsync sync, GLuint64 timeout);
+void deleteSync(GLsync sync);
+void bufferStorage(GLenum target, GLsizeiptr size, const void *data,
+                   GLbitfield flags);
+void copyBufferSubData(GLenum readTarget, GLenum writeTarget,
+                       GLintptr readOffset, GLintptr writeOffset,
+                       GLsizeiptr size);
+void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type,
+                            const void *indices, GLint baseVertex);
+void drawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type,
+                                     const void *indices,
+                                     GLsizei instanceCount, GLint baseVertex);
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                         GLsizei instanceCount);
+void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type,
+                           const void *indices, GLsizei instanceCount);
+void vertexAttribDivisor(GLuint index, GLuint divisor);
+GLuint getUniformBlockIndex(GLuint program, const GLchar *name);
+void getActiveUniformBlockiv(GLuint program, GLuint blockIndex, GLenum pname,
+                             GLint *params);
+void getActiveUniformsiv(GLuint program, GLsizei count, const GLuint *indices,
+                         GLenum pname, GLint *params);
+void uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding);
+// glMultiDraw* on desktop (core since GL 1.4). GLES3 has no multi-draw,
+// so there they loop over the draws natively.
+void multiDrawArrays(GLenum mode, const GLint *firsts, const GLsizei *counts,
+                     GLsizei drawCount);
+void multiDrawElements(GLenum mode, const GLsizei *counts, GLenum type,
+                       const void *const *indices, GLsizei drawCount);
+void drawArraysIndirect(GLenum mode, const void *indirect);
+void drawElementsIndirect(GLenum mode, GLenum type, const void *indirect);
+void multiDrawArraysIndirect(GLenum mode, const void *indirect,
+                             GLsizei drawCount, GLsizei stride);
+void multiDrawElementsIndirect(GLenum mode, GLenum type, const void *indirect,
+                               GLsizei drawCount, GLsizei stride);
+// copies bytes of the buffer bound to `target` back to client memory.
+// WebGL 2 has it although the GLES3 headers do not.
+void getBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                      void *data);
+void queryCounter(GLuint id, GLenum target);
+void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params);
+// whether timer results read since the last call are garbage, e.g. after
+// the GPU changed clocks. only the web reports this; desktop never does.
+bool timerDisjoint();
+} // namespace hello::gl
+#endif
@@ -0,0 +1,107 @@
+#include "./gpu_timer.hpp"
+#include "./extensions.hpp"
+
+#include <utility>
+
+namespace hello::gl {
+GpuTimer::GpuTimer(size_t maxPending, size_t window)
+    : maxPending(maxPending), window(window) {}
+
+GpuTimer::~GpuTimer() {
+  if (open) {
+    glEndQuery(GL_TIME_ELAPSED);
+  }
+  for (const auto &q : pending) {
+    pool.push_back(q.query);
+  }
+  if (!pool.empty()) {
+    glDeleteQueries(static_cast<GLsizei>(pool.size()), pool.data());
+  }
+}
+
+bool GpuTimer::beginPass(const std::string &name) {
+  if (!getExtensions().timerQuery || open || pending.size() >= maxPending) {
+    return false;
+  }
+
+  size_t pass = 0;
+  while (pass < passes.size() && passes[pass].name != name) {
+    ++pass;
+  }
+  if (pass == passes.size()) {
+    passes.push_back({name, std::vector<double>(window), 0, 0});
+  }
+
+  uint32_t query;
+  if (pool.empty()) {
+    glGenQueries(1, &query);
+  } else {
+    query = pool.back();
+    pool.pop_back();
+  }
+  glBeginQuery(GL_TIME_ELAPSED, query);
+  current = {query, pass};
+  open = true;
+  return true;
+}
+
+void GpuTimer::endPass() {
+  if (!open) {
+    return;
+  }
+  glEndQuery(GL_TIME_ELAPSED);
+  pending.push_back(current);
+  open = false;
+}
+
+void GpuTimer::collect() {
+  // results come back in submission order, so the first one that is not
+  // ready ends the scan
+  std::vector<std::pair<size_t, double>> results;
+  while (!pending.empty()) {
+    const auto q = pending.front();
+    GLuint available = 0;
+    glGetQueryObjectuiv(q.query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == 0) {
+      break;
+    }
+    GLuint64 elapsed = 0;
+    getQueryObjectui64v(q.query, GL_QUERY_RESULT, &elapsed);
+    results.emplace_back(q.pass, static_cast<double>(elapsed) / 1e6);
+    pool.push_back(q.query);
+    pending.pop_front();
+  }
+  if (results.empty() || timerDisjoint()) {
+    return;
+  }
+  for (const auto &[index, ms] : results) {
+    auto &pass = passes[index];
+    pass.history[pass.next] = ms;
+    pass.next = (pass.next + 1) % window;
+    if (pass.count < window) {
+      ++pass.count;
+    }
+  }
+}
+
+void GpuTimer::reset() {
+  for (auto &pass : passes) {
+    pass.next = 0;
+    pass.count = 0;
+  }
+}
+
+std::vector<PassTime> GpuTimer::getTimes() const {
+  std::vector<PassTime> times;
+  for (const auto &pass : passes) {
+    double sum = 0.0;
+    for (size_t i = 0; i < pass.count; ++i) {
+      sum += pass.history[i];
+    }
+    const auto last = (pass.next + window - 1) % window;
+    times.push_back({pass.name, pass.count > 0 ? pass.history[last] : 0.0,
+                     pass.count > 0 ? sum / pass.count : 0.0, pass.count});
+  }
+  return times;
+}
+} // namespace hello::gl
@@ -0,0 +1,66 @@
+#ifndef __GL_GPU_TIMER_HPP__
+#define __GL_GPU_TIMER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace hello::gl {
+struct PassTime {
+  std::string name;
+  // milliseconds of GPU time, of the newest result and averaged over the
+  // results in the window
+  double last;
+  double average;
+  size_t samples;
+};
+
+// GPU time of named passes through GL_TIME_ELAPSED queries. results come
+// in a few frames late; collect() only reads the queries the driver says
+// are done, so timing never makes the CPU wait for the GPU. queries are
+// recycled through a pool, and a pass is skipped rather than waited for
+// when `maxPending` are still in flight.
+class GpuTimer {
+public:
+  explicit GpuTimer(size_t maxPending = 64, size_t window = 60);
+  GpuTimer(const GpuTimer &) = delete;
+  GpuTimer &operator=(const GpuTimer &) = delete;
+  ~GpuTimer();
+
+  // passes cannot nest. false when there is no timer support, a pass is
+  // already open or the pool is full.
+  bool beginPass(const std::string &name);
+  void endPass();
+  // call once per frame
+  void collect();
+  void reset();
+
+  // passes in the order they were first begun
+  std::vector<PassTime> getTimes() const;
+  size_t getPendingCount() const { return pending.size(); }
+
+private:
+  struct Pass {
+    std::string name;
+    // milliseconds, a ring of the last `window` results
+    std::vector<double> history;
+    size_t next;
+    size_t count;
+  };
+  struct Query {
+    uint32_t query;
+    size_t pass;
+  };
+
+  size_t maxPending;
+  size_t window;
+  std::vector<Pass> passes;
+  std::deque<Query> pending;
+  std::vector<uint32_t> pool;
+  bool open = false;
+  Query current = {};
+};
+} // namespace hello::gl
+#endif
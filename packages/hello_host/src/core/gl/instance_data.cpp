@@ -0,0 +1,51 @@
+#include "./instance_data.hpp"
+
+#include <algorithm>
+
+namespace hello::gl {
+InstanceData::InstanceData(size_t components) : components(components) {}
+
+size_t InstanceData::add() {
+  const auto index = getCount();
+  values.resize(values.size() + components, 0.0f);
+  return index;
+}
+
+void InstanceData::resize(size_t count) {
+  values.resize(count * components, 0.0f);
+}
+
+void InstanceData::set(size_t index, size_t component, const float *data,
+                       size_t count) {
+  std::copy(data, data + count, &values[index * components + component]);
+}
+
+void InstanceData::setTransform(size_t index, size_t component,
+                                const float translation[3],
+                                const float rotation[4],
+                                const float scale[3]) {
+  const auto x = rotation[0];
+  const auto y = rotation[1];
+  const auto z = rotation[2];
+  const auto w = rotation[3];
+  const float m[16] = {
+      (1 - 2 * (y * y + z * z)) * scale[0],
+      2 * (x * y + z * w) * scale[0],
+      2 * (x * z - y * w) * scale[0],
+      0,
+      2 * (x * y - z * w) * scale[1],
+      (1 - 2 * (x * x + z * z)) * scale[1],
+      2 * (y * z + x * w) * scale[1],
+      0,
+      2 * (x * z + y * w) * scale[2],
+      2 * (y * z - x * w) * scale[2],
+      (1 - 2 * (x * x + y * y)) * scale[2],
+      0,
+      translation[0],
+      translation[1],
+      translation[2],
+      1,
+  };
+  set(index, component, m, 16);
+}
+} // namespace hello::gl
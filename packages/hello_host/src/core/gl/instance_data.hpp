@@ -0,0 +1,40 @@
+#ifndef __GL_INSTANCE_DATA_HPP__
+#define __GL_INSTANCE_DATA_HPP__
+
+#include <cstddef>
+#include <vector>
+
+namespace hello::gl {
+// per-instance vertex attributes packed as a float array, `components`
+// floats per instance, ready for one upload and one instanced draw. an
+// attribute at component c is read with vertexAttribPointer(loc, n,
+// GL_FLOAT, false, getStride(), c * 4) and vertexAttribDivisor(loc, 1);
+// a mat4 takes four consecutive locations.
+class InstanceData {
+public:
+  explicit InstanceData(size_t components);
+
+  // appends an instance with every component 0 and returns its index
+  size_t add();
+  void resize(size_t count);
+  void clear() { values.clear(); }
+
+  // the caller keeps `component + count` within getComponents()
+  void set(size_t index, size_t component, const float *data, size_t count);
+  // writes the column-major 4x4 matrix translate * rotate * scale, from a
+  // unit quaternion (x, y, z, w), to 16 components from `component`
+  void setTransform(size_t index, size_t component, const float translation[3],
+                    const float rotation[4], const float scale[3]);
+
+  size_t getComponents() const { return components; }
+  size_t getCount() const { return values.size() / components; }
+  size_t getStride() const { return components * sizeof(float); }
+  size_t getByteSize() const { return values.size() * sizeof(float); }
+  const float *getData() const { return values.data(); }
+
+private:
+  size_t components;
+  std::vector<float> values;
+};
+} // namespace hello::gl
+#endif
@@ -0,0 +1,98 @@
+#include "./readback.hpp"
+#include "./extensions.hpp"
+#include "./state_cache.hpp"
+
+namespace hello::gl {
+ReadbackRing::ReadbackRing(size_t count) : slots(count) {}
+
+ReadbackRing::~ReadbackRing() {
+  drop();
+  for (const auto &slot : slots) {
+    if (slot.buffer != 0) {
+      glDeleteBuffers(1, &slot.buffer);
+    }
+  }
+}
+
+uint64_t ReadbackRing::read(int32_t x, int32_t y, int32_t width,
+                            int32_t height, uint32_t format, uint32_t type,
+                            size_t size, size_t rowStride,
+                            StateCache &cache) {
+  if (size == 0 || pending.size() >= slots.size() || lost) {
+    return 0;
+  }
+
+  auto &slot = slots[next];
+  if (slot.buffer == 0) {
+    glGenBuffers(1, &slot.buffer);
+  }
+  cache.bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  if (slot.capacity < size) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size),
+                 nullptr, GL_STREAM_READ);
+    slot.capacity = size;
+  }
+  glReadPixels(x, y, width, height, format, type, nullptr);
+  cache.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  const auto sync = getExtensions().sync ? fenceSync() : nullptr;
+  pending.push_back({next, sync,
+                     {++lastId, x, y, width, height, format, type, size,
+                      rowStride}});
+  next = (next + 1) % slots.size();
+  return lastId;
+}
+
+size_t ReadbackRing::collect(
+    StateCache &cache,
+    const std::function<void(const ReadbackInfo &, const uint8_t *)>
+        &deliver) {
+  size_t count = 0;
+  while (!pending.empty()) {
+    const auto p = pending.front();
+    if (p.sync != nullptr) {
+      const auto status = clientWaitSync(static_cast<GLsync>(p.sync), 0);
+      if (status == GL_WAIT_FAILED) {
+        lost = true;
+        drop();
+        break;
+      }
+      if (status != GL_ALREADY_SIGNALED &&
+          status != GL_CONDITION_SATISFIED) {
+        break;
+      }
+      deleteSync(static_cast<GLsync>(p.sync));
+    }
+    pending.pop_front();
+
+    const auto size = static_cast<GLsizeiptr>(p.info.size);
+    cache.bindBuffer(GL_PIXEL_PACK_BUFFER, slots[p.slot].buffer);
+#ifdef __EMSCRIPTEN__
+    scratch.resize(p.info.size);
+    getBufferSubData(GL_PIXEL_PACK_BUFFER, 0, size, scratch.data());
+    cache.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    deliver(p.info, scratch.data());
+    ++count;
+#else
+    auto pixels = static_cast<const uint8_t *>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+    if (pixels != nullptr) {
+      deliver(p.info, pixels);
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      ++count;
+    }
+    cache.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+  }
+  return count;
+}
+
+void ReadbackRing::drop() {
+  for (const auto &p : pending) {
+    if (p.sync != nullptr) {
+      deleteSync(static_cast<GLsync>(p.sync));
+    }
+  }
+  pending.clear();
+}
+} // namespace hello::gl
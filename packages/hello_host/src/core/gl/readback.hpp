@@ -0,0 +1,85 @@
+#ifndef __GL_READBACK_HPP__
+#define __GL_READBACK_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace hello::gl {
+class StateCache;
+
+struct ReadbackInfo {
+  uint64_t id;
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+  uint32_t format;
+  uint32_t type;
+  // bytes of the pixels, rows padded to GL_PACK_ALIGNMENT at read time
+  // except the last
+  size_t size;
+  // bytes from one row to the next
+  size_t rowStride;
+};
+
+// asynchronous glReadPixels through a ring of pixel pack buffers. read()
+// only queues the copy on the GPU and sets a fence after it; collect()
+// hands over the readbacks whose fences have signaled, so neither call
+// waits for the GPU. without sync objects a readback counts as finished
+// once it is collected, which may block in the driver.
+class ReadbackRing {
+public:
+  explicit ReadbackRing(size_t count);
+  ReadbackRing(const ReadbackRing &) = delete;
+  ReadbackRing &operator=(const ReadbackRing &) = delete;
+  ~ReadbackRing();
+
+  // reads the rectangle of the read framebuffer into the next free buffer
+  // and returns an id, counting from 1. 0 when every buffer is still in
+  // flight or waiting for the GPU failed (see isLost()). the pack buffer
+  // binding is restored to 0.
+  uint64_t read(int32_t x, int32_t y, int32_t width, int32_t height,
+                uint32_t format, uint32_t type, size_t size, size_t rowStride,
+                StateCache &cache);
+  // passes the finished readbacks to `deliver`, oldest first, and returns
+  // how many there were. the pixels are only valid during the call. when a
+  // fence cannot be waited for, every readback still pending is dropped.
+  size_t collect(
+      StateCache &cache,
+      const std::function<void(const ReadbackInfo &, const uint8_t *)>
+          &deliver);
+
+  size_t getCount() const { return slots.size(); }
+  size_t getPendingCount() const { return pending.size(); }
+  // a fence could not be waited for, e.g. after a lost context. the ring
+  // refuses every read from then on.
+  bool isLost() const { return lost; }
+
+private:
+  struct Slot {
+    uint32_t buffer = 0;
+    size_t capacity = 0;
+  };
+
+  struct Pending {
+    size_t slot;
+    void *sync;
+    ReadbackInfo info;
+  };
+
+  // forgets every pending readback and deletes its fence
+  void drop();
+
+  std::vector<Slot> slots;
+  std::deque<Pending> pending;
+  size_t next = 0;
+  uint64_t lastId = 0;
+  bool lost = false;
+  // where WebGL copies the pixels, which cannot be mapped for reading
+  std::vector<uint8_t> scratch;
+};
+} // namespace hello::gl
+#endif
@@ -0,0 +1,265 @@
+#include "./state_cache.hpp"
+
+#ifdef __EMSCRIPTEN__
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+// buffer targets newer than the GL 3.0 loader
+#ifndef GL_COPY_READ_BUFFER
+#define GL_COPY_READ_BUFFER 0x8F36
+#endif
+#ifndef GL_COPY_WRITE_BUFFER
+#define GL_COPY_WRITE_BUFFER 0x8F37
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+namespace {
+// a name no object can have, for bindings the cache does not know
+const uint32_t UNKNOWN = 0xffffffff;
+
+int getBufferIndex(GLenum target) {
+  switch (target) {
+  case GL_ARRAY_BUFFER:
+    return 0;
+  case GL_ELEMENT_ARRAY_BUFFER:
+    return 1;
+  case GL_COPY_READ_BUFFER:
+    return 2;
+  case GL_COPY_WRITE_BUFFER:
+    return 3;
+  case GL_PIXEL_PACK_BUFFER:
+    return 4;
+  case GL_PIXEL_UNPACK_BUFFER:
+    return 5;
+  case GL_UNIFORM_BUFFER:
+    return 6;
+  case GL_TRANSFORM_FEEDBACK_BUFFER:
+    return 7;
+  case GL_DRAW_INDIRECT_BUFFER:
+    return 8;
+  default:
+    return -1;
+  }
+}
+
+int getTextureIndex(GLenum target) {
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return 0;
+  case GL_TEXTURE_CUBE_MAP:
+    return 1;
+  case GL_TEXTURE_3D:
+    return 2;
+  case GL_TEXTURE_2D_ARRAY:
+    return 3;
+  default:
+    return -1;
+  }
+}
+} // namespace
+
+namespace hello::gl {
+StateCache::StateCache() { invalidate(); }
+
+void StateCache::setContext(const void *context) {
+  if (context != this->context) {
+    this->context = context;
+    invalidate();
+  }
+}
+
+void StateCache::invalidate() {
+  for (auto &buffer : buffers) {
+    buffer = UNKNOWN;
+  }
+  for (auto &binding : uniformBuffers) {
+    binding.buffer = UNKNOWN;
+  }
+  vertexArray = UNKNOWN;
+  program = UNKNOWN;
+  drawFramebuffer = UNKNOWN;
+  readFramebuffer = UNKNOWN;
+  activeUnit = UNKNOWN;
+  for (auto &unit : textures) {
+    for (auto &texture : unit) {
+      texture = UNKNOWN;
+    }
+  }
+  clearColorKnown = false;
+  viewportKnown = false;
+}
+
+bool StateCache::isRedundant(bool redundant) {
+  if (redundant) {
+    ++stats.filtered;
+  } else {
+    ++stats.forwarded;
+  }
+  return redundant;
+}
+
+void StateCache::bindBuffer(uint32_t target, uint32_t buffer) {
+  const auto index = getBufferIndex(target);
+  if (index < 0) {
+    isRedundant(false);
+    glBindBuffer(target, buffer);
+    return;
+  }
+  if (!isRedundant(buffers[index] == buffer)) {
+    glBindBuffer(target, buffer);
+    buffers[index] = buffer;
+  }
+}
+
+void StateCache::bindBufferBase(uint32_t target, uint32_t index,
+                                uint32_t buffer) {
+  bindBufferRange(target, index, buffer, 0, -1);
+}
+
+void StateCache::bindBufferRange(uint32_t target, uint32_t index,
+                                 uint32_t buffer, intptr_t offset,
+                                 intptr_t size) {
+  if (target == GL_UNIFORM_BUFFER && index < UNIFORM_BINDINGS) {
+    auto &bound = uniformBuffers[index];
+    if (isRedundant(bound.buffer == buffer && bound.offset == offset &&
+                    bound.size == size)) {
+      return;
+    }
+    bound = {buffer, offset, size};
+  } else {
+    isRedundant(false);
+  }
+  if (size < 0) {
+    glBindBufferBase(target, index, buffer);
+  } else {
+    glBindBufferRange(target, index, buffer, offset, size);
+  }
+  const auto generic = getBufferIndex(target);
+  if (generic >= 0) {
+    buffers[generic] = buffer;
+  }
+}
+
+void StateCache::bindVertexArray(uint32_t array) {
+  if (!isRedundant(vertexArray == array)) {
+    glBindVertexArray(array);
+    vertexArray = array;
+    // the element array binding belongs to the vertex array
+    buffers[getBufferIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+  }
+}
+
+void StateCache::useProgram(uint32_t program) {
+  if (!isRedundant(this->program == program)) {
+    glUseProgram(program);
+    this->program = program;
+  }
+}
+
+void StateCache::bindFramebuffer(uint32_t target, uint32_t framebuffer) {
+  const auto draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+  const auto read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+  if (!isRedundant((draw || read) &&
+                   (!draw || drawFramebuffer == framebuffer) &&
+                   (!read || readFramebuffer == framebuffer))) {
+    glBindFramebuffer(target, framebuffer);
+    if (draw) {
+      drawFramebuffer = framebuffer;
+    }
+    if (read) {
+      readFramebuffer = framebuffer;
+    }
+  }
+}
+
+void StateCache::activeTexture(uint32_t texture) {
+  if (!isRedundant(activeUnit == texture)) {
+    glActiveTexture(texture);
+    activeUnit = texture;
+  }
+}
+
+void StateCache::bindTexture(uint32_t target, uint32_t texture) {
+  const auto index = getTextureIndex(target);
+  const auto unit = activeUnit - GL_TEXTURE0;
+  if (index < 0 || activeUnit == UNKNOWN || unit >= TEXTURE_UNITS) {
+    isRedundant(false);
+    glBindTexture(target, texture);
+    return;
+  }
+  if (!isRedundant(textures[unit][index] == texture)) {
+    glBindTexture(target, texture);
+    textures[unit][index] = texture;
+  }
+}
+
+void StateCache::clearColor(float r, float g, float b, float a) {
+  const float value[] = {r, g, b, a};
+  auto same = clearColorKnown;
+  for (size_t i = 0; same && i < 4; ++i) {
+    same = clearColorValue[i] == value[i];
+  }
+  if (!isRedundant(same)) {
+    glClearColor(r, g, b, a);
+    for (size_t i = 0; i < 4; ++i) {
+      clearColorValue[i] = value[i];
+    }
+    clearColorKnown = true;
+  }
+}
+
+void StateCache::viewport(int32_t x, int32_t y, int32_t width,
+                          int32_t height) {
+  const int32_t value[] = {x, y, width, height};
+  auto same = viewportKnown;
+  for (size_t i = 0; same && i < 4; ++i) {
+    same = viewportValue[i] == value[i];
+  }
+  if (!isRedundant(same)) {
+    glViewport(x, y, width, height);
+    for (size_t i = 0; i < 4; ++i) {
+      viewportValue[i] = value[i];
+    }
+    viewportKnown = true;
+  }
+}
+
+void StateCache::bufferDeleted(uint32_t buffer) {
+  for (auto &bound : buffers) {
+    if (bound == buffer) {
+      bound = 0;
+    }
+  }
+  for (auto &bound : uniformBuffers) {
+    if (bound.buffer == buffer) {
+      bound = {0, 0, -1};
+    }
+  }
+}
+
+void StateCache::textureDeleted(uint32_t texture) {
+  for (auto &unit : textures) {
+    for (auto &bound : unit) {
+      if (bound == texture) {
+        bound = 0;
+      }
+    }
+  }
+}
+
+void StateCache::framebufferDeleted(uint32_t framebuffer) {
+  if (drawFramebuffer == framebuffer) {
+    drawFramebuffer = 0;
+  }
+  if (readFramebuffer == framebuffer) {
+    readFramebuffer = 0;
+  }
+}
+} // namespace hello::gl
@@ -0,0 +1,80 @@
+#ifndef __GL_STATE_CACHE_HPP__
+#define __GL_STATE_CACHE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hello::gl {
+struct StateStats {
+  // calls passed on to the driver, and calls dropped as redundant
+  uint64_t forwarded;
+  uint64_t filtered;
+};
+
+// shadow copy of the binding, clear color and viewport state, so calls
+// that would not change anything never reach the driver. anything that
+// changes this state behind the cache's back must call invalidate(), after
+// which every value is unknown and the next call of each kind goes through.
+class StateCache {
+public:
+  StateCache();
+
+  // every context has its own state, so switching forgets everything
+  void setContext(const void *context);
+  void invalidate();
+
+  void bindBuffer(uint32_t target, uint32_t buffer);
+  // indexed bindings, which also set the generic binding of `target`. the
+  // uniform buffer bindings are cached, the others always go through.
+  void bindBufferBase(uint32_t target, uint32_t index, uint32_t buffer);
+  void bindBufferRange(uint32_t target, uint32_t index, uint32_t buffer,
+                       intptr_t offset, intptr_t size);
+  void bindVertexArray(uint32_t array);
+  void useProgram(uint32_t program);
+  void bindFramebuffer(uint32_t target, uint32_t framebuffer);
+  void activeTexture(uint32_t texture);
+  void bindTexture(uint32_t target, uint32_t texture);
+  void clearColor(float r, float g, float b, float a);
+  void viewport(int32_t x, int32_t y, int32_t width, int32_t height);
+
+  // deleting a bound object resets its bindings to 0 in the current
+  // context. call these after the glDelete* call.
+  void bufferDeleted(uint32_t buffer);
+  void textureDeleted(uint32_t texture);
+  void framebufferDeleted(uint32_t framebuffer);
+
+  const StateStats &getStats() const { return stats; }
+  void resetStats() { stats = {}; }
+
+private:
+  static constexpr size_t BUFFER_TARGETS = 9;
+  static constexpr size_t TEXTURE_TARGETS = 4;
+  static constexpr size_t TEXTURE_UNITS = 32;
+  static constexpr size_t UNIFORM_BINDINGS = 16;
+
+  struct IndexedBuffer {
+    uint32_t buffer;
+    intptr_t offset;
+    // -1 for the whole buffer
+    intptr_t size;
+  };
+
+  bool isRedundant(bool redundant);
+
+  const void *context = nullptr;
+  uint32_t buffers[BUFFER_TARGETS];
+  IndexedBuffer uniformBuffers[UNIFORM_BINDINGS];
+  uint32_t vertexArray;
+  uint32_t program;
+  uint32_t drawFramebuffer;
+  uint32_t readFramebuffer;
+  uint32_t activeUnit;
+  uint32_t textures[TEXTURE_UNITS][TEXTURE_TARGETS];
+  bool clearColorKnown;
+  float clearColorValue[4];
+  bool viewportKnown;
+  int32_t viewportValue[4];
+  StateStats stats = {};
+};
+} // namespace hello::gl
+#endif
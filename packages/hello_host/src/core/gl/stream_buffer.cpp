@@ -0,0 +1,122 @@
+#include "./stream_buffer.hpp"
+#include "./extensions.hpp"
+#include "./state_cache.hpp"
+
+#include <cstring>
+
+namespace {
+// how long a single wait on a fence may block before checking again
+const GLuint64 FENCE_WAIT_NS = 1000000000;
+} // namespace
+
+namespace hello::gl {
+StreamBuffer::StreamBuffer(uint32_t target, size_t size, StateCache &cache)
+    : target(target), uploadTarget(target), size(size) {
+  const auto &extensions = getExtensions();
+  // the index buffer binding belongs to the vertex array, so GL 3.0
+  // without copy buffers writes indices through the array buffer target
+  if (extensions.copyBuffer) {
+    uploadTarget = GL_COPY_WRITE_BUFFER;
+  } else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    uploadTarget = GL_ARRAY_BUFFER;
+  }
+  glGenBuffers(1, &buffer);
+  cache.bindBuffer(uploadTarget, buffer);
+
+  if (extensions.bufferStorage && extensions.sync) {
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    bufferStorage(uploadTarget, static_cast<GLsizeiptr>(size), nullptr,
+                  flags);
+    mapped = static_cast<uint8_t *>(glMapBufferRange(
+        uploadTarget, 0, static_cast<GLsizeiptr>(size), flags));
+    if (mapped != nullptr) {
+      return;
+    }
+    // storage is immutable, so the fallback needs a new buffer
+    glDeleteBuffers(1, &buffer);
+    cache.bufferDeleted(buffer);
+    glGenBuffers(1, &buffer);
+    cache.bindBuffer(uploadTarget, buffer);
+  }
+  glBufferData(uploadTarget, static_cast<GLsizeiptr>(size), nullptr,
+               GL_STREAM_DRAW);
+  // orphaning makes every lap safe, so nothing ever has to be waited for
+  released = UINT64_MAX;
+}
+
+StreamBuffer::~StreamBuffer() {
+  for (const auto &f : fences) {
+    deleteSync(static_cast<GLsync>(f.sync));
+  }
+  // deleting a mapped buffer unmaps it
+  glDeleteBuffers(1, &buffer);
+}
+
+bool StreamBuffer::waitUntilFree(uint64_t end) {
+  while (released < end) {
+    if (fences.empty()) {
+      return false;
+    }
+    const auto &front = fences.front();
+    GLenum status;
+    do {
+      status = clientWaitSync(static_cast<GLsync>(front.sync), FENCE_WAIT_NS);
+    } while (status == GL_TIMEOUT_EXPIRED);
+    if (status == GL_WAIT_FAILED) {
+      lost = true;
+      return false;
+    }
+    deleteSync(static_cast<GLsync>(front.sync));
+    released = front.end;
+    fences.pop_front();
+  }
+  return true;
+}
+
+bool StreamBuffer::write(const void *data, size_t size, size_t alignment,
+                         StateCache &cache, size_t *offset) {
+  if (size == 0 || size > this->size || alignment == 0 || lost) {
+    return false;
+  }
+  auto position = (head + alignment - 1) / alignment * alignment;
+  auto nextLap = lap;
+  if (position > this->size || this->size - position < size) {
+    position = 0;
+    ++nextLap;
+  }
+
+  // the bytes about to be written were last written one lap earlier
+  const auto end = nextLap * this->size + position + size;
+  if (end > this->size && !waitUntilFree(end - this->size)) {
+    return false;
+  }
+
+  if (mapped != nullptr) {
+    ::memcpy(mapped + position, data, size);
+  } else {
+    cache.bindBuffer(uploadTarget, buffer);
+    if (nextLap != lap) {
+      glBufferData(uploadTarget, static_cast<GLsizeiptr>(this->size),
+                   nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(uploadTarget, static_cast<GLintptr>(position),
+                    static_cast<GLsizeiptr>(size), data);
+  }
+  lap = nextLap;
+  head = position + size;
+  *offset = position;
+  return true;
+}
+
+void StreamBuffer::fence() {
+  if (mapped == nullptr) {
+    return;
+  }
+  const auto end = lap * size + head;
+  if (!fences.empty() && fences.back().end == end) {
+    return;
+  }
+  fences.push_back({fenceSync(), end});
+}
+} // namespace hello::gl
@@ -0,0 +1,67 @@
+#ifndef __GL_STREAM_BUFFER_HPP__
+#define __GL_STREAM_BUFFER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace hello::gl {
+class StateCache;
+
+// a ring of GPU memory for data rewritten every frame. with buffer storage
+// and sync objects the ring is mapped once, persistently and coherently,
+// and writes are plain copies; fences keep a region from being overwritten
+// while the GPU may still read it. elsewhere (GLES3, WebGL) every lap
+// orphans the storage with glBufferData and writes use glBufferSubData.
+class StreamBuffer {
+public:
+  // `target` is where the buffer is used. storage is allocated and written
+  // through GL_COPY_WRITE_BUFFER where there is one, so the buffer bound to
+  // `target`, e.g. the index buffer of the bound vertex array, is left be.
+  StreamBuffer(uint32_t target, size_t size, StateCache &cache);
+  StreamBuffer(const StreamBuffer &) = delete;
+  StreamBuffer &operator=(const StreamBuffer &) = delete;
+  ~StreamBuffer();
+
+  // copies `size` bytes to an offset that is a multiple of `alignment`
+  // (any value, e.g. a vertex stride) and returns it in `offset`. false
+  // when the data does not fit, would overwrite data written since the
+  // last fence(), or waiting for the GPU failed (see isLost()).
+  bool write(const void *data, size_t size, size_t alignment,
+             StateCache &cache, size_t *offset);
+  // marks everything written so far as used by the commands issued so far,
+  // typically once per frame after the draws
+  void fence();
+
+  uint32_t getBuffer() const { return buffer; }
+  uint32_t getTarget() const { return target; }
+  size_t getSize() const { return size; }
+  bool isPersistent() const { return mapped != nullptr; }
+  // a fence could not be waited for, e.g. after a lost context. the ring
+  // refuses every write from then on.
+  bool isLost() const { return lost; }
+
+private:
+  struct Fence {
+    void *sync;
+    // linear position of the write head when the fence was set
+    uint64_t end;
+  };
+
+  bool waitUntilFree(uint64_t end);
+
+  uint32_t target;
+  uint32_t uploadTarget;
+  uint32_t buffer = 0;
+  size_t size;
+  uint8_t *mapped = nullptr;
+  // position of the next write within the current lap
+  size_t head = 0;
+  uint64_t lap = 0;
+  // every byte before this linear position may be overwritten
+  uint64_t released = 0;
+  std::deque<Fence> fences;
+  bool lost = false;
+};
+} // namespace hello::gl
+#endif
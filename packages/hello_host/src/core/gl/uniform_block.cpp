@@ -0,0 +1,272 @@
+#include "./uniform_block.hpp"
+#include "./extensions.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+enum class Scalar { Float, Int, UInt, Bool };
+
+struct TypeInfo {
+  Scalar scalar;
+  // a vector is a single column
+  uint32_t columns;
+  uint32_t rows;
+};
+
+bool getTypeInfo(uint32_t type, TypeInfo *info) {
+  switch (type) {
+  case GL_FLOAT:
+    *info = {Scalar::Float, 1, 1};
+    return true;
+  case GL_FLOAT_VEC2:
+    *info = {Scalar::Float, 1, 2};
+    return true;
+  case GL_FLOAT_VEC3:
+    *info = {Scalar::Float, 1, 3};
+    return true;
+  case GL_FLOAT_VEC4:
+    *info = {Scalar::Float, 1, 4};
+    return true;
+  case GL_INT:
+    *info = {Scalar::Int, 1, 1};
+    return true;
+  case GL_INT_VEC2:
+    *info = {Scalar::Int, 1, 2};
+    return true;
+  case GL_INT_VEC3:
+    *info = {Scalar::Int, 1, 3};
+    return true;
+  case GL_INT_VEC4:
+    *info = {Scalar::Int, 1, 4};
+    return true;
+  case GL_UNSIGNED_INT:
+    *info = {Scalar::UInt, 1, 1};
+    return true;
+  case GL_UNSIGNED_INT_VEC2:
+    *info = {Scalar::UInt, 1, 2};
+    return true;
+  case GL_UNSIGNED_INT_VEC3:
+    *info = {Scalar::UInt, 1, 3};
+    return true;
+  case GL_UNSIGNED_INT_VEC4:
+    *info = {Scalar::UInt, 1, 4};
+    return true;
+  case GL_BOOL:
+    *info = {Scalar::Bool, 1, 1};
+    return true;
+  case GL_BOOL_VEC2:
+    *info = {Scalar::Bool, 1, 2};
+    return true;
+  case GL_BOOL_VEC3:
+    *info = {Scalar::Bool, 1, 3};
+    return true;
+  case GL_BOOL_VEC4:
+    *info = {Scalar::Bool, 1, 4};
+    return true;
+  case GL_FLOAT_MAT2:
+    *info = {Scalar::Float, 2, 2};
+    return true;
+  case GL_FLOAT_MAT2x3:
+    *info = {Scalar::Float, 2, 3};
+    return true;
+  case GL_FLOAT_MAT2x4:
+    *info = {Scalar::Float, 2, 4};
+    return true;
+  case GL_FLOAT_MAT3:
+    *info = {Scalar::Float, 3, 3};
+    return true;
+  case GL_FLOAT_MAT3x2:
+    *info = {Scalar::Float, 3, 2};
+    return true;
+  case GL_FLOAT_MAT3x4:
+    *info = {Scalar::Float, 3, 4};
+    return true;
+  case GL_FLOAT_MAT4:
+    *info = {Scalar::Float, 4, 4};
+    return true;
+  case GL_FLOAT_MAT4x2:
+    *info = {Scalar::Float, 4, 2};
+    return true;
+  case GL_FLOAT_MAT4x3:
+    *info = {Scalar::Float, 4, 3};
+    return true;
+  default:
+    return false;
+  }
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+namespace hello::gl {
+bool UniformLayout::add(const std::string &name, uint32_t type,
+                        uint32_t arraySize) {
+  TypeInfo info;
+  if (arraySize == 0 || !getTypeInfo(type, &info)) {
+    return false;
+  }
+
+  // std140: a matrix is an array of column vectors, and every array
+  // element, column included, starts on a vec4 boundary
+  size_t alignment;
+  size_t elementSize;
+  uint32_t matrixStride = 0;
+  if (info.columns > 1) {
+    matrixStride = 16;
+    alignment = 16;
+    elementSize = info.columns * matrixStride;
+  } else {
+    alignment = info.rows == 1 ? 4 : info.rows == 2 ? 8 : 16;
+    elementSize = info.rows * 4;
+  }
+  uint32_t arrayStride = 0;
+  auto memberSize = elementSize;
+  if (arraySize > 1) {
+    alignment = alignUp(alignment, 16);
+    arrayStride = static_cast<uint32_t>(alignUp(elementSize, 16));
+    memberSize = static_cast<size_t>(arrayStride) * arraySize;
+  }
+
+  const auto offset = alignUp(end, alignment);
+  members.push_back({name, type, static_cast<uint32_t>(offset), arraySize,
+                     arrayStride, matrixStride, false});
+  end = offset + memberSize;
+  size = alignUp(end, 16);
+  return true;
+}
+
+bool UniformLayout::reflect(uint32_t program, const char *name) {
+  if (!getExtensions().uniformBuffer) {
+    return false;
+  }
+  const auto block = getUniformBlockIndex(program, name);
+  if (block == GL_INVALID_INDEX) {
+    return false;
+  }
+  GLint dataSize = 0;
+  GLint count = 0;
+  getActiveUniformBlockiv(program, block, GL_UNIFORM_BLOCK_DATA_SIZE,
+                          &dataSize);
+  getActiveUniformBlockiv(program, block, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS,
+                          &count);
+  std::vector<GLint> indices(static_cast<size_t>(count));
+  if (count > 0) {
+    getActiveUniformBlockiv(program, block,
+                            GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES,
+                            indices.data());
+  }
+  std::vector<GLuint> uniforms(indices.begin(), indices.end());
+
+  const GLenum pnames[] = {GL_UNIFORM_TYPE,         GL_UNIFORM_SIZE,
+                           GL_UNIFORM_OFFSET,       GL_UNIFORM_ARRAY_STRIDE,
+                           GL_UNIFORM_MATRIX_STRIDE, GL_UNIFORM_IS_ROW_MAJOR};
+  std::vector<GLint> values[std::size(pnames)];
+  for (size_t i = 0; i < std::size(pnames); ++i) {
+    values[i].resize(uniforms.size());
+    if (count > 0) {
+      getActiveUniformsiv(program, count, uniforms.data(), pnames[i],
+                          values[i].data());
+    }
+  }
+
+  GLint maxLength = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+  std::vector<GLchar> buffer(static_cast<size_t>(maxLength) + 1);
+  members.clear();
+  for (size_t i = 0; i < uniforms.size(); ++i) {
+    GLsizei length = 0;
+    GLint arraySize = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program, uniforms[i],
+                       static_cast<GLsizei>(buffer.size()), &length,
+                       &arraySize, &type, buffer.data());
+    std::string uniformName(buffer.data(), static_cast<size_t>(length));
+    // arrays are reported by their first element
+    const auto suffix = uniformName.rfind("[0]");
+    if (suffix != std::string::npos && suffix + 3 == uniformName.size()) {
+      uniformName.resize(suffix);
+    }
+    members.push_back({uniformName, static_cast<uint32_t>(values[0][i]),
+                       static_cast<uint32_t>(values[2][i]),
+                       static_cast<uint32_t>(values[1][i]),
+                       static_cast<uint32_t>(values[3][i]),
+                       static_cast<uint32_t>(values[4][i]),
+                       values[5][i] != 0});
+  }
+  std::sort(members.begin(), members.end(),
+            [](const UniformMember &a, const UniformMember &b) {
+              return a.offset < b.offset;
+            });
+  end = static_cast<size_t>(dataSize);
+  size = end;
+  return true;
+}
+
+const UniformMember *UniformLayout::find(std::string_view name) const {
+  for (const auto &member : members) {
+    if (member.name == name) {
+      return &member;
+    }
+  }
+  return nullptr;
+}
+
+UniformBlock::UniformBlock(const UniformLayout &layout)
+    : layout(layout), bytes(layout.getSize(), 0) {}
+
+bool UniformBlock::set(std::string_view name, size_t element,
+                       const double *values, size_t count) {
+  const auto member = layout.find(name);
+  TypeInfo info;
+  if (member == nullptr || !getTypeInfo(member->type, &info) ||
+      element >= member->arraySize) {
+    return false;
+  }
+  const size_t components = info.columns * info.rows;
+  if (count > (member->arraySize - element) * components) {
+    return false;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    const auto e = element + i / components;
+    const auto k = i % components;
+    size_t position = member->offset + e * member->arrayStride;
+    if (info.columns > 1) {
+      const auto column = k / info.rows;
+      const auto row = k % info.rows;
+      position += member->rowMajor
+                      ? row * member->matrixStride + column * 4
+                      : column * member->matrixStride + row * 4;
+    } else {
+      position += k * 4;
+    }
+    if (position + 4 > bytes.size()) {
+      return false;
+    }
+
+    uint32_t word = 0;
+    switch (info.scalar) {
+    case Scalar::Float: {
+      const auto f = static_cast<float>(values[i]);
+      ::memcpy(&word, &f, sizeof(word));
+      break;
+    }
+    case Scalar::Int:
+      word = static_cast<uint32_t>(static_cast<int32_t>(values[i]));
+      break;
+    case Scalar::UInt:
+      word = static_cast<uint32_t>(values[i]);
+      break;
+    case Scalar::Bool:
+      word = values[i] != 0.0 ? 1 : 0;
+      break;
+    }
+    ::memcpy(&bytes[position], &word, sizeof(word));
+  }
+  return true;
+}
+} // namespace hello::gl
@@ -0,0 +1,68 @@
+#ifndef __GL_UNIFORM_BLOCK_HPP__
+#define __GL_UNIFORM_BLOCK_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hello::gl {
+struct UniformMember {
+  std::string name;
+  // GL_FLOAT, GL_FLOAT_VEC3, GL_FLOAT_MAT4, GL_INT_VEC2, ...
+  uint32_t type;
+  uint32_t offset;
+  // 1 for members that are not arrays
+  uint32_t arraySize;
+  uint32_t arrayStride;
+  // distance between columns (rows when row major) of a matrix
+  uint32_t matrixStride;
+  bool rowMajor;
+};
+
+// where each member of a uniform block lives, either computed here with
+// the std140 rules or read back from a linked program
+class UniformLayout {
+public:
+  // appends a member at the next offset std140 allows. false for types
+  // that cannot be in a uniform block.
+  bool add(const std::string &name, uint32_t type, uint32_t arraySize = 1);
+  // reads the layout of the block `name` of a linked program, including
+  // its size and any padding the driver adds. false when there is no such
+  // block or no uniform buffer support.
+  bool reflect(uint32_t program, const char *name);
+
+  const UniformMember *find(std::string_view name) const;
+  const std::vector<UniformMember> &getMembers() const { return members; }
+  size_t getSize() const { return size; }
+
+private:
+  std::vector<UniformMember> members;
+  // end of the last member, and that rounded up to a vec4 for std140
+  size_t end = 0;
+  size_t size = 0;
+};
+
+// the bytes of one uniform block instance, ready for bufferData, or for a
+// stream buffer when every draw gets a block of its own
+class UniformBlock {
+public:
+  explicit UniformBlock(const UniformLayout &layout);
+
+  // converts `count` values to the member's component type and writes them
+  // from array element `element` on, column by column for matrices. false
+  // for unknown members or values past the end of the member.
+  bool set(std::string_view name, size_t element, const double *values,
+           size_t count);
+
+  const UniformLayout &getLayout() const { return layout; }
+  const uint8_t *getData() const { return bytes.data(); }
+  size_t getSize() const { return bytes.size(); }
+
+private:
+  UniformLayout layout;
+  std::vector<uint8_t> bytes;
+};
+} // namespace hello::gl
+#endif
@@ -0,0 +1,120 @@
+#include "./image_atlas.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace hello::image {
+SkylinePacker::SkylinePacker(int width, int height)
+    : width(width), height(height) {
+  skyline.push_back({0, 0, width});
+}
+
+bool SkylinePacker::fits(size_t index, int w, int h, int *y) const {
+  const auto x = skyline[index].x;
+  if (x + w > width) {
+    return false;
+  }
+  auto top = skyline[index].y;
+  auto remaining = w;
+  for (auto i = index; remaining > 0; ++i) {
+    if (i >= skyline.size()) {
+      return false;
+    }
+    top = std::max(top, skyline[i].y);
+    if (top + h > height) {
+      return false;
+    }
+    remaining -= skyline[i].width;
+  }
+  *y = top;
+  return true;
+}
+
+void SkylinePacker::addLevel(size_t index, int x, int y, int w, int h) {
+  skyline.insert(skyline.begin() + index, {x, y + h, w});
+
+  // trim or drop the nodes the new one now covers
+  for (auto i = index + 1; i < skyline.size();) {
+    auto &node = skyline[i];
+    const auto covered = x + w - node.x;
+    if (covered <= 0) {
+      break;
+    }
+    if (covered < node.width) {
+      node.x += covered;
+      node.width -= covered;
+      break;
+    }
+    skyline.erase(skyline.begin() + i);
+  }
+
+  for (size_t i = 0; i + 1 < skyline.size();) {
+    if (skyline[i].y == skyline[i + 1].y) {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+}
+
+bool SkylinePacker::insert(int w, int h, int *x, int *y) {
+  auto bestBottom = INT_MAX;
+  auto bestWidth = INT_MAX;
+  auto bestIndex = skyline.size();
+  auto bestY = 0;
+
+  for (size_t i = 0; i < skyline.size(); ++i) {
+    int top;
+    if (!fits(i, w, h, &top)) {
+      continue;
+    }
+    const auto bottom = top + h;
+    if (bottom < bestBottom ||
+        (bottom == bestBottom && skyline[i].width < bestWidth)) {
+      bestBottom = bottom;
+      bestWidth = skyline[i].width;
+      bestIndex = i;
+      bestY = top;
+    }
+  }
+  if (bestIndex == skyline.size()) {
+    return false;
+  }
+
+  *x = skyline[bestIndex].x;
+  *y = bestY;
+  addLevel(bestIndex, *x, *y, w, h);
+  usedArea += w * h;
+  return true;
+}
+
+void blitExtruded(const ImageView &src, const ImageView &dst, int x, int y,
+                  int extrude) {
+  if (src.width <= 0 || src.height <= 0) {
+    return;
+  }
+  const auto rowBytes = static_cast<size_t>(src.width) * 4;
+  auto dstRow = [&dst](int row) { return dst.pixels + row * dst.pitch; };
+
+  for (int row = 0; row < src.height; ++row) {
+    auto s = src.pixels + row * src.pitch;
+    auto d = dstRow(y + row) + x * 4;
+    ::memcpy(d, s, rowBytes);
+    for (int i = 1; i <= extrude; ++i) {
+      ::memcpy(d - i * 4, s, 4);
+      ::memcpy(d + rowBytes + (i - 1) * 4, s + rowBytes - 4, 4);
+    }
+  }
+
+  // top and bottom borders copy the already extruded first and last rows
+  const auto fullBytes = rowBytes + extrude * 8;
+  const auto left = (x - extrude) * 4;
+  for (int i = 1; i <= extrude; ++i) {
+    ::memcpy(dstRow(y - i) + left, dstRow(y) + left, fullBytes);
+    ::memcpy(dstRow(y + src.height - 1 + i) + left,
+             dstRow(y + src.height - 1) + left, fullBytes);
+  }
+}
+} // namespace hello::image
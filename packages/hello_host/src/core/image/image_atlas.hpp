@@ -0,0 +1,40 @@
+#ifndef __IMAGE_ATLAS_HPP__
+#define __IMAGE_ATLAS_HPP__
+
+#include "./image_kernels.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace hello::image {
+// skyline bottom-left rectangle packer for one fixed-size page.
+class SkylinePacker {
+public:
+  SkylinePacker(int width, int height);
+
+  // finds room for a w x h rectangle, or returns false if the page is full.
+  bool insert(int w, int h, int *x, int *y);
+  int getUsedArea() const { return usedArea; }
+
+private:
+  struct Node {
+    int x;
+    int y;
+    int width;
+  };
+
+  int width;
+  int height;
+  int usedArea = 0;
+  std::vector<Node> skyline;
+
+  bool fits(size_t index, int w, int h, int *y) const;
+  void addLevel(size_t index, int x, int y, int w, int h);
+};
+
+// copies RGBA8 `src` to (x, y) in `dst` and repeats its outermost pixels
+// `extrude` times around it, so bilinear sampling never reads a neighbour.
+void blitExtruded(const ImageView &src, const ImageView &dst, int x, int y,
+                  int extrude);
+} // namespace hello::image
+#endif
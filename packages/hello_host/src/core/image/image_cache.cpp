@@ -0,0 +1,134 @@
+#include "./image_cache.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace {
+const char CACHE_MAGIC[4] = {'H', 'P', 'X', 'C'};
+const uint32_t CACHE_VERSION = 1;
+
+// native byte order: entries are only read back on the machine that wrote
+// them
+struct CacheHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t format;
+  int32_t width;
+  int32_t height;
+  int32_t pitch;
+  uint64_t hash;
+  uint64_t payloadSize;
+  uint8_t reserved[24];
+};
+static_assert(sizeof(CacheHeader) == 64, "cache header must be 64 bytes");
+
+// unique per process and per call, so concurrent writers of the same entry
+// never share a temporary file
+std::string getTemporarySuffix() {
+  static const auto process = std::random_device()();
+  static std::atomic<uint32_t> counter = 0;
+  return ".tmp." + std::to_string(process) + "." +
+         std::to_string(counter.fetch_add(1));
+}
+} // namespace
+
+namespace hello::image {
+bool readFile(const char *filename, std::vector<uint8_t> *data) {
+  auto rw = SDL_RWFromFile(filename, "rb");
+  if (rw == nullptr) {
+    return false;
+  }
+  const auto size = SDL_RWsize(rw);
+  auto ok = size >= 0;
+  if (ok) {
+    data->resize(static_cast<size_t>(size));
+    ok = SDL_RWread(rw, data->data(), 1, data->size()) == data->size();
+  }
+  SDL_RWclose(rw);
+  return ok;
+}
+
+uint64_t hashContent(const void *data, size_t size) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+std::string getCachePath(const std::string &directory, uint64_t hash,
+                         Uint32 format) {
+  char name[40];
+  std::snprintf(name, sizeof(name), "%016llx-%08x.pxc",
+                static_cast<unsigned long long>(hash),
+                static_cast<unsigned int>(format));
+  if (directory.empty() || directory.back() == '/' ||
+      directory.back() == '\\') {
+    return directory + name;
+  }
+  return directory + "/" + name;
+}
+
+SDL_Surface *openCachedSurface(const MappedFile &file, uint64_t hash,
+                               Uint32 format) {
+  CacheHeader header;
+  if (file.getSize() < sizeof(header)) {
+    return nullptr;
+  }
+  ::memcpy(&header, file.getData(), sizeof(header));
+  const auto payloadSize = static_cast<uint64_t>(header.pitch) *
+                           static_cast<uint64_t>(header.height);
+  if (::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+      header.version != CACHE_VERSION || header.format != format ||
+      header.hash != hash || header.width <= 0 || header.height <= 0 ||
+      header.pitch <= 0 || header.payloadSize != payloadSize ||
+      file.getSize() - sizeof(header) < payloadSize) {
+    return nullptr;
+  }
+  return SDL_CreateRGBSurfaceWithFormatFrom(
+      file.getData() + sizeof(header), header.width, header.height,
+      SDL_BITSPERPIXEL(format), header.pitch, format);
+}
+
+bool writeCachedSurface(const std::string &path, uint64_t hash,
+                        SDL_Surface *surface) {
+  CacheHeader header = {};
+  ::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.format = surface->format->format;
+  header.width = surface->w;
+  header.height = surface->h;
+  header.pitch = surface->pitch;
+  header.hash = hash;
+  header.payloadSize = static_cast<uint64_t>(surface->pitch) * surface->h;
+
+  const auto temporary = path + getTemporarySuffix();
+  {
+    std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+      return false;
+    }
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    SDL_LockSurface(surface);
+    stream.write(static_cast<const char *>(surface->pixels),
+                 static_cast<std::streamsize>(header.payloadSize));
+    SDL_UnlockSurface(surface);
+    if (!stream.flush()) {
+      stream.close();
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+  // rename does not replace an existing file everywhere
+  std::remove(path.c_str());
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+} // namespace hello::image
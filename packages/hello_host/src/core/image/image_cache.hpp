@@ -0,0 +1,33 @@
+#ifndef __IMAGE_CACHE_HPP__
+#define __IMAGE_CACHE_HPP__
+
+#include "../mapped_file.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hello::image {
+// whole file through SDL_RWops, so bundled assets work too.
+bool readFile(const char *filename, std::vector<uint8_t> *data);
+
+// 64-bit FNV-1a of the encoded image bytes.
+uint64_t hashContent(const void *data, size_t size);
+
+// file of the entry for `hash` converted to the SDL pixel `format`.
+std::string getCachePath(const std::string &directory, uint64_t hash,
+                         Uint32 format);
+
+// surface whose pixels point into `file` when it holds a complete entry for
+// `hash` and `format`, otherwise nullptr. `file` must outlive the surface.
+SDL_Surface *openCachedSurface(const MappedFile &file, uint64_t hash,
+                               Uint32 format);
+
+// writes a 64-byte header and the pixel rows to `path`. entries are
+// written to a temporary file first, so readers never see half of one.
+bool writeCachedSurface(const std::string &path, uint64_t hash,
+                        SDL_Surface *surface);
+} // namespace hello::image
+#endif
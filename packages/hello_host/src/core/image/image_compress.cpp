@@ -0,0 +1,868 @@
+#include "./image_compress.hpp"
+#include "../thread_pool.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace {
+using hello::image::BlockFormat;
+using hello::image::CompressQuality;
+using hello::image::ImageView;
+
+// below this many blocks the thread pool costs more than it saves
+const int PARALLEL_BLOCKS = 256;
+
+// 4x4 RGBA8 pixels, row-major
+struct Block {
+  uint8_t pixels[16][4];
+};
+
+void loadBlock(const ImageView &src, int bx, int by, Block &block) {
+  for (int y = 0; y < 4; ++y) {
+    const auto sy = std::min(by * 4 + y, src.height - 1);
+    auto row = src.pixels + static_cast<size_t>(sy) * src.pitch;
+    for (int x = 0; x < 4; ++x) {
+      const auto sx = std::min(bx * 4 + x, src.width - 1);
+      ::memcpy(block.pixels[y * 4 + x], row + sx * 4, 4);
+    }
+  }
+}
+
+int squaredError(const uint8_t *pixel, const int *color, int channels) {
+  auto error = 0;
+  for (int c = 0; c < channels; ++c) {
+    const auto d = pixel[c] - color[c];
+    error += d * d;
+  }
+  return error;
+}
+
+float clampColor(float v) { return std::clamp(v, 0.0f, 255.0f); }
+
+// endpoints at the extremes of the colours projected on their principal
+// axis, found by power iteration on the covariance matrix.
+void fitPrincipalAxis(const Block &block, int channels, float e0[4],
+                      float e1[4]) {
+  float mean[4] = {};
+  for (const auto &pixel : block.pixels) {
+    for (int c = 0; c < channels; ++c) {
+      mean[c] += pixel[c] / 16.0f;
+    }
+  }
+  float cov[4][4] = {};
+  for (const auto &pixel : block.pixels) {
+    for (int a = 0; a < channels; ++a) {
+      for (int b = 0; b < channels; ++b) {
+        cov[a][b] += (pixel[a] - mean[a]) * (pixel[b] - mean[b]);
+      }
+    }
+  }
+
+  auto widest = 0;
+  for (int c = 1; c < channels; ++c) {
+    if (cov[c][c] > cov[widest][widest]) {
+      widest = c;
+    }
+  }
+  float axis[4] = {};
+  std::copy_n(cov[widest], channels, axis);
+  auto length = 0.0f;
+  for (int iteration = 0; iteration < 8; ++iteration) {
+    float next[4] = {};
+    for (int a = 0; a < channels; ++a) {
+      for (int b = 0; b < channels; ++b) {
+        next[a] += cov[a][b] * axis[b];
+      }
+    }
+    length = 0.0f;
+    for (int c = 0; c < channels; ++c) {
+      length += next[c] * next[c];
+    }
+    length = std::sqrt(length);
+    if (length < 1e-6f) {
+      break;
+    }
+    for (int c = 0; c < channels; ++c) {
+      axis[c] = next[c] / length;
+    }
+  }
+  if (length < 1e-6f) {
+    // flat block
+    std::copy_n(mean, channels, e0);
+    std::copy_n(mean, channels, e1);
+    return;
+  }
+
+  auto tMin = 0.0f;
+  auto tMax = 0.0f;
+  for (const auto &pixel : block.pixels) {
+    auto t = 0.0f;
+    for (int c = 0; c < channels; ++c) {
+      t += (pixel[c] - mean[c]) * axis[c];
+    }
+    tMin = std::min(tMin, t);
+    tMax = std::max(tMax, t);
+  }
+  for (int c = 0; c < channels; ++c) {
+    e0[c] = clampColor(mean[c] + axis[c] * tMin);
+    e1[c] = clampColor(mean[c] + axis[c] * tMax);
+  }
+}
+
+// least-squares endpoints for fixed indices, where weights[index] is how
+// far towards e1 that index interpolates.
+bool refineEndpoints(const Block &block, int channels, const uint8_t idx[16],
+                     const float *weights, float e0[4], float e1[4]) {
+  auto aa = 0.0f;
+  auto ab = 0.0f;
+  auto bb = 0.0f;
+  float ax[4] = {};
+  float bx[4] = {};
+  for (int i = 0; i < 16; ++i) {
+    const auto b = weights[idx[i]];
+    const auto a = 1.0f - b;
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    for (int c = 0; c < channels; ++c) {
+      ax[c] += a * block.pixels[i][c];
+      bx[c] += b * block.pixels[i][c];
+    }
+  }
+  const auto det = aa * bb - ab * ab;
+  if (std::abs(det) < 1e-6f) {
+    return false;
+  }
+  for (int c = 0; c < channels; ++c) {
+    e0[c] = clampColor((ax[c] * bb - bx[c] * ab) / det);
+    e1[c] = clampColor((bx[c] * aa - ax[c] * ab) / det);
+  }
+  return true;
+}
+
+int getRefineIterations(CompressQuality quality) {
+  switch (quality) {
+  case CompressQuality::Fast:
+    return 0;
+  case CompressQuality::Normal:
+    return 2;
+  case CompressQuality::High:
+    return 8;
+  }
+  return 0;
+}
+
+// BC1 colour, always in four-colour mode so BC3 can share it
+
+const float BC1_WEIGHTS[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+struct Bc1Block {
+  uint16_t c0;
+  uint16_t c1;
+  uint8_t idx[16];
+  int error;
+};
+
+uint16_t packRgb565(const float color[4]) {
+  auto quantize = [](float v, int max) {
+    return std::clamp(static_cast<int>(v * max / 255.0f + 0.5f), 0, max);
+  };
+  return static_cast<uint16_t>(quantize(color[0], 31) << 11 |
+                               quantize(color[1], 63) << 5 |
+                               quantize(color[2], 31));
+}
+
+void unpackRgb565(uint16_t v, int color[3]) {
+  const auto r = (v >> 11) & 31;
+  const auto g = (v >> 5) & 63;
+  const auto b = v & 31;
+  color[0] = r << 3 | r >> 2;
+  color[1] = g << 2 | g >> 4;
+  color[2] = b << 3 | b >> 2;
+}
+
+Bc1Block evaluateBc1(const Block &block, uint16_t c0, uint16_t c1) {
+  if (c0 < c1) {
+    std::swap(c0, c1);
+  }
+  Bc1Block result = {c0, c1, {}, 0};
+  int palette[4][3];
+  unpackRgb565(c0, palette[0]);
+  unpackRgb565(c1, palette[1]);
+  for (int c = 0; c < 3; ++c) {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+  // equal endpoints would decode in three-colour mode, so stay on index 0
+  const auto colors = c0 == c1 ? 1 : 4;
+  for (int i = 0; i < 16; ++i) {
+    auto best = INT_MAX;
+    for (int k = 0; k < colors; ++k) {
+      const auto error = squaredError(block.pixels[i], palette[k], 3);
+      if (error < best) {
+        best = error;
+        result.idx[i] = static_cast<uint8_t>(k);
+      }
+    }
+    result.error += best;
+  }
+  return result;
+}
+
+void encodeBc1(const Block &block, CompressQuality quality, uint8_t *out) {
+  float e0[4];
+  float e1[4];
+  fitPrincipalAxis(block, 3, e0, e1);
+  auto best = evaluateBc1(block, packRgb565(e0), packRgb565(e1));
+  const auto iterations = getRefineIterations(quality);
+  for (int i = 0; i < iterations && best.error > 0; ++i) {
+    if (!refineEndpoints(block, 3, best.idx, BC1_WEIGHTS, e0, e1)) {
+      break;
+    }
+    auto candidate = evaluateBc1(block, packRgb565(e0), packRgb565(e1));
+    if (candidate.error >= best.error) {
+      break;
+    }
+    best = candidate;
+  }
+
+  if (quality == CompressQuality::High) {
+    // nudge each 5:6:5 field by one step while that keeps helping
+    const int shifts[3] = {11, 5, 0};
+    const int masks[3] = {31, 63, 31};
+    auto improved = true;
+    for (int round = 0; round < 4 && improved && best.error > 0; ++round) {
+      improved = false;
+      for (int e = 0; e < 2; ++e) {
+        for (int f = 0; f < 3; ++f) {
+          for (int delta = -1; delta <= 1; delta += 2) {
+            uint16_t ends[2] = {best.c0, best.c1};
+            const auto v = ((ends[e] >> shifts[f]) & masks[f]) + delta;
+            if (v < 0 || v > masks[f]) {
+              continue;
+            }
+            ends[e] = static_cast<uint16_t>(
+                (ends[e] & ~(masks[f] << shifts[f])) | v << shifts[f]);
+            auto candidate = evaluateBc1(block, ends[0], ends[1]);
+            if (candidate.error < best.error) {
+              best = candidate;
+              improved = true;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  uint32_t indices = 0;
+  for (int i = 0; i < 16; ++i) {
+    indices |= static_cast<uint32_t>(best.idx[i]) << (i * 2);
+  }
+  out[0] = static_cast<uint8_t>(best.c0);
+  out[1] = static_cast<uint8_t>(best.c0 >> 8);
+  out[2] = static_cast<uint8_t>(best.c1);
+  out[3] = static_cast<uint8_t>(best.c1 >> 8);
+  for (int i = 0; i < 4; ++i) {
+    out[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+  }
+}
+
+// BC4 alpha, the first half of a BC3 block
+
+int evaluateBc4(const Block &block, int a0, int a1, uint8_t idx[16]) {
+  int palette[8] = {a0, a1};
+  if (a0 > a1) {
+    for (int i = 2; i < 8; ++i) {
+      palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+    }
+  } else {
+    for (int i = 2; i < 6; ++i) {
+      palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+  auto total = 0;
+  for (int i = 0; i < 16; ++i) {
+    auto best = INT_MAX;
+    for (int k = 0; k < 8; ++k) {
+      const auto d = block.pixels[i][3] - palette[k];
+      if (d * d < best) {
+        best = d * d;
+        idx[i] = static_cast<uint8_t>(k);
+      }
+    }
+    total += best;
+  }
+  return total;
+}
+
+void encodeBc4(const Block &block, CompressQuality quality, uint8_t *out) {
+  auto lo = 255;
+  auto hi = 0;
+  for (const auto &pixel : block.pixels) {
+    lo = std::min<int>(lo, pixel[3]);
+    hi = std::max<int>(hi, pixel[3]);
+  }
+  auto a0 = hi;
+  auto a1 = lo;
+  uint8_t idx[16];
+  auto error = evaluateBc4(block, a0, a1, idx);
+
+  if (quality != CompressQuality::Fast && error > 0) {
+    // the six-value mode has exact 0 and 255, so its range only needs to
+    // cover the values in between
+    auto innerLo = 255;
+    auto innerHi = 0;
+    for (const auto &pixel : block.pixels) {
+      if (pixel[3] != 0 && pixel[3] != 255) {
+        innerLo = std::min<int>(innerLo, pixel[3]);
+        innerHi = std::max<int>(innerHi, pixel[3]);
+      }
+    }
+    if (innerLo > innerHi) {
+      innerLo = innerHi = 0;
+    }
+    uint8_t innerIdx[16];
+    const auto innerError = evaluateBc4(block, innerLo, innerHi, innerIdx);
+    if (innerError < error) {
+      a0 = innerLo;
+      a1 = innerHi;
+      std::copy_n(innerIdx, 16, idx);
+    }
+  }
+
+  uint64_t indices = 0;
+  for (int i = 0; i < 16; ++i) {
+    indices |= static_cast<uint64_t>(idx[i]) << (i * 3);
+  }
+  out[0] = static_cast<uint8_t>(a0);
+  out[1] = static_cast<uint8_t>(a1);
+  for (int i = 0; i < 6; ++i) {
+    out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+  }
+}
+
+// BC7 mode 6: one subset, RGBA 7.7.7.7 endpoints with a p-bit each and
+// 4-bit indices
+
+const int BC7_WEIGHTS[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                             34, 38, 43, 47, 51, 55, 60, 64};
+const float BC7_WEIGHTSF[16] = {
+    0 / 64.0f,  4 / 64.0f,  9 / 64.0f,  13 / 64.0f, 17 / 64.0f, 21 / 64.0f,
+    26 / 64.0f, 30 / 64.0f, 34 / 64.0f, 38 / 64.0f, 43 / 64.0f, 47 / 64.0f,
+    51 / 64.0f, 55 / 64.0f, 60 / 64.0f, 64 / 64.0f};
+
+struct Bc7Block {
+  uint8_t q0[4];
+  uint8_t q1[4];
+  int p0;
+  int p1;
+  uint8_t idx[16];
+  int error;
+};
+
+// 7-bit endpoint for a fixed p-bit, returning its squared error
+int quantizeBc7(const float e[4], int p, uint8_t q[4]) {
+  auto error = 0.0f;
+  for (int c = 0; c < 4; ++c) {
+    const auto v = std::clamp(static_cast<int>((e[c] - p) / 2.0f + 0.5f), 0,
+                              127);
+    q[c] = static_cast<uint8_t>(v);
+    const auto d = (v * 2 + p) - e[c];
+    error += d * d;
+  }
+  return static_cast<int>(error);
+}
+
+int quantizeBc7(const float e[4], uint8_t q[4]) {
+  uint8_t q1[4];
+  if (quantizeBc7(e, 1, q1) < quantizeBc7(e, 0, q)) {
+    std::copy_n(q1, 4, q);
+    return 1;
+  }
+  return 0;
+}
+
+Bc7Block evaluateBc7(const Block &block, const uint8_t q0[4], int p0,
+                     const uint8_t q1[4], int p1) {
+  Bc7Block result = {};
+  std::copy_n(q0, 4, result.q0);
+  std::copy_n(q1, 4, result.q1);
+  result.p0 = p0;
+  result.p1 = p1;
+  int palette[16][4];
+  for (int c = 0; c < 4; ++c) {
+    const auto a = q0[c] << 1 | p0;
+    const auto b = q1[c] << 1 | p1;
+    for (int k = 0; k < 16; ++k) {
+      palette[k][c] =
+          ((64 - BC7_WEIGHTS[k]) * a + BC7_WEIGHTS[k] * b + 32) >> 6;
+    }
+  }
+  for (int i = 0; i < 16; ++i) {
+    auto best = INT_MAX;
+    for (int k = 0; k < 16; ++k) {
+      const auto error = squaredError(block.pixels[i], palette[k], 4);
+      if (error < best) {
+        best = error;
+        result.idx[i] = static_cast<uint8_t>(k);
+      }
+    }
+    result.error += best;
+  }
+  return result;
+}
+
+Bc7Block evaluateBc7(const Block &block, const float e0[4],
+                     const float e1[4]) {
+  uint8_t q0[4];
+  uint8_t q1[4];
+  const auto p0 = quantizeBc7(e0, q0);
+  const auto p1 = quantizeBc7(e1, q1);
+  return evaluateBc7(block, q0, p0, q1, p1);
+}
+
+struct BitWriter {
+  uint8_t *out;
+  int position;
+
+  void write(uint32_t value, int bits) {
+    for (int i = 0; i < bits; ++i, ++position) {
+      if ((value >> i) & 1) {
+        out[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+      }
+    }
+  }
+};
+
+void encodeBc7(const Block &block, CompressQuality quality, uint8_t *out) {
+  float e0[4];
+  float e1[4];
+  fitPrincipalAxis(block, 4, e0, e1);
+  auto best = evaluateBc7(block, e0, e1);
+  const auto iterations = getRefineIterations(quality);
+  for (int i = 0; i < iterations && best.error > 0; ++i) {
+    if (!refineEndpoints(block, 4, best.idx, BC7_WEIGHTSF, e0, e1)) {
+      break;
+    }
+    auto candidate = evaluateBc7(block, e0, e1);
+    if (candidate.error >= best.error) {
+      break;
+    }
+    best = candidate;
+  }
+
+  if (quality == CompressQuality::High && best.error > 0 &&
+      refineEndpoints(block, 4, best.idx, BC7_WEIGHTSF, e0, e1)) {
+    // the nearest p-bit per endpoint is not always the best pair
+    for (int p0 = 0; p0 < 2; ++p0) {
+      for (int p1 = 0; p1 < 2; ++p1) {
+        uint8_t q0[4];
+        uint8_t q1[4];
+        quantizeBc7(e0, p0, q0);
+        quantizeBc7(e1, p1, q1);
+        auto candidate = evaluateBc7(block, q0, p0, q1, p1);
+        if (candidate.error < best.error) {
+          best = candidate;
+        }
+      }
+    }
+  }
+
+  // the anchor index is stored without its top bit
+  if (best.idx[0] >= 8) {
+    std::swap(best.q0, best.q1);
+    std::swap(best.p0, best.p1);
+    for (auto &index : best.idx) {
+      index = static_cast<uint8_t>(15 - index);
+    }
+  }
+
+  ::memset(out, 0, 16);
+  BitWriter writer = {out, 0};
+  writer.write(1 << 6, 7);
+  for (int c = 0; c < 4; ++c) {
+    writer.write(best.q0[c], 7);
+    writer.write(best.q1[c], 7);
+  }
+  writer.write(best.p0, 1);
+  writer.write(best.p1, 1);
+  for (int i = 0; i < 16; ++i) {
+    writer.write(best.idx[i], i == 0 ? 3 : 4);
+  }
+}
+
+// ETC1-compatible ETC2 colour: two 2x4 or 4x2 halves, each a base colour
+// plus one of eight luminance modifier tables
+
+const int ETC_MODIFIERS[8][2] = {{2, 8},   {5, 17},  {9, 29},  {13, 42},
+                                 {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+// pixel index values 0..3 select +small, +large, -small and -large
+int getEtcModifier(int table, int index) {
+  const auto modifier = ETC_MODIFIERS[table][index & 1];
+  return (index & 2) != 0 ? -modifier : modifier;
+}
+
+struct EtcHalf {
+  int table;
+  uint8_t idx[8];
+  int error;
+};
+
+// row-major pixel numbers of one half of the block
+void getEtcHalf(int flip, int half, int pixels[8]) {
+  auto n = 0;
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      if ((flip != 0 ? y / 2 : x / 2) == half) {
+        pixels[n++] = y * 4 + x;
+      }
+    }
+  }
+}
+
+int expand4(int v) { return v << 4 | v; }
+int expand5(int v) { return v << 3 | v >> 2; }
+
+EtcHalf evaluateEtcHalf(const Block &block, const int pixels[8],
+                        const int base[3]) {
+  EtcHalf best = {0, {}, INT_MAX};
+  for (int table = 0; table < 8; ++table) {
+    int candidates[4][3];
+    for (int k = 0; k < 4; ++k) {
+      const auto modifier = getEtcModifier(table, k);
+      for (int c = 0; c < 3; ++c) {
+        candidates[k][c] = std::clamp(base[c] + modifier, 0, 255);
+      }
+    }
+    EtcHalf half = {table, {}, 0};
+    for (int i = 0; i < 8 && half.error < best.error; ++i) {
+      auto pixelBest = INT_MAX;
+      for (int k = 0; k < 4; ++k) {
+        const auto error =
+            squaredError(block.pixels[pixels[i]], candidates[k], 3);
+        if (error < pixelBest) {
+          pixelBest = error;
+          half.idx[i] = static_cast<uint8_t>(k);
+        }
+      }
+      half.error += pixelBest;
+    }
+    if (half.error < best.error) {
+      best = half;
+    }
+  }
+  return best;
+}
+
+EtcHalf evaluateEtcHalf(const Block &block, const int pixels[8],
+                        const int q[3], bool differential) {
+  int base[3];
+  for (int c = 0; c < 3; ++c) {
+    base[c] = differential ? expand5(q[c]) : expand4(q[c]);
+  }
+  return evaluateEtcHalf(block, pixels, base);
+}
+
+uint64_t packEtc(int flip, bool differential, const int q[2][3],
+                 const EtcHalf halves[2], const int pixels[2][8]) {
+  uint64_t bits = 0;
+  for (int c = 0; c < 3; ++c) {
+    if (differential) {
+      bits |= static_cast<uint64_t>(q[0][c]) << (59 - c * 8);
+      bits |= static_cast<uint64_t>((q[1][c] - q[0][c]) & 7) << (56 - c * 8);
+    } else {
+      bits |= static_cast<uint64_t>(q[0][c]) << (60 - c * 8);
+      bits |= static_cast<uint64_t>(q[1][c]) << (56 - c * 8);
+    }
+  }
+  bits |= static_cast<uint64_t>(halves[0].table) << 37;
+  bits |= static_cast<uint64_t>(halves[1].table) << 34;
+  bits |= static_cast<uint64_t>(differential ? 1 : 0) << 33;
+  bits |= static_cast<uint64_t>(flip) << 32;
+  for (int h = 0; h < 2; ++h) {
+    for (int i = 0; i < 8; ++i) {
+      // indices are numbered down the columns
+      const auto p = pixels[h][i];
+      const auto n = (p % 4) * 4 + p / 4;
+      bits |= static_cast<uint64_t>(halves[h].idx[i] >> 1) << (16 + n);
+      bits |= static_cast<uint64_t>(halves[h].idx[i] & 1) << n;
+    }
+  }
+  return bits;
+}
+
+void writeBigEndian(uint64_t bits, uint8_t *out) {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<uint8_t>(bits >> (56 - i * 8));
+  }
+}
+
+// walks the base colour of one half one step per channel while that
+// lowers the error, keeping each channel within [0, max] and, when `ref`
+// is set, within -4..3 of it
+EtcHalf searchEtcHalf(const Block &block, const int pixels[8], int q[3],
+                      int max, const int *ref) {
+  auto best = evaluateEtcHalf(block, pixels, q, max == 31);
+  if (ref != nullptr) {
+    for (int c = 0; c < 3; ++c) {
+      const auto d = q[c] - ref[c];
+      if (d < -4 || d > 3) {
+        best.error = INT_MAX;
+      }
+    }
+  }
+  auto improved = true;
+  for (int round = 0; round < 4 && improved && best.error > 0; ++round) {
+    improved = false;
+    for (int c = 0; c < 3; ++c) {
+      for (int delta = -1; delta <= 1; delta += 2) {
+        int candidate[3] = {q[0], q[1], q[2]};
+        candidate[c] += delta;
+        if (candidate[c] < 0 || candidate[c] > max ||
+            (ref != nullptr &&
+             (candidate[c] - ref[c] < -4 || candidate[c] - ref[c] > 3))) {
+          continue;
+        }
+        auto half = evaluateEtcHalf(block, pixels, candidate, max == 31);
+        if (half.error < best.error) {
+          best = half;
+          std::copy_n(candidate, 3, q);
+          improved = true;
+        }
+      }
+    }
+  }
+  return best;
+}
+
+void encodeEtc(const Block &block, CompressQuality quality, uint8_t *out) {
+  uint64_t bestBits = 0;
+  auto bestError = INT_MAX;
+  const auto flips = quality == CompressQuality::Fast ? 1 : 2;
+  for (int flip = 0; flip < flips; ++flip) {
+    int pixels[2][8];
+    float average[2][3] = {};
+    for (int h = 0; h < 2; ++h) {
+      getEtcHalf(flip, h, pixels[h]);
+      for (int i = 0; i < 8; ++i) {
+        for (int c = 0; c < 3; ++c) {
+          average[h][c] += block.pixels[pixels[h][i]][c] / 8.0f;
+        }
+      }
+    }
+
+    auto consider = [&](bool differential, const int q[2][3],
+                        const EtcHalf halves[2]) {
+      const auto error = halves[0].error + halves[1].error;
+      if (error < bestError) {
+        bestError = error;
+        bestBits = packEtc(flip, differential, q, halves, pixels);
+      }
+    };
+
+    // differential mode: 5-bit bases no more than -4..3 apart
+    int q5[2][3];
+    auto fitsDifferential = true;
+    for (int c = 0; c < 3; ++c) {
+      for (int h = 0; h < 2; ++h) {
+        q5[h][c] = std::clamp(
+            static_cast<int>(average[h][c] * 31 / 255.0f + 0.5f), 0, 31);
+      }
+      const auto d = q5[1][c] - q5[0][c];
+      fitsDifferential = fitsDifferential && d >= -4 && d <= 3;
+    }
+    if (fitsDifferential) {
+      const EtcHalf halves[2] = {
+          evaluateEtcHalf(block, pixels[0], q5[0], true),
+          evaluateEtcHalf(block, pixels[1], q5[1], true)};
+      consider(true, q5, halves);
+    }
+
+    // individual mode: two independent 4-bit bases
+    int q4[2][3];
+    for (int h = 0; h < 2; ++h) {
+      for (int c = 0; c < 3; ++c) {
+        q4[h][c] = std::clamp(
+            static_cast<int>(average[h][c] * 15 / 255.0f + 0.5f), 0, 15);
+      }
+    }
+    if (!fitsDifferential || quality != CompressQuality::Fast) {
+      const EtcHalf halves[2] = {
+          evaluateEtcHalf(block, pixels[0], q4[0], false),
+          evaluateEtcHalf(block, pixels[1], q4[1], false)};
+      consider(false, q4, halves);
+    }
+
+    if (quality == CompressQuality::High) {
+      // rounded averages are rarely the best bases once modifiers apply
+      EtcHalf halves[2];
+      halves[0] = searchEtcHalf(block, pixels[0], q4[0], 15, nullptr);
+      halves[1] = searchEtcHalf(block, pixels[1], q4[1], 15, nullptr);
+      consider(false, q4, halves);
+
+      halves[0] = searchEtcHalf(block, pixels[0], q5[0], 31, nullptr);
+      halves[1] = searchEtcHalf(block, pixels[1], q5[1], 31, q5[0]);
+      if (halves[1].error != INT_MAX) {
+        consider(true, q5, halves);
+      }
+    }
+  }
+  writeBigEndian(bestBits, out);
+}
+
+// EAC alpha, the first half of an ETC2 RGBA8 block
+
+const int EAC_MODIFIERS[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},   {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},   {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},   {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},   {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},     {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+// the only table with a zero modifier, at index 4
+const int EAC_EXACT_TABLE = 13;
+
+int evaluateEac(const Block &block, int base, int table, int multiplier,
+                int limit, uint8_t idx[16]) {
+  int values[8];
+  for (int k = 0; k < 8; ++k) {
+    values[k] =
+        std::clamp(base + EAC_MODIFIERS[table][k] * multiplier, 0, 255);
+  }
+  auto total = 0;
+  for (int i = 0; i < 16 && total < limit; ++i) {
+    auto best = INT_MAX;
+    for (int k = 0; k < 8; ++k) {
+      const auto d = block.pixels[i][3] - values[k];
+      if (d * d < best) {
+        best = d * d;
+        idx[i] = static_cast<uint8_t>(k);
+      }
+    }
+    total += best;
+  }
+  return total;
+}
+
+void encodeEac(const Block &block, CompressQuality quality, uint8_t *out) {
+  auto lo = 255;
+  auto hi = 0;
+  for (const auto &pixel : block.pixels) {
+    lo = std::min<int>(lo, pixel[3]);
+    hi = std::max<int>(hi, pixel[3]);
+  }
+
+  auto bestBase = lo;
+  auto bestTable = EAC_EXACT_TABLE;
+  auto bestMultiplier = 1;
+  uint8_t bestIdx[16];
+  std::fill_n(bestIdx, 16, 4);
+  if (lo != hi) {
+    const auto multiplierRadius = quality == CompressQuality::Fast ? 0
+                                  : quality == CompressQuality::Normal ? 1
+                                                                       : 2;
+    const auto baseRadius = quality == CompressQuality::High ? 2 : 0;
+    auto bestError = INT_MAX;
+    for (int table = 0; table < 16 && bestError > 0; ++table) {
+      const auto low = EAC_MODIFIERS[table][3];
+      const auto high = EAC_MODIFIERS[table][7];
+      const auto fit = std::clamp(
+          static_cast<int>((hi - lo) / static_cast<float>(high - low) + 0.5f),
+          1, 15);
+      for (int m = std::max(1, fit - multiplierRadius);
+           m <= std::min(15, fit + multiplierRadius); ++m) {
+        const auto center = static_cast<int>(
+            std::lround((lo + hi) / 2.0 - (high + low) * m / 2.0));
+        for (int base = std::max(0, center - baseRadius);
+             base <= std::min(255, center + baseRadius); ++base) {
+          uint8_t idx[16];
+          const auto error = evaluateEac(block, base, table, m, bestError, idx);
+          if (error < bestError) {
+            bestError = error;
+            bestBase = base;
+            bestTable = table;
+            bestMultiplier = m;
+            std::copy_n(idx, 16, bestIdx);
+          }
+        }
+      }
+    }
+  }
+
+  uint64_t bits = static_cast<uint64_t>(bestBase) << 56 |
+                  static_cast<uint64_t>(bestMultiplier) << 52 |
+                  static_cast<uint64_t>(bestTable) << 48;
+  for (int i = 0; i < 16; ++i) {
+    // indices are numbered down the columns
+    const auto n = (i % 4) * 4 + i / 4;
+    bits |= static_cast<uint64_t>(bestIdx[i]) << (45 - n * 3);
+  }
+  writeBigEndian(bits, out);
+}
+
+void encodeBlock(const Block &block, BlockFormat format,
+                 CompressQuality quality, uint8_t *out) {
+  switch (format) {
+  case BlockFormat::BC1:
+    encodeBc1(block, quality, out);
+    break;
+  case BlockFormat::BC3:
+    encodeBc4(block, quality, out);
+    encodeBc1(block, quality, out + 8);
+    break;
+  case BlockFormat::BC7:
+    encodeBc7(block, quality, out);
+    break;
+  case BlockFormat::ETC2_RGB:
+    encodeEtc(block, quality, out);
+    break;
+  case BlockFormat::ETC2_RGBA:
+    encodeEac(block, quality, out);
+    encodeEtc(block, quality, out + 8);
+    break;
+  }
+}
+} // namespace
+
+namespace hello::image {
+int getBlockBytes(BlockFormat format) {
+  return format == BlockFormat::BC1 || format == BlockFormat::ETC2_RGB ? 8
+                                                                       : 16;
+}
+
+size_t getCompressedSize(BlockFormat format, int width, int height) {
+  return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) *
+         getBlockBytes(format);
+}
+
+void compress(const ImageView &src, BlockFormat format,
+              CompressQuality quality, uint8_t *dst) {
+  const auto blocksX = (src.width + 3) / 4;
+  const auto blocksY = (src.height + 3) / 4;
+  const auto blockBytes = getBlockBytes(format);
+  auto encodeRow = [&](int by) {
+    Block block;
+    auto out = dst + static_cast<size_t>(by) * blocksX * blockBytes;
+    for (int bx = 0; bx < blocksX; ++bx, out += blockBytes) {
+      loadBlock(src, bx, by, block);
+      encodeBlock(block, format, quality, out);
+    }
+  };
+  if (blocksX * blocksY < PARALLEL_BLOCKS) {
+    for (int by = 0; by < blocksY; ++by) {
+      encodeRow(by);
+    }
+  } else {
+    hello::thread_pool::parallelFor(0, blocksY, encodeRow);
+  }
+}
+} // namespace hello::image
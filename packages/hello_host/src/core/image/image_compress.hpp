@@ -0,0 +1,24 @@
+#ifndef __IMAGE_COMPRESS_HPP__
+#define __IMAGE_COMPRESS_HPP__
+
+#include "./image_kernels.hpp"
+
+#include <cstddef>
+
+namespace hello::image {
+// BC1 and BC3 are S3TC/DXT1 and DXT5, BC7 is written in mode 6 only, and
+// ETC2_RGB only uses the ETC1-compatible individual and differential modes.
+enum class BlockFormat { BC1, BC3, BC7, ETC2_RGB, ETC2_RGBA };
+enum class CompressQuality { Fast, Normal, High };
+
+int getBlockBytes(BlockFormat format);
+size_t getCompressedSize(BlockFormat format, int width, int height);
+
+// encodes an RGBA8 image into 4x4 blocks, row by row as
+// glCompressedTexImage2D expects. edge blocks repeat the last row and
+// column, BC1 and ETC2_RGB drop alpha, and big images are split across
+// the thread pool.
+void compress(const ImageView &src, BlockFormat format,
+              CompressQuality quality, uint8_t *dst);
+} // namespace hello::image
+#endif
@@ -0,0 +1,121 @@
+#include "./image_convert.hpp"
+#include "./image_kernels.hpp"
+
+namespace {
+using hello::image::SWIZZLE_ONE;
+
+// byte offset of an 8-bit channel inside a pixel in memory, or -1 when the
+// channel does not occupy a whole byte.
+int getChannelByte(const SDL_PixelFormat *format, Uint32 mask) {
+  for (int i = 0; i < format->BytesPerPixel; ++i) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    const auto shift = (format->BytesPerPixel - 1 - i) * 8;
+#else
+    const auto shift = i * 8;
+#endif
+    if (mask == 0xffu << shift) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// byte order for hello::image::repack, if the format is plain 8-bit RGB(A).
+bool getRepackOrder(const SDL_PixelFormat *format, int channels,
+                    uint8_t order[4]) {
+  if (format->BytesPerPixel != 3 && format->BytesPerPixel != 4) {
+    return false;
+  }
+  const Uint32 masks[] = {format->Rmask, format->Gmask, format->Bmask,
+                          format->Amask};
+  for (int c = 0; c < channels; ++c) {
+    if (c == 3 && format->Amask == 0) {
+      order[c] = SWIZZLE_ONE;
+      continue;
+    }
+    const auto index = getChannelByte(format, masks[c]);
+    if (index < 0) {
+      return false;
+    }
+    order[c] = static_cast<uint8_t>(index);
+  }
+  return true;
+}
+
+void convertIndexed8(SDL_Surface *src, SDL_Surface *dst, int channels) {
+  auto palette = src->format->palette;
+  uint8_t table[256][4];
+  for (int i = 0; i < 256; ++i) {
+    SDL_Color c = {0, 0, 0, 255};
+    if (i < palette->ncolors) {
+      c = palette->colors[i];
+    }
+    table[i][0] = c.r;
+    table[i][1] = c.g;
+    table[i][2] = c.b;
+    table[i][3] = c.a;
+  }
+  Uint32 key;
+  if (SDL_GetColorKey(src, &key) == 0 && key < 256) {
+    table[key][3] = 0;
+  }
+
+  for (int y = 0; y < src->h; ++y) {
+    auto s = static_cast<const uint8_t *>(src->pixels) + y * src->pitch;
+    auto d = static_cast<uint8_t *>(dst->pixels) + y * dst->pitch;
+    for (int x = 0; x < src->w; ++x) {
+      auto color = table[s[x]];
+      for (int c = 0; c < channels; ++c) {
+        d[x * channels + c] = color[c];
+      }
+    }
+  }
+}
+} // namespace
+
+namespace hello::image {
+SDL_Surface *convertToRGB(SDL_Surface *src, int channels) {
+  const auto dstFormat =
+      channels == 4 ? SDL_PIXELFORMAT_RGBA32 : SDL_PIXELFORMAT_RGB24;
+  auto format = src->format;
+  uint8_t order[4];
+  const auto isIndexed8 = SDL_ISPIXELFORMAT_INDEXED(format->format) &&
+                          format->BitsPerPixel == 8 &&
+                          format->palette != nullptr;
+  const auto isRepackable = !SDL_HasColorKey(src) &&
+                            getRepackOrder(format, channels, order);
+  if (!isIndexed8 && !isRepackable) {
+    // packed 16-bit, 10-bit, sub-byte palettes, ...: let SDL blit it
+    return SDL_ConvertSurfaceFormat(src, dstFormat, 0);
+  }
+
+  auto dst = SDL_CreateRGBSurfaceWithFormat(0, src->w, src->h, channels * 8,
+                                            dstFormat);
+  if (dst == nullptr) {
+    return nullptr;
+  }
+  if (SDL_LockSurface(src) != 0) {
+    SDL_FreeSurface(dst);
+    return nullptr;
+  }
+
+  if (isIndexed8) {
+    convertIndexed8(src, dst, channels);
+  } else {
+    repack(static_cast<const uint8_t *>(src->pixels), src->pitch,
+           format->BytesPerPixel, static_cast<uint8_t *>(dst->pixels),
+           dst->pitch, channels, src->w, src->h, order);
+  }
+
+  SDL_UnlockSurface(src);
+  return dst;
+}
+
+int getUnpackAlignment(int pitch) {
+  auto alignment = 8;
+  while (pitch % alignment != 0) {
+    alignment /= 2;
+  }
+  return alignment;
+}
+} // namespace hello::image
@@ -0,0 +1,16 @@
+#ifndef __IMAGE_CONVERT_HPP__
+#define __IMAGE_CONVERT_HPP__
+
+#include <SDL2/SDL.h>
+
+namespace hello::image {
+// converts any surface to RGBA32 (channels = 4) or RGB24 (channels = 3),
+// i.e. the byte order GL expects for GL_RGBA / GL_RGB with
+// GL_UNSIGNED_BYTE, in one pass. returns nullptr and sets the SDL error on
+// failure.
+SDL_Surface *convertToRGB(SDL_Surface *src, int channels);
+
+// largest GL_UNPACK_ALIGNMENT (8, 4, 2 or 1) that matches `pitch`.
+int getUnpackAlignment(int pitch);
+} // namespace hello::image
+#endif
@@ -0,0 +1,53 @@
+#include "./image_decode.hpp"
+#include "./image_cache.hpp"
+#include "./image_qoi.hpp"
+
+#include <SDL2/SDL_image.h>
+
+#include <climits>
+#include <vector>
+
+namespace hello::image {
+SDL_Surface *decodeImage(const void *data, size_t size, const char *type) {
+  QoiHeader header;
+  if (readQoiHeader(data, size, &header)) {
+    auto surface = SDL_CreateRGBSurfaceWithFormat(
+        0, header.width, header.height, header.channels * 8,
+        header.channels == 4 ? SDL_PIXELFORMAT_RGBA32
+                             : SDL_PIXELFORMAT_RGB24);
+    if (surface == nullptr) {
+      return nullptr;
+    }
+    if (!decodeQoi(data, size, header, static_cast<uint8_t *>(surface->pixels),
+                   surface->pitch)) {
+      SDL_FreeSurface(surface);
+      SDL_SetError("truncated QOI image");
+      return nullptr;
+    }
+    return surface;
+  }
+
+  if (size > static_cast<size_t>(INT_MAX)) {
+    SDL_SetError("image is too large");
+    return nullptr;
+  }
+  auto rw = SDL_RWFromConstMem(data, static_cast<int>(size));
+  if (rw == nullptr) {
+    return nullptr;
+  }
+  return IMG_LoadTyped_RW(rw, SDL_TRUE, type);
+}
+
+const char *getImageType(const char *filename) {
+  auto dot = SDL_strrchr(filename, '.');
+  return dot != nullptr ? dot + 1 : nullptr;
+}
+
+SDL_Surface *loadImage(const char *filename) {
+  std::vector<uint8_t> data;
+  if (!readFile(filename, &data)) {
+    return nullptr;
+  }
+  return decodeImage(data.data(), data.size(), getImageType(filename));
+}
+} // namespace hello::image
@@ -0,0 +1,23 @@
+#ifndef __IMAGE_DECODE_HPP__
+#define __IMAGE_DECODE_HPP__
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+
+namespace hello::image {
+// decodes QOI in-tree straight into RGB24 / RGBA32 surfaces and everything
+// else through SDL_image. `type` is the file extension, which SDL_image
+// needs for formats without a signature such as TGA. returns nullptr with
+// the SDL error set.
+SDL_Surface *decodeImage(const void *data, size_t size,
+                         const char *type = nullptr);
+
+// what follows the last dot of `filename`, as IMG_Load picks the type, or
+// nullptr.
+const char *getImageType(const char *filename);
+
+// decodeImage() on a whole file.
+SDL_Surface *loadImage(const char *filename);
+} // namespace hello::image
+#endif
@@ -0,0 +1,519 @@
+#include "./image_kernels.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__)
+#define HELLO_IMAGE_AVX2
+#endif
+
+#if defined(__SSSE3__) || defined(HELLO_IMAGE_AVX2)
+#define HELLO_IMAGE_SSSE3
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HELLO_IMAGE_SSE2
+#include <emmintrin.h>
+#if defined(HELLO_IMAGE_SSSE3)
+#include <tmmintrin.h>
+#endif
+#if defined(HELLO_IMAGE_AVX2)
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define HELLO_IMAGE_NEON
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#define HELLO_IMAGE_WASM
+#include <wasm_simd128.h>
+#endif
+
+namespace {
+inline uint8_t div255(uint32_t x) {
+  // exact round(x / 255) for x <= 255 * 255, matches the SIMD paths
+  x += 128;
+  return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+}
+
+void swapBytes(uint8_t *a, uint8_t *b, size_t n) {
+  size_t i = 0;
+#if defined(HELLO_IMAGE_AVX2)
+  for (; i + 32 <= n; i += 32) {
+    auto va = _mm256_loadu_si256(reinterpret_cast<__m256i *>(a + i));
+    auto vb = _mm256_loadu_si256(reinterpret_cast<__m256i *>(b + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), vb);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(b + i), va);
+  }
+#endif
+#if defined(HELLO_IMAGE_SSE2)
+  for (; i + 16 <= n; i += 16) {
+    auto va = _mm_loadu_si128(reinterpret_cast<__m128i *>(a + i));
+    auto vb = _mm_loadu_si128(reinterpret_cast<__m128i *>(b + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(a + i), vb);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(b + i), va);
+  }
+#elif defined(HELLO_IMAGE_NEON)
+  for (; i + 16 <= n; i += 16) {
+    auto va = vld1q_u8(a + i);
+    auto vb = vld1q_u8(b + i);
+    vst1q_u8(a + i, vb);
+    vst1q_u8(b + i, va);
+  }
+#elif defined(HELLO_IMAGE_WASM)
+  for (; i + 16 <= n; i += 16) {
+    auto va = wasm_v128_load(a + i);
+    auto vb = wasm_v128_load(b + i);
+    wasm_v128_store(a + i, vb);
+    wasm_v128_store(b + i, va);
+  }
+#endif
+  for (; i < n; ++i) {
+    std::swap(a[i], b[i]);
+  }
+}
+
+void flipRow32(uint32_t *row, int width) {
+  int l = 0;
+  int r = width;
+#if defined(HELLO_IMAGE_AVX2)
+  const auto reverse8 = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  for (; r - l >= 16; l += 8, r -= 8) {
+    auto pl = reinterpret_cast<__m256i *>(row + l);
+    auto pr = reinterpret_cast<__m256i *>(row + r - 8);
+    auto vl = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(pl), reverse8);
+    auto vr = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(pr), reverse8);
+    _mm256_storeu_si256(pl, vr);
+    _mm256_storeu_si256(pr, vl);
+  }
+#endif
+#if defined(HELLO_IMAGE_SSE2)
+  for (; r - l >= 8; l += 4, r -= 4) {
+    auto pl = reinterpret_cast<__m128i *>(row + l);
+    auto pr = reinterpret_cast<__m128i *>(row + r - 4);
+    auto vl = _mm_shuffle_epi32(_mm_loadu_si128(pl), 0x1b);
+    auto vr = _mm_shuffle_epi32(_mm_loadu_si128(pr), 0x1b);
+    _mm_storeu_si128(pl, vr);
+    _mm_storeu_si128(pr, vl);
+  }
+#elif defined(HELLO_IMAGE_NEON)
+  for (; r - l >= 8; l += 4, r -= 4) {
+    auto vl = vrev64q_u32(vld1q_u32(row + l));
+    auto vr = vrev64q_u32(vld1q_u32(row + r - 4));
+    vst1q_u32(row + l, vcombine_u32(vget_high_u32(vr), vget_low_u32(vr)));
+    vst1q_u32(row + r - 4, vcombine_u32(vget_high_u32(vl), vget_low_u32(vl)));
+  }
+#elif defined(HELLO_IMAGE_WASM)
+  for (; r - l >= 8; l += 4, r -= 4) {
+    auto vl = wasm_v128_load(row + l);
+    auto vr = wasm_v128_load(row + r - 4);
+    wasm_v128_store(row + l, wasm_i32x4_shuffle(vr, vr, 3, 2, 1, 0));
+    wasm_v128_store(row + r - 4, wasm_i32x4_shuffle(vl, vl, 3, 2, 1, 0));
+  }
+#endif
+  for (--r; l < r; ++l, --r) {
+    std::swap(row[l], row[r]);
+  }
+}
+
+void repackRowScalar(const uint8_t *src, int srcBpp, uint8_t *dst,
+                     int dstBpp, int width, const uint8_t *order) {
+  for (int x = 0; x < width; ++x) {
+    auto s = src + x * srcBpp;
+    auto d = dst + x * dstBpp;
+    uint8_t pixel[4];
+    ::memcpy(pixel, s, srcBpp);
+    for (int j = 0; j < dstBpp; ++j) {
+      d[j] = order[j] == hello::image::SWIZZLE_ONE ? 0xff : pixel[order[j]];
+    }
+  }
+}
+
+void premultiplyRowScalar(uint8_t *row, int width, int alphaIndex) {
+  for (int x = 0; x < width; ++x) {
+    auto p = row + x * 4;
+    const uint32_t a = p[alphaIndex];
+    for (int c = 0; c < 4; ++c) {
+      if (c != alphaIndex) {
+        p[c] = div255(p[c] * a);
+      }
+    }
+  }
+}
+
+#if defined(HELLO_IMAGE_SSE2)
+template <int A> __m128i broadcastAlpha16(__m128i v) {
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, A * 0x55), A * 0x55);
+}
+
+inline __m128i div255x8(__m128i x) {
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+#if defined(HELLO_IMAGE_AVX2)
+template <int A> __m256i broadcastAlpha16(__m256i v) {
+  return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, A * 0x55), A * 0x55);
+}
+
+inline __m256i div255x16(__m256i x) {
+  x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+#endif
+
+template <int A> void premultiplyRow(uint8_t *row, int width) {
+  int x = 0;
+#if defined(HELLO_IMAGE_AVX2)
+  const auto zero8 = _mm256_setzero_si256();
+  const auto mask8 = _mm256_set1_epi32(static_cast<int>(0xffu << (A * 8)));
+  for (; x + 8 <= width; x += 8) {
+    auto p = reinterpret_cast<__m256i *>(row + x * 4);
+    auto v = _mm256_loadu_si256(p);
+    auto lo = _mm256_unpacklo_epi8(v, zero8);
+    auto hi = _mm256_unpackhi_epi8(v, zero8);
+    lo = div255x16(_mm256_mullo_epi16(lo, broadcastAlpha16<A>(lo)));
+    hi = div255x16(_mm256_mullo_epi16(hi, broadcastAlpha16<A>(hi)));
+    auto c = _mm256_packus_epi16(lo, hi);
+    c = _mm256_or_si256(_mm256_andnot_si256(mask8, c),
+                        _mm256_and_si256(mask8, v));
+    _mm256_storeu_si256(p, c);
+  }
+#endif
+  const auto zero = _mm_setzero_si128();
+  const auto mask = _mm_set1_epi32(static_cast<int>(0xffu << (A * 8)));
+  for (; x + 4 <= width; x += 4) {
+    auto p = reinterpret_cast<__m128i *>(row + x * 4);
+    auto v = _mm_loadu_si128(p);
+    auto lo = _mm_unpacklo_epi8(v, zero);
+    auto hi = _mm_unpackhi_epi8(v, zero);
+    lo = div255x8(_mm_mullo_epi16(lo, broadcastAlpha16<A>(lo)));
+    hi = div255x8(_mm_mullo_epi16(hi, broadcastAlpha16<A>(hi)));
+    auto c = _mm_packus_epi16(lo, hi);
+    c = _mm_or_si128(_mm_andnot_si128(mask, c), _mm_and_si128(mask, v));
+    _mm_storeu_si128(p, c);
+  }
+  premultiplyRowScalar(row + x * 4, width - x, A);
+}
+#elif defined(HELLO_IMAGE_NEON)
+template <int A> void premultiplyRow(uint8_t *row, int width) {
+  const uint8_t alphaLanes[] = {A,      A,      A,      A,      A + 4,  A + 4,
+                                A + 4,  A + 4,  A + 8,  A + 8,  A + 8,  A + 8,
+                                A + 12, A + 12, A + 12, A + 12};
+  const auto lanes = vld1q_u8(alphaLanes);
+  const auto mask = vreinterpretq_u8_u32(vdupq_n_u32(0xffu << (A * 8)));
+  const auto bias = vdupq_n_u16(128);
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    auto p = row + x * 4;
+    auto v = vld1q_u8(p);
+    auto a = vqtbl1q_u8(v, lanes);
+    auto lo = vaddq_u16(vmull_u8(vget_low_u8(v), vget_low_u8(a)), bias);
+    auto hi = vaddq_u16(vmull_u8(vget_high_u8(v), vget_high_u8(a)), bias);
+    auto c = vcombine_u8(vshrn_n_u16(vsraq_n_u16(lo, lo, 8), 8),
+                         vshrn_n_u16(vsraq_n_u16(hi, hi, 8), 8));
+    vst1q_u8(p, vbslq_u8(mask, v, c));
+  }
+  premultiplyRowScalar(row + x * 4, width - x, A);
+}
+#elif defined(HELLO_IMAGE_WASM)
+template <int A> void premultiplyRow(uint8_t *row, int width) {
+  const auto lanes = wasm_i8x16_make(A, A, A, A, A + 4, A + 4, A + 4, A + 4,
+                                     A + 8, A + 8, A + 8, A + 8, A + 12,
+                                     A + 12, A + 12, A + 12);
+  const auto mask = wasm_i32x4_splat(static_cast<int>(0xffu << (A * 8)));
+  const auto bias = wasm_i16x8_splat(128);
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    auto p = row + x * 4;
+    auto v = wasm_v128_load(p);
+    auto a = wasm_i8x16_swizzle(v, lanes);
+    auto lo = wasm_i16x8_add(wasm_i16x8_mul(wasm_u16x8_extend_low_u8x16(v),
+                                            wasm_u16x8_extend_low_u8x16(a)),
+                             bias);
+    auto hi = wasm_i16x8_add(wasm_i16x8_mul(wasm_u16x8_extend_high_u8x16(v),
+                                            wasm_u16x8_extend_high_u8x16(a)),
+                             bias);
+    lo = wasm_u16x8_shr(wasm_i16x8_add(lo, wasm_u16x8_shr(lo, 8)), 8);
+    hi = wasm_u16x8_shr(wasm_i16x8_add(hi, wasm_u16x8_shr(hi, 8)), 8);
+    auto c = wasm_u8x16_narrow_i16x8(lo, hi);
+    wasm_v128_store(p, wasm_v128_bitselect(v, c, mask));
+  }
+  premultiplyRowScalar(row + x * 4, width - x, A);
+}
+#else
+template <int A> void premultiplyRow(uint8_t *row, int width) {
+  premultiplyRowScalar(row, width, A);
+}
+#endif
+
+const uint8_t *getSrgbToLinearTable() {
+  static const auto table = [] {
+    struct Table {
+      uint8_t data[256];
+    } t;
+    for (int i = 0; i < 256; ++i) {
+      const auto c = i / 255.0;
+      const auto l =
+          c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+      t.data[i] = static_cast<uint8_t>(std::lround(l * 255.0));
+    }
+    return t;
+  }();
+  return table.data;
+}
+} // namespace
+
+namespace hello::image {
+const char *simdName() {
+#if defined(HELLO_IMAGE_AVX2)
+  return "avx2";
+#elif defined(HELLO_IMAGE_SSSE3)
+  return "ssse3";
+#elif defined(HELLO_IMAGE_SSE2)
+  return "sse2";
+#elif defined(HELLO_IMAGE_NEON)
+  return "neon";
+#elif defined(HELLO_IMAGE_WASM)
+  return "wasm_simd128";
+#else
+  return "scalar";
+#endif
+}
+
+void flipVertical(uint8_t *pixels, int rowBytes, int height, int pitch) {
+  for (int y = 0; y < height / 2; ++y) {
+    swapBytes(pixels + y * pitch, pixels + (height - y - 1) * pitch,
+              static_cast<size_t>(rowBytes));
+  }
+}
+
+void flipHorizontal(uint8_t *pixels, int width, int height, int pitch,
+                    int bytesPerPixel) {
+  if (bytesPerPixel != 4) {
+    scalar::flipHorizontal(pixels, width, height, pitch, bytesPerPixel);
+    return;
+  }
+  for (int y = 0; y < height; ++y) {
+    flipRow32(reinterpret_cast<uint32_t *>(pixels + y * pitch), width);
+  }
+}
+
+void repack(const uint8_t *src, int srcPitch, int srcBpp, uint8_t *dst,
+            int dstPitch, int dstBpp, int width, int height,
+            const uint8_t *order) {
+  // 4 pixels per 16-byte register; a 3-byte source reads 4 bytes past the
+  // group and a 3-byte destination writes 4 bytes past it, both in-row.
+  const auto groupPadding = srcBpp == 3 || dstBpp == 3 ? 2 : 0;
+  const auto isSwizzle32 = srcBpp == 4 && dstBpp == 4;
+#if defined(HELLO_IMAGE_SSSE3) || defined(HELLO_IMAGE_NEON) ||                 \
+    defined(HELLO_IMAGE_WASM) || defined(HELLO_IMAGE_SSE2)
+  alignas(16) uint8_t lanes[16];
+  alignas(16) uint8_t ones[16] = {};
+  for (int i = 0; i < 16; ++i) {
+    const auto p = i / dstBpp;
+    const auto j = i % dstBpp;
+    if (p >= 4 || order[j] == SWIZZLE_ONE) {
+      lanes[i] = 0x80;
+      ones[i] = p < 4 ? 0xff : 0;
+    } else {
+      lanes[i] = static_cast<uint8_t>(p * srcBpp + order[j]);
+    }
+  }
+#endif
+#if defined(HELLO_IMAGE_AVX2)
+  const auto shuffle8 = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(lanes)));
+  const auto fill8 = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(ones)));
+#endif
+#if defined(HELLO_IMAGE_SSSE3)
+  const auto shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(lanes));
+  const auto fill = _mm_load_si128(reinterpret_cast<const __m128i *>(ones));
+#elif defined(HELLO_IMAGE_SSE2)
+  // no byte shuffle before SSSE3, so move each byte with 32-bit shifts;
+  // shifting by 32 clears the lane for bytes that are filled with 0xff
+  const auto byteMask = _mm_set1_epi32(0xff);
+  const auto fill = _mm_load_si128(reinterpret_cast<const __m128i *>(ones));
+  (void)lanes;
+  __m128i srcShift[4];
+  for (int i = 0; i < 4; ++i) {
+    const auto skip = !isSwizzle32 || order[i] == SWIZZLE_ONE;
+    srcShift[i] = _mm_cvtsi32_si128(skip ? 32 : order[i] * 8);
+  }
+#elif defined(HELLO_IMAGE_NEON)
+  const auto shuffle = vld1q_u8(lanes);
+  const auto fill = vld1q_u8(ones);
+#elif defined(HELLO_IMAGE_WASM)
+  const auto shuffle = wasm_v128_load(lanes);
+  const auto fill = wasm_v128_load(ones);
+#endif
+
+  for (int y = 0; y < height; ++y) {
+    auto s = src + y * srcPitch;
+    auto d = dst + y * dstPitch;
+    int x = 0;
+#if defined(HELLO_IMAGE_AVX2)
+    for (; isSwizzle32 && x + 8 <= width; x += 8) {
+      auto v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + x * 4));
+      v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle8), fill8);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + x * 4), v);
+    }
+#endif
+#if defined(HELLO_IMAGE_SSSE3)
+    for (; x + 4 + groupPadding <= width; x += 4) {
+      auto v =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + x * srcBpp));
+      v = _mm_or_si128(_mm_shuffle_epi8(v, shuffle), fill);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(d + x * dstBpp), v);
+    }
+#elif defined(HELLO_IMAGE_SSE2)
+    for (; isSwizzle32 && x + 4 <= width; x += 4) {
+      auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + x * 4));
+      auto b0 = _mm_and_si128(_mm_srl_epi32(v, srcShift[0]), byteMask);
+      auto b1 = _mm_and_si128(_mm_srl_epi32(v, srcShift[1]), byteMask);
+      auto b2 = _mm_and_si128(_mm_srl_epi32(v, srcShift[2]), byteMask);
+      auto b3 = _mm_srl_epi32(v, srcShift[3]);
+      auto c = _mm_or_si128(_mm_or_si128(b0, _mm_slli_epi32(b1, 8)),
+                            _mm_or_si128(_mm_slli_epi32(b2, 16),
+                                         _mm_slli_epi32(b3, 24)));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(d + x * 4),
+                       _mm_or_si128(c, fill));
+    }
+#elif defined(HELLO_IMAGE_NEON)
+    for (; x + 4 + groupPadding <= width; x += 4) {
+      auto v = vqtbl1q_u8(vld1q_u8(s + x * srcBpp), shuffle);
+      vst1q_u8(d + x * dstBpp, vorrq_u8(v, fill));
+    }
+#elif defined(HELLO_IMAGE_WASM)
+    for (; x + 4 + groupPadding <= width; x += 4) {
+      auto v = wasm_i8x16_swizzle(wasm_v128_load(s + x * srcBpp), shuffle);
+      wasm_v128_store(d + x * dstBpp, wasm_v128_or(v, fill));
+    }
+#endif
+    (void)isSwizzle32;
+    (void)groupPadding;
+    repackRowScalar(s + x * srcBpp, srcBpp, d + x * dstBpp, dstBpp, width - x,
+                    order);
+  }
+}
+
+void swizzle(uint8_t *pixels, int width, int height, int pitch,
+             const uint8_t order[4]) {
+  repack(pixels, pitch, 4, pixels, pitch, 4, width, height, order);
+}
+
+void premultiplyAlpha(uint8_t *pixels, int width, int height, int pitch,
+                      int alphaIndex) {
+  void (*kernel)(uint8_t *, int) = nullptr;
+  switch (alphaIndex) {
+  case 0:
+    kernel = premultiplyRow<0>;
+    break;
+  case 1:
+    kernel = premultiplyRow<1>;
+    break;
+  case 2:
+    kernel = premultiplyRow<2>;
+    break;
+  case 3:
+    kernel = premultiplyRow<3>;
+    break;
+  default:
+    return;
+  }
+  for (int y = 0; y < height; ++y) {
+    kernel(pixels + y * pitch, width);
+  }
+}
+
+void srgbToLinear(uint8_t *pixels, int width, int height, int pitch,
+                  int bytesPerPixel, int alphaIndex) {
+  // a 256-entry table beats evaluating the transfer curve in SIMD lanes;
+  // alpha goes through an identity table so the inner loop has no branches
+  static const auto identity = [] {
+    struct Table {
+      uint8_t data[256];
+    } t;
+    for (int i = 0; i < 256; ++i) {
+      t.data[i] = static_cast<uint8_t>(i);
+    }
+    return t;
+  }();
+  const auto lut = getSrgbToLinearTable();
+  const uint8_t *tables[4];
+  for (int c = 0; c < 4; ++c) {
+    tables[c] = c == alphaIndex ? identity.data : lut;
+  }
+
+  for (int y = 0; y < height; ++y) {
+    auto row = pixels + y * pitch;
+    if (bytesPerPixel == 4) {
+      for (int x = 0; x < width; ++x) {
+        auto p = row + x * 4;
+        p[0] = tables[0][p[0]];
+        p[1] = tables[1][p[1]];
+        p[2] = tables[2][p[2]];
+        p[3] = tables[3][p[3]];
+      }
+    } else {
+      for (int x = 0; x < width; ++x) {
+        auto p = row + x * bytesPerPixel;
+        for (int c = 0; c < bytesPerPixel; ++c) {
+          p[c] = tables[c][p[c]];
+        }
+      }
+    }
+  }
+}
+
+namespace scalar {
+void flipVertical(uint8_t *pixels, int rowBytes, int height, int pitch) {
+  for (int y = 0; y < height / 2; ++y) {
+    auto a = pixels + y * pitch;
+    auto b = pixels + (height - y - 1) * pitch;
+    for (int i = 0; i < rowBytes; ++i) {
+      std::swap(a[i], b[i]);
+    }
+  }
+}
+
+void flipHorizontal(uint8_t *pixels, int width, int height, int pitch,
+                    int bytesPerPixel) {
+  uint8_t temp[16];
+  for (int y = 0; y < height; ++y) {
+    auto row = pixels + y * pitch;
+    for (int l = 0, r = width - 1; l < r; ++l, --r) {
+      auto a = row + l * bytesPerPixel;
+      auto b = row + r * bytesPerPixel;
+      ::memcpy(temp, a, bytesPerPixel);
+      ::memcpy(a, b, bytesPerPixel);
+      ::memcpy(b, temp, bytesPerPixel);
+    }
+  }
+}
+
+void repack(const uint8_t *src, int srcPitch, int srcBpp, uint8_t *dst,
+            int dstPitch, int dstBpp, int width, int height,
+            const uint8_t *order) {
+  for (int y = 0; y < height; ++y) {
+    repackRowScalar(src + y * srcPitch, srcBpp, dst + y * dstPitch, dstBpp,
+                    width, order);
+  }
+}
+
+void swizzle(uint8_t *pixels, int width, int height, int pitch,
+             const uint8_t order[4]) {
+  repack(pixels, pitch, 4, pixels, pitch, 4, width, height, order);
+}
+
+void premultiplyAlpha(uint8_t *pixels, int width, int height, int pitch,
+                      int alphaIndex) {
+  for (int y = 0; y < height; ++y) {
+    premultiplyRowScalar(pixels + y * pitch, width, alphaIndex);
+  }
+}
+} // namespace scalar
+} // namespace hello::image
@@ -0,0 +1,60 @@
+#ifndef __IMAGE_KERNELS_HPP__
+#define __IMAGE_KERNELS_HPP__
+
+#include <cstdint>
+
+namespace hello::image {
+// pixels of an image whose rows are `pitch` bytes apart.
+struct ImageView {
+  uint8_t *pixels;
+  int width;
+  int height;
+  int pitch;
+};
+
+// in-place pixel kernels. rows are `pitch` bytes apart; swizzle,
+// premultiplyAlpha and flipHorizontal's fast path expect 4 bytes per pixel.
+
+// name of the SIMD path selected at compile time, e.g. "sse2", "neon".
+const char *simdName();
+
+void flipVertical(uint8_t *pixels, int rowBytes, int height, int pitch);
+void flipHorizontal(uint8_t *pixels, int width, int height, int pitch,
+                    int bytesPerPixel);
+
+// order[i] is the source byte (0-3) written to byte i of each pixel, or
+// SWIZZLE_ONE to write 0xff.
+const uint8_t SWIZZLE_ONE = 4;
+void swizzle(uint8_t *pixels, int width, int height, int pitch,
+             const uint8_t order[4]);
+
+// copies 3 or 4 byte pixels into 3 or 4 byte pixels, reordering bytes with
+// `order` (dstBpp entries below srcBpp or SWIZZLE_ONE) on the way. src and
+// dst must not overlap unless both are 4 bytes per pixel and identical.
+void repack(const uint8_t *src, int srcPitch, int srcBpp, uint8_t *dst,
+            int dstPitch, int dstBpp, int width, int height,
+            const uint8_t *order);
+
+// alphaIndex is the byte (0-3) holding alpha in each pixel.
+void premultiplyAlpha(uint8_t *pixels, int width, int height, int pitch,
+                      int alphaIndex);
+
+// 8-bit sRGB to 8-bit linear, skipping alphaIndex (-1 converts every byte).
+void srgbToLinear(uint8_t *pixels, int width, int height, int pitch,
+                  int bytesPerPixel, int alphaIndex);
+
+// reference implementations, used for tests and benchmarks.
+namespace scalar {
+void flipVertical(uint8_t *pixels, int rowBytes, int height, int pitch);
+void flipHorizontal(uint8_t *pixels, int width, int height, int pitch,
+                    int bytesPerPixel);
+void swizzle(uint8_t *pixels, int width, int height, int pitch,
+             const uint8_t order[4]);
+void repack(const uint8_t *src, int srcPitch, int srcBpp, uint8_t *dst,
+            int dstPitch, int dstBpp, int width, int height,
+            const uint8_t *order);
+void premultiplyAlpha(uint8_t *pixels, int width, int height, int pitch,
+                      int alphaIndex);
+} // namespace scalar
+} // namespace hello::image
+#endif
@@ -0,0 +1,283 @@
+#include "./image_mipmap.hpp"
+#include "../thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HELLO_MIPMAP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define HELLO_MIPMAP_NEON
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#define HELLO_MIPMAP_WASM
+#include <wasm_simd128.h>
+#endif
+
+namespace {
+using hello::image::ImageView;
+using hello::image::MipFilter;
+
+// one RGBA pixel in a SIMD register, or four floats without SIMD
+#if defined(HELLO_MIPMAP_SSE2)
+using Float4 = __m128;
+inline Float4 load4(const float *p) { return _mm_loadu_ps(p); }
+inline void store4(float *p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 zero4() { return _mm_setzero_ps(); }
+inline Float4 madd4(Float4 acc, Float4 v, float w) {
+  return _mm_add_ps(acc, _mm_mul_ps(v, _mm_set1_ps(w)));
+}
+#elif defined(HELLO_MIPMAP_NEON)
+using Float4 = float32x4_t;
+inline Float4 load4(const float *p) { return vld1q_f32(p); }
+inline void store4(float *p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 zero4() { return vdupq_n_f32(0.0f); }
+inline Float4 madd4(Float4 acc, Float4 v, float w) {
+  return vmlaq_n_f32(acc, v, w);
+}
+#elif defined(HELLO_MIPMAP_WASM)
+using Float4 = v128_t;
+inline Float4 load4(const float *p) { return wasm_v128_load(p); }
+inline void store4(float *p, Float4 v) { wasm_v128_store(p, v); }
+inline Float4 zero4() { return wasm_f32x4_splat(0.0f); }
+inline Float4 madd4(Float4 acc, Float4 v, float w) {
+  return wasm_f32x4_add(acc, wasm_f32x4_mul(v, wasm_f32x4_splat(w)));
+}
+#else
+struct Float4 {
+  float v[4];
+};
+inline Float4 load4(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float *p, Float4 v) { std::copy_n(v.v, 4, p); }
+inline Float4 zero4() { return {{0.0f, 0.0f, 0.0f, 0.0f}}; }
+inline Float4 madd4(Float4 acc, Float4 v, float w) {
+  for (int i = 0; i < 4; ++i) {
+    acc.v[i] += v.v[i] * w;
+  }
+  return acc;
+}
+#endif
+
+// below this many output pixels a level is not worth splitting
+const int PARALLEL_THRESHOLD = 128 * 128;
+
+const double PI = 3.14159265358979323846;
+
+double sinc(double x) {
+  if (std::abs(x) < 1e-6) {
+    return 1.0;
+  }
+  return std::sin(PI * x) / (PI * x);
+}
+
+double besselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+double getFilterSupport(MipFilter filter) {
+  return filter == MipFilter::Box ? 0.5 : 3.0;
+}
+
+double evalFilter(MipFilter filter, double x) {
+  const auto support = getFilterSupport(filter);
+  if (std::abs(x) > support) {
+    return 0.0;
+  }
+  switch (filter) {
+  case MipFilter::Box:
+    return 1.0;
+  case MipFilter::Lanczos:
+    return sinc(x) * sinc(x / support);
+  case MipFilter::Kaiser: {
+    const auto alpha = 4.0;
+    const auto t = x / support;
+    return sinc(x) * besselI0(alpha * std::sqrt(1.0 - t * t)) /
+           besselI0(alpha);
+  }
+  }
+  return 0.0;
+}
+
+// weights of the source samples feeding one destination sample, with
+// out-of-range taps clamped to the edge.
+struct Taps {
+  std::vector<int> indices;
+  std::vector<float> weights;
+};
+
+std::vector<Taps> computeTaps(MipFilter filter, int srcSize, int dstSize) {
+  const auto scale = static_cast<double>(srcSize) / dstSize;
+  const auto radius = getFilterSupport(filter) * scale;
+  std::vector<Taps> taps(dstSize);
+  for (int i = 0; i < dstSize; ++i) {
+    const auto center = (i + 0.5) * scale;
+    const auto first = static_cast<int>(std::floor(center - radius));
+    const auto last = static_cast<int>(std::ceil(center + radius));
+    auto &t = taps[i];
+    double total = 0.0;
+    std::vector<double> weights;
+    for (int j = first; j <= last; ++j) {
+      const auto w = evalFilter(filter, (j + 0.5 - center) / scale);
+      if (w == 0.0) {
+        continue;
+      }
+      t.indices.push_back(std::clamp(j, 0, srcSize - 1));
+      weights.push_back(w);
+      total += w;
+    }
+    for (auto w : weights) {
+      t.weights.push_back(static_cast<float>(w / total));
+    }
+  }
+  return taps;
+}
+
+struct ColorTables {
+  float decode[256];
+  // midpoints between consecutive decoded values, for nearest encoding
+  float thresholds[255];
+
+  explicit ColorTables(bool srgb) {
+    for (int i = 0; i < 256; ++i) {
+      const auto c = i / 255.0;
+      if (srgb) {
+        decode[i] = static_cast<float>(
+            c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+      } else {
+        decode[i] = static_cast<float>(c);
+      }
+    }
+    for (int i = 0; i < 255; ++i) {
+      thresholds[i] = (decode[i] + decode[i + 1]) * 0.5f;
+    }
+  }
+
+  uint8_t encode(float v) const {
+    return static_cast<uint8_t>(
+        std::upper_bound(thresholds, thresholds + 255, v) - thresholds);
+  }
+};
+
+// premultiplied float plane of one level
+struct Plane {
+  int width;
+  int height;
+  std::vector<float> data;
+
+  Plane(int w, int h)
+      : width(w), height(h), data(static_cast<size_t>(w) * h * 4) {}
+  float *row(int y) { return data.data() + static_cast<size_t>(y) * width * 4; }
+};
+
+void forEachRow(int rows, int pixelsPerRow,
+                const std::function<void(int)> &fn) {
+  if (rows * pixelsPerRow < PARALLEL_THRESHOLD) {
+    for (int y = 0; y < rows; ++y) {
+      fn(y);
+    }
+  } else {
+    hello::thread_pool::parallelFor(0, rows, fn);
+  }
+}
+
+Plane decodePlane(const ImageView &src, const ColorTables &tables) {
+  Plane plane(src.width, src.height);
+  forEachRow(src.height, src.width, [&](int y) {
+    auto s = src.pixels + static_cast<size_t>(y) * src.pitch;
+    auto d = plane.row(y);
+    for (int x = 0; x < src.width; ++x) {
+      const auto a = s[x * 4 + 3] / 255.0f;
+      d[x * 4 + 0] = tables.decode[s[x * 4 + 0]] * a;
+      d[x * 4 + 1] = tables.decode[s[x * 4 + 1]] * a;
+      d[x * 4 + 2] = tables.decode[s[x * 4 + 2]] * a;
+      d[x * 4 + 3] = a;
+    }
+  });
+  return plane;
+}
+
+void encodePlane(Plane &plane, const ImageView &dst,
+                 const ColorTables &tables) {
+  forEachRow(dst.height, dst.width, [&](int y) {
+    auto s = plane.row(y);
+    auto d = dst.pixels + static_cast<size_t>(y) * dst.pitch;
+    for (int x = 0; x < dst.width; ++x) {
+      const auto a = std::clamp(s[x * 4 + 3], 0.0f, 1.0f);
+      const auto inv = a > 0.0f ? 1.0f / a : 0.0f;
+      d[x * 4 + 0] = tables.encode(s[x * 4 + 0] * inv);
+      d[x * 4 + 1] = tables.encode(s[x * 4 + 1] * inv);
+      d[x * 4 + 2] = tables.encode(s[x * 4 + 2] * inv);
+      d[x * 4 + 3] = static_cast<uint8_t>(a * 255.0f + 0.5f);
+    }
+  });
+}
+
+Plane downsample(Plane &src, int width, int height, MipFilter filter) {
+  const auto xTaps = computeTaps(filter, src.width, width);
+  const auto yTaps = computeTaps(filter, src.height, height);
+
+  // horizontal pass over every source row, then vertical into the level
+  Plane temp(width, src.height);
+  forEachRow(src.height, width, [&](int y) {
+    auto s = src.row(y);
+    auto d = temp.row(y);
+    for (int x = 0; x < width; ++x) {
+      const auto &t = xTaps[x];
+      auto acc = zero4();
+      for (size_t k = 0; k < t.indices.size(); ++k) {
+        acc = madd4(acc, load4(s + t.indices[k] * 4), t.weights[k]);
+      }
+      store4(d + x * 4, acc);
+    }
+  });
+
+  Plane dst(width, height);
+  forEachRow(height, width, [&](int y) {
+    const auto &t = yTaps[y];
+    auto d = dst.row(y);
+    for (int x = 0; x < width; ++x) {
+      auto acc = zero4();
+      for (size_t k = 0; k < t.indices.size(); ++k) {
+        acc = madd4(acc, load4(temp.row(t.indices[k]) + x * 4), t.weights[k]);
+      }
+      store4(d + x * 4, acc);
+    }
+  });
+  return dst;
+}
+} // namespace
+
+namespace hello::image {
+int getMipLevelCount(int width, int height) {
+  auto count = 0;
+  while (width > 1 || height > 1) {
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+    ++count;
+  }
+  return count;
+}
+
+void generateMipmaps(const ImageView &src, const ImageView *levels, int count,
+                     MipFilter filter, bool srgb) {
+  if (count <= 0) {
+    return;
+  }
+  const ColorTables tables(srgb);
+  auto plane = decodePlane(src, tables);
+  for (int i = 0; i < count; ++i) {
+    plane = downsample(plane, levels[i].width, levels[i].height, filter);
+    encodePlane(plane, levels[i], tables);
+  }
+}
+} // namespace hello::image
@@ -0,0 +1,19 @@
+#ifndef __IMAGE_MIPMAP_HPP__
+#define __IMAGE_MIPMAP_HPP__
+
+#include "./image_kernels.hpp"
+
+namespace hello::image {
+enum class MipFilter { Box, Kaiser, Lanczos };
+
+// number of levels below `width` x `height`, down to 1x1.
+int getMipLevelCount(int width, int height);
+
+// fills levels[0..count) with successive halvings (rounded down, at least
+// 1) of an RGBA8 image. filtering happens on alpha-premultiplied floats, in
+// linear light when `srgb` is set, and every level is derived from the
+// unquantized previous one. large levels are split across the thread pool.
+void generateMipmaps(const ImageView &src, const ImageView *levels, int count,
+                     MipFilter filter, bool srgb);
+} // namespace hello::image
+#endif
@@ -0,0 +1,216 @@
+#include "./image_probe.hpp"
+#include "./image_qoi.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+uint32_t readBE16(const uint8_t *p) { return p[0] << 8 | p[1]; }
+
+uint32_t readBE32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) << 24 | readBE16(p + 1) << 8 | p[3];
+}
+
+uint32_t readLE16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+uint32_t readLE24(const uint8_t *p) { return readLE16(p) | p[2] << 16; }
+
+uint32_t readLE32(const uint8_t *p) {
+  return readLE24(p) | static_cast<uint32_t>(p[3]) << 24;
+}
+
+bool startsWith(const uint8_t *data, size_t size, const char *magic,
+                size_t offset = 0) {
+  const auto length = ::strlen(magic);
+  return size >= offset + length &&
+         ::memcmp(data + offset, magic, length) == 0;
+}
+
+bool setSize(hello::image::ImageProbe *probe, uint32_t width,
+             uint32_t height) {
+  if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX) {
+    return false;
+  }
+  probe->width = static_cast<int>(width);
+  probe->height = static_cast<int>(height);
+  return true;
+}
+
+bool probePng(const uint8_t *data, size_t size,
+              hello::image::ImageProbe *probe) {
+  // signature, then IHDR as the first chunk
+  if (size < 8 + 8 + 13 || !startsWith(data, size, "IHDR", 12)) {
+    return false;
+  }
+  if (!setSize(probe, readBE32(data + 16), readBE32(data + 20))) {
+    return false;
+  }
+  const auto colorType = data[25];
+  switch (colorType) {
+  case 0:
+    probe->channels = 1;
+    break;
+  case 2:
+  case 3:
+    probe->channels = 3;
+    break;
+  case 4:
+    probe->channels = 2;
+    break;
+  case 6:
+    probe->channels = 4;
+    break;
+  default:
+    return false;
+  }
+  if (colorType == 4 || colorType == 6) {
+    return true;
+  }
+
+  // tRNS has to come before the first IDAT, so the walk stops there
+  for (size_t offset = 8 + 8 + 13 + 4; offset + 8 <= size;) {
+    const auto length = readBE32(data + offset);
+    if (startsWith(data, size, "tRNS", offset + 4)) {
+      probe->channels = colorType == 0 ? 2 : 4;
+      break;
+    }
+    if (startsWith(data, size, "IDAT", offset + 4) ||
+        length > size - offset - 8) {
+      break;
+    }
+    offset += 8 + static_cast<size_t>(length) + 4;
+  }
+  return true;
+}
+
+bool probeJpeg(const uint8_t *data, size_t size,
+               hello::image::ImageProbe *probe) {
+  for (size_t offset = 2; offset + 4 <= size;) {
+    if (data[offset] != 0xff) {
+      return false;
+    }
+    const auto marker = data[offset + 1];
+    if (marker == 0xff) {
+      // fill byte
+      ++offset;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xd0 && marker <= 0xd8)) {
+      offset += 2;
+      continue;
+    }
+    const auto length = readBE16(data + offset + 2);
+    // SOF0 to SOF15 except DHT, JPG and DAC
+    if (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 &&
+        marker != 0xc8 && marker != 0xcc) {
+      if (length < 8 || offset + 4 + 6 > size) {
+        return false;
+      }
+      const auto segment = data + offset + 4;
+      probe->channels = segment[5] == 1 ? 1 : 3;
+      return setSize(probe, readBE16(segment + 3), readBE16(segment + 1));
+    }
+    if (marker == 0xd9 || marker == 0xda || length < 2) {
+      return false;
+    }
+    offset += 2 + length;
+  }
+  return false;
+}
+
+bool probeBmp(const uint8_t *data, size_t size,
+              hello::image::ImageProbe *probe) {
+  if (size < 14 + 12) {
+    return false;
+  }
+  const auto headerSize = readLE32(data + 14);
+  uint32_t width, height, bitsPerPixel;
+  if (headerSize == 12) {
+    width = readLE16(data + 18);
+    height = readLE16(data + 20);
+    bitsPerPixel = readLE16(data + 24);
+  } else {
+    if (headerSize < 40 || size < 14 + 40) {
+      return false;
+    }
+    width = readLE32(data + 18);
+    // top-down bitmaps store a negative height
+    const auto storedHeight = static_cast<int32_t>(readLE32(data + 22));
+    height = storedHeight < 0 ? 0u - static_cast<uint32_t>(storedHeight)
+                              : static_cast<uint32_t>(storedHeight);
+    bitsPerPixel = readLE16(data + 28);
+  }
+  probe->channels = bitsPerPixel == 32 ? 4 : 3;
+  return setSize(probe, width, height);
+}
+
+bool probeGif(const uint8_t *data, size_t size,
+              hello::image::ImageProbe *probe) {
+  if (size < 10) {
+    return false;
+  }
+  probe->channels = 3;
+  return setSize(probe, readLE16(data + 6), readLE16(data + 8));
+}
+
+bool probeWebp(const uint8_t *data, size_t size,
+               hello::image::ImageProbe *probe) {
+  if (size < 30) {
+    return false;
+  }
+  if (startsWith(data, size, "VP8X", 12)) {
+    probe->channels = (data[20] & 0x10) != 0 ? 4 : 3;
+    return setSize(probe, readLE24(data + 24) + 1, readLE24(data + 27) + 1);
+  }
+  if (startsWith(data, size, "VP8L", 12)) {
+    if (data[20] != 0x2f) {
+      return false;
+    }
+    const auto bits = readLE32(data + 21);
+    probe->channels = (bits >> 28 & 1) != 0 ? 4 : 3;
+    return setSize(probe, (bits & 0x3fff) + 1, (bits >> 14 & 0x3fff) + 1);
+  }
+  if (startsWith(data, size, "VP8 ", 12)) {
+    if (data[23] != 0x9d || data[24] != 0x01 || data[25] != 0x2a) {
+      return false;
+    }
+    probe->channels = 3;
+    return setSize(probe, readLE16(data + 26) & 0x3fff,
+                   readLE16(data + 28) & 0x3fff);
+  }
+  return false;
+}
+} // namespace
+
+namespace hello::image {
+bool probeImage(const void *data, size_t size, ImageProbe *probe) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  QoiHeader header;
+  if (readQoiHeader(data, size, &header)) {
+    probe->type = "qoi";
+    probe->channels = header.channels;
+    return setSize(probe, header.width, header.height);
+  }
+  if (startsWith(bytes, size, "\x89PNG\r\n\x1a\n")) {
+    probe->type = "png";
+    return probePng(bytes, size, probe);
+  }
+  if (startsWith(bytes, size, "\xff\xd8")) {
+    probe->type = "jpg";
+    return probeJpeg(bytes, size, probe);
+  }
+  if (startsWith(bytes, size, "BM")) {
+    probe->type = "bmp";
+    return probeBmp(bytes, size, probe);
+  }
+  if (startsWith(bytes, size, "GIF87a") || startsWith(bytes, size, "GIF89a")) {
+    probe->type = "gif";
+    return probeGif(bytes, size, probe);
+  }
+  if (startsWith(bytes, size, "RIFF") && startsWith(bytes, size, "WEBP", 8)) {
+    probe->type = "webp";
+    return probeWebp(bytes, size, probe);
+  }
+  return false;
+}
+} // namespace hello::image
@@ -0,0 +1,22 @@
+#ifndef __IMAGE_PROBE_HPP__
+#define __IMAGE_PROBE_HPP__
+
+#include <cstddef>
+
+namespace hello::image {
+struct ImageProbe {
+  // "png", "jpg", "qoi", "bmp", "gif" or "webp"
+  const char *type;
+  int width;
+  int height;
+  // 1 gray, 2 gray + alpha, 3 RGB or 4 RGBA, as stored in the file. palette
+  // images count as RGB, or RGBA when they carry transparency.
+  int channels;
+};
+
+// reads the size and channels from the file header without decoding any
+// pixels. only the bytes up to the header (for JPEG, up to the SOF marker)
+// are touched. returns false for unknown or truncated files.
+bool probeImage(const void *data, size_t size, ImageProbe *probe);
+} // namespace hello::image
+#endif
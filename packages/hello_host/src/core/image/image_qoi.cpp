@@ -0,0 +1,197 @@
+#include "./image_qoi.hpp"
+
+#include <cstring>
+
+namespace {
+const uint8_t QOI_MAGIC[4] = {'q', 'o', 'i', 'f'};
+const size_t QOI_HEADER_SIZE = 14;
+const uint8_t QOI_PADDING[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+// the reference implementation's limit, which keeps w * h * 4 in range
+const uint64_t QOI_PIXELS_MAX = 400000000;
+
+const uint8_t QOI_OP_INDEX = 0x00;
+const uint8_t QOI_OP_DIFF = 0x40;
+const uint8_t QOI_OP_LUMA = 0x80;
+const uint8_t QOI_OP_RUN = 0xc0;
+const uint8_t QOI_OP_RGB = 0xfe;
+const uint8_t QOI_OP_RGBA = 0xff;
+const uint8_t QOI_MASK_2 = 0xc0;
+
+struct Rgba {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+  uint8_t a;
+
+  bool operator==(const Rgba &o) const {
+    return r == o.r && g == o.g && b == o.b && a == o.a;
+  }
+};
+
+int hashPixel(const Rgba &px) {
+  return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+}
+
+uint32_t readBigEndian32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) << 24 |
+         static_cast<uint32_t>(p[1]) << 16 |
+         static_cast<uint32_t>(p[2]) << 8 | p[3];
+}
+
+void writeBigEndian32(uint32_t v, std::vector<uint8_t> *out) {
+  out->push_back(static_cast<uint8_t>(v >> 24));
+  out->push_back(static_cast<uint8_t>(v >> 16));
+  out->push_back(static_cast<uint8_t>(v >> 8));
+  out->push_back(static_cast<uint8_t>(v));
+}
+} // namespace
+
+namespace hello::image {
+bool readQoiHeader(const void *data, size_t size, QoiHeader *header) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  if (size < QOI_HEADER_SIZE + sizeof(QOI_PADDING) ||
+      ::memcmp(bytes, QOI_MAGIC, sizeof(QOI_MAGIC)) != 0) {
+    return false;
+  }
+  const auto width = readBigEndian32(bytes + 4);
+  const auto height = readBigEndian32(bytes + 8);
+  const auto channels = bytes[12];
+  const auto colorspace = bytes[13];
+  if (width == 0 || height == 0 || channels < 3 || channels > 4 ||
+      colorspace > 1 ||
+      static_cast<uint64_t>(width) * height > QOI_PIXELS_MAX) {
+    return false;
+  }
+  header->width = static_cast<int>(width);
+  header->height = static_cast<int>(height);
+  header->channels = channels;
+  header->colorspace = colorspace;
+  return true;
+}
+
+bool decodeQoi(const void *data, size_t size, const QoiHeader &header,
+               uint8_t *pixels, int pitch) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  // every op is at most 5 bytes, so only the padding needs checking
+  const auto end = size - sizeof(QOI_PADDING);
+  auto p = QOI_HEADER_SIZE;
+  Rgba index[64] = {};
+  Rgba px = {0, 0, 0, 255};
+  auto run = 0;
+  const auto channels = header.channels;
+
+  for (int y = 0; y < header.height; ++y) {
+    auto row = pixels + static_cast<size_t>(y) * pitch;
+    for (int x = 0; x < header.width; ++x, row += channels) {
+      if (run > 0) {
+        --run;
+      } else if (p < end) {
+        const auto b1 = bytes[p++];
+        if (b1 == QOI_OP_RGB) {
+          px.r = bytes[p];
+          px.g = bytes[p + 1];
+          px.b = bytes[p + 2];
+          p += 3;
+        } else if (b1 == QOI_OP_RGBA) {
+          px.r = bytes[p];
+          px.g = bytes[p + 1];
+          px.b = bytes[p + 2];
+          px.a = bytes[p + 3];
+          p += 4;
+        } else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+          px = index[b1];
+        } else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+          px.r = static_cast<uint8_t>(px.r + ((b1 >> 4) & 3) - 2);
+          px.g = static_cast<uint8_t>(px.g + ((b1 >> 2) & 3) - 2);
+          px.b = static_cast<uint8_t>(px.b + (b1 & 3) - 2);
+        } else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+          const auto b2 = bytes[p++];
+          const auto vg = (b1 & 0x3f) - 32;
+          px.r = static_cast<uint8_t>(px.r + vg - 8 + ((b2 >> 4) & 0x0f));
+          px.g = static_cast<uint8_t>(px.g + vg);
+          px.b = static_cast<uint8_t>(px.b + vg - 8 + (b2 & 0x0f));
+        } else {
+          run = b1 & 0x3f;
+        }
+        index[hashPixel(px)] = px;
+      } else {
+        return false;
+      }
+      row[0] = px.r;
+      row[1] = px.g;
+      row[2] = px.b;
+      if (channels == 4) {
+        row[3] = px.a;
+      }
+    }
+  }
+  return true;
+}
+
+void encodeQoi(const uint8_t *pixels, int width, int height, int pitch,
+               int channels, std::vector<uint8_t> *out) {
+  // worst case is one RGBA op per pixel
+  out->reserve(out->size() + QOI_HEADER_SIZE + sizeof(QOI_PADDING) +
+               static_cast<size_t>(width) * height * (channels + 1));
+  out->insert(out->end(), QOI_MAGIC, QOI_MAGIC + sizeof(QOI_MAGIC));
+  writeBigEndian32(static_cast<uint32_t>(width), out);
+  writeBigEndian32(static_cast<uint32_t>(height), out);
+  out->push_back(static_cast<uint8_t>(channels));
+  out->push_back(0);
+
+  Rgba index[64] = {};
+  Rgba prev = {0, 0, 0, 255};
+  auto run = 0;
+  for (int y = 0; y < height; ++y) {
+    auto row = pixels + static_cast<size_t>(y) * pitch;
+    for (int x = 0; x < width; ++x, row += channels) {
+      const Rgba px = {row[0], row[1], row[2],
+                       channels == 4 ? row[3] : static_cast<uint8_t>(255)};
+      if (px == prev) {
+        if (++run == 62) {
+          out->push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+          run = 0;
+        }
+        continue;
+      }
+      if (run > 0) {
+        out->push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+        run = 0;
+      }
+
+      const auto hash = hashPixel(px);
+      if (index[hash] == px) {
+        out->push_back(static_cast<uint8_t>(QOI_OP_INDEX | hash));
+      } else {
+        index[hash] = px;
+        if (px.a == prev.a) {
+          const auto vr = static_cast<int8_t>(px.r - prev.r);
+          const auto vg = static_cast<int8_t>(px.g - prev.g);
+          const auto vb = static_cast<int8_t>(px.b - prev.b);
+          const auto vgr = vr - vg;
+          const auto vgb = vb - vg;
+          if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+            out->push_back(static_cast<uint8_t>(
+                QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+          } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 &&
+                     vgb > -9 && vgb < 8) {
+            out->push_back(static_cast<uint8_t>(QOI_OP_LUMA | (vg + 32)));
+            out->push_back(static_cast<uint8_t>((vgr + 8) << 4 | (vgb + 8)));
+          } else {
+            const uint8_t op[] = {QOI_OP_RGB, px.r, px.g, px.b};
+            out->insert(out->end(), op, op + sizeof(op));
+          }
+        } else {
+          const uint8_t op[] = {QOI_OP_RGBA, px.r, px.g, px.b, px.a};
+          out->insert(out->end(), op, op + sizeof(op));
+        }
+      }
+      prev = px;
+    }
+  }
+  if (run > 0) {
+    out->push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+  }
+  out->insert(out->end(), QOI_PADDING, QOI_PADDING + sizeof(QOI_PADDING));
+}
+} // namespace hello::image
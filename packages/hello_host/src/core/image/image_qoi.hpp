@@ -0,0 +1,31 @@
+#ifndef __IMAGE_QOI_HPP__
+#define __IMAGE_QOI_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hello::image {
+struct QoiHeader {
+  int width;
+  int height;
+  // 3 (RGB) or 4 (RGBA)
+  int channels;
+  // 0 sRGB with linear alpha, 1 all channels linear
+  int colorspace;
+};
+
+// true when `data` starts with a valid QOI header, which goes to `header`.
+bool readQoiHeader(const void *data, size_t size, QoiHeader *header);
+
+// decodes into rows `pitch` bytes apart with header.channels bytes per
+// pixel in R, G, B(, A) order, so RGB24 / RGBA32 surfaces can upload it
+// as is. returns false on truncated data.
+bool decodeQoi(const void *data, size_t size, const QoiHeader &header,
+               uint8_t *pixels, int pitch);
+
+// appends the QOI file for 3 or 4 channel R, G, B(, A) pixels to `out`.
+void encodeQoi(const uint8_t *pixels, int width, int height, int pitch,
+               int channels, std::vector<uint8_t> *out);
+} // namespace hello::image
+#endif
@@ -0,0 +1,86 @@
+#include "./image_surface_cache.hpp"
+#include "./image_cache.hpp"
+#include "./image_decode.hpp"
+
+#include <iterator>
+
+namespace hello::image {
+SurfaceCache::SurfaceCache(size_t budget) : budget(budget) {}
+
+SurfaceCache::~SurfaceCache() { clear(); }
+
+SDL_Surface *SurfaceCache::hit(EntryList::iterator it) {
+  ++stats.hits;
+  entries.splice(entries.begin(), entries, it);
+  ++it->surface->refcount;
+  return it->surface;
+}
+
+void SurfaceCache::evict(EntryList::iterator it) {
+  for (const auto &path : it->paths) {
+    byPath.erase(path);
+  }
+  byHash.erase(it->hash);
+  stats.bytes -= it->bytes;
+  --stats.count;
+  SDL_FreeSurface(it->surface);
+  entries.erase(it);
+}
+
+void SurfaceCache::trim() {
+  while (stats.bytes > budget && !entries.empty()) {
+    evict(std::prev(entries.end()));
+    ++stats.evictions;
+  }
+}
+
+SDL_Surface *SurfaceCache::load(const std::string &path) {
+  auto pathIt = byPath.find(path);
+  if (pathIt != byPath.end()) {
+    return hit(pathIt->second);
+  }
+
+  // the same bytes under another path share the entry
+  std::vector<uint8_t> encoded;
+  if (!readFile(path.c_str(), &encoded)) {
+    return nullptr;
+  }
+  const auto hash = hashContent(encoded.data(), encoded.size());
+  auto hashIt = byHash.find(hash);
+  if (hashIt != byHash.end()) {
+    hashIt->second->paths.push_back(path);
+    byPath.emplace(path, hashIt->second);
+    return hit(hashIt->second);
+  }
+
+  ++stats.misses;
+  auto surface =
+      decodeImage(encoded.data(), encoded.size(), getImageType(path.c_str()));
+  if (surface == nullptr) {
+    return nullptr;
+  }
+
+  const auto bytes = static_cast<size_t>(surface->pitch) * surface->h;
+  entries.push_front({surface, bytes, hash, {path}});
+  byPath.emplace(path, entries.begin());
+  byHash.emplace(hash, entries.begin());
+  stats.bytes += bytes;
+  ++stats.count;
+
+  // the caller's reference keeps the surface alive even if it is evicted
+  ++surface->refcount;
+  trim();
+  return surface;
+}
+
+void SurfaceCache::setBudget(size_t budget) {
+  this->budget = budget;
+  trim();
+}
+
+void SurfaceCache::clear() {
+  while (!entries.empty()) {
+    evict(entries.begin());
+  }
+}
+} // namespace hello::image
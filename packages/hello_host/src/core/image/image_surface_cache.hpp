@@ -0,0 +1,63 @@
+#ifndef __IMAGE_SURFACE_CACHE_HPP__
+#define __IMAGE_SURFACE_CACHE_HPP__
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hello::image {
+// decoded surfaces shared by path and by content hash. the cache holds one
+// reference per entry and drops the least recently used ones once their
+// pixels take more than the byte budget. not thread-safe.
+class SurfaceCache {
+public:
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t bytes;
+    size_t count;
+  };
+
+  explicit SurfaceCache(size_t budget);
+  SurfaceCache(const SurfaceCache &) = delete;
+  SurfaceCache &operator=(const SurfaceCache &) = delete;
+  ~SurfaceCache();
+
+  // returns a new reference to the entry's surface for the caller to
+  // SDL_FreeSurface, or nullptr with the SDL error set. every load of the
+  // same path or bytes gets the same pixels, so they are read-only: copy
+  // the surface before drawing into it.
+  SDL_Surface *load(const std::string &path);
+
+  void setBudget(size_t budget);
+  size_t getBudget() const { return budget; }
+  const Stats &getStats() const { return stats; }
+  void clear();
+
+private:
+  struct Entry {
+    SDL_Surface *surface;
+    size_t bytes;
+    uint64_t hash;
+    std::vector<std::string> paths;
+  };
+  using EntryList = std::list<Entry>;
+
+  size_t budget;
+  Stats stats = {};
+  // most recently used first
+  EntryList entries;
+  std::unordered_map<std::string, EntryList::iterator> byPath;
+  std::unordered_map<uint64_t, EntryList::iterator> byHash;
+
+  SDL_Surface *hit(EntryList::iterator it);
+  void evict(EntryList::iterator it);
+  void trim();
+};
+} // namespace hello::image
+#endif
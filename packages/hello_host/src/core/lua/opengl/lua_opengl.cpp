@@ -1,8 +1,22 @@
 #include "./lua_opengl.hpp"
+#include "../../gl/command_list.hpp"
+#include "../../gl/draw_list.hpp"
+#include "../../gl/extensions.hpp"
+#include "../../gl/gpu_timer.hpp"
+#include "../../gl/instance_data.hpp"
+#include "../../gl/readback.hpp"
+#include "../../gl/state_cache.hpp"
+#include "../../gl/stream_buffer.hpp"
+#include "../../gl/uniform_block.hpp"
+#include "../../image/image_qoi.hpp"
 #include "../sdl2_image/lua_sdl2_image.hpp"
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <cfloat>
 #include <cstring>
+#include <iterator>
+#include <string_view>
+#include <vector>
 #ifdef __EMSCRIPTEN__
 #include "emscripten.h"
 #include <GLES3/gl3.h>
@@ -10,11 +24,48 @@
 #include <glad/glad.h>
 #endif
 
+// block-compressed formats the image encoder writes. S3TC is an extension
+// everywhere, and BPTC/ETC2 are newer than the GL 3.0 loader.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
 namespace {
+const char *const CONSTANTS_NAME = "GL_Constants";
+const char *const COMMAND_LIST_NAME = "GL_CommandList";
+const char *const STREAM_BUFFER_NAME = "GL_StreamBuffer";
+const char *const INSTANCE_DATA_NAME = "GL_InstanceData";
+const char *const UNIFORM_LAYOUT_NAME = "GL_UniformLayout";
+const char *const UNIFORM_BLOCK_NAME = "GL_UniformBlock";
+const char *const GPU_TIMER_NAME = "GL_GpuTimer";
+const char *const DRAW_LIST_NAME = "GL_DrawList";
+const char *const READBACK_NAME = "GL_Readback";
+
+// the cache for whichever context is current. it starts over whenever
+// that changes, e.g. between render callbacks of different windows.
+hello::gl::StateCache &getStateCache() {
+  static hello::gl::StateCache cache;
+  cache.setContext(SDL_GL_GetCurrentContext());
+  return cache;
+}
+
 int L_loadGLLoader(lua_State *) {
 #ifndef __EMSCRIPTEN__
   gladLoadGLLoader(SDL_GL_GetProcAddress);
 #endif
+  hello::gl::loadExtensions(SDL_GL_GetProcAddress);
   return 0;
 }
 
@@ -23,7 +74,7 @@ int L_glClearColor(lua_State *L) {
   auto g = static_cast<GLclampf>(luaL_checknumber(L, 2));
   auto b = static_cast<GLclampf>(luaL_checknumber(L, 3));
   auto a = static_cast<GLclampf>(luaL_checknumber(L, 4));
-  glClearColor(r, g, b, a);
+  getStateCache().clearColor(r, g, b, a);
   return 0;
 }
 
@@ -55,13 +106,14 @@ int L_glDeleteBuffer(lua_State *L) {
   GLuint buffers[] = {0};
   buffers[0] = static_cast<GLuint>(luaL_checkinteger(L, 1));
   glDeleteBuffers(1, buffers);
+  getStateCache().bufferDeleted(buffers[0]);
   return 0;
 }
 
 int L_glBindBuffer(lua_State *L) {
   auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
   auto buffer = static_cast<GLuint>(luaL_checkinteger(L, 2));
-  glBindBuffer(target, buffer);
+  getStateCache().bindBuffer(target, buffer);
   return 0;
 }
 
@@ -75,6 +127,141 @@ int L_glBufferData(lua_State *L) {
   return 0;
 }
 
+struct UDInstanceData {
+  hello::gl::InstanceData *data;
+};
+
+hello::gl::InstanceData *checkInstanceData(lua_State *L, int idx) {
+  auto pInstances = static_cast<UDInstanceData *>(
+      luaL_checkudata(L, idx, INSTANCE_DATA_NAME));
+  luaL_argcheck(L, pInstances->data != nullptr, idx, "already freed.");
+  return pInstances->data;
+}
+
+struct UDUniformBlock {
+  hello::gl::UniformBlock *data;
+};
+
+hello::gl::UniformBlock *checkUniformBlock(lua_State *L, int idx) {
+  auto pBlock = static_cast<UDUniformBlock *>(
+      luaL_checkudata(L, idx, UNIFORM_BLOCK_NAME));
+  luaL_argcheck(L, pBlock->data != nullptr, idx, "already freed.");
+  return pBlock->data;
+}
+
+struct UDDrawList {
+  hello::gl::DrawList *data;
+};
+
+hello::gl::DrawList *checkDrawList(lua_State *L, int idx) {
+  auto pList =
+      static_cast<UDDrawList *>(luaL_checkudata(L, idx, DRAW_LIST_NAME));
+  luaL_argcheck(L, pList->data != nullptr, idx, "already freed.");
+  return pList->data;
+}
+
+// bytes of a buffer upload, used in place: a string, a GL_InstanceData, a
+// GL_UniformBlock, the packed commands of a GL_DrawList, or the pixel
+// memory of an SDL_Surface (pitch * h bytes). a surface is returned
+// locked in `surface` for the caller to unlock.
+const void *checkBytes(lua_State *L, int arg, size_t *size,
+                       SDL_Surface **surface) {
+  if (lua_isstring(L, arg)) {
+    return luaL_checklstring(L, arg, size);
+  }
+  if (luaL_testudata(L, arg, INSTANCE_DATA_NAME) != nullptr) {
+    auto instances = checkInstanceData(L, arg);
+    *size = instances->getByteSize();
+    return instances->getData();
+  }
+  if (luaL_testudata(L, arg, UNIFORM_BLOCK_NAME) != nullptr) {
+    auto block = checkUniformBlock(L, arg);
+    *size = block->getSize();
+    return block->getData();
+  }
+  if (luaL_testudata(L, arg, DRAW_LIST_NAME) != nullptr) {
+    auto list = checkDrawList(L, arg);
+    *size = list->getByteSize();
+    return list->getData();
+  }
+  auto pudSurface = hello::lua::sdl2_image::get(L, arg);
+  luaL_argcheck(L, pudSurface != nullptr && pudSurface->surface != nullptr,
+                arg, "specify string, GL_InstanceData or SDL_Surface");
+  *surface = pudSurface->surface;
+  SDL_LockSurface(*surface);
+  *size = static_cast<size_t>((*surface)->pitch) * (*surface)->h;
+  return (*surface)->pixels;
+}
+
+// GL.bufferSubData(target, offset, data[, dataOffset[, size]]) replaces
+// part of the bound buffer with `size` bytes of `data` from `dataOffset`,
+// so neither side has to be copied or re-uploaded whole.
+int L_glBufferSubData(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto offset = luaL_checkinteger(L, 2);
+  luaL_argcheck(L, offset >= 0, 2, "offset out of range");
+  auto dataOffset = luaL_optinteger(L, 4, 0);
+  luaL_argcheck(L, dataOffset >= 0, 4, "offset out of range");
+  auto count = luaL_optinteger(L, 5, -1);
+  luaL_argcheck(L, count >= -1, 5, "size out of range");
+
+  size_t size;
+  SDL_Surface *surface = nullptr;
+  auto data = static_cast<const uint8_t *>(checkBytes(L, 3, &size, &surface));
+  auto rest = static_cast<lua_Integer>(size) - dataOffset;
+  if (count == -1) {
+    count = rest;
+  }
+  auto ok = rest >= 0 && count <= rest;
+  if (ok && count > 0) {
+    glBufferSubData(target, static_cast<GLintptr>(offset),
+                    static_cast<GLsizeiptr>(count), data + dataOffset);
+  }
+  if (surface != nullptr) {
+    SDL_UnlockSurface(surface);
+  }
+  luaL_argcheck(L, ok, 5, "range out of data");
+  return 0;
+}
+
+int L_glCopyBufferSubData(lua_State *L) {
+  if (!hello::gl::getExtensions().copyBuffer) {
+    return luaL_error(L, "copyBufferSubData is not supported.");
+  }
+  auto readTarget = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto writeTarget = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto readOffset = static_cast<GLintptr>(luaL_checkinteger(L, 3));
+  auto writeOffset = static_cast<GLintptr>(luaL_checkinteger(L, 4));
+  auto size = static_cast<GLsizeiptr>(luaL_checkinteger(L, 5));
+  hello::gl::copyBufferSubData(readTarget, writeTarget, readOffset,
+                               writeOffset, size);
+  return 0;
+}
+
+// indexed bindings for uniform blocks (and transform feedback). they also
+// set the generic binding of `target`, so they go through the state cache.
+int L_glBindBufferBase(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto index = static_cast<GLuint>(luaL_checkinteger(L, 2));
+  auto buffer = static_cast<GLuint>(luaL_checkinteger(L, 3));
+  getStateCache().bindBufferBase(target, index, buffer);
+  return 0;
+}
+
+int L_glBindBufferRange(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto index = static_cast<GLuint>(luaL_checkinteger(L, 2));
+  auto buffer = static_cast<GLuint>(luaL_checkinteger(L, 3));
+  auto offset = luaL_checkinteger(L, 4);
+  luaL_argcheck(L, offset >= 0, 4, "offset out of range");
+  auto size = luaL_checkinteger(L, 5);
+  luaL_argcheck(L, size > 0, 5, "size must be greater than 0");
+  getStateCache().bindBufferRange(target, index, buffer,
+                                  static_cast<intptr_t>(offset),
+                                  static_cast<intptr_t>(size));
+  return 0;
+}
+
 int L_glGenVertexArray(lua_State *L) {
   GLuint buffers[] = {0};
   glGenVertexArrays(1, buffers);
@@ -84,7 +271,7 @@ int L_glGenVertexArray(lua_State *L) {
 
 int L_glBindVertexArray(lua_State *L) {
   auto array = static_cast<GLuint>(luaL_checkinteger(L, 1));
-  glBindVertexArray(array);
+  getStateCache().bindVertexArray(array);
   return 0;
 }
 
@@ -111,7 +298,7 @@ int L_glViewport(lua_State *L) {
   auto y = static_cast<GLint>(luaL_checkinteger(L, 2));
   auto width = static_cast<GLsizei>(luaL_checkinteger(L, 3));
   auto height = static_cast<GLsizei>(luaL_checkinteger(L, 4));
-  glViewport(x, y, width, height);
+  getStateCache().viewport(x, y, width, height);
   return 0;
 }
 
@@ -127,7 +314,189 @@ int L_glDrawElements(lua_State *L) {
   auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
   auto count = static_cast<GLsizei>(luaL_checkinteger(L, 2));
   auto type = static_cast<GLenum>(luaL_checkinteger(L, 3));
-  glDrawElements(mode, count, type, nullptr);
+  auto offset = luaL_optinteger(L, 4, 0);
+  luaL_argcheck(L, offset >= 0, 4, "offset out of range");
+  glDrawElements(mode, count, type,
+                 reinterpret_cast<const void *>(static_cast<intptr_t>(offset)));
+  return 0;
+}
+
+// GL.drawElementsBaseVertex(mode, count, type, offset, baseVertex) adds
+// baseVertex to every index, so meshes packed into one vertex buffer can
+// keep indices that start at 0. see GL.getExtensions().baseVertex.
+int L_glDrawElementsBaseVertex(lua_State *L) {
+  if (!hello::gl::getExtensions().baseVertex) {
+    return luaL_error(L, "drawElementsBaseVertex is not supported.");
+  }
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto count = static_cast<GLsizei>(luaL_checkinteger(L, 2));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 3));
+  auto offset = luaL_checkinteger(L, 4);
+  luaL_argcheck(L, offset >= 0, 4, "offset out of range");
+  auto baseVertex = static_cast<GLint>(luaL_checkinteger(L, 5));
+  hello::gl::drawElementsBaseVertex(
+      mode, count, type,
+      reinterpret_cast<const void *>(static_cast<intptr_t>(offset)),
+      baseVertex);
+  return 0;
+}
+
+int L_glDrawArraysInstanced(lua_State *L) {
+  if (!hello::gl::getExtensions().instancing) {
+    return luaL_error(L, "drawArraysInstanced is not supported.");
+  }
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto first = static_cast<GLint>(luaL_checkinteger(L, 2));
+  auto count = static_cast<GLsizei>(luaL_checkinteger(L, 3));
+  auto instanceCount = static_cast<GLsizei>(luaL_checkinteger(L, 4));
+  hello::gl::drawArraysInstanced(mode, first, count, instanceCount);
+  return 0;
+}
+
+int L_glDrawElementsInstanced(lua_State *L) {
+  if (!hello::gl::getExtensions().instancing) {
+    return luaL_error(L, "drawElementsInstanced is not supported.");
+  }
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto count = static_cast<GLsizei>(luaL_checkinteger(L, 2));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 3));
+  auto offset = luaL_checkinteger(L, 4);
+  luaL_argcheck(L, offset >= 0, 4, "offset out of range");
+  auto instanceCount = static_cast<GLsizei>(luaL_checkinteger(L, 5));
+  hello::gl::drawElementsInstanced(
+      mode, count, type,
+      reinterpret_cast<const void *>(static_cast<intptr_t>(offset)),
+      instanceCount);
+  return 0;
+}
+
+// attributes with a divisor of n advance once every n instances instead
+// of once per vertex; 0 restores per-vertex attributes
+int L_glVertexAttribDivisor(lua_State *L) {
+  if (!hello::gl::getExtensions().instancing) {
+    return luaL_error(L, "vertexAttribDivisor is not supported.");
+  }
+  auto index = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  auto divisor = static_cast<GLuint>(luaL_checkinteger(L, 2));
+  hello::gl::vertexAttribDivisor(index, divisor);
+  return 0;
+}
+
+// the integers of the sequence at `arg`, checked to be at least `min`
+template <typename T>
+std::vector<T> checkIntegers(lua_State *L, int arg, lua_Integer min) {
+  luaL_checktype(L, arg, LUA_TTABLE);
+  const auto count = luaL_len(L, arg);
+  std::vector<T> values;
+  values.reserve(static_cast<size_t>(count));
+  for (lua_Integer i = 1; i <= count; ++i) {
+    lua_geti(L, arg, i);
+    auto isInteger = 0;
+    auto value = lua_tointegerx(L, -1, &isInteger);
+    lua_pop(L, 1);
+    luaL_argcheck(L, isInteger != 0 && value >= min, arg,
+                  "integers out of range");
+    values.push_back(static_cast<T>(value));
+  }
+  return values;
+}
+
+// GL.multiDrawArrays(mode, {first, ...}, {count, ...}) issues every range
+// in one call. WebGL has no multi-draw, so there they are looped natively.
+int L_glMultiDrawArrays(lua_State *L) {
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto firsts = checkIntegers<GLint>(L, 2, 0);
+  auto counts = checkIntegers<GLsizei>(L, 3, 0);
+  luaL_argcheck(L, counts.size() == firsts.size(), 3,
+                "specify as many counts as firsts");
+  hello::gl::multiDrawArrays(mode, firsts.data(), counts.data(),
+                             static_cast<GLsizei>(counts.size()));
+  return 0;
+}
+
+// GL.multiDrawElements(mode, {count, ...}, type, {offset, ...}) with the
+// byte offsets into the bound element array buffer
+int L_glMultiDrawElements(lua_State *L) {
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto counts = checkIntegers<GLsizei>(L, 2, 0);
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 3));
+  auto offsets = checkIntegers<intptr_t>(L, 4, 0);
+  luaL_argcheck(L, offsets.size() == counts.size(), 4,
+                "specify as many offsets as counts");
+  std::vector<const void *> indices(offsets.size());
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    indices[i] = reinterpret_cast<const void *>(offsets[i]);
+  }
+  hello::gl::multiDrawElements(mode, counts.data(), type, indices.data(),
+                               static_cast<GLsizei>(counts.size()));
+  return 0;
+}
+
+// the indirect draws read their parameters at byte `offset` of the buffer
+// bound to GL.DRAW_INDIRECT_BUFFER, e.g. the commands of a GL_DrawList.
+// see GL.getExtensions().drawIndirect and .multiDrawIndirect.
+int L_glDrawArraysIndirect(lua_State *L) {
+  if (!hello::gl::getExtensions().drawIndirect) {
+    return luaL_error(L, "drawArraysIndirect is not supported.");
+  }
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto offset = luaL_optinteger(L, 2, 0);
+  luaL_argcheck(L, offset >= 0, 2, "offset out of range");
+  hello::gl::drawArraysIndirect(
+      mode, reinterpret_cast<const void *>(static_cast<intptr_t>(offset)));
+  return 0;
+}
+
+int L_glDrawElementsIndirect(lua_State *L) {
+  if (!hello::gl::getExtensions().drawIndirect) {
+    return luaL_error(L, "drawElementsIndirect is not supported.");
+  }
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto offset = luaL_optinteger(L, 3, 0);
+  luaL_argcheck(L, offset >= 0, 3, "offset out of range");
+  hello::gl::drawElementsIndirect(
+      mode, type,
+      reinterpret_cast<const void *>(static_cast<intptr_t>(offset)));
+  return 0;
+}
+
+// GL.multiDrawArraysIndirect(mode, offset, drawCount[, stride]); a stride
+// of 0 means tightly packed commands
+int L_glMultiDrawArraysIndirect(lua_State *L) {
+  if (!hello::gl::getExtensions().multiDrawIndirect) {
+    return luaL_error(L, "multiDrawArraysIndirect is not supported.");
+  }
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto offset = luaL_checkinteger(L, 2);
+  luaL_argcheck(L, offset >= 0, 2, "offset out of range");
+  auto drawCount = luaL_checkinteger(L, 3);
+  luaL_argcheck(L, drawCount >= 0, 3, "drawCount out of range");
+  auto stride = luaL_optinteger(L, 4, 0);
+  luaL_argcheck(L, stride >= 0, 4, "stride out of range");
+  hello::gl::multiDrawArraysIndirect(
+      mode, reinterpret_cast<const void *>(static_cast<intptr_t>(offset)),
+      static_cast<GLsizei>(drawCount), static_cast<GLsizei>(stride));
+  return 0;
+}
+
+// GL.multiDrawElementsIndirect(mode, type, offset, drawCount[, stride])
+int L_glMultiDrawElementsIndirect(lua_State *L) {
+  if (!hello::gl::getExtensions().multiDrawIndirect) {
+    return luaL_error(L, "multiDrawElementsIndirect is not supported.");
+  }
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto offset = luaL_checkinteger(L, 3);
+  luaL_argcheck(L, offset >= 0, 3, "offset out of range");
+  auto drawCount = luaL_checkinteger(L, 4);
+  luaL_argcheck(L, drawCount >= 0, 4, "drawCount out of range");
+  auto stride = luaL_optinteger(L, 5, 0);
+  luaL_argcheck(L, stride >= 0, 5, "stride out of range");
+  hello::gl::multiDrawElementsIndirect(
+      mode, type,
+      reinterpret_cast<const void *>(static_cast<intptr_t>(offset)),
+      static_cast<GLsizei>(drawCount), static_cast<GLsizei>(stride));
   return 0;
 }
 
@@ -240,7 +609,7 @@ int L_glGetProgramInfoLog(lua_State *L) {
 
 int L_glUseProgram(lua_State *L) {
   auto program = static_cast<GLuint>(luaL_checkinteger(L, 1));
-  glUseProgram(program);
+  getStateCache().useProgram(program);
   return 0;
 }
 
@@ -251,6 +620,74 @@ int L_glUniform1i(lua_State *L) {
   return 0;
 }
 
+int L_glUniform1f(lua_State *L) {
+  auto location = static_cast<GLint>(luaL_checkinteger(L, 1));
+  auto v0 = static_cast<GLfloat>(luaL_checknumber(L, 2));
+  glUniform1f(location, v0);
+  return 0;
+}
+
+int L_glUniform2f(lua_State *L) {
+  auto location = static_cast<GLint>(luaL_checkinteger(L, 1));
+  auto v0 = static_cast<GLfloat>(luaL_checknumber(L, 2));
+  auto v1 = static_cast<GLfloat>(luaL_checknumber(L, 3));
+  glUniform2f(location, v0, v1);
+  return 0;
+}
+
+int L_glUniform3f(lua_State *L) {
+  auto location = static_cast<GLint>(luaL_checkinteger(L, 1));
+  auto v0 = static_cast<GLfloat>(luaL_checknumber(L, 2));
+  auto v1 = static_cast<GLfloat>(luaL_checknumber(L, 3));
+  auto v2 = static_cast<GLfloat>(luaL_checknumber(L, 4));
+  glUniform3f(location, v0, v1, v2);
+  return 0;
+}
+
+int L_glUniform4f(lua_State *L) {
+  auto location = static_cast<GLint>(luaL_checkinteger(L, 1));
+  auto v0 = static_cast<GLfloat>(luaL_checknumber(L, 2));
+  auto v1 = static_cast<GLfloat>(luaL_checknumber(L, 3));
+  auto v2 = static_cast<GLfloat>(luaL_checknumber(L, 4));
+  auto v3 = static_cast<GLfloat>(luaL_checknumber(L, 5));
+  glUniform4f(location, v0, v1, v2, v3);
+  return 0;
+}
+
+int L_glGetUniformBlockIndex(lua_State *L) {
+  if (!hello::gl::getExtensions().uniformBuffer) {
+    return luaL_error(L, "getUniformBlockIndex is not supported.");
+  }
+  auto program = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  auto name = luaL_checkstring(L, 2);
+  auto index = hello::gl::getUniformBlockIndex(program, name);
+  if (index == GL_INVALID_INDEX) {
+    lua_pushnil(L);
+    return 1;
+  }
+  lua_pushinteger(L, index);
+  return 1;
+}
+
+int L_glUniformBlockBinding(lua_State *L) {
+  if (!hello::gl::getExtensions().uniformBuffer) {
+    return luaL_error(L, "uniformBlockBinding is not supported.");
+  }
+  auto program = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  auto blockIndex = static_cast<GLuint>(luaL_checkinteger(L, 2));
+  auto binding = static_cast<GLuint>(luaL_checkinteger(L, 3));
+  hello::gl::uniformBlockBinding(program, blockIndex, binding);
+  return 0;
+}
+
+int L_glGetInteger(lua_State *L) {
+  auto pname = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  GLint params[] = {0};
+  glGetIntegerv(pname, params);
+  lua_pushinteger(L, params[0]);
+  return 1;
+}
+
 int L_glGenTexture(lua_State *L) {
   GLuint textures[] = {0};
   glGenTextures(1, textures);
@@ -258,6 +695,145 @@ int L_glGenTexture(lua_State *L) {
   return 1;
 }
 
+GLsizei getPixelSize(GLenum format, GLenum type) {
+  switch (type) {
+  case GL_UNSIGNED_SHORT_5_6_5:
+  case GL_UNSIGNED_SHORT_4_4_4_4:
+  case GL_UNSIGNED_SHORT_5_5_5_1:
+    return 2;
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_10F_11F_11F_REV:
+  case GL_UNSIGNED_INT_5_9_9_9_REV:
+  case GL_UNSIGNED_INT_24_8:
+    return 4;
+  }
+
+  GLsizei components = 0;
+  switch (format) {
+  case GL_RED:
+  case GL_RED_INTEGER:
+  case GL_ALPHA:
+  case GL_DEPTH_COMPONENT:
+    components = 1;
+    break;
+  case GL_RG:
+  case GL_RG_INTEGER:
+    components = 2;
+    break;
+  case GL_RGB:
+  case GL_RGB_INTEGER:
+    components = 3;
+    break;
+  case GL_RGBA:
+  case GL_RGBA_INTEGER:
+    components = 4;
+    break;
+  default:
+    return 0;
+  }
+
+  switch (type) {
+  case GL_BYTE:
+  case GL_UNSIGNED_BYTE:
+    return components;
+  case GL_SHORT:
+  case GL_UNSIGNED_SHORT:
+  case GL_HALF_FLOAT:
+    return components * 2;
+  case GL_INT:
+  case GL_UNSIGNED_INT:
+  case GL_FLOAT:
+    return components * 4;
+  default:
+    return 0;
+  }
+}
+
+// bytes from one row of a `width` pixel image to the next under the pack
+// or unpack row length and alignment.
+size_t getRowStride(GLsizei width, GLsizei pixelSize, bool pack) {
+  GLint alignment = 4;
+  GLint rowLength = 0;
+  glGetIntegerv(pack ? GL_PACK_ALIGNMENT : GL_UNPACK_ALIGNMENT, &alignment);
+  glGetIntegerv(pack ? GL_PACK_ROW_LENGTH : GL_UNPACK_ROW_LENGTH, &rowLength);
+  const auto rowPixels = rowLength > 0 ? rowLength : width;
+  return (static_cast<size_t>(rowPixels) * pixelSize + alignment - 1) /
+         alignment * alignment;
+}
+
+// bytes GL touches for the image. only the last row goes without padding.
+size_t getImageSize(GLsizei width, GLsizei height, GLsizei pixelSize,
+                    bool pack) {
+  if (width <= 0 || height <= 0) {
+    return 0;
+  }
+  return getRowStride(width, pixelSize, pack) * (height - 1) +
+         static_cast<size_t>(width) * pixelSize;
+}
+
+// pixels of a texture upload: a string that holds the whole image under
+// the unpack alignment, or an SDL_Surface (or a view of one) that is at
+// least width x height with the pixel size of format and type. `surface`
+// is set for the latter.
+const void *checkPixels(lua_State *L, int arg, GLsizei width, GLsizei height,
+                        GLenum format, GLenum type, SDL_Surface **surface) {
+  if (lua_isstring(L, arg)) {
+    size_t size;
+    auto data = luaL_checklstring(L, arg, &size);
+    luaL_argcheck(L, size > 0, arg, "size must be breater than 0");
+    const auto pixelSize = getPixelSize(format, type);
+    luaL_argcheck(L,
+                  pixelSize == 0 ||
+                      size >= getImageSize(width, height, pixelSize, false),
+                  arg, "pixels are smaller than the upload");
+    return data;
+  }
+  auto pudSurface = hello::lua::sdl2_image::get(L, arg);
+  luaL_argcheck(L, pudSurface != nullptr && pudSurface->surface != nullptr,
+                arg, "specify SDL_Surface or Buffer");
+  luaL_argcheck(L,
+                width <= pudSurface->surface->w &&
+                    height <= pudSurface->surface->h,
+                arg, "surface is smaller than the upload");
+  luaL_argcheck(L,
+                getPixelSize(format, type) ==
+                    pudSurface->surface->format->BytesPerPixel,
+                arg, "surface pixels do not match format and type");
+  *surface = pudSurface->surface;
+  return pudSurface->surface->pixels;
+}
+
+// points the unpack row length and alignment at the surface's pitch, so
+// padded surfaces and views upload row by row. the previous values go to
+// `saved` for endSurfaceUnpack.
+void beginSurfaceUnpack(lua_State *L, int arg, SDL_Surface *surface,
+                        GLint saved[2]) {
+  const auto bytesPerPixel = surface->format->BytesPerPixel;
+  luaL_argcheck(L, bytesPerPixel > 0, arg, "unsupported pixel format");
+  const auto rowLength = surface->pitch / bytesPerPixel;
+  const auto packed = rowLength * bytesPerPixel;
+  auto alignment = packed == surface->pitch ? 1 : 0;
+  for (int a = 2; a <= 8 && alignment == 0; a *= 2) {
+    if ((packed + a - 1) / a * a == surface->pitch) {
+      alignment = a;
+    }
+  }
+  luaL_argcheck(L, alignment != 0, arg,
+                "surface pitch is not a GL row length and alignment");
+
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &saved[0]);
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &saved[1]);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  SDL_LockSurface(surface);
+}
+
+void endSurfaceUnpack(SDL_Surface *surface, const GLint saved[2]) {
+  SDL_UnlockSurface(surface);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, saved[0]);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, saved[1]);
+}
+
 int L_glTexImage2D(lua_State *L) {
   auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
   auto level = static_cast<GLint>(luaL_checkinteger(L, 2));
@@ -269,22 +845,65 @@ int L_glTexImage2D(lua_State *L) {
   auto type = static_cast<GLenum>(luaL_checkinteger(L, 8));
 
   const void *pixels = nullptr;
+  SDL_Surface *surface = nullptr;
   if (!lua_isnoneornil(L, 9)) {
-    if (lua_isstring(L, 9)) {
-      size_t size;
-      auto data = luaL_checklstring(L, 9, &size);
-      luaL_argcheck(L, size > 0, 9, "size must be breater than 0");
-      pixels = data;
-    } else {
-      auto pudSurface = hello::lua::sdl2_image::get(L, 9);
-      luaL_argcheck(L, pudSurface->surface != nullptr, 9,
-                    "specify SDL_Surface or Buffer");
-      pixels = pudSurface->surface->pixels;
-    }
+    pixels = checkPixels(L, 9, width, height, format, type, &surface);
   }
 
+  GLint saved[2];
+  if (surface != nullptr) {
+    beginSurfaceUnpack(L, 9, surface, saved);
+    // RLE surfaces only have plain pixels while locked
+    pixels = surface->pixels;
+  }
   glTexImage2D(target, level, internalformat, width, height, border, format,
                type, pixels);
+  if (surface != nullptr) {
+    endSurfaceUnpack(surface, saved);
+  }
+  return 0;
+}
+
+int L_glTexSubImage2D(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto level = static_cast<GLint>(luaL_checkinteger(L, 2));
+  auto xoffset = static_cast<GLint>(luaL_checkinteger(L, 3));
+  auto yoffset = static_cast<GLint>(luaL_checkinteger(L, 4));
+  auto width = static_cast<GLsizei>(luaL_checkinteger(L, 5));
+  auto height = static_cast<GLsizei>(luaL_checkinteger(L, 6));
+  auto format = static_cast<GLenum>(luaL_checkinteger(L, 7));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 8));
+
+  SDL_Surface *surface = nullptr;
+  const void *pixels = checkPixels(L, 9, width, height, format, type, &surface);
+
+  GLint saved[2];
+  if (surface != nullptr) {
+    beginSurfaceUnpack(L, 9, surface, saved);
+    // RLE surfaces only have plain pixels while locked
+    pixels = surface->pixels;
+  }
+  glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type,
+                  pixels);
+  if (surface != nullptr) {
+    endSurfaceUnpack(surface, saved);
+  }
+  return 0;
+}
+
+int L_glCompressedTexImage2D(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto level = static_cast<GLint>(luaL_checkinteger(L, 2));
+  auto internalformat = static_cast<GLenum>(luaL_checkinteger(L, 3));
+  auto width = static_cast<GLsizei>(luaL_checkinteger(L, 4));
+  auto height = static_cast<GLsizei>(luaL_checkinteger(L, 5));
+  auto border = static_cast<GLint>(luaL_checkinteger(L, 6));
+  size_t size;
+  auto data = luaL_checklstring(L, 7, &size);
+  luaL_argcheck(L, size > 0, 7, "size must be breater than 0");
+
+  glCompressedTexImage2D(target, level, internalformat, width, height, border,
+                         static_cast<GLsizei>(size), data);
   return 0;
 }
 
@@ -306,13 +925,13 @@ int L_glPixelStorei(lua_State *L) {
 int L_glBindTexture(lua_State *L) {
   auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
   auto texture = static_cast<GLuint>(luaL_checkinteger(L, 2));
-  glBindTexture(target, texture);
+  getStateCache().bindTexture(target, texture);
   return 0;
 }
 
 int L_glActivateTexture(lua_State *L) {
   auto texture = static_cast<GLenum>(luaL_checkinteger(L, 1));
-  glActiveTexture(texture);
+  getStateCache().activeTexture(texture);
   return 0;
 }
 
@@ -320,6 +939,7 @@ int L_glDeleteTexture(lua_State *L) {
   auto texture = static_cast<GLuint>(luaL_checkinteger(L, 1));
   GLuint textures[] = {texture};
   glDeleteTextures(1, textures);
+  getStateCache().textureDeleted(texture);
   return 0;
 }
 
@@ -333,7 +953,7 @@ int L_glGenFramebuffer(lua_State *L) {
 int L_glBindFramebuffer(lua_State *L) {
   auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
   auto framebuffer = static_cast<GLuint>(luaL_checkinteger(L, 2));
-  glBindFramebuffer(target, framebuffer);
+  getStateCache().bindFramebuffer(target, framebuffer);
   return 0;
 }
 
@@ -341,6 +961,7 @@ int L_glDeleteFramebuffer(lua_State *L) {
   auto fbo = static_cast<GLuint>(luaL_checkinteger(L, 1));
   GLuint framebuffers[] = {fbo};
   glDeleteFramebuffers(1, framebuffers);
+  getStateCache().framebufferDeleted(fbo);
   return 0;
 }
 
@@ -394,1532 +1015,1806 @@ int L_glFramebufferTexture2D(lua_State *L) {
   return 0;
 }
 
-int lua_pushConstants(lua_State *L, int idx) {
-  if (idx < 0) {
-    idx = idx - 1;
-  }
-
-  lua_pushinteger(L, GL_DEPTH_BUFFER_BIT);
-  lua_setfield(L, idx, "DEPTH_BUFFER_BIT");
+int L_glCheckFramebufferStatus(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto status = glCheckFramebufferStatus(target);
+  lua_pushinteger(L, status);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_STENCIL_BUFFER_BIT);
-  lua_setfield(L, idx, "STENCIL_BUFFER_BIT");
+int L_glFlush(lua_State *) {
+  glFlush();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_BUFFER_BIT);
-  lua_setfield(L, idx, "COLOR_BUFFER_BIT");
+int L_glFinish(lua_State *) {
+  glFinish();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FALSE);
-  lua_setfield(L, idx, "FALSE");
+int L_glGenQuery(lua_State *L) {
+  GLuint queries[] = {0};
+  glGenQueries(1, queries);
+  lua_pushinteger(L, queries[0]);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_TRUE);
-  lua_setfield(L, idx, "TRUE");
+int L_glDeleteQuery(lua_State *L) {
+  GLuint queries[] = {0};
+  queries[0] = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  glDeleteQueries(1, queries);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_POINTS);
-  lua_setfield(L, idx, "POINTS");
+int L_glBeginQuery(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto id = static_cast<GLuint>(luaL_checkinteger(L, 2));
+  glBeginQuery(target, id);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_LINES);
-  lua_setfield(L, idx, "LINES");
+int L_glEndQuery(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  glEndQuery(target);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_LINE_LOOP);
-  lua_setfield(L, idx, "LINE_LOOP");
+// GL.queryCounter(id, GL.TIMESTAMP) records the GPU time once the commands
+// before it have finished. see GL.getExtensions().timerQuery.
+int L_glQueryCounter(lua_State *L) {
+  if (!hello::gl::getExtensions().timerQuery) {
+    return luaL_error(L, "queryCounter is not supported.");
+  }
+  auto id = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  hello::gl::queryCounter(id, target);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_LINE_STRIP);
-  lua_setfield(L, idx, "LINE_STRIP");
+int L_glGetQueryObjectuiv(lua_State *L) {
+  auto id = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  auto pname = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  GLuint params[] = {0};
+  glGetQueryObjectuiv(id, pname, params);
+  lua_pushinteger(L, params[0]);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_TRIANGLES);
-  lua_setfield(L, idx, "TRIANGLES");
+// nanoseconds for timer queries, which overflow 32 bits after 4 seconds
+int L_glGetQueryObjectui64v(lua_State *L) {
+  if (!hello::gl::getExtensions().timerQuery) {
+    return luaL_error(L, "getQueryObjectui64v is not supported.");
+  }
+  auto id = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  auto pname = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  GLuint64 params[] = {0};
+  hello::gl::getQueryObjectui64v(id, pname, params);
+  lua_pushinteger(L, static_cast<lua_Integer>(params[0]));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_TRIANGLE_STRIP);
-  lua_setfield(L, idx, "TRIANGLE_STRIP");
+// GL.readPixels(x, y, width, height, format, type) returns the pixels as a
+// string, waiting for the GPU. with an offset it instead queues the copy
+// into the buffer bound to GL.PIXEL_PACK_BUFFER and returns at once.
+int L_glReadPixels(lua_State *L) {
+  auto x = static_cast<GLint>(luaL_checkinteger(L, 1));
+  auto y = static_cast<GLint>(luaL_checkinteger(L, 2));
+  auto width = static_cast<GLsizei>(luaL_checkinteger(L, 3));
+  auto height = static_cast<GLsizei>(luaL_checkinteger(L, 4));
+  auto format = static_cast<GLenum>(luaL_checkinteger(L, 5));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 6));
+  const auto pixelSize = getPixelSize(format, type);
+  luaL_argcheck(L, pixelSize > 0, 6, "unsupported format/type pair");
+
+  const auto size = getImageSize(width, height, pixelSize, true);
+  luaL_argcheck(L, size > 0, 3, "size must be greater than 0");
+
+  if (!lua_isnoneornil(L, 7)) {
+    auto offset = luaL_checkinteger(L, 7);
+    luaL_argcheck(L, offset >= 0, 7, "offset out of range");
+    // without a pack buffer the offset would be taken for an address
+    GLint packBuffer = 0;
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+    luaL_argcheck(L, packBuffer != 0, 7,
+                  "an offset needs a bound PIXEL_PACK_BUFFER");
+    glReadPixels(x, y, width, height, format, type,
+                 reinterpret_cast<void *>(static_cast<intptr_t>(offset)));
+    return 0;
+  }
 
-  lua_pushinteger(L, GL_TRIANGLE_FAN);
-  lua_setfield(L, idx, "TRIANGLE_FAN");
+  luaL_Buffer buffer;
+  auto pixels = luaL_buffinitsize(L, &buffer, size);
+  glReadPixels(x, y, width, height, format, type, pixels);
+  luaL_pushresultsize(&buffer, size);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_NEVER);
-  lua_setfield(L, idx, "NEVER");
+// GL.getBufferSubData(target, offset, size) copies bytes of the bound
+// buffer back into a string, e.g. pixels read into a pack buffer. it waits
+// for the commands writing them.
+int L_glGetBufferSubData(lua_State *L) {
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 1));
+  auto offset = luaL_checkinteger(L, 2);
+  luaL_argcheck(L, offset >= 0, 2, "offset out of range");
+  auto size = luaL_checkinteger(L, 3);
+  luaL_argcheck(L, size > 0, 3, "size must be greater than 0");
+
+  luaL_Buffer buffer;
+  auto data = luaL_buffinitsize(L, &buffer, static_cast<size_t>(size));
+  hello::gl::getBufferSubData(target, static_cast<GLintptr>(offset),
+                              static_cast<GLsizeiptr>(size), data);
+  luaL_pushresultsize(&buffer, static_cast<size_t>(size));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_LESS);
-  lua_setfield(L, idx, "LESS");
+struct UDReadback {
+  hello::gl::ReadbackRing *data;
+  // whether collect() hands out QOI files instead of raw pixels
+  bool qoi;
+};
+
+UDReadback *checkReadback(lua_State *L, int idx) {
+  auto pReadback =
+      static_cast<UDReadback *>(luaL_checkudata(L, idx, READBACK_NAME));
+  luaL_argcheck(L, pReadback->data != nullptr, idx, "already freed.");
+  return pReadback;
+}
 
-  lua_pushinteger(L, GL_EQUAL);
-  lua_setfield(L, idx, "EQUAL");
+// GL.newReadback([count[, encoding]]) reads the framebuffer back through
+// `count` pixel pack buffers without waiting for the GPU: read() queues a
+// copy, and collect(fn) calls fn(pixels, info) for every copy the GPU has
+// finished since, typically a frame or two later. encoding "qoi" delivers
+// top-down QOI files of GL.RGB / GL.RGBA bytes instead of raw rows.
+int L_newReadback(lua_State *L) {
+  static const char *const ENCODINGS[] = {"raw", "qoi", nullptr};
+  auto count = luaL_optinteger(L, 1, 3);
+  luaL_argcheck(L, count > 0 && count <= 64, 1, "count out of range");
+  auto encoding = luaL_checkoption(L, 2, "raw", ENCODINGS);
+  auto pReadback =
+      static_cast<UDReadback *>(lua_newuserdata(L, sizeof(UDReadback)));
+  pReadback->data = new hello::gl::ReadbackRing(static_cast<size_t>(count));
+  pReadback->qoi = encoding == 1;
+  luaL_setmetatable(L, READBACK_NAME);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_LEQUAL);
-  lua_setfield(L, idx, "LEQUAL");
+int L_Readback_free(lua_State *L) {
+  auto pReadback =
+      static_cast<UDReadback *>(luaL_checkudata(L, 1, READBACK_NAME));
+  delete pReadback->data;
+  pReadback->data = nullptr;
+  return 0;
+}
 
-  lua_pushinteger(L, GL_GREATER);
-  lua_setfield(L, idx, "GREATER");
+// read(x, y, width, height[, format[, type]]) returns the id of the
+// readback, or nil when every buffer is still in flight and this frame
+// has to be skipped. nil and a message once waiting for the GPU failed.
+// format and type default to GL.RGBA, GL.UNSIGNED_BYTE.
+int L_Readback_read(lua_State *L) {
+  auto pReadback = checkReadback(L, 1);
+  auto x = static_cast<GLint>(luaL_checkinteger(L, 2));
+  auto y = static_cast<GLint>(luaL_checkinteger(L, 3));
+  auto width = static_cast<GLsizei>(luaL_checkinteger(L, 4));
+  auto height = static_cast<GLsizei>(luaL_checkinteger(L, 5));
+  auto format = static_cast<GLenum>(luaL_optinteger(L, 6, GL_RGBA));
+  auto type = static_cast<GLenum>(luaL_optinteger(L, 7, GL_UNSIGNED_BYTE));
+  const auto pixelSize = getPixelSize(format, type);
+  luaL_argcheck(L, pixelSize > 0, 7, "unsupported format/type pair");
+  luaL_argcheck(L,
+                !pReadback->qoi || (type == GL_UNSIGNED_BYTE &&
+                                    (format == GL_RGB || format == GL_RGBA)),
+                6, "qoi needs GL.RGB or GL.RGBA bytes");
+
+  const auto size = getImageSize(width, height, pixelSize, true);
+  luaL_argcheck(L, size > 0, 4, "size must be greater than 0");
+
+  auto id = pReadback->data->read(x, y, width, height, format, type, size,
+                                  getRowStride(width, pixelSize, true),
+                                  getStateCache());
+  if (id == 0) {
+    lua_pushnil(L);
+    if (pReadback->data->isLost()) {
+      lua_pushstring(L, "waiting for the GPU failed.");
+      return 2;
+    }
+    return 1;
+  }
+  lua_pushinteger(L, static_cast<lua_Integer>(id));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_NOTEQUAL);
-  lua_setfield(L, idx, "NOTEQUAL");
+void pushReadbackInfo(lua_State *L, const hello::gl::ReadbackInfo &info) {
+  lua_createtable(L, 0, 7);
+  lua_pushinteger(L, static_cast<lua_Integer>(info.id));
+  lua_setfield(L, -2, "id");
+  lua_pushinteger(L, info.x);
+  lua_setfield(L, -2, "x");
+  lua_pushinteger(L, info.y);
+  lua_setfield(L, -2, "y");
+  lua_pushinteger(L, info.width);
+  lua_setfield(L, -2, "width");
+  lua_pushinteger(L, info.height);
+  lua_setfield(L, -2, "height");
+  lua_pushinteger(L, info.format);
+  lua_setfield(L, -2, "format");
+  lua_pushinteger(L, info.type);
+  lua_setfield(L, -2, "type");
+}
 
-  lua_pushinteger(L, GL_GEQUAL);
-  lua_setfield(L, idx, "GEQUAL");
+// collect(fn) calls fn(pixels, {id, x, y, width, height, format, type})
+// for every finished readback, oldest first, and returns how many there
+// were, plus a message when waiting for the GPU failed and the readbacks
+// still pending were dropped. raw pixels are bottom-up rows padded to
+// GL.PACK_ALIGNMENT.
+int L_Readback_collect(lua_State *L) {
+  auto pReadback = checkReadback(L, 1);
+  luaL_checktype(L, 2, LUA_TFUNCTION);
+  lua_settop(L, 2);
+
+  // everything is copied out before anything reaches Lua, so no buffer is
+  // mapped when a string allocation or fn raises an error, or fn reads again
+  struct Collected {
+    hello::gl::ReadbackInfo info;
+    std::vector<uint8_t> data;
+  };
+  std::vector<Collected> collected;
+  std::vector<uint8_t> flipped;
+  auto count = pReadback->data->collect(
+      getStateCache(), [&](const hello::gl::ReadbackInfo &info,
+                           const uint8_t *pixels) {
+        collected.push_back({info, {}});
+        auto &data = collected.back().data;
+        if (!pReadback->qoi) {
+          data.assign(pixels, pixels + info.size);
+          return;
+        }
+        // QOI runs top-down without padding
+        const auto channels = info.format == GL_RGBA ? 4 : 3;
+        const auto rowBytes = static_cast<size_t>(info.width) * channels;
+        flipped.resize(rowBytes * static_cast<size_t>(info.height));
+        for (int32_t y = 0; y < info.height; ++y) {
+          ::memcpy(&flipped[static_cast<size_t>(y) * rowBytes],
+                   pixels + static_cast<size_t>(info.height - 1 - y) *
+                                info.rowStride,
+                   rowBytes);
+        }
+        hello::image::encodeQoi(flipped.data(), info.width, info.height,
+                                static_cast<int>(rowBytes), channels, &data);
+      });
 
-  lua_pushinteger(L, GL_ALWAYS);
-  lua_setfield(L, idx, "ALWAYS");
+  lua_newtable(L);
+  lua_Integer n = 0;
+  for (const auto &c : collected) {
+    lua_pushlstring(L, reinterpret_cast<const char *>(c.data.data()),
+                    c.data.size());
+    lua_seti(L, 3, ++n);
+    pushReadbackInfo(L, c.info);
+    lua_seti(L, 3, ++n);
+  }
+  std::vector<Collected>().swap(collected);
+  std::vector<uint8_t>().swap(flipped);
+
+  for (lua_Integer i = 1; i <= n; i += 2) {
+    lua_pushvalue(L, 2);
+    lua_geti(L, 3, i);
+    lua_geti(L, 3, i + 1);
+    lua_call(L, 2, 0);
+  }
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  if (pReadback->data->isLost()) {
+    lua_pushstring(L, "waiting for the GPU failed.");
+    return 2;
+  }
+  return 1;
+}
 
-  lua_pushinteger(L, GL_ZERO);
-  lua_setfield(L, idx, "ZERO");
+int L_Readback_getCount(lua_State *L) {
+  auto count = checkReadback(L, 1)->data->getCount();
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_ONE);
-  lua_setfield(L, idx, "ONE");
+int L_Readback_getPendingCount(lua_State *L) {
+  auto count = checkReadback(L, 1)->data->getPendingCount();
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_SRC_COLOR);
-  lua_setfield(L, idx, "SRC_COLOR");
+struct UDCommandList {
+  hello::gl::CommandList *data;
+};
 
-  lua_pushinteger(L, GL_ONE_MINUS_SRC_COLOR);
-  lua_setfield(L, idx, "ONE_MINUS_SRC_COLOR");
+hello::gl::CommandList *checkCommandList(lua_State *L, int idx) {
+  auto pList =
+      static_cast<UDCommandList *>(luaL_checkudata(L, idx, COMMAND_LIST_NAME));
+  luaL_argcheck(L, pList->data != nullptr, idx, "already freed.");
+  return pList->data;
+}
 
-  lua_pushinteger(L, GL_SRC_ALPHA);
-  lua_setfield(L, idx, "SRC_ALPHA");
+// a list whose methods take the same arguments as the GL functions of the
+// same name but only record them. every argument is checked here, once,
+// so GL.execute replays the list without touching Lua.
+int L_newCommandList(lua_State *L) {
+  auto pList =
+      static_cast<UDCommandList *>(lua_newuserdata(L, sizeof(UDCommandList)));
+  pList->data = new hello::gl::CommandList();
+  luaL_setmetatable(L, COMMAND_LIST_NAME);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_ONE_MINUS_SRC_ALPHA);
-  lua_setfield(L, idx, "ONE_MINUS_SRC_ALPHA");
+int L_CommandList___gc(lua_State *L) {
+  auto pList =
+      static_cast<UDCommandList *>(luaL_checkudata(L, 1, COMMAND_LIST_NAME));
+  delete pList->data;
+  pList->data = nullptr;
+  return 0;
+}
 
-  lua_pushinteger(L, GL_DST_ALPHA);
-  lua_setfield(L, idx, "DST_ALPHA");
+int L_CommandList_clearColor(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->clearColor(static_cast<GLfloat>(luaL_checknumber(L, 2)),
+                   static_cast<GLfloat>(luaL_checknumber(L, 3)),
+                   static_cast<GLfloat>(luaL_checknumber(L, 4)),
+                   static_cast<GLfloat>(luaL_checknumber(L, 5)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_ONE_MINUS_DST_ALPHA);
-  lua_setfield(L, idx, "ONE_MINUS_DST_ALPHA");
+int L_CommandList_clearDepth(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->clearDepth(static_cast<GLfloat>(luaL_checknumber(L, 2)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_DST_COLOR);
-  lua_setfield(L, idx, "DST_COLOR");
+int L_CommandList_clear(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->clear(static_cast<GLbitfield>(luaL_checkinteger(L, 2)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_ONE_MINUS_DST_COLOR);
-  lua_setfield(L, idx, "ONE_MINUS_DST_COLOR");
-
-  lua_pushinteger(L, GL_SRC_ALPHA_SATURATE);
-  lua_setfield(L, idx, "SRC_ALPHA_SATURATE");
-
-  lua_pushinteger(L, GL_NONE);
-  lua_setfield(L, idx, "NONE");
-
-  lua_pushinteger(L, GL_FRONT);
-  lua_setfield(L, idx, "FRONT");
-
-  lua_pushinteger(L, GL_BACK);
-  lua_setfield(L, idx, "BACK");
-
-  lua_pushinteger(L, GL_FRONT_AND_BACK);
-  lua_setfield(L, idx, "FRONT_AND_BACK");
-
-  lua_pushinteger(L, GL_NO_ERROR);
-  lua_setfield(L, idx, "NO_ERROR");
-
-  lua_pushinteger(L, GL_INVALID_ENUM);
-  lua_setfield(L, idx, "INVALID_ENUM");
-
-  lua_pushinteger(L, GL_INVALID_VALUE);
-  lua_setfield(L, idx, "INVALID_VALUE");
-
-  lua_pushinteger(L, GL_INVALID_OPERATION);
-  lua_setfield(L, idx, "INVALID_OPERATION");
-
-  lua_pushinteger(L, GL_OUT_OF_MEMORY);
-  lua_setfield(L, idx, "OUT_OF_MEMORY");
-
-  lua_pushinteger(L, GL_CW);
-  lua_setfield(L, idx, "CW");
-
-  lua_pushinteger(L, GL_CCW);
-  lua_setfield(L, idx, "CCW");
-
-  lua_pushinteger(L, GL_CULL_FACE);
-  lua_setfield(L, idx, "CULL_FACE");
-
-  lua_pushinteger(L, GL_CULL_FACE_MODE);
-  lua_setfield(L, idx, "CULL_FACE_MODE");
-
-  lua_pushinteger(L, GL_FRONT_FACE);
-  lua_setfield(L, idx, "FRONT_FACE");
-
-  lua_pushinteger(L, GL_DEPTH_RANGE);
-  lua_setfield(L, idx, "DEPTH_RANGE");
-
-  lua_pushinteger(L, GL_DEPTH_TEST);
-  lua_setfield(L, idx, "DEPTH_TEST");
-
-  lua_pushinteger(L, GL_DEPTH_WRITEMASK);
-  lua_setfield(L, idx, "DEPTH_WRITEMASK");
-
-  lua_pushinteger(L, GL_DEPTH_CLEAR_VALUE);
-  lua_setfield(L, idx, "DEPTH_CLEAR_VALUE");
-
-  lua_pushinteger(L, GL_DEPTH_FUNC);
-  lua_setfield(L, idx, "DEPTH_FUNC");
-
-  lua_pushinteger(L, GL_STENCIL_TEST);
-  lua_setfield(L, idx, "STENCIL_TEST");
-
-  lua_pushinteger(L, GL_STENCIL_CLEAR_VALUE);
-  lua_setfield(L, idx, "STENCIL_CLEAR_VALUE");
-
-  lua_pushinteger(L, GL_STENCIL_FUNC);
-  lua_setfield(L, idx, "STENCIL_FUNC");
-
-  lua_pushinteger(L, GL_STENCIL_VALUE_MASK);
-  lua_setfield(L, idx, "STENCIL_VALUE_MASK");
-
-  lua_pushinteger(L, GL_STENCIL_FAIL);
-  lua_setfield(L, idx, "STENCIL_FAIL");
-
-  lua_pushinteger(L, GL_STENCIL_PASS_DEPTH_FAIL);
-  lua_setfield(L, idx, "STENCIL_PASS_DEPTH_FAIL");
-
-  lua_pushinteger(L, GL_STENCIL_PASS_DEPTH_PASS);
-  lua_setfield(L, idx, "STENCIL_PASS_DEPTH_PASS");
-
-  lua_pushinteger(L, GL_STENCIL_REF);
-  lua_setfield(L, idx, "STENCIL_REF");
-
-  lua_pushinteger(L, GL_STENCIL_WRITEMASK);
-  lua_setfield(L, idx, "STENCIL_WRITEMASK");
-
-  lua_pushinteger(L, GL_VIEWPORT);
-  lua_setfield(L, idx, "VIEWPORT");
-
-  lua_pushinteger(L, GL_DITHER);
-  lua_setfield(L, idx, "DITHER");
-
-  lua_pushinteger(L, GL_BLEND);
-  lua_setfield(L, idx, "BLEND");
-
-  lua_pushinteger(L, GL_READ_BUFFER);
-  lua_setfield(L, idx, "READ_BUFFER");
-
-  lua_pushinteger(L, GL_SCISSOR_BOX);
-  lua_setfield(L, idx, "SCISSOR_BOX");
-
-  lua_pushinteger(L, GL_SCISSOR_TEST);
-  lua_setfield(L, idx, "SCISSOR_TEST");
-
-  lua_pushinteger(L, GL_COLOR_CLEAR_VALUE);
-  lua_setfield(L, idx, "COLOR_CLEAR_VALUE");
-
-  lua_pushinteger(L, GL_COLOR_WRITEMASK);
-  lua_setfield(L, idx, "COLOR_WRITEMASK");
-
-  lua_pushinteger(L, GL_UNPACK_ROW_LENGTH);
-  lua_setfield(L, idx, "UNPACK_ROW_LENGTH");
-
-  lua_pushinteger(L, GL_UNPACK_SKIP_ROWS);
-  lua_setfield(L, idx, "UNPACK_SKIP_ROWS");
-
-  lua_pushinteger(L, GL_UNPACK_SKIP_PIXELS);
-  lua_setfield(L, idx, "UNPACK_SKIP_PIXELS");
-
-  lua_pushinteger(L, GL_UNPACK_ALIGNMENT);
-  lua_setfield(L, idx, "UNPACK_ALIGNMENT");
-
-  lua_pushinteger(L, GL_PACK_ROW_LENGTH);
-  lua_setfield(L, idx, "PACK_ROW_LENGTH");
-
-  lua_pushinteger(L, GL_PACK_SKIP_ROWS);
-  lua_setfield(L, idx, "PACK_SKIP_ROWS");
-
-  lua_pushinteger(L, GL_PACK_SKIP_PIXELS);
-  lua_setfield(L, idx, "PACK_SKIP_PIXELS");
-
-  lua_pushinteger(L, GL_PACK_ALIGNMENT);
-  lua_setfield(L, idx, "PACK_ALIGNMENT");
-
-  lua_pushinteger(L, GL_MAX_TEXTURE_SIZE);
-  lua_setfield(L, idx, "MAX_TEXTURE_SIZE");
-
-  lua_pushinteger(L, GL_MAX_VIEWPORT_DIMS);
-  lua_setfield(L, idx, "MAX_VIEWPORT_DIMS");
-
-  lua_pushinteger(L, GL_SUBPIXEL_BITS);
-  lua_setfield(L, idx, "SUBPIXEL_BITS");
-
-  lua_pushinteger(L, GL_TEXTURE_2D);
-  lua_setfield(L, idx, "TEXTURE_2D");
-
-  lua_pushinteger(L, GL_DONT_CARE);
-  lua_setfield(L, idx, "DONT_CARE");
-
-  lua_pushinteger(L, GL_FASTEST);
-  lua_setfield(L, idx, "FASTEST");
-
-  lua_pushinteger(L, GL_NICEST);
-  lua_setfield(L, idx, "NICEST");
-
-  lua_pushinteger(L, GL_BYTE);
-  lua_setfield(L, idx, "BYTE");
-
-  lua_pushinteger(L, GL_UNSIGNED_BYTE);
-  lua_setfield(L, idx, "UNSIGNED_BYTE");
-
-  lua_pushinteger(L, GL_SHORT);
-  lua_setfield(L, idx, "SHORT");
-
-  lua_pushinteger(L, GL_UNSIGNED_SHORT);
-  lua_setfield(L, idx, "UNSIGNED_SHORT");
-
-  lua_pushinteger(L, GL_INT);
-  lua_setfield(L, idx, "INT");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT);
-  lua_setfield(L, idx, "UNSIGNED_INT");
-
-  lua_pushinteger(L, GL_FLOAT);
-  lua_setfield(L, idx, "FLOAT");
-
-  lua_pushinteger(L, GL_INVERT);
-  lua_setfield(L, idx, "INVERT");
-
-  lua_pushinteger(L, GL_TEXTURE);
-  lua_setfield(L, idx, "TEXTURE");
-
-  lua_pushinteger(L, GL_COLOR);
-  lua_setfield(L, idx, "COLOR");
-
-  lua_pushinteger(L, GL_DEPTH);
-  lua_setfield(L, idx, "DEPTH");
-
-  lua_pushinteger(L, GL_STENCIL);
-  lua_setfield(L, idx, "STENCIL");
-
-  lua_pushinteger(L, GL_DEPTH_COMPONENT);
-  lua_setfield(L, idx, "DEPTH_COMPONENT");
-
-  lua_pushinteger(L, GL_RED);
-  lua_setfield(L, idx, "RED");
-
-  lua_pushinteger(L, GL_GREEN);
-  lua_setfield(L, idx, "GREEN");
-
-  lua_pushinteger(L, GL_BLUE);
-  lua_setfield(L, idx, "BLUE");
-
-  lua_pushinteger(L, GL_ALPHA);
-  lua_setfield(L, idx, "ALPHA");
-
-  lua_pushinteger(L, GL_RGB);
-  lua_setfield(L, idx, "RGB");
-
-  lua_pushinteger(L, GL_RGBA);
-  lua_setfield(L, idx, "RGBA");
-
-  lua_pushinteger(L, GL_KEEP);
-  lua_setfield(L, idx, "KEEP");
-
-  lua_pushinteger(L, GL_REPLACE);
-  lua_setfield(L, idx, "REPLACE");
-
-  lua_pushinteger(L, GL_INCR);
-  lua_setfield(L, idx, "INCR");
-
-  lua_pushinteger(L, GL_DECR);
-  lua_setfield(L, idx, "DECR");
-
-  lua_pushinteger(L, GL_VENDOR);
-  lua_setfield(L, idx, "VENDOR");
-
-  lua_pushinteger(L, GL_RENDERER);
-  lua_setfield(L, idx, "RENDERER");
-
-  lua_pushinteger(L, GL_VERSION);
-  lua_setfield(L, idx, "VERSION");
-
-  lua_pushinteger(L, GL_EXTENSIONS);
-  lua_setfield(L, idx, "EXTENSIONS");
-
-  lua_pushinteger(L, GL_NEAREST);
-  lua_setfield(L, idx, "NEAREST");
-
-  lua_pushinteger(L, GL_LINEAR);
-  lua_setfield(L, idx, "LINEAR");
-
-  lua_pushinteger(L, GL_NEAREST_MIPMAP_NEAREST);
-  lua_setfield(L, idx, "NEAREST_MIPMAP_NEAREST");
-
-  lua_pushinteger(L, GL_LINEAR_MIPMAP_NEAREST);
-  lua_setfield(L, idx, "LINEAR_MIPMAP_NEAREST");
-
-  lua_pushinteger(L, GL_NEAREST_MIPMAP_LINEAR);
-  lua_setfield(L, idx, "NEAREST_MIPMAP_LINEAR");
-
-  lua_pushinteger(L, GL_LINEAR_MIPMAP_LINEAR);
-  lua_setfield(L, idx, "LINEAR_MIPMAP_LINEAR");
-
-  lua_pushinteger(L, GL_TEXTURE_MAG_FILTER);
-  lua_setfield(L, idx, "TEXTURE_MAG_FILTER");
-
-  lua_pushinteger(L, GL_TEXTURE_MIN_FILTER);
-  lua_setfield(L, idx, "TEXTURE_MIN_FILTER");
-
-  lua_pushinteger(L, GL_TEXTURE_WRAP_S);
-  lua_setfield(L, idx, "TEXTURE_WRAP_S");
-
-  lua_pushinteger(L, GL_TEXTURE_WRAP_T);
-  lua_setfield(L, idx, "TEXTURE_WRAP_T");
-
-  lua_pushinteger(L, GL_REPEAT);
-  lua_setfield(L, idx, "REPEAT");
-
-  lua_pushinteger(L, GL_POLYGON_OFFSET_UNITS);
-  lua_setfield(L, idx, "POLYGON_OFFSET_UNITS");
-
-  lua_pushinteger(L, GL_POLYGON_OFFSET_FILL);
-  lua_setfield(L, idx, "POLYGON_OFFSET_FILL");
-
-  lua_pushinteger(L, GL_POLYGON_OFFSET_FACTOR);
-  lua_setfield(L, idx, "POLYGON_OFFSET_FACTOR");
-
-  lua_pushinteger(L, GL_TEXTURE_BINDING_2D);
-  lua_setfield(L, idx, "TEXTURE_BINDING_2D");
-  lua_pushinteger(L, GL_RGB8);
-  lua_setfield(L, idx, "RGB8");
-
-  lua_pushinteger(L, GL_RGBA4);
-  lua_setfield(L, idx, "RGBA4");
-
-  lua_pushinteger(L, GL_RGB5_A1);
-  lua_setfield(L, idx, "RGB5_A1");
-
-  lua_pushinteger(L, GL_RGBA8);
-  lua_setfield(L, idx, "RGBA8");
-
-  lua_pushinteger(L, GL_RGB10_A2);
-  lua_setfield(L, idx, "RGB10_A2");
-
-  lua_pushinteger(L, GL_UNSIGNED_SHORT_4_4_4_4);
-  lua_setfield(L, idx, "UNSIGNED_SHORT_4_4_4_4");
-
-  lua_pushinteger(L, GL_UNSIGNED_SHORT_5_5_5_1);
-  lua_setfield(L, idx, "UNSIGNED_SHORT_5_5_5_1");
-
-  lua_pushinteger(L, GL_TEXTURE_BINDING_3D);
-  lua_setfield(L, idx, "TEXTURE_BINDING_3D");
-
-  lua_pushinteger(L, GL_UNPACK_SKIP_IMAGES);
-  lua_setfield(L, idx, "UNPACK_SKIP_IMAGES");
-
-  lua_pushinteger(L, GL_UNPACK_IMAGE_HEIGHT);
-  lua_setfield(L, idx, "UNPACK_IMAGE_HEIGHT");
-
-  lua_pushinteger(L, GL_TEXTURE_3D);
-  lua_setfield(L, idx, "TEXTURE_3D");
-
-  lua_pushinteger(L, GL_TEXTURE_WRAP_R);
-  lua_setfield(L, idx, "TEXTURE_WRAP_R");
-
-  lua_pushinteger(L, GL_MAX_3D_TEXTURE_SIZE);
-  lua_setfield(L, idx, "MAX_3D_TEXTURE_SIZE");
-
-  lua_pushinteger(L, GL_UNSIGNED_SHORT_5_6_5);
-  lua_setfield(L, idx, "UNSIGNED_SHORT_5_6_5");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_2_10_10_10_REV);
-  lua_setfield(L, idx, "UNSIGNED_INT_2_10_10_10_REV");
-
-  lua_pushinteger(L, GL_MAX_ELEMENTS_VERTICES);
-  lua_setfield(L, idx, "MAX_ELEMENTS_VERTICES");
-
-  lua_pushinteger(L, GL_MAX_ELEMENTS_INDICES);
-  lua_setfield(L, idx, "MAX_ELEMENTS_INDICES");
-
-  lua_pushinteger(L, GL_CLAMP_TO_EDGE);
-  lua_setfield(L, idx, "CLAMP_TO_EDGE");
-
-  lua_pushinteger(L, GL_TEXTURE_MIN_LOD);
-  lua_setfield(L, idx, "TEXTURE_MIN_LOD");
-
-  lua_pushinteger(L, GL_TEXTURE_MAX_LOD);
-  lua_setfield(L, idx, "TEXTURE_MAX_LOD");
-
-  lua_pushinteger(L, GL_TEXTURE_BASE_LEVEL);
-  lua_setfield(L, idx, "TEXTURE_BASE_LEVEL");
-
-  lua_pushinteger(L, GL_TEXTURE_MAX_LEVEL);
-  lua_setfield(L, idx, "TEXTURE_MAX_LEVEL");
-
-  lua_pushinteger(L, GL_ALIASED_LINE_WIDTH_RANGE);
-  lua_setfield(L, idx, "ALIASED_LINE_WIDTH_RANGE");
-
-  lua_pushinteger(L, GL_TEXTURE0);
-  lua_setfield(L, idx, "TEXTURE0");
-
-  lua_pushinteger(L, GL_TEXTURE1);
-  lua_setfield(L, idx, "TEXTURE1");
-
-  lua_pushinteger(L, GL_TEXTURE2);
-  lua_setfield(L, idx, "TEXTURE2");
-
-  lua_pushinteger(L, GL_TEXTURE3);
-  lua_setfield(L, idx, "TEXTURE3");
-
-  lua_pushinteger(L, GL_TEXTURE4);
-  lua_setfield(L, idx, "TEXTURE4");
-
-  lua_pushinteger(L, GL_TEXTURE5);
-  lua_setfield(L, idx, "TEXTURE5");
-
-  lua_pushinteger(L, GL_TEXTURE6);
-  lua_setfield(L, idx, "TEXTURE6");
-
-  lua_pushinteger(L, GL_TEXTURE7);
-  lua_setfield(L, idx, "TEXTURE7");
-
-  lua_pushinteger(L, GL_TEXTURE8);
-  lua_setfield(L, idx, "TEXTURE8");
-
-  lua_pushinteger(L, GL_TEXTURE9);
-  lua_setfield(L, idx, "TEXTURE9");
-
-  lua_pushinteger(L, GL_TEXTURE10);
-  lua_setfield(L, idx, "TEXTURE10");
-
-  lua_pushinteger(L, GL_TEXTURE11);
-  lua_setfield(L, idx, "TEXTURE11");
-
-  lua_pushinteger(L, GL_TEXTURE12);
-  lua_setfield(L, idx, "TEXTURE12");
-
-  lua_pushinteger(L, GL_TEXTURE13);
-  lua_setfield(L, idx, "TEXTURE13");
-
-  lua_pushinteger(L, GL_TEXTURE14);
-  lua_setfield(L, idx, "TEXTURE14");
-
-  lua_pushinteger(L, GL_TEXTURE15);
-  lua_setfield(L, idx, "TEXTURE15");
-
-  lua_pushinteger(L, GL_TEXTURE16);
-  lua_setfield(L, idx, "TEXTURE16");
-
-  lua_pushinteger(L, GL_TEXTURE17);
-  lua_setfield(L, idx, "TEXTURE17");
-
-  lua_pushinteger(L, GL_TEXTURE18);
-  lua_setfield(L, idx, "TEXTURE18");
-
-  lua_pushinteger(L, GL_TEXTURE19);
-  lua_setfield(L, idx, "TEXTURE19");
-
-  lua_pushinteger(L, GL_TEXTURE20);
-  lua_setfield(L, idx, "TEXTURE20");
-
-  lua_pushinteger(L, GL_TEXTURE21);
-  lua_setfield(L, idx, "TEXTURE21");
-
-  lua_pushinteger(L, GL_TEXTURE22);
-  lua_setfield(L, idx, "TEXTURE22");
-
-  lua_pushinteger(L, GL_TEXTURE23);
-  lua_setfield(L, idx, "TEXTURE23");
-
-  lua_pushinteger(L, GL_TEXTURE24);
-  lua_setfield(L, idx, "TEXTURE24");
-
-  lua_pushinteger(L, GL_TEXTURE25);
-  lua_setfield(L, idx, "TEXTURE25");
-
-  lua_pushinteger(L, GL_TEXTURE26);
-  lua_setfield(L, idx, "TEXTURE26");
-
-  lua_pushinteger(L, GL_TEXTURE27);
-  lua_setfield(L, idx, "TEXTURE27");
-
-  lua_pushinteger(L, GL_TEXTURE28);
-  lua_setfield(L, idx, "TEXTURE28");
-
-  lua_pushinteger(L, GL_TEXTURE29);
-  lua_setfield(L, idx, "TEXTURE29");
-
-  lua_pushinteger(L, GL_TEXTURE30);
-  lua_setfield(L, idx, "TEXTURE30");
-
-  lua_pushinteger(L, GL_TEXTURE31);
-  lua_setfield(L, idx, "TEXTURE31");
-
-  lua_pushinteger(L, GL_ACTIVE_TEXTURE);
-  lua_setfield(L, idx, "ACTIVE_TEXTURE");
-
-  lua_pushinteger(L, GL_SAMPLE_ALPHA_TO_COVERAGE);
-  lua_setfield(L, idx, "SAMPLE_ALPHA_TO_COVERAGE");
-
-  lua_pushinteger(L, GL_SAMPLE_COVERAGE);
-  lua_setfield(L, idx, "SAMPLE_COVERAGE");
-
-  lua_pushinteger(L, GL_SAMPLE_BUFFERS);
-  lua_setfield(L, idx, "SAMPLE_BUFFERS");
-
-  lua_pushinteger(L, GL_SAMPLES);
-  lua_setfield(L, idx, "SAMPLES");
-
-  lua_pushinteger(L, GL_SAMPLE_COVERAGE_VALUE);
-  lua_setfield(L, idx, "SAMPLE_COVERAGE_VALUE");
-
-  lua_pushinteger(L, GL_SAMPLE_COVERAGE_INVERT);
-  lua_setfield(L, idx, "SAMPLE_COVERAGE_INVERT");
-
-  lua_pushinteger(L, GL_TEXTURE_CUBE_MAP);
-  lua_setfield(L, idx, "TEXTURE_CUBE_MAP");
-
-  lua_pushinteger(L, GL_TEXTURE_BINDING_CUBE_MAP);
-  lua_setfield(L, idx, "TEXTURE_BINDING_CUBE_MAP");
-
-  lua_pushinteger(L, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
-  lua_setfield(L, idx, "TEXTURE_CUBE_MAP_POSITIVE_X");
-
-  lua_pushinteger(L, GL_TEXTURE_CUBE_MAP_NEGATIVE_X);
-  lua_setfield(L, idx, "TEXTURE_CUBE_MAP_NEGATIVE_X");
-
-  lua_pushinteger(L, GL_TEXTURE_CUBE_MAP_POSITIVE_Y);
-  lua_setfield(L, idx, "TEXTURE_CUBE_MAP_POSITIVE_Y");
-
-  lua_pushinteger(L, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y);
-  lua_setfield(L, idx, "TEXTURE_CUBE_MAP_NEGATIVE_Y");
-
-  lua_pushinteger(L, GL_TEXTURE_CUBE_MAP_POSITIVE_Z);
-  lua_setfield(L, idx, "TEXTURE_CUBE_MAP_POSITIVE_Z");
-
-  lua_pushinteger(L, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z);
-  lua_setfield(L, idx, "TEXTURE_CUBE_MAP_NEGATIVE_Z");
-
-  lua_pushinteger(L, GL_MAX_CUBE_MAP_TEXTURE_SIZE);
-  lua_setfield(L, idx, "MAX_CUBE_MAP_TEXTURE_SIZE");
-
-  lua_pushinteger(L, GL_NUM_COMPRESSED_TEXTURE_FORMATS);
-  lua_setfield(L, idx, "NUM_COMPRESSED_TEXTURE_FORMATS");
-
-  lua_pushinteger(L, GL_COMPRESSED_TEXTURE_FORMATS);
-  lua_setfield(L, idx, "COMPRESSED_TEXTURE_FORMATS");
-
-  lua_pushinteger(L, GL_BLEND_DST_RGB);
-  lua_setfield(L, idx, "BLEND_DST_RGB");
-
-  lua_pushinteger(L, GL_BLEND_SRC_RGB);
-  lua_setfield(L, idx, "BLEND_SRC_RGB");
-
-  lua_pushinteger(L, GL_BLEND_DST_ALPHA);
-  lua_setfield(L, idx, "BLEND_DST_ALPHA");
-
-  lua_pushinteger(L, GL_BLEND_SRC_ALPHA);
-  lua_setfield(L, idx, "BLEND_SRC_ALPHA");
-
-  lua_pushinteger(L, GL_DEPTH_COMPONENT16);
-  lua_setfield(L, idx, "DEPTH_COMPONENT16");
-
-  lua_pushinteger(L, GL_DEPTH_COMPONENT24);
-  lua_setfield(L, idx, "DEPTH_COMPONENT24");
-
-  lua_pushinteger(L, GL_MIRRORED_REPEAT);
-  lua_setfield(L, idx, "MIRRORED_REPEAT");
-
-  lua_pushinteger(L, GL_MAX_TEXTURE_LOD_BIAS);
-  lua_setfield(L, idx, "MAX_TEXTURE_LOD_BIAS");
-
-  lua_pushinteger(L, GL_INCR_WRAP);
-  lua_setfield(L, idx, "INCR_WRAP");
-
-  lua_pushinteger(L, GL_DECR_WRAP);
-  lua_setfield(L, idx, "DECR_WRAP");
-
-  lua_pushinteger(L, GL_TEXTURE_COMPARE_MODE);
-  lua_setfield(L, idx, "TEXTURE_COMPARE_MODE");
-
-  lua_pushinteger(L, GL_TEXTURE_COMPARE_FUNC);
-  lua_setfield(L, idx, "TEXTURE_COMPARE_FUNC");
-
-  lua_pushinteger(L, GL_BLEND_COLOR);
-  lua_setfield(L, idx, "BLEND_COLOR");
-
-  lua_pushinteger(L, GL_BLEND_EQUATION);
-  lua_setfield(L, idx, "BLEND_EQUATION");
-
-  lua_pushinteger(L, GL_CONSTANT_COLOR);
-  lua_setfield(L, idx, "CONSTANT_COLOR");
-
-  lua_pushinteger(L, GL_ONE_MINUS_CONSTANT_COLOR);
-  lua_setfield(L, idx, "ONE_MINUS_CONSTANT_COLOR");
-
-  lua_pushinteger(L, GL_CONSTANT_ALPHA);
-  lua_setfield(L, idx, "CONSTANT_ALPHA");
-
-  lua_pushinteger(L, GL_ONE_MINUS_CONSTANT_ALPHA);
-  lua_setfield(L, idx, "ONE_MINUS_CONSTANT_ALPHA");
-
-  lua_pushinteger(L, GL_FUNC_ADD);
-  lua_setfield(L, idx, "FUNC_ADD");
-
-  lua_pushinteger(L, GL_FUNC_REVERSE_SUBTRACT);
-  lua_setfield(L, idx, "FUNC_REVERSE_SUBTRACT");
-
-  lua_pushinteger(L, GL_FUNC_SUBTRACT);
-  lua_setfield(L, idx, "FUNC_SUBTRACT");
-
-  lua_pushinteger(L, GL_MIN);
-  lua_setfield(L, idx, "MIN");
-
-  lua_pushinteger(L, GL_MAX);
-  lua_setfield(L, idx, "MAX");
-
-  lua_pushinteger(L, GL_BUFFER_SIZE);
-  lua_setfield(L, idx, "BUFFER_SIZE");
-
-  lua_pushinteger(L, GL_BUFFER_USAGE);
-  lua_setfield(L, idx, "BUFFER_USAGE");
-
-  lua_pushinteger(L, GL_CURRENT_QUERY);
-  lua_setfield(L, idx, "CURRENT_QUERY");
-
-  lua_pushinteger(L, GL_QUERY_RESULT);
-  lua_setfield(L, idx, "QUERY_RESULT");
-
-  lua_pushinteger(L, GL_QUERY_RESULT_AVAILABLE);
-  lua_setfield(L, idx, "QUERY_RESULT_AVAILABLE");
-
-  lua_pushinteger(L, GL_ARRAY_BUFFER);
-  lua_setfield(L, idx, "ARRAY_BUFFER");
-
-  lua_pushinteger(L, GL_ELEMENT_ARRAY_BUFFER);
-  lua_setfield(L, idx, "ELEMENT_ARRAY_BUFFER");
-
-  lua_pushinteger(L, GL_ARRAY_BUFFER_BINDING);
-  lua_setfield(L, idx, "ARRAY_BUFFER_BINDING");
-
-  lua_pushinteger(L, GL_ELEMENT_ARRAY_BUFFER_BINDING);
-  lua_setfield(L, idx, "ELEMENT_ARRAY_BUFFER_BINDING");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_BUFFER_BINDING");
-
-  lua_pushinteger(L, GL_BUFFER_MAPPED);
-  lua_setfield(L, idx, "BUFFER_MAPPED");
-
-  lua_pushinteger(L, GL_BUFFER_MAP_POINTER);
-  lua_setfield(L, idx, "BUFFER_MAP_POINTER");
-
-  lua_pushinteger(L, GL_STREAM_DRAW);
-  lua_setfield(L, idx, "STREAM_DRAW");
-
-  lua_pushinteger(L, GL_STREAM_READ);
-  lua_setfield(L, idx, "STREAM_READ");
-
-  lua_pushinteger(L, GL_STREAM_COPY);
-  lua_setfield(L, idx, "STREAM_COPY");
-
-  lua_pushinteger(L, GL_STATIC_DRAW);
-  lua_setfield(L, idx, "STATIC_DRAW");
-
-  lua_pushinteger(L, GL_STATIC_READ);
-  lua_setfield(L, idx, "STATIC_READ");
-
-  lua_pushinteger(L, GL_STATIC_COPY);
-  lua_setfield(L, idx, "STATIC_COPY");
-
-  lua_pushinteger(L, GL_DYNAMIC_DRAW);
-  lua_setfield(L, idx, "DYNAMIC_DRAW");
-
-  lua_pushinteger(L, GL_DYNAMIC_READ);
-  lua_setfield(L, idx, "DYNAMIC_READ");
-
-  lua_pushinteger(L, GL_DYNAMIC_COPY);
-  lua_setfield(L, idx, "DYNAMIC_COPY");
-
-  lua_pushinteger(L, GL_BLEND_EQUATION_RGB);
-  lua_setfield(L, idx, "BLEND_EQUATION_RGB");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_ENABLED);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_ENABLED");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_SIZE);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_SIZE");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_STRIDE);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_STRIDE");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_TYPE);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_TYPE");
-
-  lua_pushinteger(L, GL_CURRENT_VERTEX_ATTRIB);
-  lua_setfield(L, idx, "CURRENT_VERTEX_ATTRIB");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_POINTER);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_POINTER");
-
-  lua_pushinteger(L, GL_STENCIL_BACK_FUNC);
-  lua_setfield(L, idx, "STENCIL_BACK_FUNC");
-
-  lua_pushinteger(L, GL_STENCIL_BACK_FAIL);
-  lua_setfield(L, idx, "STENCIL_BACK_FAIL");
-
-  lua_pushinteger(L, GL_STENCIL_BACK_PASS_DEPTH_FAIL);
-  lua_setfield(L, idx, "STENCIL_BACK_PASS_DEPTH_FAIL");
-
-  lua_pushinteger(L, GL_STENCIL_BACK_PASS_DEPTH_PASS);
-  lua_setfield(L, idx, "STENCIL_BACK_PASS_DEPTH_PASS");
-
-  lua_pushinteger(L, GL_MAX_DRAW_BUFFERS);
-  lua_setfield(L, idx, "MAX_DRAW_BUFFERS");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER0);
-  lua_setfield(L, idx, "DRAW_BUFFER0");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER1);
-  lua_setfield(L, idx, "DRAW_BUFFER1");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER2);
-  lua_setfield(L, idx, "DRAW_BUFFER2");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER3);
-  lua_setfield(L, idx, "DRAW_BUFFER3");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER4);
-  lua_setfield(L, idx, "DRAW_BUFFER4");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER5);
-  lua_setfield(L, idx, "DRAW_BUFFER5");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER6);
-  lua_setfield(L, idx, "DRAW_BUFFER6");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER7);
-  lua_setfield(L, idx, "DRAW_BUFFER7");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER8);
-  lua_setfield(L, idx, "DRAW_BUFFER8");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER9);
-  lua_setfield(L, idx, "DRAW_BUFFER9");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER10);
-  lua_setfield(L, idx, "DRAW_BUFFER10");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER11);
-  lua_setfield(L, idx, "DRAW_BUFFER11");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER12);
-  lua_setfield(L, idx, "DRAW_BUFFER12");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER13);
-  lua_setfield(L, idx, "DRAW_BUFFER13");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER14);
-  lua_setfield(L, idx, "DRAW_BUFFER14");
-
-  lua_pushinteger(L, GL_DRAW_BUFFER15);
-  lua_setfield(L, idx, "DRAW_BUFFER15");
-
-  lua_pushinteger(L, GL_BLEND_EQUATION_ALPHA);
-  lua_setfield(L, idx, "BLEND_EQUATION_ALPHA");
-
-  lua_pushinteger(L, GL_MAX_VERTEX_ATTRIBS);
-  lua_setfield(L, idx, "MAX_VERTEX_ATTRIBS");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_NORMALIZED");
-
-  lua_pushinteger(L, GL_MAX_TEXTURE_IMAGE_UNITS);
-  lua_setfield(L, idx, "MAX_TEXTURE_IMAGE_UNITS");
-
-  lua_pushinteger(L, GL_FRAGMENT_SHADER);
-  lua_setfield(L, idx, "FRAGMENT_SHADER");
-
-  lua_pushinteger(L, GL_VERTEX_SHADER);
-  lua_setfield(L, idx, "VERTEX_SHADER");
-
-  lua_pushinteger(L, GL_MAX_FRAGMENT_UNIFORM_COMPONENTS);
-  lua_setfield(L, idx, "MAX_FRAGMENT_UNIFORM_COMPONENTS");
-
-  lua_pushinteger(L, GL_MAX_VERTEX_UNIFORM_COMPONENTS);
-  lua_setfield(L, idx, "MAX_VERTEX_UNIFORM_COMPONENTS");
-
-  lua_pushinteger(L, GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS);
-  lua_setfield(L, idx, "MAX_VERTEX_TEXTURE_IMAGE_UNITS");
-
-  lua_pushinteger(L, GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
-  lua_setfield(L, idx, "MAX_COMBINED_TEXTURE_IMAGE_UNITS");
-
-  lua_pushinteger(L, GL_SHADER_TYPE);
-  lua_setfield(L, idx, "SHADER_TYPE");
-
-  lua_pushinteger(L, GL_FLOAT_VEC2);
-  lua_setfield(L, idx, "FLOAT_VEC2");
-
-  lua_pushinteger(L, GL_FLOAT_VEC3);
-  lua_setfield(L, idx, "FLOAT_VEC3");
-
-  lua_pushinteger(L, GL_FLOAT_VEC4);
-  lua_setfield(L, idx, "FLOAT_VEC4");
-
-  lua_pushinteger(L, GL_INT_VEC2);
-  lua_setfield(L, idx, "INT_VEC2");
-
-  lua_pushinteger(L, GL_INT_VEC3);
-  lua_setfield(L, idx, "INT_VEC3");
-
-  lua_pushinteger(L, GL_INT_VEC4);
-  lua_setfield(L, idx, "INT_VEC4");
-
-  lua_pushinteger(L, GL_BOOL);
-  lua_setfield(L, idx, "BOOL");
-
-  lua_pushinteger(L, GL_BOOL_VEC2);
-  lua_setfield(L, idx, "BOOL_VEC2");
-
-  lua_pushinteger(L, GL_BOOL_VEC3);
-  lua_setfield(L, idx, "BOOL_VEC3");
-
-  lua_pushinteger(L, GL_BOOL_VEC4);
-  lua_setfield(L, idx, "BOOL_VEC4");
-
-  lua_pushinteger(L, GL_FLOAT_MAT2);
-  lua_setfield(L, idx, "FLOAT_MAT2");
-
-  lua_pushinteger(L, GL_FLOAT_MAT3);
-  lua_setfield(L, idx, "FLOAT_MAT3");
-
-  lua_pushinteger(L, GL_FLOAT_MAT4);
-  lua_setfield(L, idx, "FLOAT_MAT4");
-
-  lua_pushinteger(L, GL_SAMPLER_2D);
-  lua_setfield(L, idx, "SAMPLER_2D");
-
-  lua_pushinteger(L, GL_SAMPLER_3D);
-  lua_setfield(L, idx, "SAMPLER_3D");
-
-  lua_pushinteger(L, GL_SAMPLER_CUBE);
-  lua_setfield(L, idx, "SAMPLER_CUBE");
-
-  lua_pushinteger(L, GL_SAMPLER_2D_SHADOW);
-  lua_setfield(L, idx, "SAMPLER_2D_SHADOW");
-
-  lua_pushinteger(L, GL_DELETE_STATUS);
-  lua_setfield(L, idx, "DELETE_STATUS");
-
-  lua_pushinteger(L, GL_COMPILE_STATUS);
-  lua_setfield(L, idx, "COMPILE_STATUS");
-
-  lua_pushinteger(L, GL_LINK_STATUS);
-  lua_setfield(L, idx, "LINK_STATUS");
-
-  lua_pushinteger(L, GL_VALIDATE_STATUS);
-  lua_setfield(L, idx, "VALIDATE_STATUS");
-
-  lua_pushinteger(L, GL_INFO_LOG_LENGTH);
-  lua_setfield(L, idx, "INFO_LOG_LENGTH");
-
-  lua_pushinteger(L, GL_ATTACHED_SHADERS);
-  lua_setfield(L, idx, "ATTACHED_SHADERS");
-
-  lua_pushinteger(L, GL_ACTIVE_UNIFORMS);
-  lua_setfield(L, idx, "ACTIVE_UNIFORMS");
-
-  lua_pushinteger(L, GL_ACTIVE_UNIFORM_MAX_LENGTH);
-  lua_setfield(L, idx, "ACTIVE_UNIFORM_MAX_LENGTH");
-
-  lua_pushinteger(L, GL_SHADER_SOURCE_LENGTH);
-  lua_setfield(L, idx, "SHADER_SOURCE_LENGTH");
-
-  lua_pushinteger(L, GL_ACTIVE_ATTRIBUTES);
-  lua_setfield(L, idx, "ACTIVE_ATTRIBUTES");
-
-  lua_pushinteger(L, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH);
-  lua_setfield(L, idx, "ACTIVE_ATTRIBUTE_MAX_LENGTH");
-
-  lua_pushinteger(L, GL_FRAGMENT_SHADER_DERIVATIVE_HINT);
-  lua_setfield(L, idx, "FRAGMENT_SHADER_DERIVATIVE_HINT");
-
-  lua_pushinteger(L, GL_SHADING_LANGUAGE_VERSION);
-  lua_setfield(L, idx, "SHADING_LANGUAGE_VERSION");
-
-  lua_pushinteger(L, GL_CURRENT_PROGRAM);
-  lua_setfield(L, idx, "CURRENT_PROGRAM");
-
-  lua_pushinteger(L, GL_STENCIL_BACK_REF);
-  lua_setfield(L, idx, "STENCIL_BACK_REF");
-
-  lua_pushinteger(L, GL_STENCIL_BACK_VALUE_MASK);
-  lua_setfield(L, idx, "STENCIL_BACK_VALUE_MASK");
-
-  lua_pushinteger(L, GL_STENCIL_BACK_WRITEMASK);
-  lua_setfield(L, idx, "STENCIL_BACK_WRITEMASK");
-
-  lua_pushinteger(L, GL_PIXEL_PACK_BUFFER);
-  lua_setfield(L, idx, "PIXEL_PACK_BUFFER");
-
-  lua_pushinteger(L, GL_PIXEL_UNPACK_BUFFER);
-  lua_setfield(L, idx, "PIXEL_UNPACK_BUFFER");
-
-  lua_pushinteger(L, GL_PIXEL_PACK_BUFFER_BINDING);
-  lua_setfield(L, idx, "PIXEL_PACK_BUFFER_BINDING");
-
-  lua_pushinteger(L, GL_PIXEL_UNPACK_BUFFER_BINDING);
-  lua_setfield(L, idx, "PIXEL_UNPACK_BUFFER_BINDING");
-
-  lua_pushinteger(L, GL_FLOAT_MAT2x3);
-  lua_setfield(L, idx, "FLOAT_MAT2x3");
-
-  lua_pushinteger(L, GL_FLOAT_MAT2x4);
-  lua_setfield(L, idx, "FLOAT_MAT2x4");
-
-  lua_pushinteger(L, GL_FLOAT_MAT3x2);
-  lua_setfield(L, idx, "FLOAT_MAT3x2");
-
-  lua_pushinteger(L, GL_FLOAT_MAT3x4);
-  lua_setfield(L, idx, "FLOAT_MAT3x4");
-
-  lua_pushinteger(L, GL_FLOAT_MAT4x2);
-  lua_setfield(L, idx, "FLOAT_MAT4x2");
-
-  lua_pushinteger(L, GL_FLOAT_MAT4x3);
-  lua_setfield(L, idx, "FLOAT_MAT4x3");
-
-  lua_pushinteger(L, GL_SRGB);
-  lua_setfield(L, idx, "SRGB");
-
-  lua_pushinteger(L, GL_SRGB8);
-  lua_setfield(L, idx, "SRGB8");
-
-  lua_pushinteger(L, GL_SRGB8_ALPHA8);
-  lua_setfield(L, idx, "SRGB8_ALPHA8");
-
-  lua_pushinteger(L, GL_COMPARE_REF_TO_TEXTURE);
-  lua_setfield(L, idx, "COMPARE_REF_TO_TEXTURE");
-
-  lua_pushinteger(L, GL_MAJOR_VERSION);
-  lua_setfield(L, idx, "MAJOR_VERSION");
-
-  lua_pushinteger(L, GL_MINOR_VERSION);
-  lua_setfield(L, idx, "MINOR_VERSION");
-
-  lua_pushinteger(L, GL_NUM_EXTENSIONS);
-  lua_setfield(L, idx, "NUM_EXTENSIONS");
-
-  lua_pushinteger(L, GL_RGBA32F);
-  lua_setfield(L, idx, "RGBA32F");
-
-  lua_pushinteger(L, GL_RGB32F);
-  lua_setfield(L, idx, "RGB32F");
-
-  lua_pushinteger(L, GL_RGBA16F);
-  lua_setfield(L, idx, "RGBA16F");
-
-  lua_pushinteger(L, GL_RGB16F);
-  lua_setfield(L, idx, "RGB16F");
-
-  lua_pushinteger(L, GL_VERTEX_ATTRIB_ARRAY_INTEGER);
-  lua_setfield(L, idx, "VERTEX_ATTRIB_ARRAY_INTEGER");
-
-  lua_pushinteger(L, GL_MAX_ARRAY_TEXTURE_LAYERS);
-  lua_setfield(L, idx, "MAX_ARRAY_TEXTURE_LAYERS");
-
-  lua_pushinteger(L, GL_MIN_PROGRAM_TEXEL_OFFSET);
-  lua_setfield(L, idx, "MIN_PROGRAM_TEXEL_OFFSET");
-
-  lua_pushinteger(L, GL_MAX_PROGRAM_TEXEL_OFFSET);
-  lua_setfield(L, idx, "MAX_PROGRAM_TEXEL_OFFSET");
-
-  lua_pushinteger(L, GL_MAX_VARYING_COMPONENTS);
-  lua_setfield(L, idx, "MAX_VARYING_COMPONENTS");
-
-  lua_pushinteger(L, GL_TEXTURE_2D_ARRAY);
-  lua_setfield(L, idx, "TEXTURE_2D_ARRAY");
-
-  lua_pushinteger(L, GL_TEXTURE_BINDING_2D_ARRAY);
-  lua_setfield(L, idx, "TEXTURE_BINDING_2D_ARRAY");
-
-  lua_pushinteger(L, GL_R11F_G11F_B10F);
-  lua_setfield(L, idx, "R11F_G11F_B10F");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_10F_11F_11F_REV);
-  lua_setfield(L, idx, "UNSIGNED_INT_10F_11F_11F_REV");
-
-  lua_pushinteger(L, GL_RGB9_E5);
-  lua_setfield(L, idx, "RGB9_E5");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_5_9_9_9_REV);
-  lua_setfield(L, idx, "UNSIGNED_INT_5_9_9_9_REV");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_VARYING_MAX_LENGTH);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_VARYING_MAX_LENGTH");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_BUFFER_MODE);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_BUFFER_MODE");
-
-  lua_pushinteger(L, GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS);
-  lua_setfield(L, idx, "MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_VARYINGS);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_VARYINGS");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_BUFFER_START);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_BUFFER_START");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_BUFFER_SIZE);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_BUFFER_SIZE");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN");
-
-  lua_pushinteger(L, GL_RASTERIZER_DISCARD);
-  lua_setfield(L, idx, "RASTERIZER_DISCARD");
-
-  lua_pushinteger(L, GL_MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS);
-  lua_setfield(L, idx, "MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS");
-
-  lua_pushinteger(L, GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS);
-  lua_setfield(L, idx, "MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS");
-
-  lua_pushinteger(L, GL_INTERLEAVED_ATTRIBS);
-  lua_setfield(L, idx, "INTERLEAVED_ATTRIBS");
-
-  lua_pushinteger(L, GL_SEPARATE_ATTRIBS);
-  lua_setfield(L, idx, "SEPARATE_ATTRIBS");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_BUFFER);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_BUFFER");
-
-  lua_pushinteger(L, GL_TRANSFORM_FEEDBACK_BUFFER_BINDING);
-  lua_setfield(L, idx, "TRANSFORM_FEEDBACK_BUFFER_BINDING");
-
-  lua_pushinteger(L, GL_RGBA32UI);
-  lua_setfield(L, idx, "RGBA32UI");
-
-  lua_pushinteger(L, GL_RGB32UI);
-  lua_setfield(L, idx, "RGB32UI");
-
-  lua_pushinteger(L, GL_RGBA16UI);
-  lua_setfield(L, idx, "RGBA16UI");
-
-  lua_pushinteger(L, GL_RGB16UI);
-  lua_setfield(L, idx, "RGB16UI");
-
-  lua_pushinteger(L, GL_RGBA8UI);
-  lua_setfield(L, idx, "RGBA8UI");
-
-  lua_pushinteger(L, GL_RGB8UI);
-  lua_setfield(L, idx, "RGB8UI");
-
-  lua_pushinteger(L, GL_RGBA32I);
-  lua_setfield(L, idx, "RGBA32I");
-
-  lua_pushinteger(L, GL_RGB32I);
-  lua_setfield(L, idx, "RGB32I");
-
-  lua_pushinteger(L, GL_RGBA16I);
-  lua_setfield(L, idx, "RGBA16I");
-
-  lua_pushinteger(L, GL_RGB16I);
-  lua_setfield(L, idx, "RGB16I");
-
-  lua_pushinteger(L, GL_RGBA8I);
-  lua_setfield(L, idx, "RGBA8I");
-
-  lua_pushinteger(L, GL_RGB8I);
-  lua_setfield(L, idx, "RGB8I");
-
-  lua_pushinteger(L, GL_RED_INTEGER);
-  lua_setfield(L, idx, "RED_INTEGER");
-
-  lua_pushinteger(L, GL_RGB_INTEGER);
-  lua_setfield(L, idx, "RGB_INTEGER");
-
-  lua_pushinteger(L, GL_RGBA_INTEGER);
-  lua_setfield(L, idx, "RGBA_INTEGER");
-
-  lua_pushinteger(L, GL_SAMPLER_2D_ARRAY);
-  lua_setfield(L, idx, "SAMPLER_2D_ARRAY");
-
-  lua_pushinteger(L, GL_SAMPLER_2D_ARRAY_SHADOW);
-  lua_setfield(L, idx, "SAMPLER_2D_ARRAY_SHADOW");
-
-  lua_pushinteger(L, GL_SAMPLER_CUBE_SHADOW);
-  lua_setfield(L, idx, "SAMPLER_CUBE_SHADOW");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_VEC2);
-  lua_setfield(L, idx, "UNSIGNED_INT_VEC2");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_VEC3);
-  lua_setfield(L, idx, "UNSIGNED_INT_VEC3");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_VEC4);
-  lua_setfield(L, idx, "UNSIGNED_INT_VEC4");
-
-  lua_pushinteger(L, GL_INT_SAMPLER_2D);
-  lua_setfield(L, idx, "INT_SAMPLER_2D");
-
-  lua_pushinteger(L, GL_INT_SAMPLER_3D);
-  lua_setfield(L, idx, "INT_SAMPLER_3D");
-
-  lua_pushinteger(L, GL_INT_SAMPLER_CUBE);
-  lua_setfield(L, idx, "INT_SAMPLER_CUBE");
-
-  lua_pushinteger(L, GL_INT_SAMPLER_2D_ARRAY);
-  lua_setfield(L, idx, "INT_SAMPLER_2D_ARRAY");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_SAMPLER_2D);
-  lua_setfield(L, idx, "UNSIGNED_INT_SAMPLER_2D");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_SAMPLER_3D);
-  lua_setfield(L, idx, "UNSIGNED_INT_SAMPLER_3D");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_SAMPLER_CUBE);
-  lua_setfield(L, idx, "UNSIGNED_INT_SAMPLER_CUBE");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_SAMPLER_2D_ARRAY);
-  lua_setfield(L, idx, "UNSIGNED_INT_SAMPLER_2D_ARRAY");
-
-  lua_pushinteger(L, GL_BUFFER_ACCESS_FLAGS);
-  lua_setfield(L, idx, "BUFFER_ACCESS_FLAGS");
-
-  lua_pushinteger(L, GL_BUFFER_MAP_LENGTH);
-  lua_setfield(L, idx, "BUFFER_MAP_LENGTH");
-
-  lua_pushinteger(L, GL_BUFFER_MAP_OFFSET);
-  lua_setfield(L, idx, "BUFFER_MAP_OFFSET");
-
-  lua_pushinteger(L, GL_DEPTH_COMPONENT32F);
-  lua_setfield(L, idx, "DEPTH_COMPONENT32F");
-
-  lua_pushinteger(L, GL_DEPTH32F_STENCIL8);
-  lua_setfield(L, idx, "DEPTH32F_STENCIL8");
-
-  lua_pushinteger(L, GL_FLOAT_32_UNSIGNED_INT_24_8_REV);
-  lua_setfield(L, idx, "FLOAT_32_UNSIGNED_INT_24_8_REV");
-
-  lua_pushinteger(L, GL_INVALID_FRAMEBUFFER_OPERATION);
-  lua_setfield(L, idx, "INVALID_FRAMEBUFFER_OPERATION");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_RED_SIZE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_RED_SIZE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_GREEN_SIZE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_GREEN_SIZE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_BLUE_SIZE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_BLUE_SIZE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_ALPHA_SIZE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_ALPHA_SIZE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_DEFAULT);
-  lua_setfield(L, idx, "FRAMEBUFFER_DEFAULT");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_UNDEFINED);
-  lua_setfield(L, idx, "FRAMEBUFFER_UNDEFINED");
-
-  lua_pushinteger(L, GL_DEPTH_STENCIL_ATTACHMENT);
-  lua_setfield(L, idx, "DEPTH_STENCIL_ATTACHMENT");
-
-  lua_pushinteger(L, GL_MAX_RENDERBUFFER_SIZE);
-  lua_setfield(L, idx, "MAX_RENDERBUFFER_SIZE");
-
-  lua_pushinteger(L, GL_DEPTH_STENCIL);
-  lua_setfield(L, idx, "DEPTH_STENCIL");
-
-  lua_pushinteger(L, GL_UNSIGNED_INT_24_8);
-  lua_setfield(L, idx, "UNSIGNED_INT_24_8");
-
-  lua_pushinteger(L, GL_DEPTH24_STENCIL8);
-  lua_setfield(L, idx, "DEPTH24_STENCIL8");
-
-  lua_pushinteger(L, GL_UNSIGNED_NORMALIZED);
-  lua_setfield(L, idx, "UNSIGNED_NORMALIZED");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_BINDING);
-  lua_setfield(L, idx, "FRAMEBUFFER_BINDING");
-
-  lua_pushinteger(L, GL_DRAW_FRAMEBUFFER_BINDING);
-  lua_setfield(L, idx, "DRAW_FRAMEBUFFER_BINDING");
-
-  lua_pushinteger(L, GL_RENDERBUFFER_BINDING);
-  lua_setfield(L, idx, "RENDERBUFFER_BINDING");
-
-  lua_pushinteger(L, GL_READ_FRAMEBUFFER);
-  lua_setfield(L, idx, "READ_FRAMEBUFFER");
-
-  lua_pushinteger(L, GL_DRAW_FRAMEBUFFER);
-  lua_setfield(L, idx, "DRAW_FRAMEBUFFER");
-
-  lua_pushinteger(L, GL_READ_FRAMEBUFFER_BINDING);
-  lua_setfield(L, idx, "READ_FRAMEBUFFER_BINDING");
-
-  lua_pushinteger(L, GL_RENDERBUFFER_SAMPLES);
-  lua_setfield(L, idx, "RENDERBUFFER_SAMPLES");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE");
-
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_OBJECT_NAME");
+int L_CommandList_viewport(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->viewport(static_cast<GLint>(luaL_checkinteger(L, 2)),
+                 static_cast<GLint>(luaL_checkinteger(L, 3)),
+                 static_cast<GLsizei>(luaL_checkinteger(L, 4)),
+                 static_cast<GLsizei>(luaL_checkinteger(L, 5)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL");
+int L_CommandList_bindFramebuffer(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->bindFramebuffer(static_cast<GLenum>(luaL_checkinteger(L, 2)),
+                        static_cast<GLuint>(luaL_checkinteger(L, 3)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE");
+int L_CommandList_bindBuffer(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->bindBuffer(static_cast<GLenum>(luaL_checkinteger(L, 2)),
+                   static_cast<GLuint>(luaL_checkinteger(L, 3)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LAYER);
-  lua_setfield(L, idx, "FRAMEBUFFER_ATTACHMENT_TEXTURE_LAYER");
+int L_CommandList_bindVertexArray(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->bindVertexArray(static_cast<GLuint>(luaL_checkinteger(L, 2)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_COMPLETE);
-  lua_setfield(L, idx, "FRAMEBUFFER_COMPLETE");
+int L_CommandList_useProgram(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->useProgram(static_cast<GLuint>(luaL_checkinteger(L, 2)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT);
-  lua_setfield(L, idx, "FRAMEBUFFER_INCOMPLETE_ATTACHMENT");
+int L_CommandList_activateTexture(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->activeTexture(static_cast<GLenum>(luaL_checkinteger(L, 2)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT);
-  lua_setfield(L, idx, "FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT");
+int L_CommandList_bindTexture(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->bindTexture(static_cast<GLenum>(luaL_checkinteger(L, 2)),
+                    static_cast<GLuint>(luaL_checkinteger(L, 3)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_UNSUPPORTED);
-  lua_setfield(L, idx, "FRAMEBUFFER_UNSUPPORTED");
+int L_CommandList_uniform1i(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->uniform1i(static_cast<GLint>(luaL_checkinteger(L, 2)),
+                  static_cast<GLint>(luaL_checkinteger(L, 3)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_MAX_COLOR_ATTACHMENTS);
-  lua_setfield(L, idx, "MAX_COLOR_ATTACHMENTS");
+int L_CommandList_uniform1f(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->uniform1f(static_cast<GLint>(luaL_checkinteger(L, 2)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 3)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT0);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT0");
+int L_CommandList_uniform2f(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->uniform2f(static_cast<GLint>(luaL_checkinteger(L, 2)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 3)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 4)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT1);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT1");
+int L_CommandList_uniform3f(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->uniform3f(static_cast<GLint>(luaL_checkinteger(L, 2)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 3)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 4)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 5)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT2);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT2");
+int L_CommandList_uniform4f(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->uniform4f(static_cast<GLint>(luaL_checkinteger(L, 2)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 3)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 4)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 5)),
+                  static_cast<GLfloat>(luaL_checknumber(L, 6)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT3);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT3");
+int L_CommandList_drawArrays(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  list->drawArrays(static_cast<GLenum>(luaL_checkinteger(L, 2)),
+                   static_cast<GLint>(luaL_checkinteger(L, 3)),
+                   static_cast<GLsizei>(luaL_checkinteger(L, 4)));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT4);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT4");
+int L_CommandList_drawElements(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto count = static_cast<GLsizei>(luaL_checkinteger(L, 3));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 4));
+  auto offset = luaL_optinteger(L, 5, 0);
+  luaL_argcheck(L, offset >= 0 && offset <= UINT32_MAX, 5,
+                "offset out of range");
+  list->drawElements(mode, count, type, static_cast<uint32_t>(offset));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT5);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT5");
+int L_CommandList_reset(lua_State *L) {
+  checkCommandList(L, 1)->reset();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT6);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT6");
+int L_CommandList_getCommandCount(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  lua_pushinteger(L, static_cast<lua_Integer>(list->getCommandCount()));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT7);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT7");
+int L_CommandList_getByteSize(lua_State *L) {
+  auto list = checkCommandList(L, 1);
+  lua_pushinteger(L, static_cast<lua_Integer>(list->getByteSize()));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT8);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT8");
+int L_execute(lua_State *L) {
+  checkCommandList(L, 1)->execute(getStateCache());
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT9);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT9");
+// for code that changes bindings, the clear color or the viewport with raw
+// GL calls: the next call of each kind goes to the driver again.
+int L_invalidateState(lua_State *) {
+  getStateCache().invalidate();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT10);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT10");
+// {forwarded, filtered} calls since the last resetStateStats. calling
+// that once per frame gives per-frame numbers.
+int L_getStateStats(lua_State *L) {
+  const auto &stats = getStateCache().getStats();
+  lua_newtable(L);
+  lua_pushinteger(L, static_cast<lua_Integer>(stats.forwarded));
+  lua_setfield(L, -2, "forwarded");
+  lua_pushinteger(L, static_cast<lua_Integer>(stats.filtered));
+  lua_setfield(L, -2, "filtered");
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT11);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT11");
+int L_resetStateStats(lua_State *) {
+  getStateCache().resetStats();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT12);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT12");
+// which features past GL 3.0 / GLES3 the current context has, as loaded
+// by GL.loadGLLoader
+int L_getExtensions(lua_State *L) {
+  const auto &extensions = hello::gl::getExtensions();
+  lua_newtable(L);
+  lua_pushboolean(L, extensions.sync);
+  lua_setfield(L, -2, "sync");
+  lua_pushboolean(L, extensions.bufferStorage);
+  lua_setfield(L, -2, "bufferStorage");
+  lua_pushboolean(L, extensions.copyBuffer);
+  lua_setfield(L, -2, "copyBuffer");
+  lua_pushboolean(L, extensions.baseVertex);
+  lua_setfield(L, -2, "baseVertex");
+  lua_pushboolean(L, extensions.instancing);
+  lua_setfield(L, -2, "instancing");
+  lua_pushboolean(L, extensions.uniformBuffer);
+  lua_setfield(L, -2, "uniformBuffer");
+  lua_pushboolean(L, extensions.timerQuery);
+  lua_setfield(L, -2, "timerQuery");
+  lua_pushboolean(L, extensions.drawIndirect);
+  lua_setfield(L, -2, "drawIndirect");
+  lua_pushboolean(L, extensions.multiDrawIndirect);
+  lua_setfield(L, -2, "multiDrawIndirect");
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT13);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT13");
+// GL.newInstanceData(components) packs per-instance attributes natively,
+// `components` floats per instance, for one upload and one instanced draw
+// instead of a draw call and uniform updates per copy. indices start at 0
+// like gl_InstanceID.
+int L_newInstanceData(lua_State *L) {
+  auto components = luaL_checkinteger(L, 1);
+  luaL_argcheck(L, components > 0 && components <= 64, 1,
+                "components out of range");
+  auto pInstances = static_cast<UDInstanceData *>(
+      lua_newuserdata(L, sizeof(UDInstanceData)));
+  pInstances->data =
+      new hello::gl::InstanceData(static_cast<size_t>(components));
+  luaL_setmetatable(L, INSTANCE_DATA_NAME);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT14);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT14");
+int L_InstanceData_free(lua_State *L) {
+  auto pInstances = static_cast<UDInstanceData *>(
+      luaL_checkudata(L, 1, INSTANCE_DATA_NAME));
+  delete pInstances->data;
+  pInstances->data = nullptr;
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT15);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT15");
+size_t checkInstanceIndex(lua_State *L, int arg,
+                          const hello::gl::InstanceData *instances) {
+  auto index = luaL_checkinteger(L, arg);
+  luaL_argcheck(L,
+                index >= 0 &&
+                    static_cast<size_t>(index) < instances->getCount(),
+                arg, "index out of range");
+  return static_cast<size_t>(index);
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT16);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT16");
+// copies the numbers from `arg` on to the instance, from `component`
+void setComponents(lua_State *L, int arg, hello::gl::InstanceData *instances,
+                   size_t index, size_t component) {
+  const auto count = lua_gettop(L) - arg + 1;
+  luaL_argcheck(L,
+                count <= 0 || component + static_cast<size_t>(count) <=
+                                  instances->getComponents(),
+                arg, "too many components");
+  float values[64];
+  for (int i = 0; i < count; ++i) {
+    values[i] = static_cast<float>(luaL_checknumber(L, arg + i));
+  }
+  if (count > 0) {
+    instances->set(index, component, values, static_cast<size_t>(count));
+  }
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT17);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT17");
+int L_InstanceData_add(lua_State *L) {
+  auto instances = checkInstanceData(L, 1);
+  auto index = instances->add();
+  setComponents(L, 2, instances, index, 0);
+  lua_pushinteger(L, static_cast<lua_Integer>(index));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT18);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT18");
+int L_InstanceData_set(lua_State *L) {
+  auto instances = checkInstanceData(L, 1);
+  auto index = checkInstanceIndex(L, 2, instances);
+  auto component = luaL_checkinteger(L, 3);
+  luaL_argcheck(L,
+                component >= 0 && static_cast<size_t>(component) <
+                                      instances->getComponents(),
+                3, "component out of range");
+  setComponents(L, 4, instances, index, static_cast<size_t>(component));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT19);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT19");
+// setTransform(index, component, x, y, z[, qx, qy, qz, qw[, sx, sy, sz]])
+// writes a mat4 from a translation, a unit quaternion and a scale
+int L_InstanceData_setTransform(lua_State *L) {
+  auto instances = checkInstanceData(L, 1);
+  auto index = checkInstanceIndex(L, 2, instances);
+  auto component = luaL_checkinteger(L, 3);
+  luaL_argcheck(L,
+                component >= 0 && static_cast<size_t>(component) + 16 <=
+                                      instances->getComponents(),
+                3, "component out of range");
+  float translation[3];
+  for (int i = 0; i < 3; ++i) {
+    translation[i] = static_cast<float>(luaL_checknumber(L, 4 + i));
+  }
+  float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  for (int i = 0; i < 4; ++i) {
+    rotation[i] = static_cast<float>(luaL_optnumber(L, 7 + i, rotation[i]));
+  }
+  float scale[3];
+  for (int i = 0; i < 3; ++i) {
+    scale[i] = static_cast<float>(luaL_optnumber(L, 11 + i, 1.0));
+  }
+  instances->setTransform(index, static_cast<size_t>(component), translation,
+                          rotation, scale);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT20);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT20");
+int L_InstanceData_resize(lua_State *L) {
+  auto instances = checkInstanceData(L, 1);
+  auto count = luaL_checkinteger(L, 2);
+  luaL_argcheck(L, count >= 0, 2, "count out of range");
+  instances->resize(static_cast<size_t>(count));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT21);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT21");
+int L_InstanceData_clear(lua_State *L) {
+  checkInstanceData(L, 1)->clear();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT22);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT22");
+int L_InstanceData_getCount(lua_State *L) {
+  auto count = checkInstanceData(L, 1)->getCount();
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT23);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT23");
+int L_InstanceData_getComponents(lua_State *L) {
+  auto components = checkInstanceData(L, 1)->getComponents();
+  lua_pushinteger(L, static_cast<lua_Integer>(components));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT24);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT24");
+int L_InstanceData_getStride(lua_State *L) {
+  auto stride = checkInstanceData(L, 1)->getStride();
+  lua_pushinteger(L, static_cast<lua_Integer>(stride));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT25);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT25");
+int L_InstanceData_getByteSize(lua_State *L) {
+  auto size = checkInstanceData(L, 1)->getByteSize();
+  lua_pushinteger(L, static_cast<lua_Integer>(size));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT26);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT26");
+// glBufferData of every instance into the buffer bound to `target`
+int L_InstanceData_upload(lua_State *L) {
+  auto instances = checkInstanceData(L, 1);
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto usage = static_cast<GLenum>(luaL_optinteger(L, 3, GL_DYNAMIC_DRAW));
+  luaL_argcheck(L, instances->getCount() > 0, 1, "no instances.");
+  glBufferData(target, static_cast<GLsizeiptr>(instances->getByteSize()),
+               instances->getData(), usage);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT27);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT27");
+struct UDUniformLayout {
+  hello::gl::UniformLayout *data;
+};
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT28);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT28");
+hello::gl::UniformLayout *checkUniformLayout(lua_State *L, int idx) {
+  auto pLayout = static_cast<UDUniformLayout *>(
+      luaL_checkudata(L, idx, UNIFORM_LAYOUT_NAME));
+  luaL_argcheck(L, pLayout->data != nullptr, idx, "already freed.");
+  return pLayout->data;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT29);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT29");
+void pushUniformLayout(lua_State *L, hello::gl::UniformLayout *layout) {
+  auto pLayout = static_cast<UDUniformLayout *>(
+      lua_newuserdata(L, sizeof(UDUniformLayout)));
+  pLayout->data = layout;
+  luaL_setmetatable(L, UNIFORM_LAYOUT_NAME);
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT30);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT30");
+// GL.newUniformLayout({{name, type[, arraySize]}, ...}) places the members
+// of a uniform block by the std140 rules, for shaders declaring
+// layout(std140). type is GL.FLOAT, GL.FLOAT_VEC4, GL.FLOAT_MAT4, ...
+int L_newUniformLayout(lua_State *L) {
+  luaL_checktype(L, 1, LUA_TTABLE);
+  auto layout = new hello::gl::UniformLayout();
+  pushUniformLayout(L, layout);
+  const auto count = luaL_len(L, 1);
+  for (lua_Integer i = 1; i <= count; ++i) {
+    lua_geti(L, 1, i);
+    luaL_argcheck(L, lua_istable(L, -1), 1, "members must be tables");
+    lua_geti(L, -1, 1);
+    lua_geti(L, -2, 2);
+    lua_geti(L, -3, 3);
+    auto name = lua_tostring(L, -3);
+    auto type = lua_tointeger(L, -2);
+    auto arraySize = lua_isnil(L, -1) ? 1 : lua_tointeger(L, -1);
+    luaL_argcheck(L,
+                  name != nullptr && arraySize > 0 &&
+                      arraySize <= UINT32_MAX &&
+                      layout->add(name, static_cast<uint32_t>(type),
+                                  static_cast<uint32_t>(arraySize)),
+                  1, "invalid member");
+    lua_pop(L, 4);
+  }
+  return 1;
+}
 
-  lua_pushinteger(L, GL_COLOR_ATTACHMENT31);
-  lua_setfield(L, idx, "COLOR_ATTACHMENT31");
+// the layout of the uniform block `name` as the linked program has it,
+// for any layout qualifier. nil if the program has no such block.
+int L_getUniformBlockLayout(lua_State *L) {
+  auto program = static_cast<GLuint>(luaL_checkinteger(L, 1));
+  auto name = luaL_checkstring(L, 2);
+  auto layout = new hello::gl::UniformLayout();
+  if (!layout->reflect(program, name)) {
+    delete layout;
+    lua_pushnil(L);
+    return 1;
+  }
+  pushUniformLayout(L, layout);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_DEPTH_ATTACHMENT);
-  lua_setfield(L, idx, "DEPTH_ATTACHMENT");
+int L_UniformLayout_free(lua_State *L) {
+  auto pLayout = static_cast<UDUniformLayout *>(
+      luaL_checkudata(L, 1, UNIFORM_LAYOUT_NAME));
+  delete pLayout->data;
+  pLayout->data = nullptr;
+  return 0;
+}
 
-  lua_pushinteger(L, GL_STENCIL_ATTACHMENT);
-  lua_setfield(L, idx, "STENCIL_ATTACHMENT");
+int L_UniformLayout_getSize(lua_State *L) {
+  auto size = checkUniformLayout(L, 1)->getSize();
+  lua_pushinteger(L, static_cast<lua_Integer>(size));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER);
-  lua_setfield(L, idx, "FRAMEBUFFER");
+int L_UniformLayout_getOffset(lua_State *L) {
+  auto layout = checkUniformLayout(L, 1);
+  auto member = layout->find(luaL_checkstring(L, 2));
+  if (member == nullptr) {
+    lua_pushnil(L);
+    return 1;
+  }
+  lua_pushinteger(L, member->offset);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER);
-  lua_setfield(L, idx, "RENDERBUFFER");
+// a zeroed block to fill in with set() and upload, or write to a stream
+// buffer and bind with GL.bindBufferRange
+int L_UniformLayout_newBlock(lua_State *L) {
+  auto layout = checkUniformLayout(L, 1);
+  auto pBlock = static_cast<UDUniformBlock *>(
+      lua_newuserdata(L, sizeof(UDUniformBlock)));
+  pBlock->data = new hello::gl::UniformBlock(*layout);
+  luaL_setmetatable(L, UNIFORM_BLOCK_NAME);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_WIDTH);
-  lua_setfield(L, idx, "RENDERBUFFER_WIDTH");
+int L_UniformBlock_free(lua_State *L) {
+  auto pBlock = static_cast<UDUniformBlock *>(
+      luaL_checkudata(L, 1, UNIFORM_BLOCK_NAME));
+  delete pBlock->data;
+  pBlock->data = nullptr;
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_HEIGHT);
-  lua_setfield(L, idx, "RENDERBUFFER_HEIGHT");
+// writes the numbers from `arg` on to `name`, starting at array element
+// `element`; matrices take their values column by column
+int setUniform(lua_State *L, hello::gl::UniformBlock *block, const char *name,
+               lua_Integer element, int arg) {
+  const auto count = lua_gettop(L) - arg + 1;
+  luaL_argcheck(L, count > 0, arg, "specify values");
+  std::vector<double> values(static_cast<size_t>(count));
+  for (int i = 0; i < count; ++i) {
+    values[i] = luaL_checknumber(L, arg + i);
+  }
+  luaL_argcheck(L,
+                element >= 0 && block->set(name, static_cast<size_t>(element),
+                                           values.data(), values.size()),
+                2, "unknown member or too many values");
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_INTERNAL_FORMAT);
-  lua_setfield(L, idx, "RENDERBUFFER_INTERNAL_FORMAT");
+int L_UniformBlock_set(lua_State *L) {
+  auto block = checkUniformBlock(L, 1);
+  auto name = luaL_checkstring(L, 2);
+  return setUniform(L, block, name, 0, 3);
+}
 
-  lua_pushinteger(L, GL_STENCIL_INDEX8);
-  lua_setfield(L, idx, "STENCIL_INDEX8");
+int L_UniformBlock_setElement(lua_State *L) {
+  auto block = checkUniformBlock(L, 1);
+  auto name = luaL_checkstring(L, 2);
+  auto element = luaL_checkinteger(L, 3);
+  return setUniform(L, block, name, element, 4);
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_RED_SIZE);
-  lua_setfield(L, idx, "RENDERBUFFER_RED_SIZE");
+int L_UniformBlock_getSize(lua_State *L) {
+  auto size = checkUniformBlock(L, 1)->getSize();
+  lua_pushinteger(L, static_cast<lua_Integer>(size));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_GREEN_SIZE);
-  lua_setfield(L, idx, "RENDERBUFFER_GREEN_SIZE");
+// glBufferData of the block into the buffer bound to `target`
+int L_UniformBlock_upload(lua_State *L) {
+  auto block = checkUniformBlock(L, 1);
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto usage = static_cast<GLenum>(luaL_optinteger(L, 3, GL_DYNAMIC_DRAW));
+  luaL_argcheck(L, block->getSize() > 0, 1, "empty block.");
+  glBufferData(target, static_cast<GLsizeiptr>(block->getSize()),
+               block->getData(), usage);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_BLUE_SIZE);
-  lua_setfield(L, idx, "RENDERBUFFER_BLUE_SIZE");
+struct UDGpuTimer {
+  hello::gl::GpuTimer *data;
+};
 
-  lua_pushinteger(L, GL_RENDERBUFFER_ALPHA_SIZE);
-  lua_setfield(L, idx, "RENDERBUFFER_ALPHA_SIZE");
+hello::gl::GpuTimer *checkGpuTimer(lua_State *L, int idx) {
+  auto pTimer =
+      static_cast<UDGpuTimer *>(luaL_checkudata(L, idx, GPU_TIMER_NAME));
+  luaL_argcheck(L, pTimer->data != nullptr, idx, "already freed.");
+  return pTimer->data;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_DEPTH_SIZE);
-  lua_setfield(L, idx, "RENDERBUFFER_DEPTH_SIZE");
+// GL.newGpuTimer([maxPending[, window]]) times named passes on the GPU.
+// wrap each pass in beginPass(name) / endPass(), call collect() once per
+// frame and read getTimes() for the average over the last `window`
+// results of every pass.
+int L_newGpuTimer(lua_State *L) {
+  auto maxPending = luaL_optinteger(L, 1, 64);
+  luaL_argcheck(L, maxPending > 0, 1, "maxPending must be greater than 0");
+  auto window = luaL_optinteger(L, 2, 60);
+  luaL_argcheck(L, window > 0, 2, "window must be greater than 0");
+  auto pTimer =
+      static_cast<UDGpuTimer *>(lua_newuserdata(L, sizeof(UDGpuTimer)));
+  pTimer->data = new hello::gl::GpuTimer(static_cast<size_t>(maxPending),
+                                         static_cast<size_t>(window));
+  luaL_setmetatable(L, GPU_TIMER_NAME);
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RENDERBUFFER_STENCIL_SIZE);
-  lua_setfield(L, idx, "RENDERBUFFER_STENCIL_SIZE");
+int L_GpuTimer_free(lua_State *L) {
+  auto pTimer =
+      static_cast<UDGpuTimer *>(luaL_checkudata(L, 1, GPU_TIMER_NAME));
+  delete pTimer->data;
+  pTimer->data = nullptr;
+  return 0;
+}
 
-  lua_pushinteger(L, GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE);
-  lua_setfield(L, idx, "FRAMEBUFFER_INCOMPLETE_MULTISAMPLE");
+// false when the pass is not timed: no timer queries, a pass still open,
+// or too many results outstanding
+int L_GpuTimer_beginPass(lua_State *L) {
+  auto timer = checkGpuTimer(L, 1);
+  auto name = luaL_checkstring(L, 2);
+  lua_pushboolean(L, timer->beginPass(name));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_MAX_SAMPLES);
-  lua_setfield(L, idx, "MAX_SAMPLES");
+int L_GpuTimer_endPass(lua_State *L) {
+  checkGpuTimer(L, 1)->endPass();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_HALF_FLOAT);
-  lua_setfield(L, idx, "HALF_FLOAT");
+int L_GpuTimer_collect(lua_State *L) {
+  checkGpuTimer(L, 1)->collect();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_MAP_READ_BIT);
-  lua_setfield(L, idx, "MAP_READ_BIT");
+int L_GpuTimer_reset(lua_State *L) {
+  checkGpuTimer(L, 1)->reset();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_MAP_WRITE_BIT);
-  lua_setfield(L, idx, "MAP_WRITE_BIT");
+int L_GpuTimer_getPendingCount(lua_State *L) {
+  auto count = checkGpuTimer(L, 1)->getPendingCount();
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_MAP_INVALIDATE_RANGE_BIT);
-  lua_setfield(L, idx, "MAP_INVALIDATE_RANGE_BIT");
+// {{name, last, average, samples}, ...} in milliseconds, in the order the
+// passes were first begun
+int L_GpuTimer_getTimes(lua_State *L) {
+  auto times = checkGpuTimer(L, 1)->getTimes();
+  lua_createtable(L, static_cast<int>(times.size()), 0);
+  for (size_t i = 0; i < times.size(); ++i) {
+    const auto &time = times[i];
+    lua_createtable(L, 0, 4);
+    lua_pushlstring(L, time.name.data(), time.name.size());
+    lua_setfield(L, -2, "name");
+    lua_pushnumber(L, time.last);
+    lua_setfield(L, -2, "last");
+    lua_pushnumber(L, time.average);
+    lua_setfield(L, -2, "average");
+    lua_pushinteger(L, static_cast<lua_Integer>(time.samples));
+    lua_setfield(L, -2, "samples");
+    lua_seti(L, -2, static_cast<lua_Integer>(i + 1));
+  }
+  return 1;
+}
 
-  lua_pushinteger(L, GL_MAP_INVALIDATE_BUFFER_BIT);
-  lua_setfield(L, idx, "MAP_INVALIDATE_BUFFER_BIT");
+// reads {count, firstIndex[, baseVertex[, instanceCount]], bounds = {x, y,
+// z, radius}} at the top of the stack into a new draw of `list`
+void addDraw(lua_State *L, int arg, hello::gl::DrawList *list) {
+  luaL_argcheck(L, lua_istable(L, -1), arg, "draws must be tables");
+  lua_Integer values[4] = {-1, -1, 0, 1};
+  for (int i = 0; i < 4; ++i) {
+    lua_geti(L, -1, i + 1);
+    if (!lua_isnil(L, -1)) {
+      int isInteger;
+      values[i] = lua_tointegerx(L, -1, &isInteger);
+      luaL_argcheck(L, isInteger, arg, "draw fields must be integers");
+    }
+    lua_pop(L, 1);
+  }
+  luaL_argcheck(L,
+                values[0] >= 0 && values[0] <= UINT32_MAX &&
+                    values[1] >= 0 && values[1] <= UINT32_MAX &&
+                    values[2] >= INT32_MIN && values[2] <= INT32_MAX &&
+                    values[3] >= 0 && values[3] <= UINT32_MAX,
+                arg, "invalid draw");
+
+  float sphere[4];
+  const auto boundsType = lua_getfield(L, -1, "bounds");
+  if (boundsType != LUA_TNIL) {
+    luaL_argcheck(L, boundsType == LUA_TTABLE, arg,
+                  "bounds must be {x, y, z, radius}");
+    for (int i = 0; i < 4; ++i) {
+      lua_geti(L, -1, i + 1);
+      int isNumber;
+      sphere[i] = static_cast<float>(lua_tonumberx(L, -1, &isNumber));
+      luaL_argcheck(L, isNumber, arg, "bounds must be {x, y, z, radius}");
+      lua_pop(L, 1);
+    }
+    luaL_argcheck(L, sphere[3] >= 0, arg, "radius must not be negative");
+  }
+  lua_pop(L, 1);
 
-  lua_pushinteger(L, GL_MAP_FLUSH_EXPLICIT_BIT);
-  lua_setfield(L, idx, "MAP_FLUSH_EXPLICIT_BIT");
+  auto index = list->add({static_cast<uint32_t>(values[0]),
+                          static_cast<uint32_t>(values[3]),
+                          static_cast<uint32_t>(values[1]),
+                          static_cast<int32_t>(values[2]), 0});
+  if (boundsType != LUA_TNIL) {
+    list->setBounds(index, sphere, sphere[3]);
+  }
+}
 
-  lua_pushinteger(L, GL_MAP_UNSYNCHRONIZED_BIT);
-  lua_setfield(L, idx, "MAP_UNSYNCHRONIZED_BIT");
+// GL.newDrawList([draws]) collects indexed draws out of shared buffers,
+// natively culled and packed as indirect commands by build(). draws is a
+// sequence of {count, firstIndex[, baseVertex[, instanceCount]], bounds =
+// {x, y, z, radius}}. indices start at 0.
+int L_newDrawList(lua_State *L) {
+  auto pList =
+      static_cast<UDDrawList *>(lua_newuserdata(L, sizeof(UDDrawList)));
+  pList->data = new hello::gl::DrawList();
+  luaL_setmetatable(L, DRAW_LIST_NAME);
+  if (!lua_isnoneornil(L, 1)) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+    const auto count = luaL_len(L, 1);
+    for (lua_Integer i = 1; i <= count; ++i) {
+      lua_geti(L, 1, i);
+      addDraw(L, 1, pList->data);
+      lua_pop(L, 1);
+    }
+  }
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RG);
-  lua_setfield(L, idx, "RG");
+int L_DrawList_free(lua_State *L) {
+  auto pList =
+      static_cast<UDDrawList *>(luaL_checkudata(L, 1, DRAW_LIST_NAME));
+  delete pList->data;
+  pList->data = nullptr;
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RG_INTEGER);
-  lua_setfield(L, idx, "RG_INTEGER");
+// add(count, firstIndex[, baseVertex[, instanceCount[, baseInstance]]])
+// returns the index of the draw
+int L_DrawList_add(lua_State *L) {
+  auto list = checkDrawList(L, 1);
+  auto count = luaL_checkinteger(L, 2);
+  luaL_argcheck(L, count >= 0 && count <= UINT32_MAX, 2,
+                "count out of range");
+  auto firstIndex = luaL_checkinteger(L, 3);
+  luaL_argcheck(L, firstIndex >= 0 && firstIndex <= UINT32_MAX, 3,
+                "firstIndex out of range");
+  auto baseVertex = luaL_optinteger(L, 4, 0);
+  luaL_argcheck(L, baseVertex >= INT32_MIN && baseVertex <= INT32_MAX, 4,
+                "baseVertex out of range");
+  auto instanceCount = luaL_optinteger(L, 5, 1);
+  luaL_argcheck(L, instanceCount >= 0 && instanceCount <= UINT32_MAX, 5,
+                "instanceCount out of range");
+  auto baseInstance = luaL_optinteger(L, 6, 0);
+  luaL_argcheck(L, baseInstance >= 0 && baseInstance <= UINT32_MAX, 6,
+                "baseInstance out of range");
+  auto index = list->add(
+      {static_cast<uint32_t>(count), static_cast<uint32_t>(instanceCount),
+       static_cast<uint32_t>(firstIndex), static_cast<int32_t>(baseVertex),
+       static_cast<uint32_t>(baseInstance)});
+  lua_pushinteger(L, static_cast<lua_Integer>(index));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_R8);
-  lua_setfield(L, idx, "R8");
+// setBounds(index, x, y, z, radius) lets build() cull the draw
+int L_DrawList_setBounds(lua_State *L) {
+  auto list = checkDrawList(L, 1);
+  auto index = luaL_checkinteger(L, 2);
+  luaL_argcheck(L,
+                index >= 0 && static_cast<size_t>(index) < list->getCount(),
+                2, "index out of range");
+  float center[3];
+  for (int i = 0; i < 3; ++i) {
+    center[i] = static_cast<float>(luaL_checknumber(L, 3 + i));
+  }
+  auto radius = luaL_checknumber(L, 6);
+  luaL_argcheck(L, radius >= 0, 6, "radius must not be negative");
+  list->setBounds(static_cast<size_t>(index), center,
+                  static_cast<float>(radius));
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RG8);
-  lua_setfield(L, idx, "RG8");
+// build([viewProjection]) packs the draws whose bounds reach into the
+// frustum of the column-major matrix, given as a sequence of 16 numbers,
+// or every draw without one. returns the number of draws packed.
+int L_DrawList_build(lua_State *L) {
+  auto list = checkDrawList(L, 1);
+  size_t count;
+  if (lua_isnoneornil(L, 2)) {
+    count = list->build(nullptr);
+  } else {
+    luaL_checktype(L, 2, LUA_TTABLE);
+    luaL_argcheck(L, luaL_len(L, 2) == 16, 2, "specify a 4x4 matrix");
+    float matrix[16];
+    for (int i = 0; i < 16; ++i) {
+      lua_geti(L, 2, i + 1);
+      matrix[i] = static_cast<float>(lua_tonumber(L, -1));
+      lua_pop(L, 1);
+    }
+    count = list->build(matrix);
+  }
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_R16F);
-  lua_setfield(L, idx, "R16F");
+// draw(mode, type) issues the packed draws one by one, merging neighbours
+// that continue each other, for contexts without indirect draws
+int L_DrawList_draw(lua_State *L) {
+  auto list = checkDrawList(L, 1);
+  auto mode = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto type = static_cast<GLenum>(luaL_checkinteger(L, 3));
+  switch (list->draw(mode, type)) {
+  case hello::gl::DrawResult::Drawn:
+    return 0;
+  case hello::gl::DrawResult::BadIndexType:
+    return luaL_argerror(L, 3, "indices must be unsigned integers");
+  case hello::gl::DrawResult::NeedsBaseInstance:
+    return luaL_error(L, "baseInstance needs indirect draws.");
+  case hello::gl::DrawResult::NeedsBaseVertex:
+    return luaL_error(L, "baseVertex is not supported.");
+  case hello::gl::DrawResult::NeedsInstancing:
+    return luaL_error(L, "instancing is not supported.");
+  }
+  return 0;
+}
 
-  lua_pushinteger(L, GL_R32F);
-  lua_setfield(L, idx, "R32F");
+int L_DrawList_clear(lua_State *L) {
+  checkDrawList(L, 1)->clear();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RG16F);
-  lua_setfield(L, idx, "RG16F");
+int L_DrawList_getCount(lua_State *L) {
+  auto count = checkDrawList(L, 1)->getCount();
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RG32F);
-  lua_setfield(L, idx, "RG32F");
+int L_DrawList_getDrawCount(lua_State *L) {
+  auto count = checkDrawList(L, 1)->getDrawCount();
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_R8I);
-  lua_setfield(L, idx, "R8I");
+int L_DrawList_getStride(lua_State *L) {
+  auto stride = checkDrawList(L, 1)->getStride();
+  lua_pushinteger(L, static_cast<lua_Integer>(stride));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_R8UI);
-  lua_setfield(L, idx, "R8UI");
+int L_DrawList_getByteSize(lua_State *L) {
+  auto size = checkDrawList(L, 1)->getByteSize();
+  lua_pushinteger(L, static_cast<lua_Integer>(size));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_R16I);
-  lua_setfield(L, idx, "R16I");
+// glBufferData of the packed commands into the buffer bound to `target`,
+// usually GL.DRAW_INDIRECT_BUFFER
+int L_DrawList_upload(lua_State *L) {
+  auto list = checkDrawList(L, 1);
+  auto target = static_cast<GLenum>(luaL_checkinteger(L, 2));
+  auto usage = static_cast<GLenum>(luaL_optinteger(L, 3, GL_DYNAMIC_DRAW));
+  luaL_argcheck(L, list->getDrawCount() > 0, 1, "no draws packed.");
+  glBufferData(target, static_cast<GLsizeiptr>(list->getByteSize()),
+               list->getData(), usage);
+  return 0;
+}
 
-  lua_pushinteger(L, GL_R16UI);
-  lua_setfield(L, idx, "R16UI");
+struct UDStreamBuffer {
+  hello::gl::StreamBuffer *data;
+};
 
-  lua_pushinteger(L, GL_R32I);
-  lua_setfield(L, idx, "R32I");
+hello::gl::StreamBuffer *checkStreamBuffer(lua_State *L, int idx) {
+  auto pStream = static_cast<UDStreamBuffer *>(
+      luaL_checkudata(L, idx, STREAM_BUFFER_NAME));
+  luaL_argcheck(L, pStream->data != nullptr, idx, "already freed.");
+  return pStream->data;
+}
 
-  lua_pushinteger(L, GL_R32UI);
-  lua_setfield(L, idx, "R32UI");
+// a ring for data rewritten every frame. write() returns the offset to
+// pass to vertexAttribPointer or drawElements; call fence() once the
+// draws reading this frame's data have been issued.
+int L_newStreamBuffer(lua_State *L) {
+  auto size = luaL_checkinteger(L, 1);
+  luaL_argcheck(L, size > 0, 1, "size must be greater than 0");
+  auto target = static_cast<GLenum>(luaL_optinteger(L, 2, GL_ARRAY_BUFFER));
+  auto pStream = static_cast<UDStreamBuffer *>(
+      lua_newuserdata(L, sizeof(UDStreamBuffer)));
+  pStream->data = nullptr;
+  luaL_setmetatable(L, STREAM_BUFFER_NAME);
+  pStream->data = new hello::gl::StreamBuffer(
+      target, static_cast<size_t>(size), getStateCache());
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RG8I);
-  lua_setfield(L, idx, "RG8I");
+int L_StreamBuffer_free(lua_State *L) {
+  auto pStream = static_cast<UDStreamBuffer *>(
+      luaL_checkudata(L, 1, STREAM_BUFFER_NAME));
+  if (pStream->data != nullptr) {
+    auto buffer = pStream->data->getBuffer();
+    delete pStream->data;
+    pStream->data = nullptr;
+    getStateCache().bufferDeleted(buffer);
+  }
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RG8UI);
-  lua_setfield(L, idx, "RG8UI");
+int L_StreamBuffer_write(lua_State *L) {
+  auto stream = checkStreamBuffer(L, 1);
+  auto alignment = luaL_optinteger(L, 3, 1);
+  luaL_argcheck(L, alignment > 0, 3, "alignment must be greater than 0");
+  size_t size;
+  SDL_Surface *surface = nullptr;
+  auto data = checkBytes(L, 2, &size, &surface);
+  size_t offset;
+  auto written = stream->write(data, size, static_cast<size_t>(alignment),
+                               getStateCache(), &offset);
+  if (surface != nullptr) {
+    SDL_UnlockSurface(surface);
+  }
+  if (!written) {
+    auto message = "no free space, call fence() every frame.";
+    if (size > stream->getSize()) {
+      message = "data is larger than the buffer.";
+    } else if (stream->isLost()) {
+      message = "waiting for the GPU failed.";
+    }
+    lua_pushnil(L);
+    lua_pushstring(L, message);
+    return 2;
+  }
+  lua_pushinteger(L, static_cast<lua_Integer>(offset));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RG16I);
-  lua_setfield(L, idx, "RG16I");
+int L_StreamBuffer_fence(lua_State *L) {
+  checkStreamBuffer(L, 1)->fence();
+  return 0;
+}
 
-  lua_pushinteger(L, GL_RG16UI);
-  lua_setfield(L, idx, "RG16UI");
+int L_StreamBuffer_getBuffer(lua_State *L) {
+  lua_pushinteger(L, checkStreamBuffer(L, 1)->getBuffer());
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RG32I);
-  lua_setfield(L, idx, "RG32I");
+int L_StreamBuffer_getSize(lua_State *L) {
+  auto size = checkStreamBuffer(L, 1)->getSize();
+  lua_pushinteger(L, static_cast<lua_Integer>(size));
+  return 1;
+}
 
-  lua_pushinteger(L, GL_RG32UI);
-  lua_setfield(L, idx, "RG32UI");
+int L_StreamBuffer_isPersistent(lua_State *L) {
+  lua_pushboolean(L, checkStreamBuffer(L, 1)->isPersistent());
+  return 1;
+}
 
-  lua_pushinteger(L, GL_VERTEX_ARRAY_BINDING);
-  lua_setfield(L, idx, "VERTEX_ARRAY_BINDING");
+struct Constant {
+  std::string_view name;
+  lua_Integer value;
+};
+
+// every GL enum the module exposes, sorted by name for binary search.
+// nothing is put into the module table up front: GL.<NAME> is resolved by
+// L_indexConstant on first use and stored in the table from then on.
+constexpr Constant CONSTANTS[] = {
+    {"ACTIVE_ATTRIBUTES", GL_ACTIVE_ATTRIBUTES},
+    {"ACTIVE_ATTRIBUTE_MAX_LENGTH", GL_ACTIVE_ATTRIBUTE_MAX_LENGTH},
+    {"ACTIVE_TEXTURE", GL_ACTIVE_TEXTURE},
+    {"ACTIVE_UNIFORMS", GL_ACTIVE_UNIFORMS},
+    {"ACTIVE_UNIFORM_MAX_LENGTH", GL_ACTIVE_UNIFORM_MAX_LENGTH},
+    {"ALIASED_LINE_WIDTH_RANGE", GL_ALIASED_LINE_WIDTH_RANGE},
+    {"ALPHA", GL_ALPHA},
+    {"ALWAYS", GL_ALWAYS},
+    {"ARRAY_BUFFER", GL_ARRAY_BUFFER},
+    {"ARRAY_BUFFER_BINDING", GL_ARRAY_BUFFER_BINDING},
+    {"ATTACHED_SHADERS", GL_ATTACHED_SHADERS},
+    {"BACK", GL_BACK},
+    {"BLEND", GL_BLEND},
+    {"BLEND_COLOR", GL_BLEND_COLOR},
+    {"BLEND_DST_ALPHA", GL_BLEND_DST_ALPHA},
+    {"BLEND_DST_RGB", GL_BLEND_DST_RGB},
+    {"BLEND_EQUATION", GL_BLEND_EQUATION},
+    {"BLEND_EQUATION_ALPHA", GL_BLEND_EQUATION_ALPHA},
+    {"BLEND_EQUATION_RGB", GL_BLEND_EQUATION_RGB},
+    {"BLEND_SRC_ALPHA", GL_BLEND_SRC_ALPHA},
+    {"BLEND_SRC_RGB", GL_BLEND_SRC_RGB},
+    {"BLUE", GL_BLUE},
+    {"BOOL", GL_BOOL},
+    {"BOOL_VEC2", GL_BOOL_VEC2},
+    {"BOOL_VEC3", GL_BOOL_VEC3},
+    {"BOOL_VEC4", GL_BOOL_VEC4},
+    {"BUFFER_ACCESS_FLAGS", GL_BUFFER_ACCESS_FLAGS},
+    {"BUFFER_MAPPED", GL_BUFFER_MAPPED},
+    {"BUFFER_MAP_LENGTH", GL_BUFFER_MAP_LENGTH},
+    {"BUFFER_MAP_OFFSET", GL_BUFFER_MAP_OFFSET},
+    {"BUFFER_MAP_POINTER", GL_BUFFER_MAP_POINTER},
+    {"BUFFER_SIZE", GL_BUFFER_SIZE},
+    {"BUFFER_USAGE", GL_BUFFER_USAGE},
+    {"BYTE", GL_BYTE},
+    {"CCW", GL_CCW},
+    {"CLAMP_TO_EDGE", GL_CLAMP_TO_EDGE},
+    {"COLOR", GL_COLOR},
+    {"COLOR_ATTACHMENT0", GL_COLOR_ATTACHMENT0},
+    {"COLOR_ATTACHMENT1", GL_COLOR_ATTACHMENT1},
+    {"COLOR_ATTACHMENT10", GL_COLOR_ATTACHMENT10},
+    {"COLOR_ATTACHMENT11", GL_COLOR_ATTACHMENT11},
+    {"COLOR_ATTACHMENT12", GL_COLOR_ATTACHMENT12},
+    {"COLOR_ATTACHMENT13", GL_COLOR_ATTACHMENT13},
+    {"COLOR_ATTACHMENT14", GL_COLOR_ATTACHMENT14},
+    {"COLOR_ATTACHMENT15", GL_COLOR_ATTACHMENT15},
+    {"COLOR_ATTACHMENT16", GL_COLOR_ATTACHMENT16},
+    {"COLOR_ATTACHMENT17", GL_COLOR_ATTACHMENT17},
+    {"COLOR_ATTACHMENT18", GL_COLOR_ATTACHMENT18},
+    {"COLOR_ATTACHMENT19", GL_COLOR_ATTACHMENT19},
+    {"COLOR_ATTACHMENT2", GL_COLOR_ATTACHMENT2},
+    {"COLOR_ATTACHMENT20", GL_COLOR_ATTACHMENT20},
+    {"COLOR_ATTACHMENT21", GL_COLOR_ATTACHMENT21},
+    {"COLOR_ATTACHMENT22", GL_COLOR_ATTACHMENT22},
+    {"COLOR_ATTACHMENT23", GL_COLOR_ATTACHMENT23},
+    {"COLOR_ATTACHMENT24", GL_COLOR_ATTACHMENT24},
+    {"COLOR_ATTACHMENT25", GL_COLOR_ATTACHMENT25},
+    {"COLOR_ATTACHMENT26", GL_COLOR_ATTACHMENT26},
+    {"COLOR_ATTACHMENT27", GL_COLOR_ATTACHMENT27},
+    {"COLOR_ATTACHMENT28", GL_COLOR_ATTACHMENT28},
+    {"COLOR_ATTACHMENT29", GL_COLOR_ATTACHMENT29},
+    {"COLOR_ATTACHMENT3", GL_COLOR_ATTACHMENT3},
+    {"COLOR_ATTACHMENT30", GL_COLOR_ATTACHMENT30},
+    {"COLOR_ATTACHMENT31", GL_COLOR_ATTACHMENT31},
+    {"COLOR_ATTACHMENT4", GL_COLOR_ATTACHMENT4},
+    {"COLOR_ATTACHMENT5", GL_COLOR_ATTACHMENT5},
+    {"COLOR_ATTACHMENT6", GL_COLOR_ATTACHMENT6},
+    {"COLOR_ATTACHMENT7", GL_COLOR_ATTACHMENT7},
+    {"COLOR_ATTACHMENT8", GL_COLOR_ATTACHMENT8},
+    {"COLOR_ATTACHMENT9", GL_COLOR_ATTACHMENT9},
+    {"COLOR_BUFFER_BIT", GL_COLOR_BUFFER_BIT},
+    {"COLOR_CLEAR_VALUE", GL_COLOR_CLEAR_VALUE},
+    {"COLOR_WRITEMASK", GL_COLOR_WRITEMASK},
+    {"COMPARE_REF_TO_TEXTURE", GL_COMPARE_REF_TO_TEXTURE},
+    {"COMPILE_STATUS", GL_COMPILE_STATUS},
+    {"COMPRESSED_RGB8_ETC2", GL_COMPRESSED_RGB8_ETC2},
+    {"COMPRESSED_RGBA8_ETC2_EAC", GL_COMPRESSED_RGBA8_ETC2_EAC},
+    {"COMPRESSED_RGBA_BPTC_UNORM", GL_COMPRESSED_RGBA_BPTC_UNORM},
+    {"COMPRESSED_RGBA_S3TC_DXT5_EXT", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT},
+    {"COMPRESSED_RGB_S3TC_DXT1_EXT", GL_COMPRESSED_RGB_S3TC_DXT1_EXT},
+    {"COMPRESSED_TEXTURE_FORMATS", GL_COMPRESSED_TEXTURE_FORMATS},
+    {"CONSTANT_ALPHA", GL_CONSTANT_ALPHA},
+    {"CONSTANT_COLOR", GL_CONSTANT_COLOR},
+    {"COPY_READ_BUFFER", GL_COPY_READ_BUFFER},
+    {"COPY_WRITE_BUFFER", GL_COPY_WRITE_BUFFER},
+    {"CULL_FACE", GL_CULL_FACE},
+    {"CULL_FACE_MODE", GL_CULL_FACE_MODE},
+    {"CURRENT_PROGRAM", GL_CURRENT_PROGRAM},
+    {"CURRENT_QUERY", GL_CURRENT_QUERY},
+    {"CURRENT_VERTEX_ATTRIB", GL_CURRENT_VERTEX_ATTRIB},
+    {"CW", GL_CW},
+    {"DECR", GL_DECR},
+    {"DECR_WRAP", GL_DECR_WRAP},
+    {"DELETE_STATUS", GL_DELETE_STATUS},
+    {"DEPTH", GL_DEPTH},
+    {"DEPTH24_STENCIL8", GL_DEPTH24_STENCIL8},
+    {"DEPTH32F_STENCIL8", GL_DEPTH32F_STENCIL8},
+    {"DEPTH_ATTACHMENT", GL_DEPTH_ATTACHMENT},
+    {"DEPTH_BUFFER_BIT", GL_DEPTH_BUFFER_BIT},
+    {"DEPTH_CLEAR_VALUE", GL_DEPTH_CLEAR_VALUE},
+    {"DEPTH_COMPONENT", GL_DEPTH_COMPONENT},
+    {"DEPTH_COMPONENT16", GL_DEPTH_COMPONENT16},
+    {"DEPTH_COMPONENT24", GL_DEPTH_COMPONENT24},
+    {"DEPTH_COMPONENT32F", GL_DEPTH_COMPONENT32F},
+    {"DEPTH_FUNC", GL_DEPTH_FUNC},
+    {"DEPTH_RANGE", GL_DEPTH_RANGE},
+    {"DEPTH_STENCIL", GL_DEPTH_STENCIL},
+    {"DEPTH_STENCIL_ATTACHMENT", GL_DEPTH_STENCIL_ATTACHMENT},
+    {"DEPTH_TEST", GL_DEPTH_TEST},
+    {"DEPTH_WRITEMASK", GL_DEPTH_WRITEMASK},
+    {"DITHER", GL_DITHER},
+    {"DONT_CARE", GL_DONT_CARE},
+    {"DRAW_BUFFER0", GL_DRAW_BUFFER0},
+    {"DRAW_BUFFER1", GL_DRAW_BUFFER1},
+    {"DRAW_BUFFER10", GL_DRAW_BUFFER10},
+    {"DRAW_BUFFER11", GL_DRAW_BUFFER11},
+    {"DRAW_BUFFER12", GL_DRAW_BUFFER12},
+    {"DRAW_BUFFER13", GL_DRAW_BUFFER13},
+    {"DRAW_BUFFER14", GL_DRAW_BUFFER14},
+    {"DRAW_BUFFER15", GL_DRAW_BUFFER15},
+    {"DRAW_BUFFER2", GL_DRAW_BUFFER2},
+    {"DRAW_BUFFER3", GL_DRAW_BUFFER3},
+    {"DRAW_BUFFER4", GL_DRAW_BUFFER4},
+    {"DRAW_BUFFER5", GL_DRAW_BUFFER5},
+    {"DRAW_BUFFER6", GL_DRAW_BUFFER6},
+    {"DRAW_BUFFER7", GL_DRAW_BUFFER7},
+    {"DRAW_BUFFER8", GL_DRAW_BUFFER8},
+    {"DRAW_BUFFER9", GL_DRAW_BUFFER9},
+    {"DRAW_FRAMEBUFFER", GL_DRAW_FRAMEBUFFER},
+    {"DRAW_FRAMEBUFFER_BINDING", GL_DRAW_FRAMEBUFFER_BINDING},
+    {"DRAW_INDIRECT_BUFFER", GL_DRAW_INDIRECT_BUFFER},
+    {"DRAW_INDIRECT_BUFFER_BINDING", GL_DRAW_INDIRECT_BUFFER_BINDING},
+    {"DST_ALPHA", GL_DST_ALPHA},
+    {"DST_COLOR", GL_DST_COLOR},
+    {"DYNAMIC_COPY", GL_DYNAMIC_COPY},
+    {"DYNAMIC_DRAW", GL_DYNAMIC_DRAW},
+    {"DYNAMIC_READ", GL_DYNAMIC_READ},
+    {"ELEMENT_ARRAY_BUFFER", GL_ELEMENT_ARRAY_BUFFER},
+    {"ELEMENT_ARRAY_BUFFER_BINDING", GL_ELEMENT_ARRAY_BUFFER_BINDING},
+    {"EQUAL", GL_EQUAL},
+    {"EXTENSIONS", GL_EXTENSIONS},
+    {"FALSE", GL_FALSE},
+    {"FASTEST", GL_FASTEST},
+    {"FLOAT", GL_FLOAT},
+    {"FLOAT_32_UNSIGNED_INT_24_8_REV", GL_FLOAT_32_UNSIGNED_INT_24_8_REV},
+    {"FLOAT_MAT2", GL_FLOAT_MAT2},
+    {"FLOAT_MAT2x3", GL_FLOAT_MAT2x3},
+    {"FLOAT_MAT2x4", GL_FLOAT_MAT2x4},
+    {"FLOAT_MAT3", GL_FLOAT_MAT3},
+    {"FLOAT_MAT3x2", GL_FLOAT_MAT3x2},
+    {"FLOAT_MAT3x4", GL_FLOAT_MAT3x4},
+    {"FLOAT_MAT4", GL_FLOAT_MAT4},
+    {"FLOAT_MAT4x2", GL_FLOAT_MAT4x2},
+    {"FLOAT_MAT4x3", GL_FLOAT_MAT4x3},
+    {"FLOAT_VEC2", GL_FLOAT_VEC2},
+    {"FLOAT_VEC3", GL_FLOAT_VEC3},
+    {"FLOAT_VEC4", GL_FLOAT_VEC4},
+    {"FRAGMENT_SHADER", GL_FRAGMENT_SHADER},
+    {"FRAGMENT_SHADER_DERIVATIVE_HINT", GL_FRAGMENT_SHADER_DERIVATIVE_HINT},
+    {"FRAMEBUFFER", GL_FRAMEBUFFER},
+    {"FRAMEBUFFER_ATTACHMENT_ALPHA_SIZE", GL_FRAMEBUFFER_ATTACHMENT_ALPHA_SIZE},
+    {"FRAMEBUFFER_ATTACHMENT_BLUE_SIZE", GL_FRAMEBUFFER_ATTACHMENT_BLUE_SIZE},
+    {"FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING",
+     GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING},
+    {"FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE",
+     GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE},
+    {"FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE", GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE},
+    {"FRAMEBUFFER_ATTACHMENT_GREEN_SIZE", GL_FRAMEBUFFER_ATTACHMENT_GREEN_SIZE},
+    {"FRAMEBUFFER_ATTACHMENT_OBJECT_NAME",
+     GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME},
+    {"FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE",
+     GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE},
+    {"FRAMEBUFFER_ATTACHMENT_RED_SIZE", GL_FRAMEBUFFER_ATTACHMENT_RED_SIZE},
+    {"FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE",
+     GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE},
+    {"FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE",
+     GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_CUBE_MAP_FACE},
+    {"FRAMEBUFFER_ATTACHMENT_TEXTURE_LAYER",
+     GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LAYER},
+    {"FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL",
+     GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL},
+    {"FRAMEBUFFER_BINDING", GL_FRAMEBUFFER_BINDING},
+    {"FRAMEBUFFER_COMPLETE", GL_FRAMEBUFFER_COMPLETE},
+    {"FRAMEBUFFER_DEFAULT", GL_FRAMEBUFFER_DEFAULT},
+    {"FRAMEBUFFER_INCOMPLETE_ATTACHMENT", GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT},
+    {"FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT",
+     GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT},
+    {"FRAMEBUFFER_INCOMPLETE_MULTISAMPLE",
+     GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE},
+    {"FRAMEBUFFER_UNDEFINED", GL_FRAMEBUFFER_UNDEFINED},
+    {"FRAMEBUFFER_UNSUPPORTED", GL_FRAMEBUFFER_UNSUPPORTED},
+    {"FRONT", GL_FRONT},
+    {"FRONT_AND_BACK", GL_FRONT_AND_BACK},
+    {"FRONT_FACE", GL_FRONT_FACE},
+    {"FUNC_ADD", GL_FUNC_ADD},
+    {"FUNC_REVERSE_SUBTRACT", GL_FUNC_REVERSE_SUBTRACT},
+    {"FUNC_SUBTRACT", GL_FUNC_SUBTRACT},
+    {"GEQUAL", GL_GEQUAL},
+    {"GPU_DISJOINT", GL_GPU_DISJOINT},
+    {"GREATER", GL_GREATER},
+    {"GREEN", GL_GREEN},
+    {"HALF_FLOAT", GL_HALF_FLOAT},
+    {"INCR", GL_INCR},
+    {"INCR_WRAP", GL_INCR_WRAP},
+    {"INFO_LOG_LENGTH", GL_INFO_LOG_LENGTH},
+    {"INT", GL_INT},
+    {"INTERLEAVED_ATTRIBS", GL_INTERLEAVED_ATTRIBS},
+    {"INT_SAMPLER_2D", GL_INT_SAMPLER_2D},
+    {"INT_SAMPLER_2D_ARRAY", GL_INT_SAMPLER_2D_ARRAY},
+    {"INT_SAMPLER_3D", GL_INT_SAMPLER_3D},
+    {"INT_SAMPLER_CUBE", GL_INT_SAMPLER_CUBE},
+    {"INT_VEC2", GL_INT_VEC2},
+    {"INT_VEC3", GL_INT_VEC3},
+    {"INT_VEC4", GL_INT_VEC4},
+    {"INVALID_ENUM", GL_INVALID_ENUM},
+    {"INVALID_FRAMEBUFFER_OPERATION", GL_INVALID_FRAMEBUFFER_OPERATION},
+    {"INVALID_OPERATION", GL_INVALID_OPERATION},
+    {"INVALID_VALUE", GL_INVALID_VALUE},
+    {"INVERT", GL_INVERT},
+    {"KEEP", GL_KEEP},
+    {"LEQUAL", GL_LEQUAL},
+    {"LESS", GL_LESS},
+    {"LINEAR", GL_LINEAR},
+    {"LINEAR_MIPMAP_LINEAR", GL_LINEAR_MIPMAP_LINEAR},
+    {"LINEAR_MIPMAP_NEAREST", GL_LINEAR_MIPMAP_NEAREST},
+    {"LINES", GL_LINES},
+    {"LINE_LOOP", GL_LINE_LOOP},
+    {"LINE_STRIP", GL_LINE_STRIP},
+    {"LINK_STATUS", GL_LINK_STATUS},
+    {"MAJOR_VERSION", GL_MAJOR_VERSION},
+    {"MAP_FLUSH_EXPLICIT_BIT", GL_MAP_FLUSH_EXPLICIT_BIT},
+    {"MAP_INVALIDATE_BUFFER_BIT", GL_MAP_INVALIDATE_BUFFER_BIT},
+    {"MAP_INVALIDATE_RANGE_BIT", GL_MAP_INVALIDATE_RANGE_BIT},
+    {"MAP_READ_BIT", GL_MAP_READ_BIT},
+    {"MAP_UNSYNCHRONIZED_BIT", GL_MAP_UNSYNCHRONIZED_BIT},
+    {"MAP_WRITE_BIT", GL_MAP_WRITE_BIT},
+    {"MAX", GL_MAX},
+    {"MAX_3D_TEXTURE_SIZE", GL_MAX_3D_TEXTURE_SIZE},
+    {"MAX_ARRAY_TEXTURE_LAYERS", GL_MAX_ARRAY_TEXTURE_LAYERS},
+    {"MAX_COLOR_ATTACHMENTS", GL_MAX_COLOR_ATTACHMENTS},
+    {"MAX_COMBINED_TEXTURE_IMAGE_UNITS", GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS},
+    {"MAX_CUBE_MAP_TEXTURE_SIZE", GL_MAX_CUBE_MAP_TEXTURE_SIZE},
+    {"MAX_DRAW_BUFFERS", GL_MAX_DRAW_BUFFERS},
+    {"MAX_ELEMENTS_INDICES", GL_MAX_ELEMENTS_INDICES},
+    {"MAX_ELEMENTS_VERTICES", GL_MAX_ELEMENTS_VERTICES},
+    {"MAX_FRAGMENT_UNIFORM_COMPONENTS", GL_MAX_FRAGMENT_UNIFORM_COMPONENTS},
+    {"MAX_PROGRAM_TEXEL_OFFSET", GL_MAX_PROGRAM_TEXEL_OFFSET},
+    {"MAX_RENDERBUFFER_SIZE", GL_MAX_RENDERBUFFER_SIZE},
+    {"MAX_SAMPLES", GL_MAX_SAMPLES},
+    {"MAX_TEXTURE_IMAGE_UNITS", GL_MAX_TEXTURE_IMAGE_UNITS},
+    {"MAX_TEXTURE_LOD_BIAS", GL_MAX_TEXTURE_LOD_BIAS},
+    {"MAX_TEXTURE_SIZE", GL_MAX_TEXTURE_SIZE},
+    {"MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS",
+     GL_MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS},
+    {"MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS",
+     GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS},
+    {"MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS",
+     GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS},
+    {"MAX_UNIFORM_BLOCK_SIZE", GL_MAX_UNIFORM_BLOCK_SIZE},
+    {"MAX_UNIFORM_BUFFER_BINDINGS", GL_MAX_UNIFORM_BUFFER_BINDINGS},
+    {"MAX_VARYING_COMPONENTS", GL_MAX_VARYING_COMPONENTS},
+    {"MAX_VERTEX_ATTRIBS", GL_MAX_VERTEX_ATTRIBS},
+    {"MAX_VERTEX_TEXTURE_IMAGE_UNITS", GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS},
+    {"MAX_VERTEX_UNIFORM_COMPONENTS", GL_MAX_VERTEX_UNIFORM_COMPONENTS},
+    {"MAX_VIEWPORT_DIMS", GL_MAX_VIEWPORT_DIMS},
+    {"MIN", GL_MIN},
+    {"MINOR_VERSION", GL_MINOR_VERSION},
+    {"MIN_PROGRAM_TEXEL_OFFSET", GL_MIN_PROGRAM_TEXEL_OFFSET},
+    {"MIRRORED_REPEAT", GL_MIRRORED_REPEAT},
+    {"NEAREST", GL_NEAREST},
+    {"NEAREST_MIPMAP_LINEAR", GL_NEAREST_MIPMAP_LINEAR},
+    {"NEAREST_MIPMAP_NEAREST", GL_NEAREST_MIPMAP_NEAREST},
+    {"NEVER", GL_NEVER},
+    {"NICEST", GL_NICEST},
+    {"NONE", GL_NONE},
+    {"NOTEQUAL", GL_NOTEQUAL},
+    {"NO_ERROR", GL_NO_ERROR},
+    {"NUM_COMPRESSED_TEXTURE_FORMATS", GL_NUM_COMPRESSED_TEXTURE_FORMATS},
+    {"NUM_EXTENSIONS", GL_NUM_EXTENSIONS},
+    {"ONE", GL_ONE},
+    {"ONE_MINUS_CONSTANT_ALPHA", GL_ONE_MINUS_CONSTANT_ALPHA},
+    {"ONE_MINUS_CONSTANT_COLOR", GL_ONE_MINUS_CONSTANT_COLOR},
+    {"ONE_MINUS_DST_ALPHA", GL_ONE_MINUS_DST_ALPHA},
+    {"ONE_MINUS_DST_COLOR", GL_ONE_MINUS_DST_COLOR},
+    {"ONE_MINUS_SRC_ALPHA", GL_ONE_MINUS_SRC_ALPHA},
+    {"ONE_MINUS_SRC_COLOR", GL_ONE_MINUS_SRC_COLOR},
+    {"OUT_OF_MEMORY", GL_OUT_OF_MEMORY},
+    {"PACK_ALIGNMENT", GL_PACK_ALIGNMENT},
+    {"PACK_ROW_LENGTH", GL_PACK_ROW_LENGTH},
+    {"PACK_SKIP_PIXELS", GL_PACK_SKIP_PIXELS},
+    {"PACK_SKIP_ROWS", GL_PACK_SKIP_ROWS},
+    {"PIXEL_PACK_BUFFER", GL_PIXEL_PACK_BUFFER},
+    {"PIXEL_PACK_BUFFER_BINDING", GL_PIXEL_PACK_BUFFER_BINDING},
+    {"PIXEL_UNPACK_BUFFER", GL_PIXEL_UNPACK_BUFFER},
+    {"PIXEL_UNPACK_BUFFER_BINDING", GL_PIXEL_UNPACK_BUFFER_BINDING},
+    {"POINTS", GL_POINTS},
+    {"POLYGON_OFFSET_FACTOR", GL_POLYGON_OFFSET_FACTOR},
+    {"POLYGON_OFFSET_FILL", GL_POLYGON_OFFSET_FILL},
+    {"POLYGON_OFFSET_UNITS", GL_POLYGON_OFFSET_UNITS},
+    {"QUERY_RESULT", GL_QUERY_RESULT},
+    {"QUERY_RESULT_AVAILABLE", GL_QUERY_RESULT_AVAILABLE},
+    {"R11F_G11F_B10F", GL_R11F_G11F_B10F},
+    {"R16F", GL_R16F},
+    {"R16I", GL_R16I},
+    {"R16UI", GL_R16UI},
+    {"R32F", GL_R32F},
+    {"R32I", GL_R32I},
+    {"R32UI", GL_R32UI},
+    {"R8", GL_R8},
+    {"R8I", GL_R8I},
+    {"R8UI", GL_R8UI},
+    {"RASTERIZER_DISCARD", GL_RASTERIZER_DISCARD},
+    {"READ_BUFFER", GL_READ_BUFFER},
+    {"READ_FRAMEBUFFER", GL_READ_FRAMEBUFFER},
+    {"READ_FRAMEBUFFER_BINDING", GL_READ_FRAMEBUFFER_BINDING},
+    {"RED", GL_RED},
+    {"RED_INTEGER", GL_RED_INTEGER},
+    {"RENDERBUFFER", GL_RENDERBUFFER},
+    {"RENDERBUFFER_ALPHA_SIZE", GL_RENDERBUFFER_ALPHA_SIZE},
+    {"RENDERBUFFER_BINDING", GL_RENDERBUFFER_BINDING},
+    {"RENDERBUFFER_BLUE_SIZE", GL_RENDERBUFFER_BLUE_SIZE},
+    {"RENDERBUFFER_DEPTH_SIZE", GL_RENDERBUFFER_DEPTH_SIZE},
+    {"RENDERBUFFER_GREEN_SIZE", GL_RENDERBUFFER_GREEN_SIZE},
+    {"RENDERBUFFER_HEIGHT", GL_RENDERBUFFER_HEIGHT},
+    {"RENDERBUFFER_INTERNAL_FORMAT", GL_RENDERBUFFER_INTERNAL_FORMAT},
+    {"RENDERBUFFER_RED_SIZE", GL_RENDERBUFFER_RED_SIZE},
+    {"RENDERBUFFER_SAMPLES", GL_RENDERBUFFER_SAMPLES},
+    {"RENDERBUFFER_STENCIL_SIZE", GL_RENDERBUFFER_STENCIL_SIZE},
+    {"RENDERBUFFER_WIDTH", GL_RENDERBUFFER_WIDTH},
+    {"RENDERER", GL_RENDERER},
+    {"REPEAT", GL_REPEAT},
+    {"REPLACE", GL_REPLACE},
+    {"RG", GL_RG},
+    {"RG16F", GL_RG16F},
+    {"RG16I", GL_RG16I},
+    {"RG16UI", GL_RG16UI},
+    {"RG32F", GL_RG32F},
+    {"RG32I", GL_RG32I},
+    {"RG32UI", GL_RG32UI},
+    {"RG8", GL_RG8},
+    {"RG8I", GL_RG8I},
+    {"RG8UI", GL_RG8UI},
+    {"RGB", GL_RGB},
+    {"RGB10_A2", GL_RGB10_A2},
+    {"RGB16F", GL_RGB16F},
+    {"RGB16I", GL_RGB16I},
+    {"RGB16UI", GL_RGB16UI},
+    {"RGB32F", GL_RGB32F},
+    {"RGB32I", GL_RGB32I},
+    {"RGB32UI", GL_RGB32UI},
+    {"RGB5_A1", GL_RGB5_A1},
+    {"RGB8", GL_RGB8},
+    {"RGB8I", GL_RGB8I},
+    {"RGB8UI", GL_RGB8UI},
+    {"RGB9_E5", GL_RGB9_E5},
+    {"RGBA", GL_RGBA},
+    {"RGBA16F", GL_RGBA16F},
+    {"RGBA16I", GL_RGBA16I},
+    {"RGBA16UI", GL_RGBA16UI},
+    {"RGBA32F", GL_RGBA32F},
+    {"RGBA32I", GL_RGBA32I},
+    {"RGBA32UI", GL_RGBA32UI},
+    {"RGBA4", GL_RGBA4},
+    {"RGBA8", GL_RGBA8},
+    {"RGBA8I", GL_RGBA8I},
+    {"RGBA8UI", GL_RGBA8UI},
+    {"RGBA_INTEGER", GL_RGBA_INTEGER},
+    {"RGB_INTEGER", GL_RGB_INTEGER},
+    {"RG_INTEGER", GL_RG_INTEGER},
+    {"SAMPLER_2D", GL_SAMPLER_2D},
+    {"SAMPLER_2D_ARRAY", GL_SAMPLER_2D_ARRAY},
+    {"SAMPLER_2D_ARRAY_SHADOW", GL_SAMPLER_2D_ARRAY_SHADOW},
+    {"SAMPLER_2D_SHADOW", GL_SAMPLER_2D_SHADOW},
+    {"SAMPLER_3D", GL_SAMPLER_3D},
+    {"SAMPLER_CUBE", GL_SAMPLER_CUBE},
+    {"SAMPLER_CUBE_SHADOW", GL_SAMPLER_CUBE_SHADOW},
+    {"SAMPLES", GL_SAMPLES},
+    {"SAMPLE_ALPHA_TO_COVERAGE", GL_SAMPLE_ALPHA_TO_COVERAGE},
+    {"SAMPLE_BUFFERS", GL_SAMPLE_BUFFERS},
+    {"SAMPLE_COVERAGE", GL_SAMPLE_COVERAGE},
+    {"SAMPLE_COVERAGE_INVERT", GL_SAMPLE_COVERAGE_INVERT},
+    {"SAMPLE_COVERAGE_VALUE", GL_SAMPLE_COVERAGE_VALUE},
+    {"SCISSOR_BOX", GL_SCISSOR_BOX},
+    {"SCISSOR_TEST", GL_SCISSOR_TEST},
+    {"SEPARATE_ATTRIBS", GL_SEPARATE_ATTRIBS},
+    {"SHADER_SOURCE_LENGTH", GL_SHADER_SOURCE_LENGTH},
+    {"SHADER_TYPE", GL_SHADER_TYPE},
+    {"SHADING_LANGUAGE_VERSION", GL_SHADING_LANGUAGE_VERSION},
+    {"SHORT", GL_SHORT},
+    {"SRC_ALPHA", GL_SRC_ALPHA},
+    {"SRC_ALPHA_SATURATE", GL_SRC_ALPHA_SATURATE},
+    {"SRC_COLOR", GL_SRC_COLOR},
+    {"SRGB", GL_SRGB},
+    {"SRGB8", GL_SRGB8},
+    {"SRGB8_ALPHA8", GL_SRGB8_ALPHA8},
+    {"STATIC_COPY", GL_STATIC_COPY},
+    {"STATIC_DRAW", GL_STATIC_DRAW},
+    {"STATIC_READ", GL_STATIC_READ},
+    {"STENCIL", GL_STENCIL},
+    {"STENCIL_ATTACHMENT", GL_STENCIL_ATTACHMENT},
+    {"STENCIL_BACK_FAIL", GL_STENCIL_BACK_FAIL},
+    {"STENCIL_BACK_FUNC", GL_STENCIL_BACK_FUNC},
+    {"STENCIL_BACK_PASS_DEPTH_FAIL", GL_STENCIL_BACK_PASS_DEPTH_FAIL},
+    {"STENCIL_BACK_PASS_DEPTH_PASS", GL_STENCIL_BACK_PASS_DEPTH_PASS},
+    {"STENCIL_BACK_REF", GL_STENCIL_BACK_REF},
+    {"STENCIL_BACK_VALUE_MASK", GL_STENCIL_BACK_VALUE_MASK},
+    {"STENCIL_BACK_WRITEMASK", GL_STENCIL_BACK_WRITEMASK},
+    {"STENCIL_BUFFER_BIT", GL_STENCIL_BUFFER_BIT},
+    {"STENCIL_CLEAR_VALUE", GL_STENCIL_CLEAR_VALUE},
+    {"STENCIL_FAIL", GL_STENCIL_FAIL},
+    {"STENCIL_FUNC", GL_STENCIL_FUNC},
+    {"STENCIL_INDEX8", GL_STENCIL_INDEX8},
+    {"STENCIL_PASS_DEPTH_FAIL", GL_STENCIL_PASS_DEPTH_FAIL},
+    {"STENCIL_PASS_DEPTH_PASS", GL_STENCIL_PASS_DEPTH_PASS},
+    {"STENCIL_REF", GL_STENCIL_REF},
+    {"STENCIL_TEST", GL_STENCIL_TEST},
+    {"STENCIL_VALUE_MASK", GL_STENCIL_VALUE_MASK},
+    {"STENCIL_WRITEMASK", GL_STENCIL_WRITEMASK},
+    {"STREAM_COPY", GL_STREAM_COPY},
+    {"STREAM_DRAW", GL_STREAM_DRAW},
+    {"STREAM_READ", GL_STREAM_READ},
+    {"SUBPIXEL_BITS", GL_SUBPIXEL_BITS},
+    {"TEXTURE", GL_TEXTURE},
+    {"TEXTURE0", GL_TEXTURE0},
+    {"TEXTURE1", GL_TEXTURE1},
+    {"TEXTURE10", GL_TEXTURE10},
+    {"TEXTURE11", GL_TEXTURE11},
+    {"TEXTURE12", GL_TEXTURE12},
+    {"TEXTURE13", GL_TEXTURE13},
+    {"TEXTURE14", GL_TEXTURE14},
+    {"TEXTURE15", GL_TEXTURE15},
+    {"TEXTURE16", GL_TEXTURE16},
+    {"TEXTURE17", GL_TEXTURE17},
+    {"TEXTURE18", GL_TEXTURE18},
+    {"TEXTURE19", GL_TEXTURE19},
+    {"TEXTURE2", GL_TEXTURE2},
+    {"TEXTURE20", GL_TEXTURE20},
+    {"TEXTURE21", GL_TEXTURE21},
+    {"TEXTURE22", GL_TEXTURE22},
+    {"TEXTURE23", GL_TEXTURE23},
+    {"TEXTURE24", GL_TEXTURE24},
+    {"TEXTURE25", GL_TEXTURE25},
+    {"TEXTURE26", GL_TEXTURE26},
+    {"TEXTURE27", GL_TEXTURE27},
+    {"TEXTURE28", GL_TEXTURE28},
+    {"TEXTURE29", GL_TEXTURE29},
+    {"TEXTURE3", GL_TEXTURE3},
+    {"TEXTURE30", GL_TEXTURE30},
+    {"TEXTURE31", GL_TEXTURE31},
+    {"TEXTURE4", GL_TEXTURE4},
+    {"TEXTURE5", GL_TEXTURE5},
+    {"TEXTURE6", GL_TEXTURE6},
+    {"TEXTURE7", GL_TEXTURE7},
+    {"TEXTURE8", GL_TEXTURE8},
+    {"TEXTURE9", GL_TEXTURE9},
+    {"TEXTURE_2D", GL_TEXTURE_2D},
+    {"TEXTURE_2D_ARRAY", GL_TEXTURE_2D_ARRAY},
+    {"TEXTURE_3D", GL_TEXTURE_3D},
+    {"TEXTURE_BASE_LEVEL", GL_TEXTURE_BASE_LEVEL},
+    {"TEXTURE_BINDING_2D", GL_TEXTURE_BINDING_2D},
+    {"TEXTURE_BINDING_2D_ARRAY", GL_TEXTURE_BINDING_2D_ARRAY},
+    {"TEXTURE_BINDING_3D", GL_TEXTURE_BINDING_3D},
+    {"TEXTURE_BINDING_CUBE_MAP", GL_TEXTURE_BINDING_CUBE_MAP},
+    {"TEXTURE_COMPARE_FUNC", GL_TEXTURE_COMPARE_FUNC},
+    {"TEXTURE_COMPARE_MODE", GL_TEXTURE_COMPARE_MODE},
+    {"TEXTURE_CUBE_MAP", GL_TEXTURE_CUBE_MAP},
+    {"TEXTURE_CUBE_MAP_NEGATIVE_X", GL_TEXTURE_CUBE_MAP_NEGATIVE_X},
+    {"TEXTURE_CUBE_MAP_NEGATIVE_Y", GL_TEXTURE_CUBE_MAP_NEGATIVE_Y},
+    {"TEXTURE_CUBE_MAP_NEGATIVE_Z", GL_TEXTURE_CUBE_MAP_NEGATIVE_Z},
+    {"TEXTURE_CUBE_MAP_POSITIVE_X", GL_TEXTURE_CUBE_MAP_POSITIVE_X},
+    {"TEXTURE_CUBE_MAP_POSITIVE_Y", GL_TEXTURE_CUBE_MAP_POSITIVE_Y},
+    {"TEXTURE_CUBE_MAP_POSITIVE_Z", GL_TEXTURE_CUBE_MAP_POSITIVE_Z},
+    {"TEXTURE_MAG_FILTER", GL_TEXTURE_MAG_FILTER},
+    {"TEXTURE_MAX_LEVEL", GL_TEXTURE_MAX_LEVEL},
+    {"TEXTURE_MAX_LOD", GL_TEXTURE_MAX_LOD},
+    {"TEXTURE_MIN_FILTER", GL_TEXTURE_MIN_FILTER},
+    {"TEXTURE_MIN_LOD", GL_TEXTURE_MIN_LOD},
+    {"TEXTURE_WRAP_R", GL_TEXTURE_WRAP_R},
+    {"TEXTURE_WRAP_S", GL_TEXTURE_WRAP_S},
+    {"TEXTURE_WRAP_T", GL_TEXTURE_WRAP_T},
+    {"TIMESTAMP", GL_TIMESTAMP},
+    {"TIME_ELAPSED", GL_TIME_ELAPSED},
+    {"TRANSFORM_FEEDBACK_BUFFER", GL_TRANSFORM_FEEDBACK_BUFFER},
+    {"TRANSFORM_FEEDBACK_BUFFER_BINDING", GL_TRANSFORM_FEEDBACK_BUFFER_BINDING},
+    {"TRANSFORM_FEEDBACK_BUFFER_MODE", GL_TRANSFORM_FEEDBACK_BUFFER_MODE},
+    {"TRANSFORM_FEEDBACK_BUFFER_SIZE", GL_TRANSFORM_FEEDBACK_BUFFER_SIZE},
+    {"TRANSFORM_FEEDBACK_BUFFER_START", GL_TRANSFORM_FEEDBACK_BUFFER_START},
+    {"TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN",
+     GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN},
+    {"TRANSFORM_FEEDBACK_VARYINGS", GL_TRANSFORM_FEEDBACK_VARYINGS},
+    {"TRANSFORM_FEEDBACK_VARYING_MAX_LENGTH",
+     GL_TRANSFORM_FEEDBACK_VARYING_MAX_LENGTH},
+    {"TRIANGLES", GL_TRIANGLES},
+    {"TRIANGLE_FAN", GL_TRIANGLE_FAN},
+    {"TRIANGLE_STRIP", GL_TRIANGLE_STRIP},
+    {"TRUE", GL_TRUE},
+    {"UNIFORM_BUFFER", GL_UNIFORM_BUFFER},
+    {"UNIFORM_BUFFER_BINDING", GL_UNIFORM_BUFFER_BINDING},
+    {"UNIFORM_BUFFER_OFFSET_ALIGNMENT", GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT},
+    {"UNPACK_ALIGNMENT", GL_UNPACK_ALIGNMENT},
+    {"UNPACK_IMAGE_HEIGHT", GL_UNPACK_IMAGE_HEIGHT},
+    {"UNPACK_ROW_LENGTH", GL_UNPACK_ROW_LENGTH},
+    {"UNPACK_SKIP_IMAGES", GL_UNPACK_SKIP_IMAGES},
+    {"UNPACK_SKIP_PIXELS", GL_UNPACK_SKIP_PIXELS},
+    {"UNPACK_SKIP_ROWS", GL_UNPACK_SKIP_ROWS},
+    {"UNSIGNED_BYTE", GL_UNSIGNED_BYTE},
+    {"UNSIGNED_INT", GL_UNSIGNED_INT},
+    {"UNSIGNED_INT_10F_11F_11F_REV", GL_UNSIGNED_INT_10F_11F_11F_REV},
+    {"UNSIGNED_INT_24_8", GL_UNSIGNED_INT_24_8},
+    {"UNSIGNED_INT_2_10_10_10_REV", GL_UNSIGNED_INT_2_10_10_10_REV},
+    {"UNSIGNED_INT_5_9_9_9_REV", GL_UNSIGNED_INT_5_9_9_9_REV},
+    {"UNSIGNED_INT_SAMPLER_2D", GL_UNSIGNED_INT_SAMPLER_2D},
+    {"UNSIGNED_INT_SAMPLER_2D_ARRAY", GL_UNSIGNED_INT_SAMPLER_2D_ARRAY},
+    {"UNSIGNED_INT_SAMPLER_3D", GL_UNSIGNED_INT_SAMPLER_3D},
+    {"UNSIGNED_INT_SAMPLER_CUBE", GL_UNSIGNED_INT_SAMPLER_CUBE},
+    {"UNSIGNED_INT_VEC2", GL_UNSIGNED_INT_VEC2},
+    {"UNSIGNED_INT_VEC3", GL_UNSIGNED_INT_VEC3},
+    {"UNSIGNED_INT_VEC4", GL_UNSIGNED_INT_VEC4},
+    {"UNSIGNED_NORMALIZED", GL_UNSIGNED_NORMALIZED},
+    {"UNSIGNED_SHORT", GL_UNSIGNED_SHORT},
+    {"UNSIGNED_SHORT_4_4_4_4", GL_UNSIGNED_SHORT_4_4_4_4},
+    {"UNSIGNED_SHORT_5_5_5_1", GL_UNSIGNED_SHORT_5_5_5_1},
+    {"UNSIGNED_SHORT_5_6_5", GL_UNSIGNED_SHORT_5_6_5},
+    {"VALIDATE_STATUS", GL_VALIDATE_STATUS},
+    {"VENDOR", GL_VENDOR},
+    {"VERSION", GL_VERSION},
+    {"VERTEX_ARRAY_BINDING", GL_VERTEX_ARRAY_BINDING},
+    {"VERTEX_ATTRIB_ARRAY_BUFFER_BINDING",
+     GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING},
+    {"VERTEX_ATTRIB_ARRAY_ENABLED", GL_VERTEX_ATTRIB_ARRAY_ENABLED},
+    {"VERTEX_ATTRIB_ARRAY_INTEGER", GL_VERTEX_ATTRIB_ARRAY_INTEGER},
+    {"VERTEX_ATTRIB_ARRAY_NORMALIZED", GL_VERTEX_ATTRIB_ARRAY_NORMALIZED},
+    {"VERTEX_ATTRIB_ARRAY_POINTER", GL_VERTEX_ATTRIB_ARRAY_POINTER},
+    {"VERTEX_ATTRIB_ARRAY_SIZE", GL_VERTEX_ATTRIB_ARRAY_SIZE},
+    {"VERTEX_ATTRIB_ARRAY_STRIDE", GL_VERTEX_ATTRIB_ARRAY_STRIDE},
+    {"VERTEX_ATTRIB_ARRAY_TYPE", GL_VERTEX_ATTRIB_ARRAY_TYPE},
+    {"VERTEX_SHADER", GL_VERTEX_SHADER},
+    {"VIEWPORT", GL_VIEWPORT},
+    {"ZERO", GL_ZERO},
+};
+
+constexpr bool isSortedByName(const Constant *begin, const Constant *end) {
+  for (auto it = begin; it + 1 < end; ++it) {
+    if (!(it->name < (it + 1)->name)) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(isSortedByName(std::begin(CONSTANTS), std::end(CONSTANTS)),
+              "CONSTANTS must be sorted by name without duplicates");
 
-  return 0;
+int L_indexConstant(lua_State *L) {
+  if (lua_type(L, 2) != LUA_TSTRING) {
+    lua_pushnil(L);
+    return 1;
+  }
+  size_t length;
+  auto key = lua_tolstring(L, 2, &length);
+  const std::string_view name(key, length);
+  auto it = std::lower_bound(
+      std::begin(CONSTANTS), std::end(CONSTANTS), name,
+      [](const Constant &c, std::string_view v) { return c.name < v; });
+  if (it == std::end(CONSTANTS) || it->name != name) {
+    lua_pushnil(L);
+    return 1;
+  }
+  lua_pushinteger(L, it->value);
+  lua_pushvalue(L, 2);
+  lua_pushvalue(L, -2);
+  lua_rawset(L, 1);
+  return 1;
 }
 
 int L_require(lua_State *L) {
   lua_newtable(L);
-
-  lua_pushConstants(L, -1);
+  luaL_setmetatable(L, CONSTANTS_NAME);
 
   lua_pushcfunction(L, L_loadGLLoader);
   lua_setfield(L, -2, "loadGLLoader");
@@ -1942,6 +2837,36 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_glDrawElements);
   lua_setfield(L, -2, "drawElements");
 
+  lua_pushcfunction(L, L_glDrawElementsBaseVertex);
+  lua_setfield(L, -2, "drawElementsBaseVertex");
+
+  lua_pushcfunction(L, L_glDrawArraysInstanced);
+  lua_setfield(L, -2, "drawArraysInstanced");
+
+  lua_pushcfunction(L, L_glDrawElementsInstanced);
+  lua_setfield(L, -2, "drawElementsInstanced");
+
+  lua_pushcfunction(L, L_glVertexAttribDivisor);
+  lua_setfield(L, -2, "vertexAttribDivisor");
+
+  lua_pushcfunction(L, L_glMultiDrawArrays);
+  lua_setfield(L, -2, "multiDrawArrays");
+
+  lua_pushcfunction(L, L_glMultiDrawElements);
+  lua_setfield(L, -2, "multiDrawElements");
+
+  lua_pushcfunction(L, L_glDrawArraysIndirect);
+  lua_setfield(L, -2, "drawArraysIndirect");
+
+  lua_pushcfunction(L, L_glDrawElementsIndirect);
+  lua_setfield(L, -2, "drawElementsIndirect");
+
+  lua_pushcfunction(L, L_glMultiDrawArraysIndirect);
+  lua_setfield(L, -2, "multiDrawArraysIndirect");
+
+  lua_pushcfunction(L, L_glMultiDrawElementsIndirect);
+  lua_setfield(L, -2, "multiDrawElementsIndirect");
+
   lua_pushcfunction(L, L_glGenBuffer);
   lua_setfield(L, -2, "genBuffer");
 
@@ -1954,6 +2879,18 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_glBufferData);
   lua_setfield(L, -2, "bufferData");
 
+  lua_pushcfunction(L, L_glBufferSubData);
+  lua_setfield(L, -2, "bufferSubData");
+
+  lua_pushcfunction(L, L_glCopyBufferSubData);
+  lua_setfield(L, -2, "copyBufferSubData");
+
+  lua_pushcfunction(L, L_glBindBufferBase);
+  lua_setfield(L, -2, "bindBufferBase");
+
+  lua_pushcfunction(L, L_glBindBufferRange);
+  lua_setfield(L, -2, "bindBufferRange");
+
   lua_pushcfunction(L, L_glGenVertexArray);
   lua_setfield(L, -2, "genVertexArray");
 
@@ -2008,12 +2945,39 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_glUniform1i);
   lua_setfield(L, -2, "uniform1i");
 
+  lua_pushcfunction(L, L_glUniform1f);
+  lua_setfield(L, -2, "uniform1f");
+
+  lua_pushcfunction(L, L_glUniform2f);
+  lua_setfield(L, -2, "uniform2f");
+
+  lua_pushcfunction(L, L_glUniform3f);
+  lua_setfield(L, -2, "uniform3f");
+
+  lua_pushcfunction(L, L_glUniform4f);
+  lua_setfield(L, -2, "uniform4f");
+
+  lua_pushcfunction(L, L_glGetUniformBlockIndex);
+  lua_setfield(L, -2, "getUniformBlockIndex");
+
+  lua_pushcfunction(L, L_glUniformBlockBinding);
+  lua_setfield(L, -2, "uniformBlockBinding");
+
+  lua_pushcfunction(L, L_glGetInteger);
+  lua_setfield(L, -2, "getInteger");
+
   lua_pushcfunction(L, L_glGenTexture);
   lua_setfield(L, -2, "genTexture");
 
   lua_pushcfunction(L, L_glTexImage2D);
   lua_setfield(L, -2, "texImage2D");
 
+  lua_pushcfunction(L, L_glTexSubImage2D);
+  lua_setfield(L, -2, "texSubImage2D");
+
+  lua_pushcfunction(L, L_glCompressedTexImage2D);
+  lua_setfield(L, -2, "compressedTexImage2D");
+
   lua_pushcfunction(L, L_glPixelStorei);
   lua_setfield(L, -2, "pixelStorei");
 
@@ -2056,13 +3020,280 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_glFramebufferTexture2D);
   lua_setfield(L, -2, "framebufferTexture2D");
 
+  lua_pushcfunction(L, L_glCheckFramebufferStatus);
+  lua_setfield(L, -2, "checkFramebufferStatus");
+
+  lua_pushcfunction(L, L_glReadPixels);
+  lua_setfield(L, -2, "readPixels");
+
+  lua_pushcfunction(L, L_glGetBufferSubData);
+  lua_setfield(L, -2, "getBufferSubData");
+
+  lua_pushcfunction(L, L_glFlush);
+  lua_setfield(L, -2, "flush");
+
+  lua_pushcfunction(L, L_glFinish);
+  lua_setfield(L, -2, "finish");
+
+  lua_pushcfunction(L, L_glGenQuery);
+  lua_setfield(L, -2, "genQuery");
+
+  lua_pushcfunction(L, L_glDeleteQuery);
+  lua_setfield(L, -2, "deleteQuery");
+
+  lua_pushcfunction(L, L_glBeginQuery);
+  lua_setfield(L, -2, "beginQuery");
+
+  lua_pushcfunction(L, L_glEndQuery);
+  lua_setfield(L, -2, "endQuery");
+
+  lua_pushcfunction(L, L_glQueryCounter);
+  lua_setfield(L, -2, "queryCounter");
+
+  lua_pushcfunction(L, L_glGetQueryObjectuiv);
+  lua_setfield(L, -2, "getQueryObjectuiv");
+
+  lua_pushcfunction(L, L_glGetQueryObjectui64v);
+  lua_setfield(L, -2, "getQueryObjectui64v");
+
+  lua_pushcfunction(L, L_newCommandList);
+  lua_setfield(L, -2, "newCommandList");
+
+  lua_pushcfunction(L, L_execute);
+  lua_setfield(L, -2, "execute");
+
+  lua_pushcfunction(L, L_invalidateState);
+  lua_setfield(L, -2, "invalidateState");
+
+  lua_pushcfunction(L, L_getStateStats);
+  lua_setfield(L, -2, "getStateStats");
+
+  lua_pushcfunction(L, L_resetStateStats);
+  lua_setfield(L, -2, "resetStateStats");
+
+  lua_pushcfunction(L, L_newStreamBuffer);
+  lua_setfield(L, -2, "newStreamBuffer");
+
+  lua_pushcfunction(L, L_getExtensions);
+  lua_setfield(L, -2, "getExtensions");
+
+  lua_pushcfunction(L, L_newInstanceData);
+  lua_setfield(L, -2, "newInstanceData");
+
+  lua_pushcfunction(L, L_newUniformLayout);
+  lua_setfield(L, -2, "newUniformLayout");
+
+  lua_pushcfunction(L, L_getUniformBlockLayout);
+  lua_setfield(L, -2, "getUniformBlockLayout");
+
+  lua_pushcfunction(L, L_newGpuTimer);
+  lua_setfield(L, -2, "newGpuTimer");
+
+  lua_pushcfunction(L, L_newDrawList);
+  lua_setfield(L, -2, "newDrawList");
+
+  lua_pushcfunction(L, L_newReadback);
+  lua_setfield(L, -2, "newReadback");
+
   return 1;
 }
 } // namespace
 
 namespace hello::lua::opengl {
 void openlibs(lua_State *L) {
+  luaL_newmetatable(L, CONSTANTS_NAME);
+  lua_pushcfunction(L, L_indexConstant);
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, COMMAND_LIST_NAME);
+  lua_pushcfunction(L, L_CommandList___gc);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_CommandList_clearColor);
+  lua_setfield(L, -2, "clearColor");
+  lua_pushcfunction(L, L_CommandList_clearDepth);
+  lua_setfield(L, -2, "clearDepth");
+  lua_pushcfunction(L, L_CommandList_clear);
+  lua_setfield(L, -2, "clear");
+  lua_pushcfunction(L, L_CommandList_viewport);
+  lua_setfield(L, -2, "viewport");
+  lua_pushcfunction(L, L_CommandList_bindFramebuffer);
+  lua_setfield(L, -2, "bindFramebuffer");
+  lua_pushcfunction(L, L_CommandList_bindBuffer);
+  lua_setfield(L, -2, "bindBuffer");
+  lua_pushcfunction(L, L_CommandList_bindVertexArray);
+  lua_setfield(L, -2, "bindVertexArray");
+  lua_pushcfunction(L, L_CommandList_useProgram);
+  lua_setfield(L, -2, "useProgram");
+  lua_pushcfunction(L, L_CommandList_activateTexture);
+  lua_setfield(L, -2, "activateTexture");
+  lua_pushcfunction(L, L_CommandList_bindTexture);
+  lua_setfield(L, -2, "bindTexture");
+  lua_pushcfunction(L, L_CommandList_uniform1i);
+  lua_setfield(L, -2, "uniform1i");
+  lua_pushcfunction(L, L_CommandList_uniform1f);
+  lua_setfield(L, -2, "uniform1f");
+  lua_pushcfunction(L, L_CommandList_uniform2f);
+  lua_setfield(L, -2, "uniform2f");
+  lua_pushcfunction(L, L_CommandList_uniform3f);
+  lua_setfield(L, -2, "uniform3f");
+  lua_pushcfunction(L, L_CommandList_uniform4f);
+  lua_setfield(L, -2, "uniform4f");
+  lua_pushcfunction(L, L_CommandList_drawArrays);
+  lua_setfield(L, -2, "drawArrays");
+  lua_pushcfunction(L, L_CommandList_drawElements);
+  lua_setfield(L, -2, "drawElements");
+  lua_pushcfunction(L, L_CommandList_reset);
+  lua_setfield(L, -2, "reset");
+  lua_pushcfunction(L, L_CommandList_getCommandCount);
+  lua_setfield(L, -2, "getCommandCount");
+  lua_pushcfunction(L, L_CommandList_getByteSize);
+  lua_setfield(L, -2, "getByteSize");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, STREAM_BUFFER_NAME);
+  lua_pushcfunction(L, L_StreamBuffer_free);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_StreamBuffer_write);
+  lua_setfield(L, -2, "write");
+  lua_pushcfunction(L, L_StreamBuffer_fence);
+  lua_setfield(L, -2, "fence");
+  lua_pushcfunction(L, L_StreamBuffer_getBuffer);
+  lua_setfield(L, -2, "getBuffer");
+  lua_pushcfunction(L, L_StreamBuffer_getSize);
+  lua_setfield(L, -2, "getSize");
+  lua_pushcfunction(L, L_StreamBuffer_isPersistent);
+  lua_setfield(L, -2, "isPersistent");
+  lua_pushcfunction(L, L_StreamBuffer_free);
+  lua_setfield(L, -2, "free");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, INSTANCE_DATA_NAME);
+  lua_pushcfunction(L, L_InstanceData_free);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_InstanceData_add);
+  lua_setfield(L, -2, "add");
+  lua_pushcfunction(L, L_InstanceData_set);
+  lua_setfield(L, -2, "set");
+  lua_pushcfunction(L, L_InstanceData_setTransform);
+  lua_setfield(L, -2, "setTransform");
+  lua_pushcfunction(L, L_InstanceData_resize);
+  lua_setfield(L, -2, "resize");
+  lua_pushcfunction(L, L_InstanceData_clear);
+  lua_setfield(L, -2, "clear");
+  lua_pushcfunction(L, L_InstanceData_getCount);
+  lua_setfield(L, -2, "getCount");
+  lua_pushcfunction(L, L_InstanceData_getComponents);
+  lua_setfield(L, -2, "getComponents");
+  lua_pushcfunction(L, L_InstanceData_getStride);
+  lua_setfield(L, -2, "getStride");
+  lua_pushcfunction(L, L_InstanceData_getByteSize);
+  lua_setfield(L, -2, "getByteSize");
+  lua_pushcfunction(L, L_InstanceData_upload);
+  lua_setfield(L, -2, "upload");
+  lua_pushcfunction(L, L_InstanceData_free);
+  lua_setfield(L, -2, "free");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, UNIFORM_LAYOUT_NAME);
+  lua_pushcfunction(L, L_UniformLayout_free);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_UniformLayout_getSize);
+  lua_setfield(L, -2, "getSize");
+  lua_pushcfunction(L, L_UniformLayout_getOffset);
+  lua_setfield(L, -2, "getOffset");
+  lua_pushcfunction(L, L_UniformLayout_newBlock);
+  lua_setfield(L, -2, "newBlock");
+  lua_pushcfunction(L, L_UniformLayout_free);
+  lua_setfield(L, -2, "free");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, UNIFORM_BLOCK_NAME);
+  lua_pushcfunction(L, L_UniformBlock_free);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_UniformBlock_set);
+  lua_setfield(L, -2, "set");
+  lua_pushcfunction(L, L_UniformBlock_setElement);
+  lua_setfield(L, -2, "setElement");
+  lua_pushcfunction(L, L_UniformBlock_getSize);
+  lua_setfield(L, -2, "getSize");
+  lua_pushcfunction(L, L_UniformBlock_upload);
+  lua_setfield(L, -2, "upload");
+  lua_pushcfunction(L, L_UniformBlock_free);
+  lua_setfield(L, -2, "free");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, GPU_TIMER_NAME);
+  lua_pushcfunction(L, L_GpuTimer_free);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_GpuTimer_beginPass);
+  lua_setfield(L, -2, "beginPass");
+  lua_pushcfunction(L, L_GpuTimer_endPass);
+  lua_setfield(L, -2, "endPass");
+  lua_pushcfunction(L, L_GpuTimer_collect);
+  lua_setfield(L, -2, "collect");
+  lua_pushcfunction(L, L_GpuTimer_reset);
+  lua_setfield(L, -2, "reset");
+  lua_pushcfunction(L, L_GpuTimer_getPendingCount);
+  lua_setfield(L, -2, "getPendingCount");
+  lua_pushcfunction(L, L_GpuTimer_getTimes);
+  lua_setfield(L, -2, "getTimes");
+  lua_pushcfunction(L, L_GpuTimer_free);
+  lua_setfield(L, -2, "free");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, DRAW_LIST_NAME);
+  lua_pushcfunction(L, L_DrawList_free);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_DrawList_add);
+  lua_setfield(L, -2, "add");
+  lua_pushcfunction(L, L_DrawList_setBounds);
+  lua_setfield(L, -2, "setBounds");
+  lua_pushcfunction(L, L_DrawList_build);
+  lua_setfield(L, -2, "build");
+  lua_pushcfunction(L, L_DrawList_draw);
+  lua_setfield(L, -2, "draw");
+  lua_pushcfunction(L, L_DrawList_clear);
+  lua_setfield(L, -2, "clear");
+  lua_pushcfunction(L, L_DrawList_getCount);
+  lua_setfield(L, -2, "getCount");
+  lua_pushcfunction(L, L_DrawList_getDrawCount);
+  lua_setfield(L, -2, "getDrawCount");
+  lua_pushcfunction(L, L_DrawList_getStride);
+  lua_setfield(L, -2, "getStride");
+  lua_pushcfunction(L, L_DrawList_getByteSize);
+  lua_setfield(L, -2, "getByteSize");
+  lua_pushcfunction(L, L_DrawList_upload);
+  lua_setfield(L, -2, "upload");
+  lua_pushcfunction(L, L_DrawList_free);
+  lua_setfield(L, -2, "free");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, READBACK_NAME);
+  lua_pushcfunction(L, L_Readback_free);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_Readback_read);
+  lua_setfield(L, -2, "read");
+  lua_pushcfunction(L, L_Readback_collect);
+  lua_setfield(L, -2, "collect");
+  lua_pushcfunction(L, L_Readback_getCount);
+  lua_setfield(L, -2, "getCount");
+  lua_pushcfunction(L, L_Readback_getPendingCount);
+  lua_setfield(L, -2, "getPendingCount");
+  lua_pushcfunction(L, L_Readback_free);
+  lua_setfield(L, -2, "free");
+  lua_setfield(L, -2, "__index");
+
   luaL_requiref(L, "opengl", L_require, false);
-  lua_pop(L, 1);
+  lua_pop(L, 10);
 }
+
+void resetStateCache() { getStateCache().setContext(nullptr); }
 } // namespace hello::lua::opengl
\ No newline at end of file
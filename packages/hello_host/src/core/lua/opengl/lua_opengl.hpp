@@ -5,5 +5,9 @@
 #include "../lua_utils.hpp"
 namespace hello::lua::opengl {
 void openlibs(lua_State *L);
+
+// forgets the cached GL state. call it when a context is deleted, since the
+// next one may be created at the same address.
+void resetStateCache();
 } // namespace hello::lua::opengl
 #endif
\ No newline at end of file
@@ -1,11 +1,68 @@
 #include "./lua_sdl2.hpp"
+#include "../opengl/lua_opengl.hpp"
+#include "../sdl2_image/lua_sdl2_image.hpp"
 
 #include <SDL2/SDL.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
 namespace {
 const char *const SDL_WINDOW_NAME = "SDL_Window";
 const char *const SDL_RENDERER_NAME = "SDL_Renderer";
+const char *const SDL_TEXTURE_NAME = "SDL_Texture";
+const char *const SDL_SPRITE_BATCH_NAME = "SDL_SpriteBatch";
 const char *const SDL_GL_CONTEXT_NAME = "SDL_GL_Context";
+const char *const RENDER_TARGETS_KEY = "0b5f4f0e-3c1d-4a39-9a5e-2f7d6c8e41b7";
+
+int getRenderTargets(lua_State *L) {
+  lua_pushstring(L, RENDER_TARGETS_KEY);
+  if (lua_rawget(L, LUA_REGISTRYINDEX) == LUA_TTABLE) {
+    return LUA_TTABLE;
+  }
+  lua_pop(L, 1);
+  lua_newtable(L);
+  lua_pushstring(L, RENDER_TARGETS_KEY);
+  lua_pushvalue(L, -2);
+  lua_rawset(L, LUA_REGISTRYINDEX);
+  return LUA_TTABLE;
+}
+
+// returns the array index of the entry bound to the window, or 0.
+lua_Integer findRenderTarget(lua_State *L, int targets, SDL_Window *window) {
+  const auto n = static_cast<lua_Integer>(lua_rawlen(L, targets));
+  for (lua_Integer i = 1; i <= n; ++i) {
+    lua_rawgeti(L, targets, i);
+    lua_getfield(L, -1, "window");
+    auto pWindow =
+        static_cast<SDL_Window **>(luaL_testudata(L, -1, SDL_WINDOW_NAME));
+    const auto found = pWindow != nullptr && *pWindow == window;
+    lua_pop(L, 2);
+    if (found) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+void removeRenderTarget(lua_State *L, SDL_Window *window) {
+  getRenderTargets(L);
+  const auto targets = lua_gettop(L);
+  const auto index = findRenderTarget(L, targets, window);
+  if (index > 0) {
+    const auto n = static_cast<lua_Integer>(lua_rawlen(L, targets));
+    for (auto i = index; i < n; ++i) {
+      lua_rawgeti(L, targets, i + 1);
+      lua_rawseti(L, targets, i);
+    }
+    lua_pushnil(L);
+    lua_rawseti(L, targets, n);
+  }
+  lua_pop(L, 1);
+}
 
 int L_SDL_Init(lua_State *L) {
   auto flags = static_cast<Uint32>(luaL_checkinteger(L, 1));
@@ -25,6 +82,24 @@ int L_SDL_GetError(lua_State *L) {
   return 1;
 }
 
+int L_SDL_SetHint(lua_State *L) {
+  const char *const name = luaL_checkstring(L, 1);
+  const char *const value = luaL_checkstring(L, 2);
+  auto result = SDL_SetHint(name, value);
+  lua_pushboolean(L, result);
+  return 1;
+}
+
+int L_SDL_GetCurrentVideoDriver(lua_State *L) {
+  const auto driver = SDL_GetCurrentVideoDriver();
+  if (driver == nullptr) {
+    lua_pushnil(L);
+  } else {
+    lua_pushstring(L, driver);
+  }
+  return 1;
+}
+
 int L_SDL_CreateWindow(lua_State *L) {
   const char *const title = luaL_checkstring(L, 1);
   const auto x = static_cast<int32_t>(luaL_checkinteger(L, 2));
@@ -43,7 +118,11 @@ int L_SDL_CreateWindow(lua_State *L) {
 int L_SDL_DestroyWindow(lua_State *L) {
   auto pWindow =
       static_cast<SDL_Window **>(luaL_checkudata(L, 1, SDL_WINDOW_NAME));
+  if (*pWindow != nullptr) {
+    removeRenderTarget(L, *pWindow);
+  }
   SDL_DestroyWindow(*pWindow);
+  *pWindow = nullptr;
   return 0;
 }
 
@@ -67,6 +146,295 @@ int L_SDL_DestroyRenderer(lua_State *L) {
   return 0;
 }
 
+int L_SDL_SetRenderDrawColor(lua_State *L) {
+  auto pRenderer =
+      static_cast<SDL_Renderer **>(luaL_checkudata(L, 1, SDL_RENDERER_NAME));
+  const auto r = static_cast<Uint8>(luaL_checkinteger(L, 2));
+  const auto g = static_cast<Uint8>(luaL_checkinteger(L, 3));
+  const auto b = static_cast<Uint8>(luaL_checkinteger(L, 4));
+  const auto a = static_cast<Uint8>(luaL_optinteger(L, 5, 255));
+  auto result = SDL_SetRenderDrawColor(*pRenderer, r, g, b, a);
+  lua_pushinteger(L, result);
+  return 1;
+}
+
+int L_SDL_RenderClear(lua_State *L) {
+  auto pRenderer =
+      static_cast<SDL_Renderer **>(luaL_checkudata(L, 1, SDL_RENDERER_NAME));
+  auto result = SDL_RenderClear(*pRenderer);
+  lua_pushinteger(L, result);
+  return 1;
+}
+
+int L_SDL_RenderPresent(lua_State *L) {
+  auto pRenderer =
+      static_cast<SDL_Renderer **>(luaL_checkudata(L, 1, SDL_RENDERER_NAME));
+  SDL_RenderPresent(*pRenderer);
+  return 0;
+}
+
+SDL_Texture *checkTexture(lua_State *L, int idx) {
+  auto pTexture =
+      static_cast<SDL_Texture **>(luaL_checkudata(L, idx, SDL_TEXTURE_NAME));
+  luaL_argcheck(L, *pTexture != nullptr, idx, "already destroyed.");
+  return *pTexture;
+}
+
+int L_SDL_CreateTextureFromSurface(lua_State *L) {
+  auto pRenderer =
+      static_cast<SDL_Renderer **>(luaL_checkudata(L, 1, SDL_RENDERER_NAME));
+  auto pudSurface = hello::lua::sdl2_image::get(L, 2);
+  luaL_argcheck(L, pudSurface != nullptr && pudSurface->surface != nullptr, 2,
+                "specify SDL_Surface");
+  auto texture = SDL_CreateTextureFromSurface(*pRenderer, pudSurface->surface);
+  if (texture == nullptr) {
+    lua_pushnil(L);
+  } else {
+    auto pTexture =
+        static_cast<SDL_Texture **>(lua_newuserdata(L, sizeof(SDL_Texture *)));
+    *pTexture = texture;
+    luaL_setmetatable(L, SDL_TEXTURE_NAME);
+  }
+  return 1;
+}
+
+int L_SDL_DestroyTexture(lua_State *L) {
+  auto pTexture =
+      static_cast<SDL_Texture **>(luaL_checkudata(L, 1, SDL_TEXTURE_NAME));
+  if (*pTexture != nullptr) {
+    SDL_DestroyTexture(*pTexture);
+    *pTexture = nullptr;
+  }
+  return 0;
+}
+
+struct SpriteQuad {
+  // the slot of the SDL_Texture userdata, which the batch keeps alive until
+  // the next flush. DestroyTexture clears it, and flush drops the quad.
+  SDL_Texture *const *texture;
+  SDL_Vertex vertices[4];
+};
+
+struct SpriteBatch {
+  SDL_Renderer *renderer = nullptr;
+  SDL_Color color = {255, 255, 255, 255};
+  std::vector<SpriteQuad> quads;
+  std::vector<uint32_t> order;
+  std::vector<SDL_Vertex> vertices;
+  std::vector<int> indices;
+
+  void add(SDL_Texture *const *texture, const float *q) {
+    const auto x0 = q[0];
+    const auto y0 = q[1];
+    const auto x1 = q[0] + q[2];
+    const auto y1 = q[1] + q[3];
+    quads.push_back({texture,
+                     {{{x0, y0}, color, {q[4], q[5]}},
+                      {{x1, y0}, color, {q[6], q[5]}},
+                      {{x0, y1}, color, {q[4], q[7]}},
+                      {{x1, y1}, color, {q[6], q[7]}}}});
+  }
+
+  // issues one SDL_RenderGeometry per run of quads sharing a texture, in
+  // the order they were added unless sorted by texture. returns the number
+  // of draw calls, or -1 when SDL_RenderGeometry fails.
+  int flush(bool sortByTexture) {
+    quads.erase(std::remove_if(quads.begin(), quads.end(),
+                               [](const SpriteQuad &quad) {
+                                 return *quad.texture == nullptr;
+                               }),
+                quads.end());
+    const auto count = static_cast<uint32_t>(quads.size());
+    order.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      order[i] = i;
+    }
+    if (sortByTexture) {
+      std::stable_sort(order.begin(), order.end(),
+                       [this](uint32_t a, uint32_t b) {
+                         return quads[a].texture < quads[b].texture;
+                       });
+    }
+
+    vertices.resize(static_cast<size_t>(count) * 4);
+    for (uint32_t i = 0; i < count; ++i) {
+      std::copy_n(quads[order[i]].vertices, 4, &vertices[i * 4]);
+    }
+
+    // each run starts at vertex 0, so one shared index pattern serves all
+    const auto indexCount = static_cast<size_t>(count) * 6;
+    for (auto i = indices.size() / 6; indices.size() < indexCount; ++i) {
+      const auto v = static_cast<int>(i * 4);
+      indices.insert(indices.end(), {v, v + 1, v + 2, v + 2, v + 1, v + 3});
+    }
+
+    auto drawCalls = 0;
+    for (uint32_t first = 0; first < count;) {
+      const auto texture = quads[order[first]].texture;
+      auto last = first + 1;
+      while (last < count && quads[order[last]].texture == texture) {
+        ++last;
+      }
+      const auto n = static_cast<int>(last - first);
+      if (SDL_RenderGeometry(renderer, *texture, &vertices[first * 4], n * 4,
+                             indices.data(), n * 6) != 0) {
+        drawCalls = -1;
+        break;
+      }
+      ++drawCalls;
+      first = last;
+    }
+
+    quads.clear();
+    return drawCalls;
+  }
+};
+
+struct UDSDL_SpriteBatch {
+  SpriteBatch *data;
+};
+
+SpriteBatch *checkSpriteBatch(lua_State *L, int idx) {
+  auto pBatch = static_cast<UDSDL_SpriteBatch *>(
+      luaL_checkudata(L, idx, SDL_SPRITE_BATCH_NAME));
+  luaL_argcheck(L, pBatch->data != nullptr, idx, "already freed.");
+  return pBatch->data;
+}
+
+// keeps textures referenced by pending quads alive until the next flush.
+void retainTexture(lua_State *L, int batch, int texture) {
+  lua_getiuservalue(L, batch, 1);
+  lua_pushlightuserdata(L, lua_touserdata(L, texture));
+  lua_pushvalue(L, texture);
+  lua_rawset(L, -3);
+  lua_pop(L, 1);
+}
+
+int L_SDL_CreateSpriteBatch(lua_State *L) {
+  auto pRenderer =
+      static_cast<SDL_Renderer **>(luaL_checkudata(L, 1, SDL_RENDERER_NAME));
+  luaL_argcheck(L, *pRenderer != nullptr, 1, "renderer is null value.");
+  auto pBatch = static_cast<UDSDL_SpriteBatch *>(
+      lua_newuserdatauv(L, sizeof(UDSDL_SpriteBatch), 1));
+  pBatch->data = new SpriteBatch();
+  pBatch->data->renderer = *pRenderer;
+  lua_newtable(L);
+  lua_setiuservalue(L, -2, 1);
+  luaL_setmetatable(L, SDL_SPRITE_BATCH_NAME);
+  return 1;
+}
+
+int L_SpriteBatch___gc(lua_State *L) {
+  auto pBatch = static_cast<UDSDL_SpriteBatch *>(
+      luaL_checkudata(L, 1, SDL_SPRITE_BATCH_NAME));
+  delete pBatch->data;
+  pBatch->data = nullptr;
+  return 0;
+}
+
+int L_SpriteBatch_setColor(lua_State *L) {
+  auto batch = checkSpriteBatch(L, 1);
+  batch->color.r = static_cast<Uint8>(luaL_checkinteger(L, 2));
+  batch->color.g = static_cast<Uint8>(luaL_checkinteger(L, 3));
+  batch->color.b = static_cast<Uint8>(luaL_checkinteger(L, 4));
+  batch->color.a = static_cast<Uint8>(luaL_optinteger(L, 5, 255));
+  return 0;
+}
+
+// the userdata slot of the texture at `idx`, which must not be destroyed
+SDL_Texture *const *checkTextureSlot(lua_State *L, int idx) {
+  checkTexture(L, idx);
+  return static_cast<SDL_Texture **>(lua_touserdata(L, idx));
+}
+
+int L_SpriteBatch_add(lua_State *L) {
+  auto batch = checkSpriteBatch(L, 1);
+  auto texture = checkTextureSlot(L, 2);
+  const float quad[] = {
+      static_cast<float>(luaL_checknumber(L, 3)),
+      static_cast<float>(luaL_checknumber(L, 4)),
+      static_cast<float>(luaL_checknumber(L, 5)),
+      static_cast<float>(luaL_checknumber(L, 6)),
+      static_cast<float>(luaL_optnumber(L, 7, 0.0)),
+      static_cast<float>(luaL_optnumber(L, 8, 0.0)),
+      static_cast<float>(luaL_optnumber(L, 9, 1.0)),
+      static_cast<float>(luaL_optnumber(L, 10, 1.0)),
+  };
+  retainTexture(L, 1, 2);
+  batch->add(texture, quad);
+  return 0;
+}
+
+// quads are 8 floats each: x, y, w, h, u0, v0, u1, v1.
+int L_SpriteBatch_addQuads(lua_State *L) {
+  auto batch = checkSpriteBatch(L, 1);
+  auto texture = checkTextureSlot(L, 2);
+  const size_t stride = 8;
+  size_t count = 0;
+
+  if (lua_type(L, 3) == LUA_TSTRING) {
+    size_t size;
+    auto data = lua_tolstring(L, 3, &size);
+    luaL_argcheck(L, size % (stride * sizeof(float)) == 0, 3,
+                  "size must be a multiple of 8 floats");
+    count = size / (stride * sizeof(float));
+    batch->quads.reserve(batch->quads.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+      float quad[stride];
+      ::memcpy(quad, data + i * sizeof(quad), sizeof(quad));
+      batch->add(texture, quad);
+    }
+  } else {
+    luaL_checktype(L, 3, LUA_TTABLE);
+    const auto length = static_cast<size_t>(lua_rawlen(L, 3));
+    luaL_argcheck(L, length % stride == 0, 3,
+                  "length must be a multiple of 8");
+    count = length / stride;
+    // every value is checked before the first quad is added
+    std::vector<float> values(length);
+    for (size_t i = 0; i < length; ++i) {
+      lua_rawgeti(L, 3, static_cast<lua_Integer>(i + 1));
+      auto isNumber = 0;
+      values[i] = static_cast<float>(lua_tonumberx(L, -1, &isNumber));
+      lua_pop(L, 1);
+      luaL_argcheck(L, isNumber != 0, 3, "quads must be numbers");
+    }
+    batch->quads.reserve(batch->quads.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+      batch->add(texture, &values[i * stride]);
+    }
+  }
+
+  retainTexture(L, 1, 2);
+  lua_pushinteger(L, static_cast<lua_Integer>(count));
+  return 1;
+}
+
+int L_SpriteBatch_getCount(lua_State *L) {
+  auto batch = checkSpriteBatch(L, 1);
+  lua_pushinteger(L, static_cast<lua_Integer>(batch->quads.size()));
+  return 1;
+}
+
+// flush([sortByTexture]) draws the pending quads in the order they were
+// added, so overlapping sprites keep painter's order. sorting by texture
+// (stable) saves draw calls when the sprites do not overlap. returns the
+// number of draw calls, or nil and the SDL error.
+int L_SpriteBatch_flush(lua_State *L) {
+  auto batch = checkSpriteBatch(L, 1);
+  const auto sortByTexture = lua_toboolean(L, 2) != 0;
+  auto drawCalls = batch->flush(sortByTexture);
+  lua_newtable(L);
+  lua_setiuservalue(L, 1, 1);
+  if (drawCalls < 0) {
+    lua_pushnil(L);
+    lua_pushstring(L, SDL_GetError());
+    return 2;
+  }
+  lua_pushinteger(L, drawCalls);
+  return 1;
+}
+
 int L_SDL_PollEvent(lua_State *L) {
   SDL_Event event = {0};
   int result = SDL_PollEvent(&event);
@@ -153,6 +521,15 @@ int L_SDL_GL_CreateContext(lua_State *L) {
   return 1;
 }
 
+int L_SDL_GL_DeleteContext(lua_State *L) {
+  auto pContext =
+      static_cast<SDL_GLContext *>(luaL_checkudata(L, 1, SDL_GL_CONTEXT_NAME));
+  SDL_GL_DeleteContext(*pContext);
+  *pContext = nullptr;
+  hello::lua::opengl::resetStateCache();
+  return 0;
+}
+
 int L_SDL_GL_MakeCurrent(lua_State *L) {
   auto pWindow =
       static_cast<SDL_Window **>(luaL_checkudata(L, 1, SDL_WINDOW_NAME));
@@ -176,6 +553,37 @@ int L_SDL_GL_SwapWindow(lua_State *L) {
   return 0;
 }
 
+int L_SDL_GL_SetRenderCallback(lua_State *L) {
+  auto pWindow =
+      static_cast<SDL_Window **>(luaL_checkudata(L, 1, SDL_WINDOW_NAME));
+  luaL_argcheck(L, *pWindow != nullptr, 1, "already destroyed.");
+  luaL_checkudata(L, 2, SDL_GL_CONTEXT_NAME);
+  lua_settop(L, 3);
+
+  if (lua_isnil(L, 3)) {
+    removeRenderTarget(L, *pWindow);
+    return 0;
+  }
+  luaL_checktype(L, 3, LUA_TFUNCTION);
+
+  getRenderTargets(L);
+  const auto targets = lua_gettop(L);
+  auto index = findRenderTarget(L, targets, *pWindow);
+  if (index == 0) {
+    index = static_cast<lua_Integer>(lua_rawlen(L, targets)) + 1;
+  }
+
+  lua_createtable(L, 0, 3);
+  lua_pushvalue(L, 1);
+  lua_setfield(L, -2, "window");
+  lua_pushvalue(L, 2);
+  lua_setfield(L, -2, "context");
+  lua_pushvalue(L, 3);
+  lua_setfield(L, -2, "render");
+  lua_rawseti(L, targets, index);
+  return 0;
+}
+
 int L_require(lua_State *L) {
   lua_newtable(L);
 
@@ -197,6 +605,9 @@ int L_require(lua_State *L) {
   lua_pushinteger(L, SDL_RENDERER_ACCELERATED);
   lua_setfield(L, -2, "RENDERER_ACCELERATED");
 
+  lua_pushinteger(L, SDL_RENDERER_SOFTWARE);
+  lua_setfield(L, -2, "RENDERER_SOFTWARE");
+
   lua_pushinteger(L, SDL_QUIT);
   lua_setfield(L, -2, "QUIT");
 
@@ -215,9 +626,15 @@ int L_require(lua_State *L) {
   lua_pushinteger(L, SDL_GL_CONTEXT_MINOR_VERSION);
   lua_setfield(L, -2, "GL_CONTEXT_MINOR_VERSION");
 
+  lua_pushinteger(L, SDL_GL_SHARE_WITH_CURRENT_CONTEXT);
+  lua_setfield(L, -2, "GL_SHARE_WITH_CURRENT_CONTEXT");
+
   lua_pushinteger(L, SDL_PIXELFORMAT_ABGR8888);
   lua_setfield(L, -2, "PIXELFORMAT_ABGR8888");
 
+  lua_pushstring(L, SDL_HINT_VIDEODRIVER);
+  lua_setfield(L, -2, "HINT_VIDEODRIVER");
+
   lua_pushcfunction(L, L_SDL_Init);
   lua_setfield(L, -2, "Init");
 
@@ -227,6 +644,12 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_SDL_GetError);
   lua_setfield(L, -2, "GetError");
 
+  lua_pushcfunction(L, L_SDL_SetHint);
+  lua_setfield(L, -2, "SetHint");
+
+  lua_pushcfunction(L, L_SDL_GetCurrentVideoDriver);
+  lua_setfield(L, -2, "GetCurrentVideoDriver");
+
   lua_pushcfunction(L, L_SDL_CreateWindow);
   lua_setfield(L, -2, "CreateWindow");
 
@@ -239,6 +662,24 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_SDL_DestroyRenderer);
   lua_setfield(L, -2, "DestroyRenderer");
 
+  lua_pushcfunction(L, L_SDL_SetRenderDrawColor);
+  lua_setfield(L, -2, "SetRenderDrawColor");
+
+  lua_pushcfunction(L, L_SDL_RenderClear);
+  lua_setfield(L, -2, "RenderClear");
+
+  lua_pushcfunction(L, L_SDL_RenderPresent);
+  lua_setfield(L, -2, "RenderPresent");
+
+  lua_pushcfunction(L, L_SDL_CreateTextureFromSurface);
+  lua_setfield(L, -2, "CreateTextureFromSurface");
+
+  lua_pushcfunction(L, L_SDL_DestroyTexture);
+  lua_setfield(L, -2, "DestroyTexture");
+
+  lua_pushcfunction(L, L_SDL_CreateSpriteBatch);
+  lua_setfield(L, -2, "CreateSpriteBatch");
+
   lua_pushcfunction(L, L_SDL_PollEvent);
   lua_setfield(L, -2, "PollEvent");
 
@@ -251,6 +692,9 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_SDL_GL_CreateContext);
   lua_setfield(L, -2, "GL_CreateContext");
 
+  lua_pushcfunction(L, L_SDL_GL_DeleteContext);
+  lua_setfield(L, -2, "GL_DeleteContext");
+
   lua_pushcfunction(L, L_SDL_GL_MakeCurrent);
   lua_setfield(L, -2, "GL_MakeCurrent");
 
@@ -260,6 +704,9 @@ int L_require(lua_State *L) {
   lua_pushcfunction(L, L_SDL_GL_SwapWindow);
   lua_setfield(L, -2, "GL_SwapWindow");
 
+  lua_pushcfunction(L, L_SDL_GL_SetRenderCallback);
+  lua_setfield(L, -2, "GL_SetRenderCallback");
+
   return 1;
 }
 } // namespace
@@ -268,8 +715,100 @@ namespace hello::lua::sdl2 {
 void openlibs(lua_State *L) {
   luaL_newmetatable(L, SDL_WINDOW_NAME);
   luaL_newmetatable(L, SDL_RENDERER_NAME);
+  luaL_newmetatable(L, SDL_TEXTURE_NAME);
+
+  luaL_newmetatable(L, SDL_SPRITE_BATCH_NAME);
+  lua_pushcfunction(L, L_SpriteBatch___gc);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_SpriteBatch_setColor);
+  lua_setfield(L, -2, "setColor");
+  lua_pushcfunction(L, L_SpriteBatch_add);
+  lua_setfield(L, -2, "add");
+  lua_pushcfunction(L, L_SpriteBatch_addQuads);
+  lua_setfield(L, -2, "addQuads");
+  lua_pushcfunction(L, L_SpriteBatch_getCount);
+  lua_setfield(L, -2, "getCount");
+  lua_pushcfunction(L, L_SpriteBatch_flush);
+  lua_setfield(L, -2, "flush");
+  lua_setfield(L, -2, "__index");
+
   luaL_newmetatable(L, SDL_GL_CONTEXT_NAME);
   luaL_requiref(L, "sdl2", L_require, false);
-  lua_pop(L, 4);
+  lua_pop(L, 6);
+}
+
+int renderWindows(lua_State *L) {
+  // windows are gone once the script has called SDL.Quit
+  if (SDL_WasInit(SDL_INIT_VIDEO) == 0) {
+    return LUA_OK;
+  }
+
+  getRenderTargets(L);
+  const auto targets = lua_gettop(L);
+  const auto n = static_cast<lua_Integer>(lua_rawlen(L, targets));
+  auto status = LUA_OK;
+
+  // callbacks may destroy or unregister windows, which shifts the targets,
+  // so dispatch from a copy. it also keeps the userdata of every window to
+  // present alive.
+  lua_createtable(L, static_cast<int>(n), 0);
+  const auto dispatched = lua_gettop(L);
+  for (lua_Integer i = 1; i <= n; ++i) {
+    lua_rawgeti(L, targets, i);
+    lua_rawseti(L, dispatched, i);
+  }
+
+  // dispatch every render callback first, then present all windows at once
+  std::vector<std::pair<SDL_Window **, SDL_GLContext *>> presents;
+  for (lua_Integer i = 1; i <= n; ++i) {
+    if (lua_rawgeti(L, dispatched, i) != LUA_TTABLE) {
+      lua_pop(L, 1);
+      continue;
+    }
+    lua_getfield(L, -1, "window");
+    auto pWindow =
+        static_cast<SDL_Window **>(luaL_testudata(L, -1, SDL_WINDOW_NAME));
+    lua_getfield(L, -2, "context");
+    auto pContext = static_cast<SDL_GLContext *>(
+        luaL_testudata(L, -1, SDL_GL_CONTEXT_NAME));
+    lua_pop(L, 1);
+
+    // an earlier callback may have unregistered or replaced the entry
+    auto registered = false;
+    if (pWindow != nullptr && *pWindow != nullptr) {
+      const auto index = findRenderTarget(L, targets, *pWindow);
+      if (index > 0) {
+        lua_rawgeti(L, targets, index);
+        registered = lua_rawequal(L, -1, -3) != 0;
+        lua_pop(L, 1);
+      }
+    }
+    if (!registered || pContext == nullptr || *pContext == nullptr ||
+        SDL_GL_MakeCurrent(*pWindow, *pContext) != 0) {
+      lua_pop(L, 2);
+      continue;
+    }
+
+    lua_getfield(L, -2, "render");
+    lua_insert(L, -2);
+    const auto result = utils::report(L, utils::docall(L, 1, 0));
+    if (result != LUA_OK) {
+      status = result;
+    }
+    presents.emplace_back(pWindow, pContext);
+    lua_pop(L, 1);
+  }
+
+  // a later callback may have destroyed a window or context already drawn
+  for (const auto &[pWindow, pContext] : presents) {
+    if (*pWindow == nullptr || *pContext == nullptr) {
+      continue;
+    }
+    SDL_GL_MakeCurrent(*pWindow, *pContext);
+    SDL_GL_SwapWindow(*pWindow);
+  }
+  lua_pop(L, 2);
+  return status;
 }
 } // namespace hello::lua::sdl2
\ No newline at end of file
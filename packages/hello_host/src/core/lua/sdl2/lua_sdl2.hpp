@@ -5,5 +5,6 @@
 #include "../lua_utils.hpp"
 namespace hello::lua::sdl2 {
 void openlibs(lua_State *L);
+int renderWindows(lua_State *L);
 } // namespace hello::lua::sdl2
 #endif
\ No newline at end of file
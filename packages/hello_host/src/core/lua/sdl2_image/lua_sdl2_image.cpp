@@ -1,94 +1,1108 @@
 #include "./lua_sdl2_image.hpp"
+#include "../../image/image_atlas.hpp"
+#include "../../image/image_cache.hpp"
+#include "../../image/image_compress.hpp"
+#include "../../image/image_convert.hpp"
+#include "../../image/image_decode.hpp"
+#include "../../image/image_kernels.hpp"
+#include "../../image/image_mipmap.hpp"
+#include "../../image/image_probe.hpp"
+#include "../../image/image_qoi.hpp"
+#include "../../image/image_surface_cache.hpp"
+#include "../../mapped_file.hpp"
+#include "../../thread_pool.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#ifdef __EMSCRIPTEN__
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
 
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace {
 using hello::lua::sdl2_image::UDSDL_Surface;
 
 const char *const SDL_SURFACE_NAME = "SDL_Surface";
+const char *const LOAD_BATCH_NAME = "SDL_Image_LoadBatch";
+const char *const LOAD_FUTURE_NAME = "SDL_Image_LoadFuture";
+const char *const ATLAS_NAME = "SDL_Image_Atlas";
+const char *const MAPPED_FILE_NAME = "SDL_Image_MappedFile";
+const char *const CACHE_NAME = "SDL_Image_Cache";
+
+// swaps the pixel-less placeholder of a lazily loaded surface for the
+// decoded file, converted to the placeholder's format so its info stays
+// the same. raises an error if the file is gone or no longer matches.
+void decodeLazy(lua_State *L, int idx, UDSDL_Surface *pudSurface) {
+  idx = lua_absindex(L, idx);
+  lua_getiuservalue(L, idx, 1);
+  auto filename = lua_tostring(L, -1);
+  auto placeholder = pudSurface->surface;
+
+  auto surface = hello::image::loadImage(filename);
+  if (surface != nullptr &&
+      surface->format->format != placeholder->format->format) {
+    auto converted = hello::image::convertToRGB(
+        surface, placeholder->format->BytesPerPixel);
+    SDL_FreeSurface(surface);
+    surface = converted;
+  }
+  if (surface != nullptr &&
+      (surface->w != placeholder->w || surface->h != placeholder->h)) {
+    SDL_FreeSurface(surface);
+    surface = nullptr;
+    SDL_SetError("size changed since it was probed");
+  }
+  if (surface == nullptr) {
+    luaL_error(L, "failed to decode '%s': %s", filename, SDL_GetError());
+  }
+  lua_pop(L, 1);
+
+  SDL_FreeSurface(placeholder);
+  pudSurface->surface = surface;
+  pudSurface->lazy = false;
+  lua_pushnil(L);
+  lua_setiuservalue(L, idx, 1);
+}
+
+SDL_Surface *checkSurface(lua_State *L, int idx) {
+  auto pudSurface =
+      static_cast<UDSDL_Surface *>(luaL_checkudata(L, idx, SDL_SURFACE_NAME));
+  luaL_argcheck(L, pudSurface->surface != nullptr, idx, "already freed.");
+  if (pudSurface->lazy) {
+    decodeLazy(L, idx, pudSurface);
+  }
+  return pudSurface->surface;
+}
 
 int L_load(lua_State *L) {
   auto filename = static_cast<const char *>(luaL_checkstring(L, 1));
-  auto surface = IMG_Load(filename);
+  auto surface = hello::image::loadImage(filename);
+  hello::lua::sdl2_image::push(L, surface);
+  return 1;
+}
 
-  if (surface != nullptr) {
-    auto pudSurface =
-        static_cast<UDSDL_Surface *>(lua_newuserdata(L, sizeof(UDSDL_Surface)));
-    pudSurface->surface = surface;
-    luaL_setmetatable(L, SDL_SURFACE_NAME);
-  } else {
+bool probeFile(const char *filename, hello::image::ImageProbe *probe) {
+  auto file = hello::MappedFile::open(filename);
+  if (file == nullptr) {
+    SDL_SetError("could not open '%s'", filename);
+    return false;
+  }
+  if (!hello::image::probeImage(file->getData(), file->getSize(), probe)) {
+    SDL_SetError("unknown or truncated image '%s'", filename);
+    return false;
+  }
+  return true;
+}
+
+// {type, w, h, channels} read from the file header alone, or nil and the
+// error. nothing past the header is read.
+int L_probe(lua_State *L) {
+  auto filename = luaL_checkstring(L, 1);
+  hello::image::ImageProbe probe;
+  if (!probeFile(filename, &probe)) {
+    lua_pushnil(L);
+    lua_pushstring(L, SDL_GetError());
+    return 2;
+  }
+  lua_newtable(L);
+  lua_pushstring(L, probe.type);
+  lua_setfield(L, -2, "type");
+  lua_pushinteger(L, probe.width);
+  lua_setfield(L, -2, "w");
+  lua_pushinteger(L, probe.height);
+  lua_setfield(L, -2, "h");
+  lua_pushinteger(L, probe.channels);
+  lua_setfield(L, -2, "channels");
+  return 1;
+}
+
+// a surface that only knows its size and format until its pixels are
+// first needed (lock, any pixel method, a GL or renderer upload), when
+// the file is decoded. lazy surfaces are RGBA32 if the file has alpha and
+// RGB24 otherwise, and getInfo and free never decode.
+int L_loadLazy(lua_State *L) {
+  auto filename = luaL_checkstring(L, 1);
+  hello::image::ImageProbe probe;
+  if (!probeFile(filename, &probe)) {
     lua_pushnil(L);
+    lua_pushstring(L, SDL_GetError());
+    return 2;
   }
+  const auto channels = probe.channels % 2 == 0 ? 4 : 3;
+  const auto pitch = (static_cast<int64_t>(probe.width) * channels + 3) & ~3;
+  if (pitch > INT_MAX) {
+    lua_pushnil(L);
+    lua_pushstring(L, "image is too large");
+    return 2;
+  }
+  auto placeholder = SDL_CreateRGBSurfaceWithFormatFrom(
+      nullptr, probe.width, probe.height, channels * 8,
+      static_cast<int>(pitch),
+      channels == 4 ? SDL_PIXELFORMAT_RGBA32 : SDL_PIXELFORMAT_RGB24);
+  if (placeholder == nullptr) {
+    lua_pushnil(L);
+    lua_pushstring(L, SDL_GetError());
+    return 2;
+  }
+  hello::lua::sdl2_image::push(L, placeholder);
+  hello::lua::sdl2_image::get(L, -1)->lazy = true;
+  lua_pushvalue(L, 1);
+  lua_setiuservalue(L, -2, 1);
+  return 1;
+}
+
+int L_isLoaded(lua_State *L) {
+  auto pudSurface =
+      static_cast<UDSDL_Surface *>(luaL_checkudata(L, 1, SDL_SURFACE_NAME));
+  luaL_argcheck(L, pudSurface->surface != nullptr, 1, "already freed.");
+  lua_pushboolean(L, !pudSurface->lazy);
   return 1;
 }
 
+// the encoded bytes of a string. the value stays on the stack, so it is
+// pinned for as long as the returned memory is used.
+const void *checkEncoded(lua_State *L, int idx, size_t *size) {
+  auto data = luaL_checklstring(L, idx, size);
+  luaL_argcheck(L, *size <= static_cast<size_t>(INT_MAX), idx,
+                "data is too large");
+  return data;
+}
+
+SDL_Surface *decodeFromMemory(lua_State *L, int idx) {
+  size_t size;
+  auto src = checkEncoded(L, idx, &size);
+  return hello::image::decodeImage(src, size);
+}
+
 int L_loadFromString(lua_State *L) {
+  auto surface = decodeFromMemory(L, 1);
+  hello::lua::sdl2_image::push(L, surface);
+  return 1;
+}
+
+// decodes into an existing surface of the same size. QOI goes straight
+// into its pixels when the channels match; SDL_image always decodes into a
+// surface of its own, which is then converted into `dst`.
+int L_loadFromStringInto(lua_State *L) {
+  auto dst = checkSurface(L, 2);
   size_t size;
-  auto src = luaL_checklstring(L, 1, &size);
-  auto dst = malloc(size);
-  ::memcpy(dst, src, size);
-  auto rw = SDL_RWFromMem(dst, static_cast<int>(size));
-  auto surface = IMG_Load_RW(rw, SDL_TRUE);
+  auto data = checkEncoded(L, 1, &size);
 
-  if (surface != nullptr) {
-    auto pudSurface =
-        static_cast<UDSDL_Surface *>(lua_newuserdata(L, sizeof(UDSDL_Surface)));
-    pudSurface->surface = surface;
-    luaL_setmetatable(L, SDL_SURFACE_NAME);
+  hello::image::QoiHeader header;
+  auto channels = 0;
+  if (dst->format->format == SDL_PIXELFORMAT_RGBA32) {
+    channels = 4;
+  } else if (dst->format->format == SDL_PIXELFORMAT_RGB24) {
+    channels = 3;
+  }
+  if (hello::image::readQoiHeader(data, size, &header) &&
+      header.width == dst->w && header.height == dst->h &&
+      header.channels == channels && !SDL_MUSTLOCK(dst)) {
+    if (!hello::image::decodeQoi(data, size, header,
+                                 static_cast<uint8_t *>(dst->pixels),
+                                 dst->pitch)) {
+      SDL_SetError("truncated QOI image");
+      lua_pushnil(L);
+      return 1;
+    }
+    lua_pushvalue(L, 2);
+    return 1;
+  }
+
+  auto src = hello::image::decodeImage(data, size);
+  if (src == nullptr) {
+    lua_pushnil(L);
+    return 1;
+  }
+
+  auto result = -1;
+  if (src->w == dst->w && src->h == dst->h) {
+    SDL_LockSurface(src);
+    SDL_LockSurface(dst);
+    result = SDL_ConvertPixels(src->w, src->h, src->format->format,
+                               src->pixels, src->pitch, dst->format->format,
+                               dst->pixels, dst->pitch);
+    SDL_UnlockSurface(dst);
+    SDL_UnlockSurface(src);
+  } else {
+    SDL_SetError("size mismatch: decoded %dx%d into %dx%d", src->w, src->h,
+                 dst->w, dst->h);
+  }
+  SDL_FreeSurface(src);
+
+  if (result == 0) {
+    lua_pushvalue(L, 2);
   } else {
     lua_pushnil(L);
   }
   return 1;
 }
 
+struct UDMappedFile {
+  hello::MappedFile *data;
+};
+
+int L_MappedFile___gc(lua_State *L) {
+  auto pFile =
+      static_cast<UDMappedFile *>(luaL_checkudata(L, 1, MAPPED_FILE_NAME));
+  delete pFile->data;
+  pFile->data = nullptr;
+  return 0;
+}
+
+// load() through a disk cache of GL-ready pixels in `directory`, keyed by
+// the file's content hash and the format (GL.RGBA or GL.RGB). hits map the
+// entry instead of decoding it, and the surface keeps the mapping alive.
+// the second result tells whether the pixels came from the cache.
+int L_loadCached(lua_State *L) {
+  auto filename = luaL_checkstring(L, 1);
+  auto directory = luaL_checkstring(L, 2);
+  auto glFormat = static_cast<GLenum>(luaL_optinteger(L, 3, GL_RGBA));
+  luaL_argcheck(L, glFormat == GL_RGBA || glFormat == GL_RGB, 3,
+                "format must be GL_RGBA or GL_RGB");
+  const auto channels = glFormat == GL_RGBA ? 4 : 3;
+  const Uint32 format =
+      channels == 4 ? SDL_PIXELFORMAT_RGBA32 : SDL_PIXELFORMAT_RGB24;
+
+  std::vector<uint8_t> encoded;
+  if (!hello::image::readFile(filename, &encoded) ||
+      encoded.size() > static_cast<size_t>(INT_MAX)) {
+    lua_pushnil(L);
+    return 1;
+  }
+  const auto hash = hello::image::hashContent(encoded.data(), encoded.size());
+  const auto path = hello::image::getCachePath(directory, hash, format);
+
+  if (auto file = hello::MappedFile::open(path)) {
+    auto surface = hello::image::openCachedSurface(*file, hash, format);
+    if (surface != nullptr) {
+      hello::lua::sdl2_image::push(L, surface);
+      auto pFile = static_cast<UDMappedFile *>(
+          lua_newuserdata(L, sizeof(UDMappedFile)));
+      pFile->data = file.release();
+      luaL_setmetatable(L, MAPPED_FILE_NAME);
+      lua_setiuservalue(L, -2, 1);
+      lua_pushboolean(L, 1);
+      return 2;
+    }
+  }
+
+  auto decoded = hello::image::decodeImage(
+      encoded.data(), encoded.size(), hello::image::getImageType(filename));
+  if (decoded == nullptr) {
+    lua_pushnil(L);
+    return 1;
+  }
+  auto surface = decoded;
+  if (decoded->format->format != format) {
+    surface = hello::image::convertToRGB(decoded, channels);
+    SDL_FreeSurface(decoded);
+    if (surface == nullptr) {
+      lua_pushnil(L);
+      return 1;
+    }
+  }
+  // a cache that cannot be written only costs the next start a decode
+  hello::image::writeCachedSurface(path, hash, surface);
+  hello::lua::sdl2_image::push(L, surface);
+  lua_pushboolean(L, 0);
+  return 2;
+}
+
+struct UDSurfaceCache {
+  hello::image::SurfaceCache *data;
+};
+
+hello::image::SurfaceCache *checkSurfaceCache(lua_State *L, int idx) {
+  auto pCache =
+      static_cast<UDSurfaceCache *>(luaL_checkudata(L, idx, CACHE_NAME));
+  luaL_argcheck(L, pCache->data != nullptr, idx, "already freed.");
+  return pCache->data;
+}
+
+size_t checkBudget(lua_State *L, int idx) {
+  auto budget = luaL_checkinteger(L, idx);
+  luaL_argcheck(L, budget >= 0, idx, "budget must not be negative");
+  return static_cast<size_t>(budget);
+}
+
+int L_newCache(lua_State *L) {
+  auto budget = checkBudget(L, 1);
+  auto pCache =
+      static_cast<UDSurfaceCache *>(lua_newuserdata(L, sizeof(UDSurfaceCache)));
+  pCache->data = new hello::image::SurfaceCache(budget);
+  luaL_setmetatable(L, CACHE_NAME);
+  return 1;
+}
+
+int L_Cache___gc(lua_State *L) {
+  auto pCache =
+      static_cast<UDSurfaceCache *>(luaL_checkudata(L, 1, CACHE_NAME));
+  delete pCache->data;
+  pCache->data = nullptr;
+  return 0;
+}
+
+// the entry's surface, shared with every load of the same path or bytes.
+// its pixels are read-only. the surface anchors the cache, which stays
+// alive as long as any surface it handed out.
+int L_Cache_load(lua_State *L) {
+  auto cache = checkSurfaceCache(L, 1);
+  auto filename = luaL_checkstring(L, 2);
+  auto surface = cache->load(filename);
+  hello::lua::sdl2_image::push(L, surface);
+  if (surface != nullptr) {
+    lua_pushvalue(L, 1);
+    lua_setiuservalue(L, -2, 1);
+  }
+  return 1;
+}
+
+int L_Cache_setBudget(lua_State *L) {
+  auto cache = checkSurfaceCache(L, 1);
+  cache->setBudget(checkBudget(L, 2));
+  return 0;
+}
+
+int L_Cache_clear(lua_State *L) {
+  auto cache = checkSurfaceCache(L, 1);
+  cache->clear();
+  return 0;
+}
+
+int L_Cache_getStats(lua_State *L) {
+  auto cache = checkSurfaceCache(L, 1);
+  const auto &stats = cache->getStats();
+  lua_createtable(L, 0, 6);
+  lua_pushinteger(L, static_cast<lua_Integer>(stats.hits));
+  lua_setfield(L, -2, "hits");
+  lua_pushinteger(L, static_cast<lua_Integer>(stats.misses));
+  lua_setfield(L, -2, "misses");
+  lua_pushinteger(L, static_cast<lua_Integer>(stats.evictions));
+  lua_setfield(L, -2, "evictions");
+  lua_pushinteger(L, static_cast<lua_Integer>(stats.bytes));
+  lua_setfield(L, -2, "bytes");
+  lua_pushinteger(L, static_cast<lua_Integer>(stats.count));
+  lua_setfield(L, -2, "count");
+  lua_pushinteger(L, static_cast<lua_Integer>(cache->getBudget()));
+  lua_setfield(L, -2, "budget");
+  return 1;
+}
+
+struct LoadResult {
+  int index;
+  SDL_Surface *surface;
+  std::string error;
+};
+
+// shared between Lua and the workers; whoever drops it last frees the
+// surfaces that were decoded but never handed to Lua.
+struct LoadBatch {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<LoadResult> completed;
+  int remaining = 0;
+
+  ~LoadBatch() {
+    for (auto &result : completed) {
+      SDL_FreeSurface(result.surface);
+    }
+  }
+};
+
+struct UDLoadBatch {
+  std::shared_ptr<LoadBatch> *data;
+};
+
+// IMG_Init sets up the decoder libraries lazily and is not thread-safe,
+// so it runs on the Lua thread before any worker may decode.
+void initImageLoaders() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+  });
+}
+
+void startLoad(const std::shared_ptr<LoadBatch> &batch, int index,
+               std::string path) {
+  initImageLoaders();
+  hello::thread_pool::submit([batch, index, path = std::move(path)] {
+    auto surface = hello::image::loadImage(path.c_str());
+    std::string error = surface == nullptr ? SDL_GetError() : "";
+    {
+      std::lock_guard<std::mutex> lock(batch->mutex);
+      batch->completed.push_back({index, surface, std::move(error)});
+    }
+    batch->cv.notify_all();
+  });
+}
+
+UDLoadBatch *newLoadBatch(lua_State *L, const char *name) {
+  auto pBatch = static_cast<UDLoadBatch *>(
+      lua_newuserdatauv(L, sizeof(UDLoadBatch), 1));
+  pBatch->data = new std::shared_ptr<LoadBatch>(new LoadBatch());
+  luaL_setmetatable(L, name);
+  return pBatch;
+}
+
+LoadBatch *checkLoadBatch(lua_State *L, int idx, const char *name) {
+  auto pBatch = static_cast<UDLoadBatch *>(luaL_checkudata(L, idx, name));
+  luaL_argcheck(L, pBatch->data != nullptr, idx, "already freed.");
+  return pBatch->data->get();
+}
+
+// pushes index, surface|nil, error|nil for the next completed load.
+int pushLoadResult(lua_State *L, LoadBatch *batch, bool wait) {
+  LoadResult result;
+  {
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    if (batch->remaining == 0) {
+      lua_pushnil(L);
+      return 1;
+    }
+    if (wait) {
+      batch->cv.wait(lock, [batch] { return !batch->completed.empty(); });
+    } else if (batch->completed.empty()) {
+      lua_pushnil(L);
+      return 1;
+    }
+    result = std::move(batch->completed.front());
+    batch->completed.pop_front();
+    --batch->remaining;
+  }
+
+  lua_pushinteger(L, result.index);
+  hello::lua::sdl2_image::push(L, result.surface);
+  if (result.surface == nullptr) {
+    lua_pushstring(L, result.error.c_str());
+    return 3;
+  }
+  return 2;
+}
+
+int L_loadAsync(lua_State *L) {
+  auto path = luaL_checkstring(L, 1);
+  auto pBatch = newLoadBatch(L, LOAD_FUTURE_NAME);
+  (*pBatch->data)->remaining = 1;
+  startLoad(*pBatch->data, 1, path);
+  return 1;
+}
+
+int L_loadMany(lua_State *L) {
+  luaL_checktype(L, 1, LUA_TTABLE);
+  const auto count = static_cast<int>(luaL_len(L, 1));
+  std::vector<std::string> paths;
+  for (int i = 1; i <= count; ++i) {
+    lua_geti(L, 1, i);
+    luaL_argcheck(L, lua_type(L, -1) == LUA_TSTRING, 1,
+                  "paths must be an array of strings");
+    paths.emplace_back(lua_tostring(L, -1));
+    lua_pop(L, 1);
+  }
+
+  auto pBatch = newLoadBatch(L, LOAD_BATCH_NAME);
+  (*pBatch->data)->remaining = count;
+  for (int i = 1; i <= count; ++i) {
+    startLoad(*pBatch->data, i, std::move(paths[i - 1]));
+  }
+  return 1;
+}
+
+int L_LoadBatch___gc(lua_State *L) {
+  auto pBatch = static_cast<UDLoadBatch *>(lua_touserdata(L, 1));
+  delete pBatch->data;
+  pBatch->data = nullptr;
+  return 0;
+}
+
+int L_LoadBatch_next(lua_State *L) {
+  auto batch = checkLoadBatch(L, 1, LOAD_BATCH_NAME);
+  return pushLoadResult(L, batch, true);
+}
+
+int L_LoadBatch_poll(lua_State *L) {
+  auto batch = checkLoadBatch(L, 1, LOAD_BATCH_NAME);
+  return pushLoadResult(L, batch, false);
+}
+
+int L_LoadBatch_getRemaining(lua_State *L) {
+  auto batch = checkLoadBatch(L, 1, LOAD_BATCH_NAME);
+  std::lock_guard<std::mutex> lock(batch->mutex);
+  lua_pushinteger(L, batch->remaining);
+  return 1;
+}
+
+int L_LoadFuture_isReady(lua_State *L) {
+  auto batch = checkLoadBatch(L, 1, LOAD_FUTURE_NAME);
+  std::lock_guard<std::mutex> lock(batch->mutex);
+  lua_pushboolean(L, batch->remaining == 0 || !batch->completed.empty());
+  return 1;
+}
+
+// blocks until decoded; later calls return the same surface userdata.
+int L_LoadFuture_wait(lua_State *L) {
+  auto batch = checkLoadBatch(L, 1, LOAD_FUTURE_NAME);
+  if (lua_getiuservalue(L, 1, 1) != LUA_TNIL) {
+    return 1;
+  }
+  lua_pop(L, 1);
+
+  auto n = pushLoadResult(L, batch, true);
+  if (n == 1) {
+    // a failed load was already reported by an earlier call
+    return 1;
+  }
+  lua_remove(L, -n);
+  if (n == 2) {
+    lua_pushvalue(L, -1);
+    lua_setiuservalue(L, 1, 1);
+    return 1;
+  }
+  return 2;
+}
+
 int L_lockSurface(lua_State *L) {
-  auto pudSurface =
-      static_cast<UDSDL_Surface *>(luaL_checkudata(L, 1, SDL_SURFACE_NAME));
-  luaL_argcheck(L, pudSurface->surface != nullptr, 1, "already freed.");
-  auto surface = pudSurface->surface;
+  auto surface = checkSurface(L, 1);
   SDL_LockSurface(surface);
   return 0;
 }
 
 int L_unlockSurface(lua_State *L) {
-  auto pudSurface =
-      static_cast<UDSDL_Surface *>(luaL_checkudata(L, 1, SDL_SURFACE_NAME));
-  luaL_argcheck(L, pudSurface->surface != nullptr, 1, "already freed.");
-  auto surface = pudSurface->surface;
+  auto surface = checkSurface(L, 1);
   SDL_UnlockSurface(surface);
   return 0;
 }
 
+// a surface over the (x, y, w, h) rectangle of this one, sharing its
+// pixels and pitch. the view keeps the parent surface alive, and every
+// surface method and GL upload works on it as on any other surface.
+int L_view(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  auto x = static_cast<int>(luaL_checkinteger(L, 2));
+  auto y = static_cast<int>(luaL_checkinteger(L, 3));
+  auto w = static_cast<int>(luaL_checkinteger(L, 4));
+  auto h = static_cast<int>(luaL_checkinteger(L, 5));
+  luaL_argcheck(L, x >= 0 && y >= 0 && w > 0 && h > 0 && x + w <= surface->w &&
+                       y + h <= surface->h,
+                2, "rectangle is outside the surface");
+  luaL_argcheck(L, surface->format->BitsPerPixel % 8 == 0, 1,
+                "sub-byte pixel formats cannot be viewed");
+  luaL_argcheck(L, !SDL_MUSTLOCK(surface), 1,
+                "RLE surfaces cannot be viewed");
+
+  auto pixels = static_cast<uint8_t *>(surface->pixels) +
+                static_cast<size_t>(y) * surface->pitch +
+                x * surface->format->BytesPerPixel;
+  auto view = SDL_CreateRGBSurfaceWithFormatFrom(
+      pixels, w, h, surface->format->BitsPerPixel, surface->pitch,
+      surface->format->format);
+  if (view == nullptr) {
+    return luaL_error(L, "failed to create view: %s", SDL_GetError());
+  }
+  if (surface->format->palette != nullptr) {
+    SDL_SetSurfacePalette(view, surface->format->palette);
+  }
+
+  hello::lua::sdl2_image::push(L, view);
+  // a reference of our own, so freeing the parent leaves the pixels intact.
+  // it anchors the parent's userdata in turn, which may own the mapping
+  // the pixels live in.
+  ++surface->refcount;
+  hello::lua::sdl2_image::push(L, surface);
+  lua_pushvalue(L, 1);
+  lua_setiuservalue(L, -2, 1);
+  lua_setiuservalue(L, -2, 1);
+  return 1;
+}
+
+// byte offset of a channel inside a pixel in memory, or -1 if absent.
+int getByteIndex(const SDL_PixelFormat *format, Uint32 mask, Uint8 shift) {
+  if (mask == 0) {
+    return -1;
+  }
+  auto index = shift / 8;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+  index = format->BytesPerPixel - 1 - index;
+#else
+  (void)format;
+#endif
+  return index;
+}
+
 int L_flipVertical(lua_State *L) {
-  auto pudSurface =
-      static_cast<UDSDL_Surface *>(luaL_checkudata(L, 1, SDL_SURFACE_NAME));
-  luaL_argcheck(L, pudSurface->surface != nullptr, 1, "already freed.");
-  auto surface = pudSurface->surface;
+  auto surface = checkSurface(L, 1);
+  hello::image::flipVertical(static_cast<uint8_t *>(surface->pixels),
+                             surface->w * surface->format->BytesPerPixel,
+                             surface->h, surface->pitch);
+  return 0;
+}
+
+int L_flipHorizontal(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  hello::image::flipHorizontal(static_cast<uint8_t *>(surface->pixels),
+                               surface->w, surface->h, surface->pitch,
+                               surface->format->BytesPerPixel);
+  return 0;
+}
+
+int L_swizzle(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  size_t length;
+  auto channels = luaL_checklstring(L, 2, &length);
+  auto format = surface->format;
+  luaL_argcheck(L, format->BytesPerPixel == 4, 1,
+                "surface must have 4 bytes per pixel");
+  luaL_argcheck(L, length == 4, 2, "order must be 4 characters of 'rgba'");
+
+  uint8_t order[4];
+  Uint32 masks[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 4; ++i) {
+    Uint32 mask = 0;
+    Uint8 shift = 0;
+    int channel = 0;
+    switch (channels[i]) {
+    case 'r':
+      mask = format->Rmask;
+      shift = format->Rshift;
+      channel = 0;
+      break;
+    case 'g':
+      mask = format->Gmask;
+      shift = format->Gshift;
+      channel = 1;
+      break;
+    case 'b':
+      mask = format->Bmask;
+      shift = format->Bshift;
+      channel = 2;
+      break;
+    case 'a':
+      mask = format->Amask;
+      shift = format->Ashift;
+      channel = 3;
+      break;
+    default:
+      return luaL_argerror(L, 2, "order must be 4 characters of 'rgba'");
+    }
+    auto index = getByteIndex(format, mask, shift);
+    luaL_argcheck(L, index >= 0, 2, "surface has no such channel");
+    order[i] = static_cast<uint8_t>(index);
+
+    // mask of the byte this channel lands on
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    masks[channel] = 0xffu << ((3 - i) * 8);
+#else
+    masks[channel] = 0xffu << (i * 8);
+#endif
+  }
+
+  hello::image::swizzle(static_cast<uint8_t *>(surface->pixels), surface->w,
+                        surface->h, surface->pitch, order);
+
+  // the surface keeps its format; report the one describing the new bytes
+  lua_pushinteger(L, SDL_MasksToPixelFormatEnum(32, masks[0], masks[1],
+                                                masks[2], masks[3]));
+  return 1;
+}
+
+int L_premultiplyAlpha(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  auto format = surface->format;
+  luaL_argcheck(L, format->BytesPerPixel == 4, 1,
+                "surface must have 4 bytes per pixel");
+  auto alphaIndex = getByteIndex(format, format->Amask, format->Ashift);
+  luaL_argcheck(L, alphaIndex >= 0, 1, "surface has no alpha channel");
+  hello::image::premultiplyAlpha(static_cast<uint8_t *>(surface->pixels),
+                                 surface->w, surface->h, surface->pitch,
+                                 alphaIndex);
+  return 0;
+}
+
+int L_srgbToLinear(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  auto format = surface->format;
+  luaL_argcheck(L, format->BytesPerPixel >= 3, 1,
+                "surface must have 3 or 4 bytes per pixel");
+  auto alphaIndex = getByteIndex(format, format->Amask, format->Ashift);
+  hello::image::srgbToLinear(static_cast<uint8_t *>(surface->pixels),
+                             surface->w, surface->h, surface->pitch,
+                             format->BytesPerPixel, alphaIndex);
+  return 0;
+}
+
+// returns a new tightly packed surface plus the format, type and
+// UNPACK_ALIGNMENT to upload it with.
+int L_toGLFormat(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  auto format = static_cast<GLenum>(luaL_optinteger(L, 2, GL_RGBA));
+  luaL_argcheck(L, format == GL_RGBA || format == GL_RGB, 2,
+                "format must be GL_RGBA or GL_RGB");
+
+  auto converted =
+      hello::image::convertToRGB(surface, format == GL_RGBA ? 4 : 3);
+  if (converted == nullptr) {
+    lua_pushnil(L);
+    return 1;
+  }
+  hello::lua::sdl2_image::push(L, converted);
+  lua_pushinteger(L, format);
+  lua_pushinteger(L, GL_UNSIGNED_BYTE);
+  lua_pushinteger(L, hello::image::getUnpackAlignment(converted->pitch));
+  return 4;
+}
+
+// returns {level0, level1, ...} as RGBA32 surfaces. options:
+// filter = "box" | "kaiser" | "lanczos", srgb = true, levels = all
+int L_generateMipmaps(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  auto filter = hello::image::MipFilter::Box;
+  auto srgb = true;
+  auto count = hello::image::getMipLevelCount(surface->w, surface->h);
+
+  if (!lua_isnoneornil(L, 2)) {
+    luaL_checktype(L, 2, LUA_TTABLE);
+    static const char *const filters[] = {"box", "kaiser", "lanczos",
+                                          nullptr};
+    lua_getfield(L, 2, "filter");
+    filter = static_cast<hello::image::MipFilter>(
+        luaL_checkoption(L, -1, "box", filters));
+    lua_getfield(L, 2, "srgb");
+    srgb = lua_isnil(L, -1) || lua_toboolean(L, -1);
+    lua_getfield(L, 2, "levels");
+    count = std::min(count, static_cast<int>(luaL_optinteger(L, -1, count)));
+    lua_pop(L, 3);
+  }
+
+  lua_newtable(L);
+  SDL_Surface *base = surface;
+  if (surface->format->format == SDL_PIXELFORMAT_RGBA32) {
+    lua_pushvalue(L, 1);
+  } else {
+    base = hello::image::convertToRGB(surface, 4);
+    if (base == nullptr) {
+      return luaL_error(L, "failed to convert surface: %s", SDL_GetError());
+    }
+    hello::lua::sdl2_image::push(L, base);
+  }
+  lua_rawseti(L, -2, 1);
+
+  std::vector<hello::image::ImageView> levels;
+  auto w = base->w;
+  auto h = base->h;
+  for (int i = 0; i < count; ++i) {
+    w = std::max(1, w / 2);
+    h = std::max(1, h / 2);
+    auto level =
+        SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (level == nullptr) {
+      return luaL_error(L, "failed to create surface: %s", SDL_GetError());
+    }
+    // owned by the table right away, so a later error cannot leak it
+    hello::lua::sdl2_image::push(L, level);
+    lua_rawseti(L, -2, i + 2);
+    levels.push_back({static_cast<uint8_t *>(level->pixels), w, h,
+                      level->pitch});
+  }
+
+  SDL_LockSurface(base);
+  hello::image::generateMipmaps(
+      {static_cast<uint8_t *>(base->pixels), base->w, base->h, base->pitch},
+      levels.data(), count, filter, srgb);
+  SDL_UnlockSurface(base);
+  return 1;
+}
+
+// returns the 4x4 blocks as a string for GL.compressedTexImage2D. format
+// is "bc1" | "bc3" | "bc7" | "etc2" | "etc2_eac", options: quality =
+// "fast" | "normal" | "high"
+int L_compress(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  static const char *const formats[] = {"bc1",  "bc3",      "bc7",
+                                        "etc2", "etc2_eac", nullptr};
+  auto format = static_cast<hello::image::BlockFormat>(
+      luaL_checkoption(L, 2, nullptr, formats));
+  auto quality = hello::image::CompressQuality::Normal;
+  if (!lua_isnoneornil(L, 3)) {
+    luaL_checktype(L, 3, LUA_TTABLE);
+    static const char *const qualities[] = {"fast", "normal", "high",
+                                            nullptr};
+    lua_getfield(L, 3, "quality");
+    quality = static_cast<hello::image::CompressQuality>(
+        luaL_checkoption(L, -1, "normal", qualities));
+    lua_pop(L, 1);
+  }
+
+  // encode straight into the result string. it is allocated first, since
+  // a memory error after the conversion would leak the converted surface.
+  const auto size =
+      hello::image::getCompressedSize(format, surface->w, surface->h);
+  luaL_Buffer buffer;
+  auto blocks =
+      reinterpret_cast<uint8_t *>(luaL_buffinitsize(L, &buffer, size));
+
+  auto rgba = surface;
+  if (surface->format->format != SDL_PIXELFORMAT_RGBA32) {
+    rgba = hello::image::convertToRGB(surface, 4);
+    if (rgba == nullptr) {
+      return luaL_error(L, "failed to convert surface: %s", SDL_GetError());
+    }
+  }
+  SDL_LockSurface(rgba);
+  hello::image::compress(
+      {static_cast<uint8_t *>(rgba->pixels), rgba->w, rgba->h, rgba->pitch},
+      format, quality, blocks);
+  SDL_UnlockSurface(rgba);
+  if (rgba != surface) {
+    SDL_FreeSurface(rgba);
+  }
+  luaL_pushresultsize(&buffer, size);
+  return 1;
+}
+
+// writes the surface as QOI, RGBA when it has alpha and RGB otherwise.
+// returns true, or nil and the error message.
+int L_saveQOI(lua_State *L) {
+  auto surface = checkSurface(L, 1);
+  auto filename = luaL_checkstring(L, 2);
+  const auto channels = surface->format->Amask != 0 ? 4 : 3;
+  const Uint32 format =
+      channels == 4 ? SDL_PIXELFORMAT_RGBA32 : SDL_PIXELFORMAT_RGB24;
+
+  auto src = surface;
+  if (surface->format->format != format) {
+    src = hello::image::convertToRGB(surface, channels);
+    if (src == nullptr) {
+      lua_pushnil(L);
+      lua_pushstring(L, SDL_GetError());
+      return 2;
+    }
+  }
+  std::vector<uint8_t> encoded;
+  SDL_LockSurface(src);
+  hello::image::encodeQoi(static_cast<const uint8_t *>(src->pixels), src->w,
+                          src->h, src->pitch, channels, &encoded);
+  SDL_UnlockSurface(src);
+  if (src != surface) {
+    SDL_FreeSurface(src);
+  }
+
+  auto rw = SDL_RWFromFile(filename, "wb");
+  auto ok = rw != nullptr &&
+            SDL_RWwrite(rw, encoded.data(), 1, encoded.size()) ==
+                encoded.size();
+  if (rw != nullptr) {
+    ok = SDL_RWclose(rw) == 0 && ok;
+  }
+  if (!ok) {
+    lua_pushnil(L);
+    lua_pushstring(L, SDL_GetError());
+    return 2;
+  }
+  lua_pushboolean(L, true);
+  return 1;
+}
+
+struct Atlas {
+  int pageWidth;
+  int pageHeight;
+  int padding;
+  int extrude;
+  std::vector<SDL_Surface *> pages;
+  std::vector<hello::image::SkylinePacker> packers;
+
+  ~Atlas() {
+    for (auto page : pages) {
+      SDL_FreeSurface(page);
+    }
+  }
+};
+
+struct UDAtlas {
+  Atlas *data;
+};
+
+Atlas *checkAtlas(lua_State *L, int idx) {
+  auto pAtlas = static_cast<UDAtlas *>(luaL_checkudata(L, idx, ATLAS_NAME));
+  luaL_argcheck(L, pAtlas->data != nullptr, idx, "already freed.");
+  return pAtlas->data;
+}
+
+// packs one surface and pushes {page, x, y, w, h, u0, v0, u1, v1}.
+void addToAtlas(lua_State *L, Atlas *atlas, SDL_Surface *surface, int arg) {
+  const auto cellWidth = surface->w + atlas->extrude * 2 + atlas->padding;
+  const auto cellHeight = surface->h + atlas->extrude * 2 + atlas->padding;
+  luaL_argcheck(L,
+                cellWidth - atlas->padding <= atlas->pageWidth &&
+                    cellHeight - atlas->padding <= atlas->pageHeight,
+                arg, "surface does not fit in an atlas page");
+
+  auto rgba = surface;
+  if (surface->format->format != SDL_PIXELFORMAT_RGBA32) {
+    rgba = hello::image::convertToRGB(surface, 4);
+    if (rgba == nullptr) {
+      luaL_error(L, "failed to convert surface: %s", SDL_GetError());
+    }
+  }
+
+  size_t page = 0;
+  int x = 0;
+  int y = 0;
+  for (; page < atlas->packers.size(); ++page) {
+    if (atlas->packers[page].insert(cellWidth, cellHeight, &x, &y)) {
+      break;
+    }
+  }
+  if (page == atlas->packers.size()) {
+    auto pageSurface =
+        SDL_CreateRGBSurfaceWithFormat(0, atlas->pageWidth, atlas->pageHeight,
+                                       32, SDL_PIXELFORMAT_RGBA32);
+    if (pageSurface == nullptr) {
+      if (rgba != surface) {
+        SDL_FreeSurface(rgba);
+      }
+      luaL_error(L, "failed to create atlas page: %s", SDL_GetError());
+    }
+    atlas->pages.push_back(pageSurface);
+    // trailing padding may hang over the right and bottom edges
+    atlas->packers.emplace_back(atlas->pageWidth + atlas->padding,
+                                atlas->pageHeight + atlas->padding);
+    atlas->packers.back().insert(cellWidth, cellHeight, &x, &y);
+  }
 
-  int pitch = surface->pitch;   // row size
-  char *temp = new char[pitch]; // intermediate buffer
-  char *pixels = (char *)surface->pixels;
+  x += atlas->extrude;
+  y += atlas->extrude;
+  auto dst = atlas->pages[page];
+  SDL_LockSurface(rgba);
+  hello::image::blitExtruded(
+      {static_cast<uint8_t *>(rgba->pixels), rgba->w, rgba->h, rgba->pitch},
+      {static_cast<uint8_t *>(dst->pixels), dst->w, dst->h, dst->pitch}, x,
+      y, atlas->extrude);
+  SDL_UnlockSurface(rgba);
+  if (rgba != surface) {
+    SDL_FreeSurface(rgba);
+  }
 
-  for (int i = 0; i < surface->h / 2; ++i) {
-    // get pointers to the two rows to swap
-    char *row1 = pixels + i * pitch;
-    char *row2 = pixels + (surface->h - i - 1) * pitch;
+  const auto w = surface->w;
+  const auto h = surface->h;
+  lua_createtable(L, 0, 9);
+  lua_pushinteger(L, static_cast<lua_Integer>(page + 1));
+  lua_setfield(L, -2, "page");
+  lua_pushinteger(L, x);
+  lua_setfield(L, -2, "x");
+  lua_pushinteger(L, y);
+  lua_setfield(L, -2, "y");
+  lua_pushinteger(L, w);
+  lua_setfield(L, -2, "w");
+  lua_pushinteger(L, h);
+  lua_setfield(L, -2, "h");
+  lua_pushnumber(L, static_cast<lua_Number>(x) / atlas->pageWidth);
+  lua_setfield(L, -2, "u0");
+  lua_pushnumber(L, static_cast<lua_Number>(y) / atlas->pageHeight);
+  lua_setfield(L, -2, "v0");
+  lua_pushnumber(L, static_cast<lua_Number>(x + w) / atlas->pageWidth);
+  lua_setfield(L, -2, "u1");
+  lua_pushnumber(L, static_cast<lua_Number>(y + h) / atlas->pageHeight);
+  lua_setfield(L, -2, "v1");
+}
 
-    // swap rows
-    ::memcpy(temp, row1, pitch);
-    ::memcpy(row1, row2, pitch);
-    ::memcpy(row2, temp, pitch);
+int L_newAtlas(lua_State *L) {
+  auto pageWidth = static_cast<int>(luaL_checkinteger(L, 1));
+  auto pageHeight = static_cast<int>(luaL_checkinteger(L, 2));
+  luaL_argcheck(L, pageWidth > 0, 1, "width must be greater than 0");
+  luaL_argcheck(L, pageHeight > 0, 2, "height must be greater than 0");
+  auto padding = 2;
+  auto extrude = 1;
+  if (!lua_isnoneornil(L, 3)) {
+    luaL_checktype(L, 3, LUA_TTABLE);
+    lua_getfield(L, 3, "padding");
+    padding = static_cast<int>(luaL_optinteger(L, -1, padding));
+    lua_getfield(L, 3, "extrude");
+    extrude = static_cast<int>(luaL_optinteger(L, -1, extrude));
+    lua_pop(L, 2);
+    luaL_argcheck(L, padding >= 0 && extrude >= 0, 3,
+                  "padding and extrude must not be negative");
   }
 
-  delete[] temp;
+  auto pAtlas = static_cast<UDAtlas *>(lua_newuserdata(L, sizeof(UDAtlas)));
+  pAtlas->data = new Atlas{pageWidth, pageHeight, padding, extrude, {}, {}};
+  luaL_setmetatable(L, ATLAS_NAME);
+  return 1;
+}
 
+int L_Atlas___gc(lua_State *L) {
+  auto pAtlas = static_cast<UDAtlas *>(luaL_checkudata(L, 1, ATLAS_NAME));
+  delete pAtlas->data;
+  pAtlas->data = nullptr;
   return 0;
 }
 
+int L_Atlas_add(lua_State *L) {
+  auto atlas = checkAtlas(L, 1);
+  addToAtlas(L, atlas, checkSurface(L, 2), 2);
+  return 1;
+}
+
+// packs tallest first, which the skyline packer handles much better than
+// arrival order. results keep the order of the input array.
+int L_Atlas_addMany(lua_State *L) {
+  auto atlas = checkAtlas(L, 1);
+  luaL_checktype(L, 2, LUA_TTABLE);
+  const auto count = static_cast<int>(luaL_len(L, 2));
+  std::vector<std::pair<SDL_Surface *, int>> surfaces;
+  for (int i = 1; i <= count; ++i) {
+    lua_geti(L, 2, i);
+    auto pudSurface = hello::lua::sdl2_image::get(L, -1);
+    luaL_argcheck(L, pudSurface != nullptr && pudSurface->surface != nullptr,
+                  2, "surfaces must be an array of SDL_Surface");
+    surfaces.emplace_back(pudSurface->surface, i);
+    lua_pop(L, 1);
+  }
+  std::stable_sort(surfaces.begin(), surfaces.end(),
+                   [](const auto &a, const auto &b) {
+                     if (a.first->h != b.first->h) {
+                       return a.first->h > b.first->h;
+                     }
+                     return a.first->w > b.first->w;
+                   });
+
+  lua_createtable(L, count, 0);
+  for (auto &[surface, index] : surfaces) {
+    addToAtlas(L, atlas, surface, 2);
+    lua_rawseti(L, -2, index);
+  }
+  return 1;
+}
+
+// the page is shared with the atlas, which keeps drawing into it.
+int L_Atlas_getPage(lua_State *L) {
+  auto atlas = checkAtlas(L, 1);
+  auto index = luaL_checkinteger(L, 2);
+  luaL_argcheck(
+      L, index >= 1 && index <= static_cast<lua_Integer>(atlas->pages.size()),
+      2, "page out of range");
+  auto page = atlas->pages[index - 1];
+  ++page->refcount;
+  hello::lua::sdl2_image::push(L, page);
+  return 1;
+}
+
+int L_Atlas_getPageCount(lua_State *L) {
+  auto atlas = checkAtlas(L, 1);
+  lua_pushinteger(L, static_cast<lua_Integer>(atlas->pages.size()));
+  return 1;
+}
+
 int L_getInfoSurface(lua_State *L) {
   auto pudSurface =
       static_cast<UDSDL_Surface *>(luaL_checkudata(L, 1, SDL_SURFACE_NAME));
@@ -131,6 +1145,22 @@ int L_require(lua_State *L) {
   lua_setfield(L, -2, "load");
   lua_pushcfunction(L, L_loadFromString);
   lua_setfield(L, -2, "loadFromString");
+  lua_pushcfunction(L, L_loadFromStringInto);
+  lua_setfield(L, -2, "loadFromStringInto");
+  lua_pushcfunction(L, L_loadAsync);
+  lua_setfield(L, -2, "loadAsync");
+  lua_pushcfunction(L, L_loadMany);
+  lua_setfield(L, -2, "loadMany");
+  lua_pushcfunction(L, L_newAtlas);
+  lua_setfield(L, -2, "newAtlas");
+  lua_pushcfunction(L, L_loadCached);
+  lua_setfield(L, -2, "loadCached");
+  lua_pushcfunction(L, L_newCache);
+  lua_setfield(L, -2, "newCache");
+  lua_pushcfunction(L, L_probe);
+  lua_setfield(L, -2, "probe");
+  lua_pushcfunction(L, L_loadLazy);
+  lua_setfield(L, -2, "loadLazy");
   return 1;
 }
 } // namespace
@@ -139,9 +1169,25 @@ namespace hello::lua::sdl2_image {
 UDSDL_Surface *get(lua_State *L, int idx) {
   auto pudSurface =
       static_cast<UDSDL_Surface *>(luaL_testudata(L, idx, SDL_SURFACE_NAME));
+  if (pudSurface != nullptr && pudSurface->surface != nullptr &&
+      pudSurface->lazy) {
+    decodeLazy(L, idx, pudSurface);
+  }
   return pudSurface;
 }
 
+void push(lua_State *L, SDL_Surface *surface) {
+  if (surface != nullptr) {
+    auto pudSurface =
+        static_cast<UDSDL_Surface *>(lua_newuserdata(L, sizeof(UDSDL_Surface)));
+    pudSurface->surface = surface;
+    pudSurface->lazy = false;
+    luaL_setmetatable(L, SDL_SURFACE_NAME);
+  } else {
+    lua_pushnil(L);
+  }
+}
+
 void openlibs(lua_State *L) {
   luaL_newmetatable(L, SDL_SURFACE_NAME);
   lua_pushcfunction(L, L_freeSurface);
@@ -151,15 +1197,89 @@ void openlibs(lua_State *L) {
   lua_setfield(L, -2, "free");
   lua_pushcfunction(L, L_getInfoSurface);
   lua_setfield(L, -2, "getInfo");
+  lua_pushcfunction(L, L_isLoaded);
+  lua_setfield(L, -2, "isLoaded");
   lua_pushcfunction(L, L_lockSurface);
   lua_setfield(L, -2, "lock");
   lua_pushcfunction(L, L_unlockSurface);
   lua_setfield(L, -2, "unlock");
+  lua_pushcfunction(L, L_view);
+  lua_setfield(L, -2, "view");
   lua_pushcfunction(L, L_flipVertical);
   lua_setfield(L, -2, "flipVertical");
+  lua_pushcfunction(L, L_flipHorizontal);
+  lua_setfield(L, -2, "flipHorizontal");
+  lua_pushcfunction(L, L_swizzle);
+  lua_setfield(L, -2, "swizzle");
+  lua_pushcfunction(L, L_premultiplyAlpha);
+  lua_setfield(L, -2, "premultiplyAlpha");
+  lua_pushcfunction(L, L_srgbToLinear);
+  lua_setfield(L, -2, "srgbToLinear");
+  lua_pushcfunction(L, L_toGLFormat);
+  lua_setfield(L, -2, "toGLFormat");
+  lua_pushcfunction(L, L_generateMipmaps);
+  lua_setfield(L, -2, "generateMipmaps");
+  lua_pushcfunction(L, L_compress);
+  lua_setfield(L, -2, "compress");
+  lua_pushcfunction(L, L_saveQOI);
+  lua_setfield(L, -2, "saveQOI");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, LOAD_BATCH_NAME);
+  lua_pushcfunction(L, L_LoadBatch___gc);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_LoadBatch_next);
+  lua_setfield(L, -2, "next");
+  lua_pushcfunction(L, L_LoadBatch_poll);
+  lua_setfield(L, -2, "poll");
+  lua_pushcfunction(L, L_LoadBatch_getRemaining);
+  lua_setfield(L, -2, "getRemaining");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, LOAD_FUTURE_NAME);
+  lua_pushcfunction(L, L_LoadBatch___gc);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_LoadFuture_isReady);
+  lua_setfield(L, -2, "isReady");
+  lua_pushcfunction(L, L_LoadFuture_wait);
+  lua_setfield(L, -2, "wait");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, ATLAS_NAME);
+  lua_pushcfunction(L, L_Atlas___gc);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_Atlas_add);
+  lua_setfield(L, -2, "add");
+  lua_pushcfunction(L, L_Atlas_addMany);
+  lua_setfield(L, -2, "addMany");
+  lua_pushcfunction(L, L_Atlas_getPage);
+  lua_setfield(L, -2, "getPage");
+  lua_pushcfunction(L, L_Atlas_getPageCount);
+  lua_setfield(L, -2, "getPageCount");
+  lua_setfield(L, -2, "__index");
+
+  luaL_newmetatable(L, MAPPED_FILE_NAME);
+  lua_pushcfunction(L, L_MappedFile___gc);
+  lua_setfield(L, -2, "__gc");
+
+  luaL_newmetatable(L, CACHE_NAME);
+  lua_pushcfunction(L, L_Cache___gc);
+  lua_setfield(L, -2, "__gc");
+  lua_newtable(L);
+  lua_pushcfunction(L, L_Cache_load);
+  lua_setfield(L, -2, "load");
+  lua_pushcfunction(L, L_Cache_setBudget);
+  lua_setfield(L, -2, "setBudget");
+  lua_pushcfunction(L, L_Cache_clear);
+  lua_setfield(L, -2, "clear");
+  lua_pushcfunction(L, L_Cache_getStats);
+  lua_setfield(L, -2, "getStats");
   lua_setfield(L, -2, "__index");
 
   luaL_requiref(L, "sdl2_image", L_require, false);
-  lua_pop(L, 2);
+  lua_pop(L, 7);
 }
 } // namespace hello::lua::sdl2_image
\ No newline at end of file
@@ -10,9 +10,13 @@
 namespace hello::lua::sdl2_image {
 struct UDSDL_Surface {
   SDL_Surface *surface;
+  // `surface` is a placeholder without pixels until the first get() or
+  // pixel access decodes the file (see sdl2_image.loadLazy)
+  bool lazy;
 };
 
 void openlibs(lua_State *L);
 UDSDL_Surface *get(lua_State *L, int idx);
+void push(lua_State *L, SDL_Surface *surface);
 } // namespace hello::lua::sdl2_image
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "./mapped_file.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__EMSCRIPTEN__)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hello {
+std::unique_ptr<MappedFile> MappedFile::open(const std::string &path) {
+  std::unique_ptr<MappedFile> file(new MappedFile());
+#if defined(_WIN32)
+  auto handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+    CloseHandle(handle);
+    return nullptr;
+  }
+  file->mapping =
+      CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (file->mapping == nullptr) {
+    return nullptr;
+  }
+  file->data = static_cast<uint8_t *>(
+      MapViewOfFile(file->mapping, FILE_MAP_COPY, 0, 0, 0));
+  if (file->data == nullptr) {
+    return nullptr;
+  }
+  file->size = static_cast<size_t>(size.QuadPart);
+#elif defined(__EMSCRIPTEN__)
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  if (!stream) {
+    return nullptr;
+  }
+  const auto size = static_cast<size_t>(stream.tellg());
+  if (size == 0) {
+    return nullptr;
+  }
+  file->data = new uint8_t[size];
+  file->size = size;
+  stream.seekg(0);
+  if (!stream.read(reinterpret_cast<char *>(file->data),
+                   static_cast<std::streamsize>(size))) {
+    return nullptr;
+  }
+#else
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  const auto size = static_cast<size_t>(st.st_size);
+  auto data =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  file->data = static_cast<uint8_t *>(data);
+  file->size = size;
+#endif
+  return file;
+}
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+  if (data != nullptr) {
+    UnmapViewOfFile(data);
+  }
+  if (mapping != nullptr) {
+    CloseHandle(mapping);
+  }
+#elif defined(__EMSCRIPTEN__)
+  delete[] data;
+#else
+  if (data != nullptr) {
+    ::munmap(data, size);
+  }
+#endif
+}
+} // namespace hello
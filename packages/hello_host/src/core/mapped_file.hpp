@@ -0,0 +1,32 @@
+#ifndef __MAPPED_FILE_HPP__
+#define __MAPPED_FILE_HPP__
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace hello {
+// private copy-on-write view of a whole file, so writes through getData()
+// never reach the disk. builds without mmap read the file into memory.
+class MappedFile {
+public:
+  static std::unique_ptr<MappedFile> open(const std::string &path);
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  uint8_t *getData() const { return data; }
+  size_t getSize() const { return size; }
+
+private:
+  MappedFile() = default;
+
+  uint8_t *data = nullptr;
+  size_t size = 0;
+#if defined(_WIN32)
+  void *mapping = nullptr;
+#endif
+};
+} // namespace hello
+#endif
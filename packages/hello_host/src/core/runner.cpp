@@ -5,6 +5,7 @@
 #include "lua/sdl2/lua_sdl2.hpp"
 #include "lua/sdl2_image/lua_sdl2_image.hpp"
 #include "lua/spv_cross/lua_spv_cross.hpp"
+#include <cstring>
 #include <iostream>
 
 #if defined(__EMSCRIPTEN__)
@@ -41,17 +42,35 @@ void handleEvents(void *arg) {
   }
 #endif
   lua::utils::report(L, lua::utils::docall(L, 0, LUA_MULTRET));
+  lua::sdl2::renderWindows(L);
 }
 } // namespace
 
 namespace hello::runner {
 int run(int argc, char **argv) {
-  if (argc < 2) {
-    printf("usage: %s filename\n", argv[0]);
+  auto argi = 1;
+  auto headless = false;
+  if (argi < argc && strcmp(argv[argi], "--headless") == 0) {
+    headless = true;
+    ++argi;
+  }
+
+  if (argi >= argc) {
+    printf("usage: %s [--headless] filename\n", argv[0]);
     return -1;
   }
 
-  const auto file = argv[1];
+#if !defined(__EMSCRIPTEN__)
+  // render through SDL's EGL-backed offscreen driver (pbuffer surfaces),
+  // so scripts run on hosts without a display or GPU (e.g. Mesa llvmpipe).
+  if (headless) {
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+  }
+#else
+  (void)headless;
+#endif
+
+  const auto file = argv[argi];
   auto L = luaL_newstate();
   initialize(L);
   lua::utils::report(
@@ -0,0 +1,156 @@
+#include "./thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define HELLO_NO_THREADS
+#endif
+
+namespace {
+#if !defined(HELLO_NO_THREADS)
+class Pool {
+public:
+  Pool() {
+    auto count = std::max(1u, std::thread::hardware_concurrency());
+    for (auto i = 0u; i < count; ++i) {
+      workers.emplace_back([this] { run(); });
+    }
+  }
+
+  ~Pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    cv.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  int size() const { return static_cast<int>(workers.size()); }
+
+  void push(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::function<void()>> tasks;
+  std::vector<std::thread> workers;
+  bool stopping = false;
+
+  void run() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (tasks.empty()) {
+          return;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+};
+
+Pool &getPool() {
+  static Pool pool;
+  return pool;
+}
+
+struct ParallelForState {
+  std::atomic<int> next;
+  int end;
+  int chunk;
+  std::mutex mutex;
+  std::condition_variable cv;
+  int done = 0;
+  const std::function<void(int)> *fn;
+
+  // claims chunks until the range is exhausted
+  void work() {
+    for (;;) {
+      const auto first = next.fetch_add(chunk);
+      if (first >= end) {
+        return;
+      }
+      const auto last = std::min(first + chunk, end);
+      for (auto i = first; i < last; ++i) {
+        (*fn)(i);
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      done += last - first;
+      if (done == end) {
+        cv.notify_all();
+      }
+    }
+  }
+};
+#endif
+} // namespace
+
+namespace hello::thread_pool {
+#if defined(HELLO_NO_THREADS)
+int getWorkerCount() { return 0; }
+
+void submit(std::function<void()> task) { task(); }
+
+void parallelFor(int begin, int end, const std::function<void(int)> &fn) {
+  for (auto i = begin; i < end; ++i) {
+    fn(i);
+  }
+}
+#else
+int getWorkerCount() { return getPool().size(); }
+
+void submit(std::function<void()> task) { getPool().push(std::move(task)); }
+
+void parallelFor(int begin, int end, const std::function<void(int)> &fn) {
+  const auto count = end - begin;
+  if (count <= 0) {
+    return;
+  }
+  if (count == 1) {
+    fn(begin);
+    return;
+  }
+
+  // a few chunks per worker keeps the tail short when items vary in cost
+  const auto helpers = std::min(getWorkerCount(), count - 1);
+  auto state = std::make_shared<ParallelForState>();
+  state->next = 0;
+  state->end = count;
+  state->chunk = std::max(1, count / ((helpers + 1) * 4));
+  const std::function<void(int)> shifted = [&fn, begin](int i) {
+    fn(begin + i);
+  };
+  state->fn = &shifted;
+
+  // helpers that start after the range is drained return without touching
+  // fn, so the shared state only has to outlive them, not the call
+  for (auto i = 0; i < helpers; ++i) {
+    submit([state] { state->work(); });
+  }
+  state->work();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cv.wait(lock, [&state] { return state->done == state->end; });
+}
+#endif
+} // namespace hello::thread_pool
@@ -0,0 +1,15 @@
+#ifndef __THREAD_POOL_HPP__
+#define __THREAD_POOL_HPP__
+#include <functional>
+
+namespace hello::thread_pool {
+// process-wide worker pool sized to the hardware. builds without thread
+// support (Emscripten without pthreads) run every task inline.
+int getWorkerCount();
+void submit(std::function<void()> task);
+
+// runs fn(i) for every i in [begin, end) across the workers and the calling
+// thread, returning once all of them have finished.
+void parallelFor(int begin, int end, const std::function<void(int)> &fn);
+} // namespace hello::thread_pool
+#endif
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "../core/gl/draw_list.hpp"
+
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+#include <vector>
+
+using namespace hello::gl;
+
+namespace {
+struct DrawCall {
+  GLsizei count;
+  uintptr_t offset;
+};
+
+std::vector<DrawCall> calls;
+
+const float IDENTITY[16] = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+                            0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+class GLDrawList_Test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    saved = glad_glDrawElements;
+    calls.clear();
+    glad_glDrawElements = [](GLenum, GLsizei count, GLenum,
+                             const void *indices) {
+      calls.push_back({count, reinterpret_cast<uintptr_t>(indices)});
+    };
+  }
+
+  void TearDown() override { glad_glDrawElements = saved; }
+
+  PFNGLDRAWELEMENTSPROC saved;
+};
+} // namespace
+
+TEST_F(GLDrawList_Test, PacksIndirectCommands) {
+  ASSERT_EQ(sizeof(DrawElementsCommand), 20u);
+  DrawList list;
+  ASSERT_EQ(list.add({6, 1, 0, 0, 0}), 0u);
+  ASSERT_EQ(list.add({3, 2, 6, 4, 0}), 1u);
+  ASSERT_EQ(list.getDrawCount(), 0u);
+
+  ASSERT_EQ(list.build(nullptr), 2u);
+  ASSERT_EQ(list.getByteSize(), 40u);
+  ASSERT_EQ(list.getData()[1].firstIndex, 6u);
+  ASSERT_EQ(list.getData()[1].baseVertex, 4);
+
+  list.clear();
+  ASSERT_EQ(list.getCount(), 0u);
+  ASSERT_EQ(list.build(nullptr), 0u);
+}
+
+TEST_F(GLDrawList_Test, CullsSpheresOutsideTheFrustum) {
+  DrawList list;
+  const float inside[3] = {0.0f, 0.0f, 0.0f};
+  const float outside[3] = {3.0f, 0.0f, 0.0f};
+  const float straddling[3] = {1.4f, 0.0f, 0.0f};
+  list.setBounds(list.add({1, 1, 0, 0, 0}), inside, 0.1f);
+  list.setBounds(list.add({2, 1, 0, 0, 0}), outside, 0.5f);
+  list.setBounds(list.add({3, 1, 0, 0, 0}), straddling, 0.5f);
+  list.add({4, 1, 0, 0, 0});
+
+  ASSERT_EQ(list.build(IDENTITY), 3u);
+  ASSERT_EQ(list.getData()[0].count, 1u);
+  ASSERT_EQ(list.getData()[1].count, 3u);
+  ASSERT_EQ(list.getData()[2].count, 4u);
+}
+
+TEST_F(GLDrawList_Test, MergesContinuedRanges) {
+  DrawList list;
+  list.add({6, 1, 0, 0, 0});
+  list.add({6, 1, 6, 0, 0});
+  list.add({3, 1, 20, 0, 0});
+  list.add({0, 1, 23, 0, 0});
+  list.build(nullptr);
+
+  ASSERT_EQ(list.draw(GL_TRIANGLES, GL_UNSIGNED_SHORT), DrawResult::Drawn);
+  ASSERT_EQ(calls.size(), 2u);
+  ASSERT_EQ(calls[0].count, 12);
+  ASSERT_EQ(calls[0].offset, 0u);
+  ASSERT_EQ(calls[1].count, 3);
+  ASSERT_EQ(calls[1].offset, 40u);
+}
+
+TEST_F(GLDrawList_Test, KeepsStripsAndPartialPrimitivesApart) {
+  DrawList list;
+  list.add({4, 1, 0, 0, 0});
+  list.add({4, 1, 4, 0, 0});
+  list.build(nullptr);
+
+  // one strip over both ranges would add triangles between them
+  ASSERT_EQ(list.draw(GL_TRIANGLE_STRIP, GL_UNSIGNED_SHORT),
+            DrawResult::Drawn);
+  ASSERT_EQ(calls.size(), 2u);
+  ASSERT_EQ(calls[1].count, 4);
+  ASSERT_EQ(calls[1].offset, 8u);
+
+  // 4 indices leave one over, which would start the next draw's triangle
+  calls.clear();
+  ASSERT_EQ(list.draw(GL_TRIANGLES, GL_UNSIGNED_SHORT), DrawResult::Drawn);
+  ASSERT_EQ(calls.size(), 2u);
+
+  // but they are two whole lines each
+  calls.clear();
+  ASSERT_EQ(list.draw(GL_LINES, GL_UNSIGNED_SHORT), DrawResult::Drawn);
+  ASSERT_EQ(calls.size(), 1u);
+  ASSERT_EQ(calls[0].count, 8);
+}
+
+TEST_F(GLDrawList_Test, RefusesDrawsItCannotIssue) {
+  DrawList list;
+  list.add({6, 1, 0, 0, 0});
+  list.add({6, 1, 6, 0, 1});
+  list.build(nullptr);
+
+  // an instance offset needs the indirect buffer
+  ASSERT_EQ(list.draw(GL_TRIANGLES, GL_UNSIGNED_SHORT),
+            DrawResult::NeedsBaseInstance);
+  ASSERT_EQ(list.draw(GL_TRIANGLES, GL_FLOAT), DrawResult::BadIndexType);
+  ASSERT_TRUE(calls.empty());
+}
+#endif
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "../core/gl/extensions.hpp"
+#include "../core/gl/gpu_timer.hpp"
+
+#ifndef __EMSCRIPTEN__
+#include <cstring>
+#include <glad/glad.h>
+
+using namespace hello::gl;
+
+namespace {
+// a GL 4.6 driver whose queries finish when `ready` says so, each taking
+// 2 ms, stubbed in via the glad pointers and a fake loader
+GLint version = 0;
+bool ready = false;
+GLuint nextQuery = 1;
+GLuint deleted = 0;
+
+void *getProcAddress(const char *name) {
+  if (::strcmp(name, "glQueryCounter") == 0) {
+    return reinterpret_cast<void *>(+[](GLuint, GLenum) {});
+  }
+  if (::strcmp(name, "glGetQueryObjectui64v") == 0) {
+    return reinterpret_cast<void *>(
+        +[](GLuint, GLenum, GLuint64 *params) { *params = 2000000; });
+  }
+  return nullptr;
+}
+
+class GLGpuTimer_Test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    saved = {glad_glGetIntegerv, glad_glGenQueries,   glad_glDeleteQueries,
+             glad_glBeginQuery,  glad_glEndQuery,     glad_glGetQueryObjectuiv};
+    ready = false;
+    nextQuery = 1;
+    deleted = 0;
+    glad_glGetIntegerv = [](GLenum pname, GLint *data) {
+      *data = pname == GL_MAJOR_VERSION ? version : 0;
+    };
+    glad_glGenQueries = [](GLsizei, GLuint *ids) { ids[0] = nextQuery++; };
+    glad_glDeleteQueries = [](GLsizei n, const GLuint *) {
+      deleted += static_cast<GLuint>(n);
+    };
+    glad_glBeginQuery = [](GLenum, GLuint) {};
+    glad_glEndQuery = [](GLenum) {};
+    glad_glGetQueryObjectuiv = [](GLuint, GLenum, GLuint *params) {
+      *params = ready ? 1 : 0;
+    };
+    version = 4;
+    loadExtensions(getProcAddress);
+  }
+
+  void TearDown() override {
+    // forget the fake entry points again
+    version = 0;
+    loadExtensions(getProcAddress);
+    glad_glGetIntegerv = saved.getIntegerv;
+    glad_glGenQueries = saved.genQueries;
+    glad_glDeleteQueries = saved.deleteQueries;
+    glad_glBeginQuery = saved.beginQuery;
+    glad_glEndQuery = saved.endQuery;
+    glad_glGetQueryObjectuiv = saved.getQueryObjectuiv;
+  }
+
+  struct {
+    PFNGLGETINTEGERVPROC getIntegerv;
+    PFNGLGENQUERIESPROC genQueries;
+    PFNGLDELETEQUERIESPROC deleteQueries;
+    PFNGLBEGINQUERYPROC beginQuery;
+    PFNGLENDQUERYPROC endQuery;
+    PFNGLGETQUERYOBJECTUIVPROC getQueryObjectuiv;
+  } saved;
+};
+} // namespace
+
+TEST_F(GLGpuTimer_Test, ReadsFinishedQueriesOnly) {
+  ASSERT_TRUE(getExtensions().timerQuery);
+  {
+    GpuTimer timer(3, 4);
+    EXPECT_TRUE(timer.beginPass("scene"));
+    EXPECT_FALSE(timer.beginPass("nested"));
+    timer.endPass();
+    EXPECT_TRUE(timer.beginPass("present"));
+    timer.endPass();
+
+    // nothing is ready, so nothing is read and nothing waits
+    timer.collect();
+    EXPECT_EQ(timer.getPendingCount(), 2u);
+    EXPECT_EQ(timer.getTimes()[0].samples, 0u);
+
+    EXPECT_TRUE(timer.beginPass("scene"));
+    timer.endPass();
+    // a full pool skips the pass instead of stalling
+    EXPECT_FALSE(timer.beginPass("scene"));
+
+    ready = true;
+    timer.collect();
+    EXPECT_EQ(timer.getPendingCount(), 0u);
+    const auto times = timer.getTimes();
+    ASSERT_EQ(times.size(), 2u);
+    EXPECT_EQ(times[0].name, "scene");
+    EXPECT_EQ(times[0].samples, 2u);
+    EXPECT_DOUBLE_EQ(times[0].average, 2.0);
+    EXPECT_EQ(times[1].name, "present");
+    EXPECT_DOUBLE_EQ(times[1].last, 2.0);
+
+    // finished queries are reused
+    EXPECT_TRUE(timer.beginPass("scene"));
+    timer.endPass();
+    EXPECT_EQ(nextQuery, 4u);
+  }
+  EXPECT_EQ(deleted, 3u);
+}
+
+TEST_F(GLGpuTimer_Test, NeedsTimerQueries) {
+  version = 3;
+  loadExtensions(getProcAddress);
+  ASSERT_FALSE(getExtensions().timerQuery);
+  GpuTimer timer;
+  EXPECT_FALSE(timer.beginPass("scene"));
+}
+#endif
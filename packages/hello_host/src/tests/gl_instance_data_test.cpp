@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include "../core/gl/instance_data.hpp"
+
+#include <cmath>
+
+using namespace hello::gl;
+
+TEST(GLInstanceData_Test, PacksInstances) {
+  InstanceData instances(4);
+  EXPECT_EQ(instances.getStride(), 16u);
+  EXPECT_EQ(instances.add(), 0u);
+  EXPECT_EQ(instances.add(), 1u);
+  const float color[] = {0.25f, 0.5f};
+  instances.set(1, 2, color, 2);
+  EXPECT_EQ(instances.getCount(), 2u);
+  EXPECT_EQ(instances.getByteSize(), 32u);
+
+  const auto data = instances.getData();
+  for (size_t i = 0; i < 6; ++i) {
+    EXPECT_EQ(data[i], 0.0f);
+  }
+  EXPECT_EQ(data[6], 0.25f);
+  EXPECT_EQ(data[7], 0.5f);
+
+  instances.resize(5);
+  EXPECT_EQ(instances.getCount(), 5u);
+  EXPECT_EQ(instances.getData()[19], 0.0f);
+  instances.clear();
+  EXPECT_EQ(instances.getCount(), 0u);
+}
+
+TEST(GLInstanceData_Test, WritesTransforms) {
+  InstanceData instances(20);
+  instances.add();
+  // 90 degrees around z, then scaled by (2, 3, 4) and moved to (5, 6, 7)
+  const float half = std::sqrt(0.5f);
+  const float translation[] = {5.0f, 6.0f, 7.0f};
+  const float rotation[] = {0.0f, 0.0f, half, half};
+  const float scale[] = {2.0f, 3.0f, 4.0f};
+  instances.setTransform(0, 4, translation, rotation, scale);
+
+  const float expected[] = {0, 2, 0, 0, -3, 0, 0, 0,
+                            0, 0, 4, 0, 5,  6, 7, 1};
+  const auto m = instances.getData() + 4;
+  for (size_t i = 0; i < 16; ++i) {
+    EXPECT_NEAR(m[i], expected[i], 1e-6f) << i;
+  }
+  EXPECT_EQ(instances.getData()[3], 0.0f);
+}
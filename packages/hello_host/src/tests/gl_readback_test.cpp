@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include "../core/gl/extensions.hpp"
+#include "../core/gl/readback.hpp"
+#include "../core/gl/state_cache.hpp"
+
+#ifndef __EMSCRIPTEN__
+#include <cstring>
+#include <glad/glad.h>
+
+#include <vector>
+
+using namespace hello::gl;
+
+namespace {
+// a GL 4.6 driver whose fences signal when `signaled` says so and fail to
+// be waited for when `failed` does, stubbed in
+// via the glad pointers and a fake loader. mapping a pack buffer yields
+// its name in every byte.
+GLint version = 0;
+bool signaled = false;
+bool failed = false;
+GLuint nextBuffer = 1;
+GLuint packBuffer = 0;
+GLuint syncs = 0;
+uint8_t mapped[16];
+
+void *getProcAddress(const char *name) {
+  if (::strcmp(name, "glFenceSync") == 0) {
+    return reinterpret_cast<void *>(+[](GLenum, GLbitfield) {
+      ++syncs;
+      return reinterpret_cast<GLsync>(static_cast<uintptr_t>(syncs));
+    });
+  }
+  if (::strcmp(name, "glClientWaitSync") == 0) {
+    return reinterpret_cast<void *>(+[](GLsync, GLbitfield, GLuint64) {
+      if (failed) {
+        return static_cast<GLenum>(GL_WAIT_FAILED);
+      }
+      return static_cast<GLenum>(signaled ? GL_ALREADY_SIGNALED
+                                          : GL_TIMEOUT_EXPIRED);
+    });
+  }
+  if (::strcmp(name, "glDeleteSync") == 0) {
+    return reinterpret_cast<void *>(+[](GLsync) { --syncs; });
+  }
+  return nullptr;
+}
+
+class GLReadback_Test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    saved = {glad_glGetIntegerv,    glad_glGenBuffers, glad_glDeleteBuffers,
+             glad_glBindBuffer,     glad_glBufferData, glad_glReadPixels,
+             glad_glMapBufferRange, glad_glUnmapBuffer};
+    signaled = false;
+    failed = false;
+    nextBuffer = 1;
+    packBuffer = 0;
+    syncs = 0;
+    glad_glGetIntegerv = [](GLenum pname, GLint *data) {
+      *data = pname == GL_MAJOR_VERSION ? version : 0;
+    };
+    glad_glGenBuffers = [](GLsizei, GLuint *buffers) {
+      buffers[0] = nextBuffer++;
+    };
+    glad_glDeleteBuffers = [](GLsizei, const GLuint *) {};
+    glad_glBindBuffer = [](GLenum target, GLuint buffer) {
+      if (target == GL_PIXEL_PACK_BUFFER) {
+        packBuffer = buffer;
+      }
+    };
+    glad_glBufferData = [](GLenum, GLsizeiptr, const void *, GLenum) {};
+    glad_glReadPixels = [](GLint, GLint, GLsizei, GLsizei, GLenum, GLenum,
+                           void *) {};
+    glad_glMapBufferRange = [](GLenum, GLintptr, GLsizeiptr,
+                               GLbitfield) -> void * {
+      ::memset(mapped, static_cast<int>(packBuffer), sizeof(mapped));
+      return mapped;
+    };
+    glad_glUnmapBuffer = [](GLenum) -> GLboolean { return GL_TRUE; };
+  }
+
+  void TearDown() override {
+    // forget the fake entry points again
+    version = 0;
+    loadExtensions(getProcAddress);
+    glad_glGetIntegerv = saved.getIntegerv;
+    glad_glGenBuffers = saved.genBuffers;
+    glad_glDeleteBuffers = saved.deleteBuffers;
+    glad_glBindBuffer = saved.bindBuffer;
+    glad_glBufferData = saved.bufferData;
+    glad_glReadPixels = saved.readPixels;
+    glad_glMapBufferRange = saved.mapBufferRange;
+    glad_glUnmapBuffer = saved.unmapBuffer;
+  }
+
+  struct {
+    PFNGLGETINTEGERVPROC getIntegerv;
+    PFNGLGENBUFFERSPROC genBuffers;
+    PFNGLDELETEBUFFERSPROC deleteBuffers;
+    PFNGLBINDBUFFERPROC bindBuffer;
+    PFNGLBUFFERDATAPROC bufferData;
+    PFNGLREADPIXELSPROC readPixels;
+    PFNGLMAPBUFFERRANGEPROC mapBufferRange;
+    PFNGLUNMAPBUFFERPROC unmapBuffer;
+  } saved;
+};
+} // namespace
+
+TEST_F(GLReadback_Test, DeliversSignaledReadbacksInOrder) {
+  version = 4;
+  loadExtensions(getProcAddress);
+  ASSERT_TRUE(getExtensions().sync);
+
+  StateCache cache;
+  std::vector<uint64_t> ids;
+  std::vector<uint8_t> firstBytes;
+  auto deliver = [&](const ReadbackInfo &info, const uint8_t *pixels) {
+    ids.push_back(info.id);
+    firstBytes.push_back(pixels[0]);
+  };
+  {
+    ReadbackRing ring(2);
+    ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache),
+              1u);
+    ASSERT_EQ(packBuffer, 0u);
+    ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache),
+              2u);
+    // both buffers are in flight
+    ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache),
+              0u);
+    ASSERT_EQ(ring.getPendingCount(), 2u);
+
+    ASSERT_EQ(ring.collect(cache, deliver), 0u);
+    signaled = true;
+    ASSERT_EQ(ring.collect(cache, deliver), 2u);
+    ASSERT_EQ(ids, (std::vector<uint64_t>{1, 2}));
+    ASSERT_EQ(firstBytes, (std::vector<uint8_t>{1, 2}));
+    ASSERT_EQ(packBuffer, 0u);
+    ASSERT_EQ(syncs, 0u);
+
+    // the ring goes round without new buffers
+    ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache),
+              3u);
+    ASSERT_EQ(nextBuffer, 3u);
+  }
+  // fences still pending are deleted with the ring
+  ASSERT_EQ(syncs, 0u);
+}
+
+TEST_F(GLReadback_Test, DropsReadbacksWhenWaitingFails) {
+  version = 4;
+  loadExtensions(getProcAddress);
+
+  StateCache cache;
+  ReadbackRing ring(2);
+  ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache), 1u);
+  ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache), 2u);
+  failed = true;
+  size_t delivered = 0;
+  ASSERT_EQ(ring.collect(cache,
+                         [&](const ReadbackInfo &, const uint8_t *) {
+                           ++delivered;
+                         }),
+            0u);
+  ASSERT_EQ(delivered, 0u);
+  ASSERT_TRUE(ring.isLost());
+  ASSERT_EQ(ring.getPendingCount(), 0u);
+  ASSERT_EQ(syncs, 0u);
+
+  // the free buffers are refused rather than read into again
+  ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache), 0u);
+}
+
+TEST_F(GLReadback_Test, CollectsWithoutSyncObjects) {
+  version = 0;
+  loadExtensions(getProcAddress);
+  ASSERT_FALSE(getExtensions().sync);
+
+  StateCache cache;
+  ReadbackRing ring(1);
+  ASSERT_EQ(ring.read(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, cache), 1u);
+  size_t delivered = 0;
+  size_t rowStride = 0;
+  ASSERT_EQ(ring.collect(cache,
+                         [&](const ReadbackInfo &info, const uint8_t *) {
+                           delivered += info.size;
+                           rowStride = info.rowStride;
+                         }),
+            1u);
+  ASSERT_EQ(delivered, 16u);
+  ASSERT_EQ(rowStride, 8u);
+  ASSERT_EQ(ring.getPendingCount(), 0u);
+}
+#endif
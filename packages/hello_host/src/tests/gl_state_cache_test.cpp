@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include "../core/gl/command_list.hpp"
+#include "../core/gl/extensions.hpp"
+#include "../core/gl/state_cache.hpp"
+
+#ifndef __EMSCRIPTEN__
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+using namespace hello::gl;
+
+namespace {
+// driver calls the cache let through, stubbed in via the glad pointers
+std::vector<std::string> calls;
+
+class GLStateCache_Test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    calls.clear();
+    saved = {glad_glBindBuffer,      glad_glBindVertexArray,
+             glad_glUseProgram,      glad_glBindFramebuffer,
+             glad_glActiveTexture,   glad_glBindTexture,
+             glad_glClearColor,      glad_glViewport,
+             glad_glClear,           glad_glDrawArrays,
+             glad_glBindBufferBase,  glad_glBindBufferRange};
+    glad_glBindBuffer = [](GLenum, GLuint) { calls.push_back("buffer"); };
+    glad_glBindVertexArray = [](GLuint) { calls.push_back("vao"); };
+    glad_glUseProgram = [](GLuint) { calls.push_back("program"); };
+    glad_glBindFramebuffer = [](GLenum, GLuint) { calls.push_back("fbo"); };
+    glad_glActiveTexture = [](GLenum) { calls.push_back("unit"); };
+    glad_glBindTexture = [](GLenum, GLuint) { calls.push_back("texture"); };
+    glad_glClearColor = [](GLfloat, GLfloat, GLfloat, GLfloat) {
+      calls.push_back("clearColor");
+    };
+    glad_glViewport = [](GLint, GLint, GLsizei, GLsizei) {
+      calls.push_back("viewport");
+    };
+    glad_glClear = [](GLbitfield) { calls.push_back("clear"); };
+    glad_glDrawArrays = [](GLenum, GLint, GLsizei) {
+      calls.push_back("draw");
+    };
+    glad_glBindBufferBase = [](GLenum, GLuint, GLuint) {
+      calls.push_back("base");
+    };
+    glad_glBindBufferRange = [](GLenum, GLuint, GLuint, GLintptr,
+                                GLsizeiptr) { calls.push_back("range"); };
+  }
+
+  void TearDown() override {
+    glad_glBindBuffer = saved.bindBuffer;
+    glad_glBindVertexArray = saved.bindVertexArray;
+    glad_glUseProgram = saved.useProgram;
+    glad_glBindFramebuffer = saved.bindFramebuffer;
+    glad_glActiveTexture = saved.activeTexture;
+    glad_glBindTexture = saved.bindTexture;
+    glad_glClearColor = saved.clearColor;
+    glad_glViewport = saved.viewport;
+    glad_glClear = saved.clear;
+    glad_glDrawArrays = saved.drawArrays;
+    glad_glBindBufferBase = saved.bindBufferBase;
+    glad_glBindBufferRange = saved.bindBufferRange;
+  }
+
+  struct {
+    PFNGLBINDBUFFERPROC bindBuffer;
+    PFNGLBINDVERTEXARRAYPROC bindVertexArray;
+    PFNGLUSEPROGRAMPROC useProgram;
+    PFNGLBINDFRAMEBUFFERPROC bindFramebuffer;
+    PFNGLACTIVETEXTUREPROC activeTexture;
+    PFNGLBINDTEXTUREPROC bindTexture;
+    PFNGLCLEARCOLORPROC clearColor;
+    PFNGLVIEWPORTPROC viewport;
+    PFNGLCLEARPROC clear;
+    PFNGLDRAWARRAYSPROC drawArrays;
+    PFNGLBINDBUFFERBASEPROC bindBufferBase;
+    PFNGLBINDBUFFERRANGEPROC bindBufferRange;
+  } saved;
+};
+} // namespace
+
+TEST_F(GLStateCache_Test, FiltersRedundantCalls) {
+  StateCache cache;
+  cache.useProgram(3);
+  cache.useProgram(3);
+  cache.bindBuffer(GL_ARRAY_BUFFER, 5);
+  cache.bindBuffer(GL_ARRAY_BUFFER, 5);
+  cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 6);
+  cache.clearColor(0.5f, 0.5f, 0.5f, 1.0f);
+  cache.clearColor(0.5f, 0.5f, 0.5f, 1.0f);
+  cache.viewport(0, 0, 64, 64);
+  cache.viewport(0, 0, 64, 32);
+  EXPECT_EQ(calls, (std::vector<std::string>{"program", "buffer", "buffer",
+                                             "clearColor", "viewport",
+                                             "viewport"}));
+  EXPECT_EQ(cache.getStats().forwarded, 6u);
+  EXPECT_EQ(cache.getStats().filtered, 3u);
+
+  cache.resetStats();
+  EXPECT_EQ(cache.getStats().forwarded, 0u);
+  EXPECT_EQ(cache.getStats().filtered, 0u);
+}
+
+TEST_F(GLStateCache_Test, TracksTexturesPerUnit) {
+  StateCache cache;
+  cache.activeTexture(GL_TEXTURE0);
+  cache.bindTexture(GL_TEXTURE_2D, 7);
+  cache.activeTexture(GL_TEXTURE1);
+  cache.bindTexture(GL_TEXTURE_2D, 7);
+  cache.bindTexture(GL_TEXTURE_2D, 7);
+  cache.activeTexture(GL_TEXTURE0);
+  cache.bindTexture(GL_TEXTURE_2D, 7);
+  cache.bindTexture(GL_TEXTURE_CUBE_MAP, 7);
+  EXPECT_EQ(calls, (std::vector<std::string>{"unit", "texture", "unit",
+                                             "texture", "unit", "texture"}));
+
+  // a deleted texture is unbound everywhere, so binding its recycled name
+  // has to go through
+  calls.clear();
+  cache.textureDeleted(7);
+  cache.bindTexture(GL_TEXTURE_2D, 7);
+  cache.bindTexture(GL_TEXTURE_2D, 0);
+  EXPECT_EQ(calls, (std::vector<std::string>{"texture", "texture"}));
+}
+
+TEST_F(GLStateCache_Test, VertexArraysOwnTheElementBinding) {
+  StateCache cache;
+  cache.bindVertexArray(1);
+  cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 2);
+  cache.bindVertexArray(4);
+  cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 2);
+  cache.bindVertexArray(4);
+  EXPECT_EQ(calls, (std::vector<std::string>{"vao", "buffer", "vao",
+                                             "buffer"}));
+}
+
+TEST_F(GLStateCache_Test, FramebufferTargets) {
+  StateCache cache;
+  cache.bindFramebuffer(GL_FRAMEBUFFER, 1);
+  cache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 1);
+  cache.bindFramebuffer(GL_READ_FRAMEBUFFER, 2);
+  cache.bindFramebuffer(GL_FRAMEBUFFER, 1);
+  cache.framebufferDeleted(1);
+  cache.bindFramebuffer(GL_FRAMEBUFFER, 0);
+  EXPECT_EQ(calls, (std::vector<std::string>{"fbo", "fbo", "fbo"}));
+}
+
+TEST_F(GLStateCache_Test, InvalidateAndContextSwitch) {
+  StateCache cache;
+  int a, b;
+  cache.setContext(&a);
+  cache.useProgram(1);
+  cache.setContext(&a);
+  cache.useProgram(1);
+  cache.setContext(&b);
+  cache.useProgram(1);
+  cache.invalidate();
+  cache.useProgram(1);
+  EXPECT_EQ(calls,
+            (std::vector<std::string>{"program", "program", "program"}));
+}
+
+TEST_F(GLStateCache_Test, CommandListReplaysThroughCache) {
+  CommandList list;
+  list.viewport(0, 0, 8, 8);
+  list.clearColor(1.0f, 0.0f, 0.0f, 1.0f);
+  list.clear(GL_COLOR_BUFFER_BIT);
+  list.useProgram(2);
+  list.drawArrays(GL_TRIANGLES, 0, 3);
+  list.useProgram(2);
+  list.drawArrays(GL_TRIANGLES, 3, 3);
+  EXPECT_EQ(list.getCommandCount(), 7u);
+
+  StateCache cache;
+  list.execute(cache);
+  list.execute(cache);
+  EXPECT_EQ(calls, (std::vector<std::string>{"viewport", "clearColor",
+                                             "clear", "program", "draw",
+                                             "draw", "clear", "draw",
+                                             "draw"}));
+  EXPECT_EQ(cache.getStats().filtered, 5u);
+}
+
+TEST_F(GLStateCache_Test, CachesUniformBufferBindings) {
+  StateCache cache;
+  cache.bindBufferRange(GL_UNIFORM_BUFFER, 1, 4, 0, 256);
+  cache.bindBufferRange(GL_UNIFORM_BUFFER, 1, 4, 0, 256);
+  cache.bindBufferRange(GL_UNIFORM_BUFFER, 1, 4, 256, 256);
+  cache.bindBufferBase(GL_UNIFORM_BUFFER, 1, 4);
+  cache.bindBufferBase(GL_UNIFORM_BUFFER, 1, 4);
+  // the indexed binding also bound the buffer to the generic target
+  cache.bindBuffer(GL_UNIFORM_BUFFER, 4);
+  cache.bufferDeleted(4);
+  cache.bindBufferBase(GL_UNIFORM_BUFFER, 1, 0);
+  cache.bindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 5);
+  cache.bindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 5);
+  EXPECT_EQ(calls, (std::vector<std::string>{"range", "range", "base",
+                                             "base", "base"}));
+  EXPECT_EQ(cache.getStats().filtered, 4u);
+}
+#endif
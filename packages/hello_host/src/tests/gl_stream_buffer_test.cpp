@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include "../core/gl/extensions.hpp"
+#include "../core/gl/state_cache.hpp"
+#include "../core/gl/stream_buffer.hpp"
+
+#ifndef __EMSCRIPTEN__
+#include <cstring>
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+using namespace hello::gl;
+
+namespace {
+// driver calls made by the ring, stubbed in via the glad pointers. without
+// loadExtensions there is no buffer storage, so the ring orphans.
+std::vector<std::string> calls;
+std::vector<GLintptr> offsets;
+std::vector<GLenum> targets;
+
+// a GL 4.4 driver with buffer storage and copy buffers, whose fences
+// cannot be waited for
+GLint version = 0;
+uint8_t mapped[32];
+
+void *getProcAddress(const char *name) {
+  if (::strcmp(name, "glFenceSync") == 0) {
+    return reinterpret_cast<void *>(+[](GLenum, GLbitfield) {
+      return reinterpret_cast<GLsync>(static_cast<uintptr_t>(1));
+    });
+  }
+  if (::strcmp(name, "glClientWaitSync") == 0) {
+    return reinterpret_cast<void *>(+[](GLsync, GLbitfield, GLuint64) {
+      return static_cast<GLenum>(GL_WAIT_FAILED);
+    });
+  }
+  if (::strcmp(name, "glDeleteSync") == 0) {
+    return reinterpret_cast<void *>(+[](GLsync) {});
+  }
+  if (::strcmp(name, "glBufferStorage") == 0) {
+    return reinterpret_cast<void *>(
+        +[](GLenum target, GLsizeiptr, const void *, GLbitfield) {
+          targets.push_back(target);
+        });
+  }
+  if (::strcmp(name, "glCopyBufferSubData") == 0) {
+    return reinterpret_cast<void *>(
+        +[](GLenum, GLenum, GLintptr, GLintptr, GLsizeiptr) {});
+  }
+  return nullptr;
+}
+
+class GLStreamBuffer_Test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    calls.clear();
+    offsets.clear();
+    targets.clear();
+    saved = {glad_glGenBuffers,    glad_glDeleteBuffers, glad_glBindBuffer,
+             glad_glBufferData,    glad_glBufferSubData, glad_glGetIntegerv,
+             glad_glMapBufferRange};
+    glad_glGenBuffers = [](GLsizei, GLuint *buffers) { buffers[0] = 7; };
+    glad_glDeleteBuffers = [](GLsizei, const GLuint *) {
+      calls.push_back("delete");
+    };
+    glad_glBindBuffer = [](GLenum target, GLuint) {
+      calls.push_back("bind");
+      targets.push_back(target);
+    };
+    glad_glBufferData = [](GLenum, GLsizeiptr, const void *data, GLenum) {
+      calls.push_back(data == nullptr ? "orphan" : "data");
+    };
+    glad_glBufferSubData = [](GLenum, GLintptr offset, GLsizeiptr,
+                              const void *) {
+      calls.push_back("write");
+      offsets.push_back(offset);
+    };
+    glad_glGetIntegerv = [](GLenum pname, GLint *data) {
+      *data = pname == GL_MAJOR_VERSION || pname == GL_MINOR_VERSION ? version
+                                                                      : 0;
+    };
+    glad_glMapBufferRange = [](GLenum, GLintptr, GLsizeiptr,
+                               GLbitfield) -> void * { return mapped; };
+  }
+
+  void TearDown() override {
+    // forget the fake entry points again
+    version = 0;
+    loadExtensions(getProcAddress);
+    glad_glGenBuffers = saved.genBuffers;
+    glad_glDeleteBuffers = saved.deleteBuffers;
+    glad_glBindBuffer = saved.bindBuffer;
+    glad_glBufferData = saved.bufferData;
+    glad_glBufferSubData = saved.bufferSubData;
+    glad_glGetIntegerv = saved.getIntegerv;
+    glad_glMapBufferRange = saved.mapBufferRange;
+  }
+
+  struct {
+    PFNGLGENBUFFERSPROC genBuffers;
+    PFNGLDELETEBUFFERSPROC deleteBuffers;
+    PFNGLBINDBUFFERPROC bindBuffer;
+    PFNGLBUFFERDATAPROC bufferData;
+    PFNGLBUFFERSUBDATAPROC bufferSubData;
+    PFNGLGETINTEGERVPROC getIntegerv;
+    PFNGLMAPBUFFERRANGEPROC mapBufferRange;
+  } saved;
+};
+} // namespace
+
+TEST_F(GLStreamBuffer_Test, AlignsAndWrapsWrites) {
+  StateCache cache;
+  const char data[12] = {};
+  size_t offset = 0;
+  {
+    StreamBuffer stream(GL_ARRAY_BUFFER, 32, cache);
+    EXPECT_FALSE(stream.isPersistent());
+    EXPECT_EQ(stream.getBuffer(), 7u);
+
+    EXPECT_TRUE(stream.write(data, 5, 1, cache, &offset));
+    EXPECT_EQ(offset, 0u);
+    // alignment need not be a power of two, e.g. a 12 byte vertex
+    EXPECT_TRUE(stream.write(data, 12, 12, cache, &offset));
+    EXPECT_EQ(offset, 12u);
+    // 24 + 12 does not fit, so the next lap starts on fresh storage
+    EXPECT_TRUE(stream.write(data, 12, 4, cache, &offset));
+    EXPECT_EQ(offset, 0u);
+    stream.fence();
+    EXPECT_TRUE(stream.write(data, 12, 4, cache, &offset));
+    EXPECT_EQ(offset, 12u);
+
+    EXPECT_FALSE(stream.write(data, 0, 1, cache, &offset));
+    std::vector<char> large(33);
+    EXPECT_FALSE(stream.write(large.data(), large.size(), 1, cache, &offset));
+  }
+  EXPECT_EQ(calls, (std::vector<std::string>{"bind", "orphan", "write",
+                                             "write", "orphan", "write",
+                                             "write", "delete"}));
+  EXPECT_EQ(offsets, (std::vector<GLintptr>{0, 12, 0, 12}));
+}
+
+TEST_F(GLStreamBuffer_Test, LeavesTheIndexBufferBindingAlone) {
+  StateCache cache;
+  const char data[4] = {};
+  size_t offset = 0;
+  {
+    // without copy buffers the array buffer target stands in
+    StreamBuffer stream(GL_ELEMENT_ARRAY_BUFFER, 32, cache);
+    EXPECT_TRUE(stream.write(data, 4, 4, cache, &offset));
+  }
+  EXPECT_EQ(targets, (std::vector<GLenum>{GL_ARRAY_BUFFER}));
+
+  targets.clear();
+  version = 4;
+  loadExtensions(getProcAddress);
+  ASSERT_TRUE(getExtensions().copyBuffer);
+  StreamBuffer stream(GL_ELEMENT_ARRAY_BUFFER, 32, cache);
+  EXPECT_TRUE(stream.isPersistent());
+  EXPECT_EQ(targets,
+            (std::vector<GLenum>{GL_COPY_WRITE_BUFFER, GL_COPY_WRITE_BUFFER}));
+}
+
+TEST_F(GLStreamBuffer_Test, FailedWaitsLoseTheRing) {
+  version = 4;
+  loadExtensions(getProcAddress);
+  ASSERT_TRUE(getExtensions().bufferStorage && getExtensions().sync);
+
+  StateCache cache;
+  const char data[16] = {};
+  size_t offset = 0;
+  StreamBuffer stream(GL_ARRAY_BUFFER, 32, cache);
+  ASSERT_TRUE(stream.isPersistent());
+  EXPECT_TRUE(stream.write(data, 16, 1, cache, &offset));
+  EXPECT_TRUE(stream.write(data, 16, 1, cache, &offset));
+  stream.fence();
+  // the next lap has to wait for the fence, which fails
+  EXPECT_FALSE(stream.write(data, 16, 1, cache, &offset));
+  EXPECT_TRUE(stream.isLost());
+  EXPECT_FALSE(stream.write(data, 16, 1, cache, &offset));
+}
+#endif
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "../core/gl/uniform_block.hpp"
+
+#ifdef __EMSCRIPTEN__
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <cstring>
+
+using namespace hello::gl;
+
+namespace {
+float readFloat(const UniformBlock &block, size_t offset) {
+  float f;
+  ::memcpy(&f, block.getData() + offset, sizeof(f));
+  return f;
+}
+} // namespace
+
+TEST(GLUniformBlock_Test, PlacesMembersByStd140) {
+  UniformLayout layout;
+  EXPECT_TRUE(layout.add("scale", GL_FLOAT));
+  EXPECT_TRUE(layout.add("offset", GL_FLOAT_VEC2));
+  EXPECT_TRUE(layout.add("color", GL_FLOAT_VEC3));
+  EXPECT_TRUE(layout.add("alpha", GL_FLOAT));
+  EXPECT_TRUE(layout.add("normal", GL_FLOAT_MAT3));
+  EXPECT_TRUE(layout.add("weights", GL_FLOAT, 3));
+  EXPECT_TRUE(layout.add("flags", GL_INT_VEC2));
+  EXPECT_FALSE(layout.add("sampler", GL_SAMPLER_2D));
+  EXPECT_FALSE(layout.add("empty", GL_FLOAT, 0));
+
+  // a vec3 takes a vec4 slot but a scalar can fill its last component
+  EXPECT_EQ(layout.find("scale")->offset, 0u);
+  EXPECT_EQ(layout.find("offset")->offset, 8u);
+  EXPECT_EQ(layout.find("color")->offset, 16u);
+  EXPECT_EQ(layout.find("alpha")->offset, 28u);
+  EXPECT_EQ(layout.find("normal")->offset, 32u);
+  EXPECT_EQ(layout.find("normal")->matrixStride, 16u);
+  // scalars in arrays are padded to a vec4 each
+  EXPECT_EQ(layout.find("weights")->offset, 80u);
+  EXPECT_EQ(layout.find("weights")->arrayStride, 16u);
+  EXPECT_EQ(layout.find("flags")->offset, 128u);
+  EXPECT_EQ(layout.getSize(), 144u);
+  EXPECT_EQ(layout.find("sampler"), nullptr);
+}
+
+TEST(GLUniformBlock_Test, WritesPaddedValues) {
+  UniformLayout layout;
+  layout.add("normal", GL_FLOAT_MAT3);
+  layout.add("weights", GL_FLOAT, 3);
+  layout.add("count", GL_INT);
+  UniformBlock block(layout);
+  ASSERT_EQ(block.getSize(), 112u);
+
+  const double normal[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_TRUE(block.set("normal", 0, normal, 9));
+  EXPECT_EQ(readFloat(block, 0), 1.0f);
+  EXPECT_EQ(readFloat(block, 8), 3.0f);
+  EXPECT_EQ(readFloat(block, 12), 0.0f);
+  EXPECT_EQ(readFloat(block, 16), 4.0f);
+  EXPECT_EQ(readFloat(block, 40), 9.0f);
+
+  const double weights[] = {0.5, 0.25};
+  EXPECT_TRUE(block.set("weights", 1, weights, 2));
+  EXPECT_EQ(readFloat(block, 48), 0.0f);
+  EXPECT_EQ(readFloat(block, 64), 0.5f);
+  EXPECT_EQ(readFloat(block, 80), 0.25f);
+  EXPECT_FALSE(block.set("weights", 2, weights, 2));
+  EXPECT_FALSE(block.set("weights", 3, weights, 1));
+  EXPECT_FALSE(block.set("missing", 0, weights, 1));
+
+  const double count[] = {-3};
+  EXPECT_TRUE(block.set("count", 0, count, 1));
+  int32_t i;
+  ::memcpy(&i, block.getData() + 96, sizeof(i));
+  EXPECT_EQ(i, -3);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "../core/image/image_atlas.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace hello::image;
+
+namespace {
+struct Rect {
+  int x;
+  int y;
+  int w;
+  int h;
+};
+
+bool overlaps(const Rect &a, const Rect &b) {
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h &&
+         b.y < a.y + a.h;
+}
+} // namespace
+
+TEST(ImageAtlas_Test, PackerKeepsRectsApartAndInside) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> size(1, 40);
+  SkylinePacker packer(256, 256);
+  std::vector<Rect> rects;
+  auto area = 0;
+  for (int i = 0; i < 500; ++i) {
+    Rect r = {0, 0, size(rng), size(rng)};
+    if (!packer.insert(r.w, r.h, &r.x, &r.y)) {
+      continue;
+    }
+    ASSERT_GE(r.x, 0);
+    ASSERT_GE(r.y, 0);
+    ASSERT_LE(r.x + r.w, 256);
+    ASSERT_LE(r.y + r.h, 256);
+    for (const auto &other : rects) {
+      ASSERT_FALSE(overlaps(r, other));
+    }
+    rects.push_back(r);
+    area += r.w * r.h;
+  }
+  EXPECT_EQ(packer.getUsedArea(), area);
+  EXPECT_GT(area, 256 * 256 / 2);
+}
+
+TEST(ImageAtlas_Test, PackerRejectsOversizedRects) {
+  SkylinePacker packer(64, 32);
+  int x, y;
+  EXPECT_FALSE(packer.insert(65, 1, &x, &y));
+  EXPECT_FALSE(packer.insert(1, 33, &x, &y));
+  EXPECT_TRUE(packer.insert(64, 32, &x, &y));
+  EXPECT_FALSE(packer.insert(1, 1, &x, &y));
+}
+
+TEST(ImageAtlas_Test, BlitExtrudedRepeatsEdges) {
+  const int w = 3, h = 2, extrude = 2;
+  std::vector<uint8_t> src(w * h * 4);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i + 1);
+  }
+  std::vector<uint8_t> dst(16 * 16 * 4);
+  blitExtruded({src.data(), w, h, w * 4}, {dst.data(), 16, 16, 16 * 4}, 5, 4,
+               extrude);
+
+  auto pixelAt = [&dst](int x, int y) { return &dst[(y * 16 + x) * 4]; };
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 16; ++x) {
+      const auto inside = x >= 5 - extrude && x < 5 + w + extrude &&
+                          y >= 4 - extrude && y < 4 + h + extrude;
+      const auto sx = std::clamp(x - 5, 0, w - 1);
+      const auto sy = std::clamp(y - 4, 0, h - 1);
+      for (int c = 0; c < 4; ++c) {
+        const uint8_t expected = inside ? src[(sy * w + sx) * 4 + c] : 0;
+        ASSERT_EQ(pixelAt(x, y)[c], expected) << x << ", " << y;
+      }
+    }
+  }
+}
@@ -0,0 +1,338 @@
+#include <gtest/gtest.h>
+
+#include "../core/image/image_compress.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace hello::image;
+
+namespace {
+struct TestImage {
+  std::vector<uint8_t> pixels;
+  ImageView view;
+
+  TestImage(int w, int h)
+      : pixels(static_cast<size_t>(w) * h * 4),
+        view{pixels.data(), w, h, w * 4} {}
+};
+
+// gradients with a little noise, and alpha running across
+TestImage makeTestImage(int w, int h) {
+  TestImage image(w, h);
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> noise(-6, 6);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      auto p = &image.pixels[(y * w + x) * 4];
+      p[0] = static_cast<uint8_t>(std::clamp(x * 255 / w + noise(rng), 0, 255));
+      p[1] = static_cast<uint8_t>(std::clamp(y * 255 / h + noise(rng), 0, 255));
+      p[2] = static_cast<uint8_t>(std::clamp(128 + noise(rng) * 4, 0, 255));
+      p[3] = static_cast<uint8_t>(255 - x * 200 / w);
+    }
+  }
+  return image;
+}
+
+uint64_t readBigEndian(const uint8_t *p) {
+  uint64_t bits = 0;
+  for (int i = 0; i < 8; ++i) {
+    bits = bits << 8 | p[i];
+  }
+  return bits;
+}
+
+// reference decoders writing 16 row-major RGBA pixels
+
+void decodeBc1(const uint8_t *block, uint8_t out[16][4]) {
+  const int c0 = block[0] | block[1] << 8;
+  const int c1 = block[2] | block[3] << 8;
+  int palette[4][4];
+  for (int e = 0; e < 2; ++e) {
+    const auto v = e == 0 ? c0 : c1;
+    palette[e][0] = ((v >> 11) & 31) << 3 | ((v >> 11) & 31) >> 2;
+    palette[e][1] = ((v >> 5) & 63) << 2 | ((v >> 5) & 63) >> 4;
+    palette[e][2] = (v & 31) << 3 | (v & 31) >> 2;
+    palette[e][3] = 255;
+  }
+  for (int c = 0; c < 3; ++c) {
+    if (c0 > c1) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    } else {
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+      palette[3][c] = 0;
+    }
+  }
+  palette[2][3] = 255;
+  palette[3][3] = c0 > c1 ? 255 : 0;
+  for (int i = 0; i < 16; ++i) {
+    const auto index = (block[4 + i / 4] >> ((i % 4) * 2)) & 3;
+    for (int c = 0; c < 4; ++c) {
+      out[i][c] = static_cast<uint8_t>(palette[index][c]);
+    }
+  }
+}
+
+void decodeBc4(const uint8_t *block, uint8_t out[16][4]) {
+  const int a0 = block[0];
+  const int a1 = block[1];
+  int palette[8] = {a0, a1};
+  for (int i = 2; i < 8; ++i) {
+    palette[i] = a0 > a1 ? ((8 - i) * a0 + (i - 1) * a1) / 7
+                 : i < 6 ? ((6 - i) * a0 + (i - 1) * a1) / 5
+                 : i == 6 ? 0
+                          : 255;
+  }
+  uint64_t bits = 0;
+  for (int i = 0; i < 6; ++i) {
+    bits |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+  }
+  for (int i = 0; i < 16; ++i) {
+    out[i][3] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+  }
+}
+
+void decodeBc7Mode6(const uint8_t *block, uint8_t out[16][4]) {
+  auto position = 0;
+  auto read = [&](int bits) {
+    auto value = 0;
+    for (int i = 0; i < bits; ++i, ++position) {
+      value |= ((block[position >> 3] >> (position & 7)) & 1) << i;
+    }
+    return value;
+  };
+  ASSERT_EQ(read(7), 1 << 6);
+  int endpoints[2][4];
+  for (int c = 0; c < 4; ++c) {
+    endpoints[0][c] = read(7);
+    endpoints[1][c] = read(7);
+  }
+  const auto p0 = read(1);
+  const auto p1 = read(1);
+  const int weights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                           34, 38, 43, 47, 51, 55, 60, 64};
+  for (int i = 0; i < 16; ++i) {
+    const auto w = weights[read(i == 0 ? 3 : 4)];
+    for (int c = 0; c < 4; ++c) {
+      const auto a = endpoints[0][c] << 1 | p0;
+      const auto b = endpoints[1][c] << 1 | p1;
+      out[i][c] = static_cast<uint8_t>(((64 - w) * a + w * b + 32) >> 6);
+    }
+  }
+}
+
+void decodeEtc(const uint8_t *block, uint8_t out[16][4]) {
+  static const int modifiers[8][2] = {{2, 8},   {5, 17},  {9, 29},
+                                      {13, 42}, {18, 60}, {24, 80},
+                                      {33, 106}, {47, 183}};
+  const auto bits = readBigEndian(block);
+  const auto differential = (bits >> 33) & 1;
+  const auto flip = (bits >> 32) & 1;
+  int bases[2][3];
+  for (int c = 0; c < 3; ++c) {
+    if (differential) {
+      const int q0 = (bits >> (59 - c * 8)) & 31;
+      auto d = static_cast<int>((bits >> (56 - c * 8)) & 7);
+      d = d >= 4 ? d - 8 : d;
+      const auto q1 = q0 + d;
+      ASSERT_TRUE(q1 >= 0 && q1 <= 31) << "ETC2 T/H/planar block";
+      bases[0][c] = q0 << 3 | q0 >> 2;
+      bases[1][c] = q1 << 3 | q1 >> 2;
+    } else {
+      const int q0 = (bits >> (60 - c * 8)) & 15;
+      const int q1 = (bits >> (56 - c * 8)) & 15;
+      bases[0][c] = q0 << 4 | q0;
+      bases[1][c] = q1 << 4 | q1;
+    }
+  }
+  const int tables[2] = {static_cast<int>((bits >> 37) & 7),
+                         static_cast<int>((bits >> 34) & 7)};
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      const auto half = flip ? y / 2 : x / 2;
+      const auto n = x * 4 + y;
+      const auto msb = (bits >> (16 + n)) & 1;
+      const auto lsb = (bits >> n) & 1;
+      auto modifier = modifiers[tables[half]][lsb];
+      modifier = msb ? -modifier : modifier;
+      for (int c = 0; c < 3; ++c) {
+        out[y * 4 + x][c] =
+            static_cast<uint8_t>(std::clamp(bases[half][c] + modifier, 0, 255));
+      }
+      out[y * 4 + x][3] = 255;
+    }
+  }
+}
+
+void decodeEac(const uint8_t *block, uint8_t out[16][4]) {
+  static const int modifiers[16][8] = {
+      {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+      {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+      {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+      {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+      {-2, -6, -8, -10, 1, 5, 7, 9},  {-2, -5, -8, -10, 1, 4, 7, 9},
+      {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+      {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},
+      {-4, -6, -8, -9, 3, 5, 7, 8},   {-3, -5, -7, -9, 2, 4, 6, 8}};
+  const auto bits = readBigEndian(block);
+  const int base = (bits >> 56) & 255;
+  const int multiplier = (bits >> 52) & 15;
+  const int table = (bits >> 48) & 15;
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      const auto n = x * 4 + y;
+      const auto index = (bits >> (45 - n * 3)) & 7;
+      out[y * 4 + x][3] = static_cast<uint8_t>(
+          std::clamp(base + modifiers[table][index] * multiplier, 0, 255));
+    }
+  }
+}
+
+void decodeBlock(BlockFormat format, const uint8_t *block,
+                 uint8_t out[16][4]) {
+  switch (format) {
+  case BlockFormat::BC1:
+    decodeBc1(block, out);
+    break;
+  case BlockFormat::BC3:
+    decodeBc1(block + 8, out);
+    decodeBc4(block, out);
+    break;
+  case BlockFormat::BC7:
+    decodeBc7Mode6(block, out);
+    break;
+  case BlockFormat::ETC2_RGB:
+    decodeEtc(block, out);
+    break;
+  case BlockFormat::ETC2_RGBA:
+    decodeEtc(block + 8, out);
+    decodeEac(block, out);
+    break;
+  }
+}
+
+bool hasAlpha(BlockFormat format) {
+  return format != BlockFormat::BC1 && format != BlockFormat::ETC2_RGB;
+}
+
+// mean squared error per channel of a compressed image against its source
+double getError(const TestImage &src, BlockFormat format,
+                CompressQuality quality) {
+  const auto w = src.view.width;
+  const auto h = src.view.height;
+  std::vector<uint8_t> blocks(getCompressedSize(format, w, h));
+  compress(src.view, format, quality, blocks.data());
+
+  const auto channels = hasAlpha(format) ? 4 : 3;
+  const auto blockBytes = getBlockBytes(format);
+  double total = 0.0;
+  for (int by = 0; by < (h + 3) / 4; ++by) {
+    for (int bx = 0; bx < (w + 3) / 4; ++bx) {
+      uint8_t decoded[16][4];
+      decodeBlock(format,
+                  blocks.data() + (by * ((w + 3) / 4) + bx) * blockBytes,
+                  decoded);
+      for (int i = 0; i < 16; ++i) {
+        const auto x = bx * 4 + i % 4;
+        const auto y = by * 4 + i / 4;
+        if (x >= w || y >= h) {
+          continue;
+        }
+        for (int c = 0; c < channels; ++c) {
+          const double d = decoded[i][c] - src.pixels[(y * w + x) * 4 + c];
+          total += d * d;
+        }
+      }
+    }
+  }
+  return total / (static_cast<double>(w) * h * channels);
+}
+
+double toPsnr(double mse) { return 10.0 * std::log10(255.0 * 255.0 / mse); }
+
+const BlockFormat FORMATS[] = {BlockFormat::BC1, BlockFormat::BC3,
+                               BlockFormat::BC7, BlockFormat::ETC2_RGB,
+                               BlockFormat::ETC2_RGBA};
+} // namespace
+
+TEST(ImageCompress_Test, CompressedSize) {
+  EXPECT_EQ(getCompressedSize(BlockFormat::BC1, 256, 256), 32768u);
+  EXPECT_EQ(getCompressedSize(BlockFormat::BC7, 256, 256), 65536u);
+  EXPECT_EQ(getCompressedSize(BlockFormat::ETC2_RGBA, 5, 3), 32u);
+  EXPECT_EQ(getCompressedSize(BlockFormat::ETC2_RGB, 1, 1), 8u);
+}
+
+TEST(ImageCompress_Test, RoundTripQuality) {
+  const auto image = makeTestImage(64, 48);
+  for (auto format : FORMATS) {
+    const auto fast = getError(image, format, CompressQuality::Fast);
+    const auto normal = getError(image, format, CompressQuality::Normal);
+    const auto high = getError(image, format, CompressQuality::High);
+    EXPECT_GT(toPsnr(fast), 28.0) << static_cast<int>(format);
+    EXPECT_LE(normal, fast) << static_cast<int>(format);
+    EXPECT_LE(high, normal) << static_cast<int>(format);
+  }
+}
+
+TEST(ImageCompress_Test, FlatBlocksAreNearlyExact) {
+  TestImage image(4, 4);
+  for (size_t i = 0; i < image.pixels.size(); i += 4) {
+    image.pixels[i + 0] = 37;
+    image.pixels[i + 1] = 201;
+    image.pixels[i + 2] = 90;
+    image.pixels[i + 3] = 77;
+  }
+  for (auto format : FORMATS) {
+    // endpoint precision limits BC1 and ETC, BC7 and the alpha codecs are
+    // within a step
+    const auto limit = format == BlockFormat::BC7 ? 1.0 : 16.0;
+    EXPECT_LE(getError(image, format, CompressQuality::High), limit)
+        << static_cast<int>(format);
+  }
+
+  // EAC has a zero modifier, so flat alpha is exact
+  std::vector<uint8_t> block(16);
+  compress(image.view, BlockFormat::ETC2_RGBA, CompressQuality::Fast,
+           block.data());
+  uint8_t decoded[16][4];
+  decodeEac(block.data(), decoded);
+  for (auto &pixel : decoded) {
+    EXPECT_EQ(pixel[3], 77);
+  }
+}
+
+TEST(ImageCompress_Test, PartialBlocksRepeatEdges) {
+  // a corner of a bigger image, so rows are also further apart than 6
+  const auto image = makeTestImage(64, 48);
+  TestImage corner(6, 5);
+  for (int y = 0; y < 5; ++y) {
+    std::copy_n(&image.pixels[y * 64 * 4], 6 * 4, &corner.pixels[y * 6 * 4]);
+  }
+  for (auto format : FORMATS) {
+    const auto full = getError(corner, format, CompressQuality::Normal);
+    EXPECT_GT(toPsnr(full), 28.0) << static_cast<int>(format);
+
+    std::vector<uint8_t> blocks(getCompressedSize(format, 6, 5));
+    compress({image.view.pixels, 6, 5, image.view.pitch}, format,
+             CompressQuality::Normal, blocks.data());
+    std::vector<uint8_t> expected(blocks.size());
+    compress(corner.view, format, CompressQuality::Normal, expected.data());
+    EXPECT_EQ(blocks, expected) << static_cast<int>(format);
+  }
+}
+
+TEST(ImageCompress_Test, ParallelMatchesSerial) {
+  // 100x100 blocks go through the thread pool, a single block does not
+  const auto image = makeTestImage(400, 400);
+  std::vector<uint8_t> all(getCompressedSize(BlockFormat::BC7, 400, 400));
+  compress(image.view, BlockFormat::BC7, CompressQuality::Normal, all.data());
+
+  const ImageView corner = {image.view.pixels + (396 * 400 + 396) * 4, 4, 4,
+                            image.view.pitch};
+  std::vector<uint8_t> single(16);
+  compress(corner, BlockFormat::BC7, CompressQuality::Normal, single.data());
+  EXPECT_TRUE(std::equal(single.begin(), single.end(), all.end() - 16));
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include "../core/image/image_kernels.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+const int TEST_WIDTHS[] = {1, 3, 4, 7, 8, 15, 16, 17, 33, 64, 65};
+
+struct TestImage {
+  int width;
+  int height;
+  int pitch;
+  std::vector<uint8_t> pixels;
+
+  TestImage(int w, int h, int bytesPerPixel = 4)
+      : width(w), height(h), pitch(w * bytesPerPixel + 12),
+        pixels(static_cast<size_t>(pitch) * h) {
+    std::mt19937 rng(static_cast<uint32_t>(w * 131 + h));
+    for (auto &p : pixels) {
+      p = static_cast<uint8_t>(rng());
+    }
+  }
+};
+
+// the implementation flipVertical had before the kernels were added
+void flipVerticalWithTemp(uint8_t *pixels, int pitch, int height) {
+  char *temp = new char[pitch];
+  for (int i = 0; i < height / 2; ++i) {
+    auto row1 = pixels + i * pitch;
+    auto row2 = pixels + (height - i - 1) * pitch;
+    ::memcpy(temp, row1, pitch);
+    ::memcpy(row1, row2, pitch);
+    ::memcpy(row2, temp, pitch);
+  }
+  delete[] temp;
+}
+
+template <typename F> double measureMs(int iterations, F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    f();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+} // namespace
+
+using namespace hello::image;
+
+TEST(ImageKernels_Test, FlipVerticalMatchesScalar) {
+  for (auto w : TEST_WIDTHS) {
+    TestImage a(w, 5);
+    auto b = a;
+    flipVertical(a.pixels.data(), w * 4, a.height, a.pitch);
+    scalar::flipVertical(b.pixels.data(), w * 4, b.height, b.pitch);
+    ASSERT_EQ(a.pixels, b.pixels) << "width: " << w;
+  }
+}
+
+TEST(ImageKernels_Test, FlipHorizontalMatchesScalar) {
+  for (auto bytesPerPixel : {3, 4}) {
+    for (auto w : TEST_WIDTHS) {
+      TestImage a(w, 3, bytesPerPixel);
+      auto b = a;
+      flipHorizontal(a.pixels.data(), w, a.height, a.pitch, bytesPerPixel);
+      scalar::flipHorizontal(b.pixels.data(), w, b.height, b.pitch,
+                             bytesPerPixel);
+      ASSERT_EQ(a.pixels, b.pixels) << "width: " << w;
+    }
+  }
+}
+
+TEST(ImageKernels_Test, SwizzleMatchesScalar) {
+  const uint8_t order[] = {2, 1, 0, 3};
+  for (auto w : TEST_WIDTHS) {
+    TestImage a(w, 3);
+    auto b = a;
+    swizzle(a.pixels.data(), w, a.height, a.pitch, order);
+    scalar::swizzle(b.pixels.data(), w, b.height, b.pitch, order);
+    ASSERT_EQ(a.pixels, b.pixels) << "width: " << w;
+  }
+}
+
+TEST(ImageKernels_Test, RepackMatchesScalar) {
+  const uint8_t orders[][4] = {{2, 1, 0, 3}, {0, 1, 2, SWIZZLE_ONE}};
+  for (auto srcBpp : {3, 4}) {
+    for (auto dstBpp : {3, 4}) {
+      for (auto &order : orders) {
+        if (dstBpp == 4 && order[3] >= srcBpp && order[3] != SWIZZLE_ONE) {
+          continue;
+        }
+        for (auto w : TEST_WIDTHS) {
+          TestImage src(w, 3, srcBpp);
+          TestImage a(w, 3, dstBpp);
+          auto b = a;
+          repack(src.pixels.data(), src.pitch, srcBpp, a.pixels.data(),
+                 a.pitch, dstBpp, w, a.height, order);
+          scalar::repack(src.pixels.data(), src.pitch, srcBpp,
+                         b.pixels.data(), b.pitch, dstBpp, w, b.height, order);
+          ASSERT_EQ(a.pixels, b.pixels)
+              << srcBpp << " to " << dstBpp << ", width: " << w;
+        }
+      }
+    }
+  }
+}
+
+TEST(ImageKernels_Test, PremultiplyAlphaMatchesScalar) {
+  for (auto alphaIndex = 0; alphaIndex < 4; ++alphaIndex) {
+    for (auto w : TEST_WIDTHS) {
+      TestImage a(w, 3);
+      auto b = a;
+      premultiplyAlpha(a.pixels.data(), w, a.height, a.pitch, alphaIndex);
+      scalar::premultiplyAlpha(b.pixels.data(), w, b.height, b.pitch,
+                               alphaIndex);
+      ASSERT_EQ(a.pixels, b.pixels) << "width: " << w;
+    }
+  }
+}
+
+TEST(ImageKernels_Test, PremultiplyAlphaRoundsExactly) {
+  std::vector<uint8_t> pixels(256 * 256 * 4);
+  for (int i = 0; i < 256 * 256; ++i) {
+    pixels[i * 4] = static_cast<uint8_t>(i & 0xff);
+    pixels[i * 4 + 3] = static_cast<uint8_t>(i >> 8);
+  }
+  premultiplyAlpha(pixels.data(), 256 * 256, 1, 256 * 256 * 4, 3);
+  for (int i = 0; i < 256 * 256; ++i) {
+    const auto expected = ((i & 0xff) * (i >> 8) * 2 + 255) / 510;
+    ASSERT_EQ(pixels[i * 4], expected) << "index: " << i;
+    ASSERT_EQ(pixels[i * 4 + 3], i >> 8) << "index: " << i;
+  }
+}
+
+TEST(ImageKernels_Test, SrgbToLinear) {
+  uint8_t pixels[] = {0, 128, 255, 128};
+  srgbToLinear(pixels, 1, 1, 4, 4, 3);
+  EXPECT_EQ(pixels[0], 0);
+  EXPECT_EQ(pixels[1], 55);
+  EXPECT_EQ(pixels[2], 255);
+  EXPECT_EQ(pixels[3], 128);
+}
+
+TEST(ImageKernels_Test, DISABLED_Benchmark) {
+  TestImage image(2048, 2048);
+  const uint8_t order[] = {2, 1, 0, 3};
+  auto p = image.pixels.data();
+  auto w = image.width;
+  auto h = image.height;
+  auto pitch = image.pitch;
+  const int n = 20;
+
+  std::cout << "simd: " << simdName() << std::endl;
+  std::cout << "flipVertical (memcpy via temp): "
+            << measureMs(n, [&] { flipVerticalWithTemp(p, pitch, h); })
+            << " ms" << std::endl;
+  std::cout << "flipVertical (scalar): "
+            << measureMs(n, [&] { scalar::flipVertical(p, w * 4, h, pitch); })
+            << " ms" << std::endl;
+  std::cout << "flipVertical: "
+            << measureMs(n, [&] { flipVertical(p, w * 4, h, pitch); }) << " ms"
+            << std::endl;
+  std::cout << "flipHorizontal (scalar): "
+            << measureMs(n,
+                         [&] { scalar::flipHorizontal(p, w, h, pitch, 4); })
+            << " ms" << std::endl;
+  std::cout << "flipHorizontal: "
+            << measureMs(n, [&] { flipHorizontal(p, w, h, pitch, 4); })
+            << " ms" << std::endl;
+  std::cout << "swizzle (scalar): "
+            << measureMs(n, [&] { scalar::swizzle(p, w, h, pitch, order); })
+            << " ms" << std::endl;
+  std::cout << "swizzle: "
+            << measureMs(n, [&] { swizzle(p, w, h, pitch, order); }) << " ms"
+            << std::endl;
+  std::cout << "premultiplyAlpha (scalar): "
+            << measureMs(n,
+                         [&] { scalar::premultiplyAlpha(p, w, h, pitch, 3); })
+            << " ms" << std::endl;
+  std::cout << "premultiplyAlpha: "
+            << measureMs(n, [&] { premultiplyAlpha(p, w, h, pitch, 3); })
+            << " ms" << std::endl;
+  std::cout << "srgbToLinear: "
+            << measureMs(n, [&] { srgbToLinear(p, w, h, pitch, 4, 3); })
+            << " ms" << std::endl;
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "../core/image/image_mipmap.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace hello::image;
+
+namespace {
+struct TestImage {
+  std::vector<uint8_t> pixels;
+  ImageView view;
+
+  TestImage(int w, int h)
+      : pixels(static_cast<size_t>(w) * h * 4),
+        view{pixels.data(), w, h, w * 4} {}
+};
+} // namespace
+
+TEST(ImageMipmap_Test, LevelCount) {
+  EXPECT_EQ(getMipLevelCount(1, 1), 0);
+  EXPECT_EQ(getMipLevelCount(256, 256), 8);
+  EXPECT_EQ(getMipLevelCount(5, 3), 2);
+  EXPECT_EQ(getMipLevelCount(1, 16), 4);
+}
+
+TEST(ImageMipmap_Test, ConstantColorIsPreserved) {
+  for (auto filter : {MipFilter::Box, MipFilter::Kaiser, MipFilter::Lanczos}) {
+    TestImage src(300, 200);
+    for (size_t i = 0; i < src.pixels.size(); i += 4) {
+      src.pixels[i + 0] = 200;
+      src.pixels[i + 1] = 100;
+      src.pixels[i + 2] = 50;
+      src.pixels[i + 3] = 255;
+    }
+    const auto count = getMipLevelCount(300, 200);
+    std::vector<TestImage> images;
+    std::vector<ImageView> levels;
+    for (int i = 1, w = 300, h = 200; i <= count; ++i) {
+      w = std::max(1, w / 2);
+      h = std::max(1, h / 2);
+      images.emplace_back(w, h);
+    }
+    for (auto &image : images) {
+      levels.push_back(image.view);
+    }
+    generateMipmaps(src.view, levels.data(), count, filter, true);
+    for (auto &image : images) {
+      for (size_t i = 0; i < image.pixels.size(); i += 4) {
+        ASSERT_EQ(image.pixels[i + 0], 200);
+        ASSERT_EQ(image.pixels[i + 1], 100);
+        ASSERT_EQ(image.pixels[i + 2], 50);
+        ASSERT_EQ(image.pixels[i + 3], 255);
+      }
+    }
+  }
+}
+
+TEST(ImageMipmap_Test, BoxFilterAveragesInLinearLight) {
+  TestImage src(2, 1);
+  const uint8_t pixels[] = {0, 0, 0, 255, 255, 255, 255, 255};
+  std::copy_n(pixels, 8, src.pixels.data());
+  TestImage srgb(1, 1);
+  generateMipmaps(src.view, &srgb.view, 1, MipFilter::Box, true);
+  EXPECT_EQ(srgb.pixels[0], 188);
+  EXPECT_EQ(srgb.pixels[3], 255);
+
+  TestImage linear(1, 1);
+  generateMipmaps(src.view, &linear.view, 1, MipFilter::Box, false);
+  EXPECT_EQ(linear.pixels[0], 128);
+}
+
+TEST(ImageMipmap_Test, TransparentTexelsDoNotBleed) {
+  TestImage src(2, 1);
+  const uint8_t pixels[] = {255, 0, 0, 255, 0, 255, 0, 0};
+  std::copy_n(pixels, 8, src.pixels.data());
+  TestImage dst(1, 1);
+  generateMipmaps(src.view, &dst.view, 1, MipFilter::Box, true);
+  EXPECT_EQ(dst.pixels[0], 255);
+  EXPECT_EQ(dst.pixels[1], 0);
+  EXPECT_EQ(dst.pixels[3], 128);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "../core/image/image_probe.hpp"
+#include "../core/image/image_qoi.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace hello::image;
+
+namespace {
+void appendBE32(std::vector<uint8_t> *out, uint32_t v) {
+  out->push_back(static_cast<uint8_t>(v >> 24));
+  out->push_back(static_cast<uint8_t>(v >> 16));
+  out->push_back(static_cast<uint8_t>(v >> 8));
+  out->push_back(static_cast<uint8_t>(v));
+}
+
+void appendChunk(std::vector<uint8_t> *out, const char *type,
+                 const std::vector<uint8_t> &payload) {
+  appendBE32(out, static_cast<uint32_t>(payload.size()));
+  out->insert(out->end(), type, type + 4);
+  out->insert(out->end(), payload.begin(), payload.end());
+  appendBE32(out, 0); // crc is not checked
+}
+
+std::vector<uint8_t> makePng(uint32_t w, uint32_t h, uint8_t colorType,
+                             bool transparency) {
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  std::vector<uint8_t> ihdr;
+  appendBE32(&ihdr, w);
+  appendBE32(&ihdr, h);
+  ihdr.insert(ihdr.end(), {8, colorType, 0, 0, 0});
+  appendChunk(&png, "IHDR", ihdr);
+  appendChunk(&png, "gAMA", {0, 0, 0xb1, 0x8f});
+  if (transparency) {
+    appendChunk(&png, "tRNS", {0});
+  }
+  appendChunk(&png, "IDAT", {});
+  return png;
+}
+
+ImageProbe probe(const std::vector<uint8_t> &data) {
+  ImageProbe result = {};
+  EXPECT_TRUE(probeImage(data.data(), data.size(), &result));
+  return result;
+}
+} // namespace
+
+TEST(ImageProbe_Test, Png) {
+  auto result = probe(makePng(640, 480, 6, false));
+  EXPECT_STREQ(result.type, "png");
+  EXPECT_EQ(result.width, 640);
+  EXPECT_EQ(result.height, 480);
+  EXPECT_EQ(result.channels, 4);
+
+  EXPECT_EQ(probe(makePng(3, 5, 2, false)).channels, 3);
+  EXPECT_EQ(probe(makePng(3, 5, 3, true)).channels, 4);
+  EXPECT_EQ(probe(makePng(3, 5, 0, true)).channels, 2);
+}
+
+TEST(ImageProbe_Test, Jpeg) {
+  // SOI, an APP0 segment to skip, then SOF2 with 3 components
+  std::vector<uint8_t> jpeg = {0xff, 0xd8, 0xff, 0xe0, 0, 6, 'J', 'F', 'I',
+                               'F',  0xff, 0xc2, 0,    17, 8, 0x01, 0x2c,
+                               0x03, 0x20, 3};
+  jpeg.resize(jpeg.size() + 9);
+  auto result = probe(jpeg);
+  EXPECT_STREQ(result.type, "jpg");
+  EXPECT_EQ(result.width, 800);
+  EXPECT_EQ(result.height, 300);
+  EXPECT_EQ(result.channels, 3);
+}
+
+TEST(ImageProbe_Test, BmpGifWebp) {
+  std::vector<uint8_t> bmp(54, 0);
+  bmp[0] = 'B';
+  bmp[1] = 'M';
+  bmp[14] = 40;
+  bmp[18] = 0x10; // width 16
+  bmp[22] = 0xf8; // height -8, top-down
+  bmp[23] = bmp[24] = bmp[25] = 0xff;
+  bmp[28] = 32;
+  auto result = probe(bmp);
+  EXPECT_STREQ(result.type, "bmp");
+  EXPECT_EQ(result.width, 16);
+  EXPECT_EQ(result.height, 8);
+  EXPECT_EQ(result.channels, 4);
+
+  const std::vector<uint8_t> gif = {'G', 'I', 'F', '8', '9', 'a',
+                                    0x40, 0x01, 0xf0, 0x00};
+  result = probe(gif);
+  EXPECT_STREQ(result.type, "gif");
+  EXPECT_EQ(result.width, 320);
+  EXPECT_EQ(result.height, 240);
+
+  const std::string header = "RIFF....WEBPVP8X";
+  std::vector<uint8_t> webp(header.begin(), header.end());
+  webp.resize(30);
+  webp[20] = 0x10;
+  webp[24] = 99; // canvas size minus one
+  webp[27] = 49;
+  result = probe(webp);
+  EXPECT_STREQ(result.type, "webp");
+  EXPECT_EQ(result.width, 100);
+  EXPECT_EQ(result.height, 50);
+  EXPECT_EQ(result.channels, 4);
+}
+
+TEST(ImageProbe_Test, Qoi) {
+  std::vector<uint8_t> pixels(7 * 3 * 3, 128);
+  std::vector<uint8_t> qoi;
+  encodeQoi(pixels.data(), 7, 3, 7 * 3, 3, &qoi);
+  auto result = probe(qoi);
+  EXPECT_STREQ(result.type, "qoi");
+  EXPECT_EQ(result.width, 7);
+  EXPECT_EQ(result.height, 3);
+  EXPECT_EQ(result.channels, 3);
+}
+
+TEST(ImageProbe_Test, RejectsUnknownAndTruncated) {
+  ImageProbe result;
+  const std::string text = "not an image at all, just some text";
+  EXPECT_FALSE(probeImage(text.data(), text.size(), &result));
+
+  const auto png = makePng(640, 480, 6, false);
+  EXPECT_FALSE(probeImage(png.data(), 20, &result));
+  EXPECT_FALSE(probeImage(png.data(), 0, &result));
+
+  const auto empty = makePng(0, 480, 6, false);
+  EXPECT_FALSE(probeImage(empty.data(), empty.size(), &result));
+
+  const uint8_t jpeg[] = {0xff, 0xd8, 0xff, 0xe0, 0, 16, 'J'};
+  EXPECT_FALSE(probeImage(jpeg, sizeof(jpeg), &result));
+}
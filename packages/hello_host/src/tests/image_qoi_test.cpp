@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "../core/image/image_qoi.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace hello::image;
+
+namespace {
+// smooth areas, runs, repeats and noise, so every op gets used
+std::vector<uint8_t> makePixels(int w, int h, int channels, int pitch) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(pitch) * h);
+  std::mt19937 rng(5);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      auto p = &pixels[y * pitch + x * channels];
+      if (x < w / 4) {
+        p[0] = p[1] = p[2] = 40;
+      } else if (x < w / 2) {
+        p[0] = static_cast<uint8_t>(x);
+        p[1] = static_cast<uint8_t>(y * 3);
+        p[2] = static_cast<uint8_t>(x + y);
+      } else if (x < w * 3 / 4) {
+        p[0] = static_cast<uint8_t>((x % 3) * 90);
+        p[1] = p[2] = static_cast<uint8_t>((x % 3) * 50);
+      } else {
+        p[0] = static_cast<uint8_t>(rng());
+        p[1] = static_cast<uint8_t>(rng());
+        p[2] = static_cast<uint8_t>(rng());
+      }
+      if (channels == 4) {
+        p[3] = static_cast<uint8_t>(x < w / 2 ? 255 : rng() % 4 * 85);
+      }
+    }
+  }
+  return pixels;
+}
+} // namespace
+
+TEST(ImageQoi_Test, RoundTrip) {
+  for (int channels = 3; channels <= 4; ++channels) {
+    const int w = 157, h = 61;
+    const auto pitch = w * channels + 5;
+    const auto pixels = makePixels(w, h, channels, pitch);
+    std::vector<uint8_t> encoded;
+    encodeQoi(pixels.data(), w, h, pitch, channels, &encoded);
+    EXPECT_LT(encoded.size(), pixels.size());
+
+    QoiHeader header;
+    ASSERT_TRUE(readQoiHeader(encoded.data(), encoded.size(), &header));
+    EXPECT_EQ(header.width, w);
+    EXPECT_EQ(header.height, h);
+    EXPECT_EQ(header.channels, channels);
+
+    std::vector<uint8_t> decoded(pixels.size());
+    ASSERT_TRUE(decodeQoi(encoded.data(), encoded.size(), header,
+                          decoded.data(), pitch));
+    for (int y = 0; y < h; ++y) {
+      for (int i = 0; i < w * channels; ++i) {
+        ASSERT_EQ(decoded[y * pitch + i], pixels[y * pitch + i])
+            << channels << ": " << i << ", " << y;
+      }
+    }
+  }
+}
+
+TEST(ImageQoi_Test, LongRunsAreSplit) {
+  // 200 identical pixels need four run ops of at most 62
+  std::vector<uint8_t> pixels(200 * 4, 0);
+  for (size_t i = 3; i < pixels.size(); i += 4) {
+    pixels[i] = 255;
+  }
+  std::vector<uint8_t> encoded;
+  encodeQoi(pixels.data(), 200, 1, 200 * 4, 4, &encoded);
+  EXPECT_EQ(encoded.size(), 14u + 4u + 8u);
+
+  QoiHeader header;
+  ASSERT_TRUE(readQoiHeader(encoded.data(), encoded.size(), &header));
+  std::vector<uint8_t> decoded(pixels.size());
+  ASSERT_TRUE(decodeQoi(encoded.data(), encoded.size(), header,
+                        decoded.data(), 200 * 4));
+  EXPECT_EQ(decoded, pixels);
+}
+
+TEST(ImageQoi_Test, RejectsBadInput) {
+  QoiHeader header;
+  const uint8_t png[] = {0x89, 'P', 'N', 'G', 0, 0, 0, 0, 0, 0, 0, 0,
+                         0,    0,   0,   0,   0, 0, 0, 0, 0, 0, 0, 0};
+  EXPECT_FALSE(readQoiHeader(png, sizeof(png), &header));
+
+  const auto pixels = makePixels(32, 32, 4, 32 * 4);
+  std::vector<uint8_t> encoded;
+  encodeQoi(pixels.data(), 32, 32, 32 * 4, 4, &encoded);
+  encoded[12] = 5;
+  EXPECT_FALSE(readQoiHeader(encoded.data(), encoded.size(), &header));
+  encoded[12] = 4;
+
+  // cut in the middle of the pixel data
+  encoded.resize(encoded.size() / 2);
+  ASSERT_TRUE(readQoiHeader(encoded.data(), encoded.size(), &header));
+  std::vector<uint8_t> decoded(pixels.size());
+  EXPECT_FALSE(decodeQoi(encoded.data(), encoded.size(), header,
+                         decoded.data(), 32 * 4));
+}
@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+
+#include "../core/image/image_surface_cache.hpp"
+
+using namespace hello::image;
+
+TEST(SurfaceCache_Test, SharesSurfaces) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  const char *path = "../../hello_host/assets/uv_checker.png";
+  SurfaceCache cache(64 * 1024 * 1024);
+  auto a = cache.load(path);
+  auto b = cache.load(path);
+  ASSERT_NE(a, nullptr);
+  ASSERT_EQ(a, b);
+  EXPECT_EQ(a->refcount, 3);
+  EXPECT_EQ(cache.getStats().hits, 1u);
+  EXPECT_EQ(cache.getStats().misses, 1u);
+
+  // evicted entries stay alive for their holders
+  cache.clear();
+  EXPECT_EQ(cache.getStats().count, 0u);
+  EXPECT_EQ(a->refcount, 2);
+  SDL_FreeSurface(a);
+  SDL_FreeSurface(b);
+}
@@ -1,9 +1,20 @@
 #include "./lua_sdl2_test.hpp"
+#include "../core/gl/extensions.hpp"
+#include <cstdlib>
 #include <glad/glad.h>
 
 using namespace hello::lua;
 
-void LuaSDL2_Test::SetUpTestSuite() { SDL_Init(SDL_INIT_VIDEO); }
+void LuaSDL2_Test::SetUpTestSuite() {
+#if defined(__linux__)
+  // no display server: fall back to the EGL offscreen driver (llvmpipe on CI)
+  if (std::getenv("DISPLAY") == nullptr &&
+      std::getenv("WAYLAND_DISPLAY") == nullptr) {
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+  }
+#endif
+  SDL_Init(SDL_INIT_VIDEO);
+}
 
 void LuaSDL2_Test::TearDownTestSuite() { SDL_Quit(); }
 
@@ -29,6 +40,7 @@ void LuaSDL2_Test::initOpenGL() {
 #ifndef __EMSCRIPTEN__
   gladLoadGLLoader(SDL_GL_GetProcAddress);
 #endif
+  hello::gl::loadExtensions(SDL_GL_GetProcAddress);
 }
 
 void LuaSDL2_Test::initWindow(Uint32 flags) {
@@ -1,4 +1,5 @@
 #include "./lua_sdl2_test.hpp"
+#include "../core/gl/extensions.hpp"
 
 using namespace hello::lua;
 
@@ -97,6 +98,21 @@ TEST_F(LuaSDL2_Test, TestGL_SwapWindow) {
   ASSERT_EQ(LUA_OK, utils::docall(L, 1)) << lua_tostring(L, -1);
 }
 
+TEST_F(LuaSDL2_Test, TestConstantsResolveOnDemand) {
+  ASSERT_EQ(utils::dostring(L, "local gl = require('opengl');\n"
+                               "assert(rawget(gl, 'TEXTURE_2D') == nil);\n"
+                               "assert(gl.TEXTURE_2D == 0x0DE1);\n"
+                               "assert(rawget(gl, 'TEXTURE_2D') == 0x0DE1);\n"
+                               "assert(gl.ACTIVE_ATTRIBUTES == 0x8B89);\n"
+                               "assert(gl.FLOAT_MAT2x3 == 0x8B65);\n"
+                               "assert(gl.VERTEX_ARRAY_BINDING == 0x85B5);\n"
+                               "assert(gl.NOT_A_CONSTANT == nil);\n"
+                               "assert(gl[1] == nil);\n"
+                               "assert(type(gl.clearColor) == 'function');\n"),
+            LUA_OK)
+      << lua_tostring(L, -1);
+}
+
 TEST_F(LuaSDL2_Test, TestglClearColor) {
 #if defined(__EMSCRIPTEN__)
   GTEST_SKIP() << "Not work for Emscripten";
@@ -394,6 +410,51 @@ TEST_F(LuaSDL2_Test, TestGenTexture) {
   luaL_checkinteger(L, -1);
 }
 
+TEST_F(LuaSDL2_Test, TestTexSubImage2DFromView) {
+#if defined(GITHUB_ACTIONS)
+  GTEST_SKIP() << "Not work for GitHub Actions";
+#endif
+
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initRenderer();
+  initOpenGL();
+
+  ASSERT_EQ(
+      utils::dostring(
+          L,
+          "local gl = require('opengl');\n"
+          "local SDL_image = require('sdl2_image');\n"
+          "local image = "
+          "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+          "local tex = gl.genTexture();\n"
+          "gl.bindTexture(gl.TEXTURE_2D, tex);\n"
+          "gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 256, 256, 0, gl.RGBA, "
+          "gl.UNSIGNED_BYTE, image:view(512, 512, 256, 256));\n"
+          "local rgb = image:toGLFormat(gl.RGB);\n"
+          "gl.texSubImage2D(gl.TEXTURE_2D, 0, 16, 16, 33, 17, gl.RGB, "
+          "gl.UNSIGNED_BYTE, rgb:view(1, 3, 33, 17));\n"
+          "assert(not pcall(gl.texSubImage2D, gl.TEXTURE_2D, 0, 0, 0, 64, "
+          "64, gl.RGB, gl.UNSIGNED_BYTE, rgb:view(0, 0, 32, 32)));\n"
+          "assert(not pcall(gl.texSubImage2D, gl.TEXTURE_2D, 0, 0, 0, 32, "
+          "32, gl.RGBA, gl.UNSIGNED_BYTE, rgb:view(0, 0, 32, 32)));\n"
+          "-- 3 RGB pixels pad to 12 bytes a row, but the last row does not\n"
+          "gl.texSubImage2D(gl.TEXTURE_2D, 0, 0, 0, 3, 2, gl.RGB, "
+          "gl.UNSIGNED_BYTE, string.rep('x', 21));\n"
+          "assert(not pcall(gl.texSubImage2D, gl.TEXTURE_2D, 0, 0, 0, 3, 2, "
+          "gl.RGB, gl.UNSIGNED_BYTE, string.rep('x', 20)));\n"
+          "assert(not pcall(gl.texImage2D, gl.TEXTURE_2D, 0, gl.RGBA, 4, 4, "
+          "0, gl.RGBA, gl.UNSIGNED_BYTE, string.rep('x', 63)));\n"
+          "gl.deleteTexture(tex);\n"
+          "return tex;\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+  luaL_checkinteger(L, -1);
+}
+
 TEST_F(LuaSDL2_Test, TestFramebufferRenderbuffer) {
 #if defined(__EMSCRIPTEN__)
   GTEST_SKIP() << "Not work for Emscripten";
@@ -441,4 +502,706 @@ TEST_F(LuaSDL2_Test, TestFramebufferRenderbuffer) {
       << lua_tostring(L, -1);
   luaL_checkinteger(L, -1);
   luaL_checkinteger(L, -2);
-}
\ No newline at end of file
+}
+
+TEST_F(LuaSDL2_Test, TestReadPixelsFromFramebuffer) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local tex = gl.genTexture();\n"
+             "gl.bindTexture(gl.TEXTURE_2D, tex);\n"
+             "gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 4, 4, 0, gl.RGBA, "
+             "gl.UNSIGNED_BYTE, nil);\n"
+             "local fbo = gl.genFramebuffer();\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, fbo);\n"
+             "gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, "
+             "gl.TEXTURE_2D, tex, 0);\n"
+             "assert(gl.checkFramebufferStatus(gl.FRAMEBUFFER) == "
+             "gl.FRAMEBUFFER_COMPLETE);\n"
+             "gl.viewport(0, 0, 4, 4);\n"
+             "gl.clearColor(1, 0, 1, 1);\n"
+             "gl.clear(gl.COLOR_BUFFER_BIT);\n"
+             "local pixels = gl.readPixels(0, 0, 4, 4, gl.RGBA, "
+             "gl.UNSIGNED_BYTE);\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, 0);\n"
+             "gl.deleteFramebuffer(fbo);\n"
+             "gl.deleteTexture(tex);\n"
+             "return pixels;\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+
+  size_t size = 0;
+  auto pixels = reinterpret_cast<const uint8_t *>(lua_tolstring(L, -1, &size));
+  ASSERT_EQ(4u * 4u * 4u, size);
+  for (size_t i = 0; i < size; i += 4) {
+    EXPECT_EQ(0xff, pixels[i + 0]);
+    EXPECT_EQ(0x00, pixels[i + 1]);
+    EXPECT_EQ(0xff, pixels[i + 2]);
+    EXPECT_EQ(0xff, pixels[i + 3]);
+  }
+}
+
+TEST_F(LuaSDL2_Test, TestFailedToReadPixels) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+
+  ASSERT_NE(utils::dostring(L, "local gl = require('opengl');"
+                               "return gl.readPixels(0, 0, 4, 4, gl.RGBA, "
+                               "gl.TEXTURE_2D);"),
+            LUA_OK);
+}
+
+TEST_F(LuaSDL2_Test, TestGL_SetRenderCallback) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  ASSERT_EQ(
+      LUA_OK,
+      utils::dostring(
+          L, "local SDL = require('sdl2');\n"
+             "local gl = require('opengl');\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_FLAGS, 0);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_PROFILE_MASK, "
+             "SDL.GL_CONTEXT_PROFILE_CORE);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_MAJOR_VERSION, 3);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_MINOR_VERSION, 0);\n"
+             "local flags = SDL.WINDOW_OPENGL | SDL.WINDOW_HIDDEN;\n"
+             "local w1 = SDL.CreateWindow('1', SDL.WINDOWPOS_UNDEFINED, "
+             "SDL.WINDOWPOS_UNDEFINED, 64, 64, flags);\n"
+             "local c1 = SDL.GL_CreateContext(w1);\n"
+             "SDL.GL_MakeCurrent(w1, c1);\n"
+             "gl.loadGLLoader();\n"
+             "SDL.GL_SetAttribute(SDL.GL_SHARE_WITH_CURRENT_CONTEXT, 1);\n"
+             "local w2 = SDL.CreateWindow('2', SDL.WINDOWPOS_UNDEFINED, "
+             "SDL.WINDOWPOS_UNDEFINED, 64, 64, flags);\n"
+             "local c2 = SDL.GL_CreateContext(w2);\n"
+             "SDL.GL_SetAttribute(SDL.GL_SHARE_WITH_CURRENT_CONTEXT, 0);\n"
+             "assert(c2 ~= nil, SDL.GetError());\n"
+             "frames = { 0, 0 };\n"
+             "windows = { w1, w2 };\n"
+             "contexts = { c1, c2 };\n"
+             "SDL.GL_SetRenderCallback(w1, c1, function(w)\n"
+             "  assert(w == w1);\n"
+             "  frames[1] = frames[1] + 1;\n"
+             "end);\n"
+             "SDL.GL_SetRenderCallback(w2, c2, function(w)\n"
+             "  assert(w == w2);\n"
+             "  frames[2] = frames[2] + 1;\n"
+             "end);\n"))
+      << lua_tostring(L, -1);
+
+  ASSERT_EQ(LUA_OK, sdl2::renderWindows(L));
+  ASSERT_EQ(LUA_OK, sdl2::renderWindows(L));
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(L, "local SDL = require('sdl2');\n"
+                               "assert(frames[1] == 2 and frames[2] == 2);\n"
+                               "SDL.DestroyWindow(windows[2]);\n"))
+      << lua_tostring(L, -1);
+
+  ASSERT_EQ(LUA_OK, sdl2::renderWindows(L));
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(L, "local SDL = require('sdl2');\n"
+                               "assert(frames[1] == 3 and frames[2] == 2);\n"
+                               "SDL.GL_SetRenderCallback(windows[1], "
+                               "contexts[1], nil);\n"
+                               "SDL.GL_DeleteContext(contexts[2]);\n"
+                               "SDL.GL_DeleteContext(contexts[1]);\n"
+                               "SDL.DestroyWindow(windows[1]);\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestRenderCallbackRemovesWindows) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  // the second callback destroys the window drawn before it and
+  // unregisters the one after it
+  ASSERT_EQ(
+      LUA_OK,
+      utils::dostring(
+          L, "local SDL = require('sdl2');\n"
+             "local gl = require('opengl');\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_FLAGS, 0);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_PROFILE_MASK, "
+             "SDL.GL_CONTEXT_PROFILE_CORE);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_MAJOR_VERSION, 3);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_MINOR_VERSION, 0);\n"
+             "local flags = SDL.WINDOW_OPENGL | SDL.WINDOW_HIDDEN;\n"
+             "frames = { 0, 0, 0 };\n"
+             "windows = {};\n"
+             "contexts = {};\n"
+             "for i = 1, 3 do\n"
+             "  windows[i] = SDL.CreateWindow(tostring(i), "
+             "SDL.WINDOWPOS_UNDEFINED, SDL.WINDOWPOS_UNDEFINED, 64, 64, "
+             "flags);\n"
+             "  contexts[i] = SDL.GL_CreateContext(windows[i]);\n"
+             "  assert(contexts[i] ~= nil, SDL.GetError());\n"
+             "  SDL.GL_SetRenderCallback(windows[i], contexts[i], "
+             "function()\n"
+             "    frames[i] = frames[i] + 1;\n"
+             "    if i == 2 and frames[2] == 1 then\n"
+             "      SDL.DestroyWindow(windows[1]);\n"
+             "      SDL.GL_SetRenderCallback(windows[3], contexts[3], nil);\n"
+             "    end\n"
+             "  end);\n"
+             "end\n"
+             "SDL.GL_MakeCurrent(windows[1], contexts[1]);\n"
+             "gl.loadGLLoader();\n"))
+      << lua_tostring(L, -1);
+
+  ASSERT_EQ(LUA_OK, sdl2::renderWindows(L));
+  ASSERT_EQ(LUA_OK, sdl2::renderWindows(L));
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(L, "local SDL = require('sdl2');\n"
+                               "assert(frames[1] == 1 and frames[2] == 2 and "
+                               "frames[3] == 0);\n"
+                               "SDL.DestroyWindow(windows[2]);\n"
+                               "SDL.DestroyWindow(windows[3]);\n"
+                               "for i = 1, 3 do\n"
+                               "  SDL.GL_DeleteContext(contexts[i]);\n"
+                               "end\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestDeleteContextResetsStateCache) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  // a new context may reuse the address of a deleted one, and must not
+  // inherit what the cache knew about the old one
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local SDL = require('sdl2');\n"
+             "local gl = require('opengl');\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_FLAGS, 0);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_PROFILE_MASK, "
+             "SDL.GL_CONTEXT_PROFILE_CORE);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_MAJOR_VERSION, 3);\n"
+             "SDL.GL_SetAttribute(SDL.GL_CONTEXT_MINOR_VERSION, 0);\n"
+             "local w = SDL.CreateWindow('1', SDL.WINDOWPOS_UNDEFINED, "
+             "SDL.WINDOWPOS_UNDEFINED, 64, 64, "
+             "SDL.WINDOW_OPENGL | SDL.WINDOW_HIDDEN);\n"
+             "local c = SDL.GL_CreateContext(w);\n"
+             "SDL.GL_MakeCurrent(w, c);\n"
+             "gl.loadGLLoader();\n"
+             "gl.clearColor(0.25, 0.5, 0.75, 1);\n"
+             "gl.resetStateStats();\n"
+             "gl.clearColor(0.25, 0.5, 0.75, 1);\n"
+             "assert(gl.getStateStats().filtered == 1);\n"
+             "SDL.GL_DeleteContext(c);\n"
+             "c = SDL.GL_CreateContext(w);\n"
+             "SDL.GL_MakeCurrent(w, c);\n"
+             "gl.resetStateStats();\n"
+             "gl.clearColor(0.25, 0.5, 0.75, 1);\n"
+             "local stats = gl.getStateStats();\n"
+             "assert(stats.forwarded == 1 and stats.filtered == 0);\n"
+             "SDL.GL_DeleteContext(c);\n"
+             "SDL.DestroyWindow(w);\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestExecuteCommandList) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local tex = gl.genTexture();\n"
+             "gl.bindTexture(gl.TEXTURE_2D, tex);\n"
+             "gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 4, 4, 0, gl.RGBA, "
+             "gl.UNSIGNED_BYTE, nil);\n"
+             "local fbo = gl.genFramebuffer();\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, fbo);\n"
+             "gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, "
+             "gl.TEXTURE_2D, tex, 0);\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, 0);\n"
+             "local list = gl.newCommandList();\n"
+             "list:bindFramebuffer(gl.FRAMEBUFFER, fbo);\n"
+             "list:viewport(0, 0, 4, 4);\n"
+             "list:clearColor(0, 1, 1, 1);\n"
+             "list:clear(gl.COLOR_BUFFER_BIT);\n"
+             "assert(list:getCommandCount() == 4);\n"
+             "assert(list:getByteSize() == (3 + 5 + 5 + 2) * 4);\n"
+             "assert(not pcall(list.viewport, list, 0, 0, 'x', 4));\n"
+             "gl.execute(list);\n"
+             "gl.execute(list);\n"
+             "local pixels = gl.readPixels(0, 0, 4, 4, gl.RGBA, "
+             "gl.UNSIGNED_BYTE);\n"
+             "list:reset();\n"
+             "assert(list:getCommandCount() == 0);\n"
+             "gl.execute(list);\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, 0);\n"
+             "gl.deleteFramebuffer(fbo);\n"
+             "gl.deleteTexture(tex);\n"
+             "return pixels;\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+
+  size_t size = 0;
+  auto pixels = reinterpret_cast<const uint8_t *>(lua_tolstring(L, -1, &size));
+  ASSERT_EQ(4u * 4u * 4u, size);
+  for (size_t i = 0; i < size; i += 4) {
+    EXPECT_EQ(0x00, pixels[i + 0]);
+    EXPECT_EQ(0xff, pixels[i + 1]);
+    EXPECT_EQ(0xff, pixels[i + 2]);
+    EXPECT_EQ(0xff, pixels[i + 3]);
+  }
+}
+
+TEST_F(LuaSDL2_Test, TestStreamBuffer) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local stream = gl.newStreamBuffer(64);\n"
+             "assert(stream:getSize() == 64);\n"
+             "assert(stream:getBuffer() > 0);\n"
+             "local vertex = string.pack('fff', 0, 1, 2);\n"
+             "assert(stream:write(vertex, 12) == 0);\n"
+             "assert(stream:write('x') == 12);\n"
+             "assert(stream:write(vertex, 12) == 24);\n"
+             "stream:fence();\n"
+             "assert(stream:write(vertex, 12) == 36);\n"
+             "assert(stream:write(vertex, 12) == 48);\n"
+             "assert(stream:write(vertex, 12) == 0);\n"
+             "assert(stream:write(vertex, 12) == 12);\n"
+             "assert(stream:write(vertex, 12) == 24);\n"
+             "local offset, err = stream:write(vertex, 12);\n"
+             "if stream:isPersistent() then\n"
+             "  assert(offset == nil and err ~= nil);\n"
+             "  stream:fence();\n"
+             "  offset = stream:write(vertex, 12);\n"
+             "end\n"
+             "assert(offset == 36);\n"
+             "assert(stream:write(string.rep('x', 65)) == nil);\n"
+             "stream:free();\n"
+             "assert(not pcall(stream.write, stream, vertex));\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestBufferSubDataAndCopy) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+  if (!hello::gl::getExtensions().copyBuffer) {
+    GTEST_SKIP() << "copyBufferSubData is not supported";
+  }
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local red = string.pack('BBBB', 255, 0, 0, 255);\n"
+             "local cyan = string.pack('BBBB', 0, 255, 255, 255);\n"
+             "local src = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.COPY_READ_BUFFER, src);\n"
+             "gl.bufferData(gl.COPY_READ_BUFFER, red:rep(4), "
+             "gl.STATIC_DRAW);\n"
+             "gl.bufferSubData(gl.COPY_READ_BUFFER, 8, red .. cyan:rep(2), "
+             "4);\n"
+             "assert(not pcall(gl.bufferSubData, gl.COPY_READ_BUFFER, 0, "
+             "red, 2, 4));\n"
+             "local dst = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.PIXEL_UNPACK_BUFFER, dst);\n"
+             "gl.bufferData(gl.PIXEL_UNPACK_BUFFER, red:rep(4), "
+             "gl.STREAM_DRAW);\n"
+             "gl.copyBufferSubData(gl.COPY_READ_BUFFER, "
+             "gl.PIXEL_UNPACK_BUFFER, 8, 0, 8);\n"
+             "local tex = gl.genTexture();\n"
+             "gl.bindTexture(gl.TEXTURE_2D, tex);\n"
+             "gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 2, 2, 0, gl.RGBA, "
+             "gl.UNSIGNED_BYTE, nil);\n"
+             "gl.bindBuffer(gl.PIXEL_UNPACK_BUFFER, 0);\n"
+             "local fbo = gl.genFramebuffer();\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, fbo);\n"
+             "gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, "
+             "gl.TEXTURE_2D, tex, 0);\n"
+             "local pixels = gl.readPixels(0, 0, 2, 2, gl.RGBA, "
+             "gl.UNSIGNED_BYTE);\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, 0);\n"
+             "gl.deleteFramebuffer(fbo);\n"
+             "gl.deleteTexture(tex);\n"
+             "gl.deleteBuffer(dst);\n"
+             "gl.deleteBuffer(src);\n"
+             "assert(pixels == cyan:rep(2) .. red:rep(2));\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestDrawInstanced) {
+#if defined(GITHUB_ACTIONS)
+  GTEST_SKIP() << "Not work for GitHub Actions";
+#endif
+
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initRenderer();
+  initOpenGL();
+  if (!hello::gl::getExtensions().instancing) {
+    GTEST_SKIP() << "instancing is not supported";
+  }
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local vertices = string.pack('fffffffff', 0, 0.1, 0, "
+             "0.1, -0.1, 0, -0.1, -0.1, 0);\n"
+             "local vbo = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.ARRAY_BUFFER, vbo);\n"
+             "gl.bufferData(gl.ARRAY_BUFFER, vertices, gl.STATIC_DRAW);\n"
+             "local instances = gl.newInstanceData(20);\n"
+             "for i = 0, 99 do\n"
+             "  local index = instances:add();\n"
+             "  instances:setTransform(index, 0, i / 100, 0, 0);\n"
+             "  instances:set(index, 16, 1, i / 100, 0, 1);\n"
+             "end\n"
+             "assert(instances:getCount() == 100);\n"
+             "assert(instances:getStride() == 80);\n"
+             "assert(not pcall(instances.set, instances, 100, 0, 1));\n"
+             "assert(not pcall(instances.set, instances, 0, 18, 1, 2, 3));\n"
+             "local ibo = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.ARRAY_BUFFER, ibo);\n"
+             "instances:upload(gl.ARRAY_BUFFER, gl.STREAM_DRAW);\n"
+             "local vao = gl.genVertexArray();\n"
+             "gl.bindVertexArray(vao);\n"
+             "gl.bindBuffer(gl.ARRAY_BUFFER, vbo);\n"
+             "gl.enableVertexAttribArray(0);\n"
+             "gl.vertexAttribPointer(0, 3, gl.FLOAT, gl.FALSE, 0);\n"
+             "gl.bindBuffer(gl.ARRAY_BUFFER, ibo);\n"
+             "for i = 0, 4 do\n"
+             "  gl.enableVertexAttribArray(1 + i);\n"
+             "  gl.vertexAttribPointer(1 + i, 4, gl.FLOAT, gl.FALSE, "
+             "instances:getStride(), i * 16);\n"
+             "  gl.vertexAttribDivisor(1 + i, 1);\n"
+             "end\n"
+             "gl.drawArraysInstanced(gl.TRIANGLES, 0, 3, "
+             "instances:getCount());\n"
+             "gl.bufferSubData(gl.ARRAY_BUFFER, 0, instances);\n"
+             "instances:free();\n"
+             "assert(not pcall(instances.add, instances));\n"
+             "gl.bindVertexArray(0);\n"
+             "gl.deleteBuffer(ibo);\n"
+             "gl.deleteBuffer(vbo);\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestUniformBlock) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+  if (!hello::gl::getExtensions().uniformBuffer) {
+    GTEST_SKIP() << "uniform buffers are not supported";
+  }
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local function compile(type, source)\n"
+             "  local shader = gl.createShader(type);\n"
+             "  gl.shaderSource(shader, source);\n"
+             "  gl.compileShader(shader);\n"
+             "  assert(gl.getShaderiv(shader, gl.COMPILE_STATUS) == gl.TRUE,\n"
+             "         gl.getShaderInfoLog(shader));\n"
+             "  return shader;\n"
+             "end\n"
+             "local vs = compile(gl.VERTEX_SHADER, [[#version 140\n"
+             "layout(std140) uniform Params {\n"
+             "  mat4 transform;\n"
+             "  vec3 color;\n"
+             "  float alpha;\n"
+             "  float weights[3];\n"
+             "};\n"
+             "in vec3 position;\n"
+             "out vec4 tint;\n"
+             "void main() {\n"
+             "  tint = vec4(color * weights[2], alpha);\n"
+             "  gl_Position = transform * vec4(position, 1.0);\n"
+             "}]]);\n"
+             "local fs = compile(gl.FRAGMENT_SHADER, [[#version 140\n"
+             "in vec4 tint;\n"
+             "out vec4 fragColor;\n"
+             "void main() { fragColor = tint; }]]);\n"
+             "local program = gl.createProgram();\n"
+             "gl.attachShader(program, vs);\n"
+             "gl.attachShader(program, fs);\n"
+             "gl.linkProgram(program);\n"
+             "assert(gl.getProgramiv(program, gl.LINK_STATUS) == gl.TRUE);\n"
+             "local layout = gl.newUniformLayout({\n"
+             "  {'transform', gl.FLOAT_MAT4}, {'color', gl.FLOAT_VEC3},\n"
+             "  {'alpha', gl.FLOAT}, {'weights', gl.FLOAT, 3},\n"
+             "});\n"
+             "local reflected = gl.getUniformBlockLayout(program, 'Params');\n"
+             "for _, name in ipairs({'transform', 'color', 'alpha', "
+             "'weights'}) do\n"
+             "  assert(reflected:getOffset(name) == layout:getOffset(name),\n"
+             "         name);\n"
+             "end\n"
+             "assert(reflected:getSize() == layout:getSize());\n"
+             "assert(gl.getUniformBlockLayout(program, 'Missing') == nil);\n"
+             "assert(not pcall(gl.newUniformLayout, {{'s', gl.SAMPLER_2D}}));\n"
+             "local index = gl.getUniformBlockIndex(program, 'Params');\n"
+             "gl.uniformBlockBinding(program, index, 1);\n"
+             "local block = layout:newBlock();\n"
+             "block:set('transform', 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, "
+             "0, 0, 0, 1);\n"
+             "block:set('color', 1, 0.5, 0.25);\n"
+             "block:setElement('weights', 2, 1);\n"
+             "assert(not pcall(block.set, block, 'color', 1, 2, 3, 4));\n"
+             "assert(not pcall(block.set, block, 'missing', 1));\n"
+             "local alignment = "
+             "gl.getInteger(gl.UNIFORM_BUFFER_OFFSET_ALIGNMENT);\n"
+             "local stream = gl.newStreamBuffer(4096, gl.UNIFORM_BUFFER);\n"
+             "for i = 1, 3 do\n"
+             "  local offset = stream:write(block, alignment);\n"
+             "  assert(offset % alignment == 0);\n"
+             "  gl.bindBufferRange(gl.UNIFORM_BUFFER, 1, stream:getBuffer(), "
+             "offset, block:getSize());\n"
+             "end\n"
+             "stream:fence();\n"
+             "local ubo = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.UNIFORM_BUFFER, ubo);\n"
+             "block:upload(gl.UNIFORM_BUFFER);\n"
+             "gl.bindBufferBase(gl.UNIFORM_BUFFER, 0, ubo);\n"
+             "gl.deleteBuffer(ubo);\n"
+             "stream:free();\n"
+             "gl.deleteProgram(program);\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestGpuTimer) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+  if (!hello::gl::getExtensions().timerQuery) {
+    GTEST_SKIP() << "timer queries are not supported";
+  }
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local query = gl.genQuery();\n"
+             "gl.queryCounter(query, gl.TIMESTAMP);\n"
+             "gl.finish();\n"
+             "assert(gl.getQueryObjectuiv(query, "
+             "gl.QUERY_RESULT_AVAILABLE) == 1);\n"
+             "assert(gl.getQueryObjectui64v(query, gl.QUERY_RESULT) > 0);\n"
+             "gl.deleteQuery(query);\n"
+             "local timer = gl.newGpuTimer(16, 4);\n"
+             "for frame = 1, 6 do\n"
+             "  assert(timer:beginPass('clear'));\n"
+             "  assert(not timer:beginPass('nested'));\n"
+             "  gl.clearColor(0, 0, frame / 6, 1);\n"
+             "  gl.clear(gl.COLOR_BUFFER_BIT);\n"
+             "  timer:endPass();\n"
+             "  if timer:beginPass('idle') then timer:endPass() end\n"
+             "  timer:collect();\n"
+             "end\n"
+             "gl.finish();\n"
+             "timer:collect();\n"
+             "assert(timer:getPendingCount() == 0);\n"
+             "local times = timer:getTimes();\n"
+             "assert(#times == 2 and times[1].name == 'clear');\n"
+             "assert(times[1].samples == 4 and times[1].average >= 0);\n"
+             "timer:reset();\n"
+             "assert(timer:getTimes()[2].samples == 0);\n"
+             "timer:free();\n"
+             "assert(not pcall(timer.collect, timer));\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestMultiDrawAndDrawList) {
+#if defined(GITHUB_ACTIONS)
+  GTEST_SKIP() << "Not work for GitHub Actions";
+#endif
+
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initRenderer();
+  initOpenGL();
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local vertices = string.pack('ffffffffffff', -1, -1, 1, -1, "
+             "1, 1, -1, 1, 0, 0, 0.5, 0.5);\n"
+             "local indices = string.pack('HHHHHHHHH', 0, 1, 2, 0, 2, 3, "
+             "0, 4, 5);\n"
+             "local vao = gl.genVertexArray();\n"
+             "gl.bindVertexArray(vao);\n"
+             "local vbo = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.ARRAY_BUFFER, vbo);\n"
+             "gl.bufferData(gl.ARRAY_BUFFER, vertices, gl.STATIC_DRAW);\n"
+             "gl.enableVertexAttribArray(0);\n"
+             "gl.vertexAttribPointer(0, 2, gl.FLOAT, gl.FALSE, 0);\n"
+             "local ebo = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, ebo);\n"
+             "gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, indices, "
+             "gl.STATIC_DRAW);\n"
+             "gl.multiDrawArrays(gl.TRIANGLES, {0, 3}, {3, 3});\n"
+             "gl.multiDrawElements(gl.TRIANGLES, {6, 3}, "
+             "gl.UNSIGNED_SHORT, {0, 12});\n"
+             "assert(not pcall(gl.multiDrawArrays, gl.TRIANGLES, {0}, "
+             "{3, 3}));\n"
+             "local list = gl.newDrawList({\n"
+             "  {6, 0, bounds = {0, 0, 0, 1.5}},\n"
+             "  {3, 6, bounds = {5, 0, 0, 1}},\n"
+             "});\n"
+             "assert(list:add(3, 6) == 2);\n"
+             "list:setBounds(2, 0, 0, -5, 1);\n"
+             "assert(list:getCount() == 3);\n"
+             "local identity = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, "
+             "0, 0, 0, 1};\n"
+             "assert(list:build(identity) == 1);\n"
+             "assert(list:build() == 3);\n"
+             "assert(list:getByteSize() == 3 * list:getStride());\n"
+             "list:draw(gl.TRIANGLES, gl.UNSIGNED_SHORT);\n"
+             "if gl.getExtensions().multiDrawIndirect then\n"
+             "  local commands = gl.genBuffer();\n"
+             "  gl.bindBuffer(gl.DRAW_INDIRECT_BUFFER, commands);\n"
+             "  list:upload(gl.DRAW_INDIRECT_BUFFER);\n"
+             "  gl.multiDrawElementsIndirect(gl.TRIANGLES, "
+             "gl.UNSIGNED_SHORT, 0, list:getDrawCount());\n"
+             "  gl.drawElementsIndirect(gl.TRIANGLES, gl.UNSIGNED_SHORT, "
+             "list:getStride());\n"
+             "  gl.bindBuffer(gl.DRAW_INDIRECT_BUFFER, 0);\n"
+             "  gl.deleteBuffer(commands);\n"
+             "end\n"
+             "list:add(3, 6, 0, 1, 1);\n"
+             "list:build();\n"
+             "local ok, err = pcall(list.draw, list, gl.TRIANGLES, "
+             "gl.UNSIGNED_SHORT);\n"
+             "assert(not ok and err:find('baseInstance'));\n"
+             "assert(not pcall(gl.newDrawList, {{6.5, 0}}));\n"
+             "assert(not pcall(gl.newDrawList, {{6, 0, bounds = {0, 0, "
+             "0}}}));\n"
+             "assert(not pcall(gl.newDrawList, {{6, 0, bounds = {0, 0, 0, "
+             "-1}}}));\n"
+             "assert(not pcall(gl.newDrawList, {{6, 0, bounds = 1}}));\n"
+             "list:free();\n"
+             "assert(not pcall(list.build, list));\n"
+             "gl.bindVertexArray(0);\n"
+             "gl.deleteBuffer(ebo);\n"
+             "gl.deleteBuffer(vbo);\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, TestAsyncReadback) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+
+  initWindow();
+  initOpenGL();
+
+  ASSERT_EQ(
+      utils::dostring(
+          L, "local gl = require('opengl');\n"
+             "local tex = gl.genTexture();\n"
+             "gl.bindTexture(gl.TEXTURE_2D, tex);\n"
+             "gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 4, 4, 0, gl.RGBA, "
+             "gl.UNSIGNED_BYTE, nil);\n"
+             "local fbo = gl.genFramebuffer();\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, fbo);\n"
+             "gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, "
+             "gl.TEXTURE_2D, tex, 0);\n"
+             "gl.viewport(0, 0, 4, 4);\n"
+             "gl.clearColor(1, 0, 1, 1);\n"
+             "gl.clear(gl.COLOR_BUFFER_BIT);\n"
+             "local expected = gl.readPixels(0, 0, 4, 4, gl.RGBA, "
+             "gl.UNSIGNED_BYTE);\n"
+             "local pbo = gl.genBuffer();\n"
+             "gl.bindBuffer(gl.PIXEL_PACK_BUFFER, pbo);\n"
+             "gl.bufferData(gl.PIXEL_PACK_BUFFER, string.rep('\\0', 64), "
+             "gl.STREAM_READ);\n"
+             "gl.readPixels(0, 0, 4, 4, gl.RGBA, gl.UNSIGNED_BYTE, 0);\n"
+             "assert(gl.getBufferSubData(gl.PIXEL_PACK_BUFFER, 0, 64) == "
+             "expected);\n"
+             "gl.bindBuffer(gl.PIXEL_PACK_BUFFER, 0);\n"
+             "gl.deleteBuffer(pbo);\n"
+             "local readback = gl.newReadback(2);\n"
+             "assert(readback:read(0, 0, 4, 4) == 1);\n"
+             "assert(readback:read(0, 0, 4, 4, gl.RGBA, "
+             "gl.UNSIGNED_BYTE) == 2);\n"
+             "assert(readback:read(0, 0, 4, 4) == nil);\n"
+             "assert(readback:getPendingCount() == 2);\n"
+             "gl.finish();\n"
+             "local ids = {};\n"
+             "assert(readback:collect(function(pixels, info)\n"
+             "  assert(pixels == expected);\n"
+             "  assert(info.width == 4 and info.height == 4);\n"
+             "  ids[#ids + 1] = info.id;\n"
+             "end) == 2);\n"
+             "assert(ids[1] == 1 and ids[2] == 2);\n"
+             "assert(readback:read(0, 0, 4, 4) == 3);\n"
+             "readback:free();\n"
+             "assert(not pcall(readback.read, readback, 0, 0, 4, 4));\n"
+             "local encoder = gl.newReadback(1, 'qoi');\n"
+             "assert(not pcall(encoder.read, encoder, 0, 0, 4, 4, gl.RED));\n"
+             "assert(encoder:read(0, 0, 4, 4) == 1);\n"
+             "gl.finish();\n"
+             "local file;\n"
+             "encoder:collect(function(pixels) file = pixels end);\n"
+             "assert(file:sub(1, 4) == 'qoif');\n"
+             "-- 3 RGB pixels pad to 12 bytes a row, but the last row does "
+             "not\n"
+             "assert(encoder:read(1, 1, 3, 2, gl.RGB) == 2);\n"
+             "gl.finish();\n"
+             "encoder:collect(function(pixels) file = pixels end);\n"
+             "local image = require('sdl2_image').loadFromString(file);\n"
+             "assert(image:getInfo().w == 3 and image:getInfo().h == 2);\n"
+             "-- six equal pixels: a run of five before the end marker\n"
+             "assert(file:byte(-9) == 0xc4);\n"
+             "encoder:free();\n"
+             "assert(not pcall(gl.readPixels, 0, 0, 4, 4, gl.RGBA, "
+             "gl.UNSIGNED_BYTE, 0));\n"
+             "gl.bindFramebuffer(gl.FRAMEBUFFER, 0);\n"
+             "gl.deleteFramebuffer(fbo);\n"
+             "gl.deleteTexture(tex);\n"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+}
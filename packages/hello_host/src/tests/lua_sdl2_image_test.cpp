@@ -1,6 +1,10 @@
 
 #include "./lua_sdl2_test.hpp"
 
+#include <filesystem>
+#include <fstream>
+#include <string>
+
 using namespace hello::lua;
 
 TEST_F(LuaSDL2_Test, LoadImageTest) {
@@ -18,3 +22,347 @@ TEST_F(LuaSDL2_Test, LoadImageTest) {
                    "return image:getInfo();\n"))
       << lua_tostring(L, -1);
 }
+
+TEST_F(LuaSDL2_Test, LoadImageFromStringTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local f = "
+                   "io.open('../../hello_host/assets/uv_checker.png', 'rb');\n"
+                   "local data = f:read('a');\n"
+                   "f:close();\n"
+                   "local image = SDL_image.loadFromString(data);\n"
+                   "assert(image ~= nil, 'failed to decode');\n"
+                   "local reused = SDL_image.loadFromStringInto(data, image);\n"
+                   "assert(reused == image, 'failed to decode into surface');\n"
+                   "assert(SDL_image.loadFromString('not an image') == nil);\n"
+                   "return image:getInfo();\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, ImageKernelsTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL = require('sdl2');\n"
+                   "local SDL_image = require('sdl2_image');\n"
+                   "local image = "
+                   "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+                   "image:lock();\n"
+                   "image:flipHorizontal();\n"
+                   "image:premultiplyAlpha();\n"
+                   "image:srgbToLinear();\n"
+                   "local format = image:swizzle('bgra');\n"
+                   "image:unlock();\n"
+                   "assert(math.type(format) == 'integer');\n"
+                   "assert(not pcall(image.swizzle, image, 'rgbx'));\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, LoadManyTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local path = '../../hello_host/assets/uv_checker.png';\n"
+                   "local paths = {path, 'not_found.png', path, path};\n"
+                   "local batch = SDL_image.loadMany(paths);\n"
+                   "local seen = {};\n"
+                   "for i, surface, err in batch.next, batch do\n"
+                   "  assert(not seen[i]);\n"
+                   "  seen[i] = true;\n"
+                   "  if i == 2 then\n"
+                   "    assert(surface == nil and type(err) == 'string');\n"
+                   "  else\n"
+                   "    assert(surface:getInfo().w == 1024);\n"
+                   "  end\n"
+                   "end\n"
+                   "assert(#seen == 4 and batch:getRemaining() == 0);\n"
+                   "assert(batch:poll() == nil);\n"
+                   "local future = SDL_image.loadAsync(path);\n"
+                   "local surface = future:wait();\n"
+                   "assert(future:isReady() and future:wait() == surface);\n"
+                   "local failed, err = SDL_image.loadAsync('x.png'):wait();\n"
+                   "assert(failed == nil and type(err) == 'string');\n"
+                   "SDL_image.loadMany(paths);\n"
+                   "collectgarbage();\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, ToGLFormatTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL = require('sdl2');\n"
+                   "local GL = require('opengl');\n"
+                   "local SDL_image = require('sdl2_image');\n"
+                   "local image = "
+                   "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+                   "local rgb, format, type, alignment = "
+                   "image:toGLFormat(GL.RGB);\n"
+                   "assert(format == GL.RGB and type == GL.UNSIGNED_BYTE);\n"
+                   "local info = rgb:getInfo();\n"
+                   "assert(info.pitch == info.w * 3 and alignment >= 4);\n"
+                   "assert(info.format.BytesPerPixel == 3);\n"
+                   "local rgba, format = rgb:toGLFormat();\n"
+                   "assert(format == GL.RGBA);\n"
+                   "assert(rgba:getInfo().format.format == "
+                   "SDL.PIXELFORMAT_ABGR8888);\n"
+                   "assert(not pcall(image.toGLFormat, image, GL.RED));\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, GenerateMipmapsTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local image = "
+                   "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+                   "local chain = image:generateMipmaps();\n"
+                   "assert(#chain == 11 and chain[1] == image);\n"
+                   "assert(chain[2]:getInfo().w == 512);\n"
+                   "assert(chain[11]:getInfo().w == 1);\n"
+                   "chain = image:generateMipmaps({filter = 'lanczos', "
+                   "srgb = false, levels = 2});\n"
+                   "assert(#chain == 3 and chain[3]:getInfo().h == 256);\n"
+                   "assert(not pcall(image.generateMipmaps, image, "
+                   "{filter = 'cubic'}));\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, AtlasTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local image = "
+                   "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+                   "local chain = image:generateMipmaps({levels = 6});\n"
+                   "local atlas = SDL_image.newAtlas(512, 512, "
+                   "{padding = 2, extrude = 1});\n"
+                   "local rects = atlas:addMany({chain[6], chain[4], "
+                   "chain[5]});\n"
+                   "assert(#rects == 3 and rects[2].w == 128);\n"
+                   "assert(rects[2].x == 1 and rects[2].y == 1);\n"
+                   "assert(rects[2].u1 == 129 / 512);\n"
+                   "local rect = atlas:add(chain[3]);\n"
+                   "assert(rect.page == 1 and rect.w == 256);\n"
+                   "assert(atlas:getPageCount() == 1);\n"
+                   "rect = atlas:add(chain[3]);\n"
+                   "assert(rect.page == 2 and atlas:getPageCount() == 2);\n"
+                   "assert(atlas:getPage(1):getInfo().w == 512);\n"
+                   "assert(not pcall(atlas.add, atlas, image));\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, CompressTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local image = "
+                   "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+                   "local level = image:generateMipmaps({levels = 2})[3];\n"
+                   "assert(#level:compress('bc1') == 256 * 256 / 2);\n"
+                   "assert(#level:compress('bc3') == 256 * 256);\n"
+                   "assert(#level:compress('bc7', {quality = 'fast'}) == "
+                   "256 * 256);\n"
+                   "assert(#level:compress('etc2') == 256 * 256 / 2);\n"
+                   "assert(#level:compress('etc2_eac') == 256 * 256);\n"
+                   "assert(not pcall(level.compress, level, 'astc'));\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, LoadCachedTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  const auto directory =
+      std::filesystem::temp_directory_path() / "hello_load_cached_test";
+  std::filesystem::remove_all(directory);
+  ASSERT_TRUE(std::filesystem::create_directory(directory));
+  lua_pushstring(L, directory.string().c_str());
+  lua_setglobal(L, "directory");
+
+  const auto result = utils::dostring(
+      L, "local SDL_image = require('sdl2_image');\n"
+         "local GL = require('opengl');\n"
+         "local path = '../../hello_host/assets/uv_checker.png';\n"
+         "local cold, hit = SDL_image.loadCached(path, directory, GL.RGB);\n"
+         "assert(hit == false, 'cold load hit the cache');\n"
+         "local warm, hit = SDL_image.loadCached(path, directory, GL.RGB);\n"
+         "assert(hit == true, 'warm load missed the cache');\n"
+         "assert(cold:getInfo().format.BytesPerPixel == 3);\n"
+         "assert(warm:getInfo().w == 1024);\n"
+         "assert(warm:getInfo().pitch == cold:getInfo().pitch);\n"
+         "warm:flipVertical();\n"
+         "local view = warm:view(0, 0, 8, 8);\n"
+         "warm:free();\n"
+         "warm = nil;\n"
+         "collectgarbage();\n"
+         "assert(view:toGLFormat():getInfo().w == 8);\n"
+         "assert(not SDL_image.loadCached('missing.png', directory));\n");
+  const std::string message = result == LUA_OK ? "" : lua_tostring(L, -1);
+
+  size_t entries = 0;
+  for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+    entries += entry.path().extension() == ".pxc" ? 1 : 0;
+  }
+  std::filesystem::remove_all(directory);
+  ASSERT_EQ(LUA_OK, result) << message;
+  ASSERT_EQ(entries, 1u);
+}
+
+TEST_F(LuaSDL2_Test, SurfaceCacheTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local cache = SDL_image.newCache(8 * 1024 * 1024);\n"
+                   "local path = '../../hello_host/assets/uv_checker.png';\n"
+                   "local a = cache:load(path);\n"
+                   "local b = cache:load(path);\n"
+                   "local c = cache:load("
+                   "'../../hello_host/assets/../assets/uv_checker.png');\n"
+                   "local stats = cache:getStats();\n"
+                   "assert(stats.misses == 1 and stats.hits == 2);\n"
+                   "assert(stats.count == 1);\n"
+                   "assert(stats.bytes == 1024 * 1024 * 4);\n"
+                   "cache:setBudget(0);\n"
+                   "stats = cache:getStats();\n"
+                   "assert(stats.evictions == 1 and stats.bytes == 0);\n"
+                   "assert(a:getInfo().w == 1024 and c:getInfo().w == 1024);\n"
+                   "b:free();\n"
+                   "assert(cache:load('missing.png') == nil);\n"
+                   "assert(cache:getStats().misses == 1);\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, SurfaceViewTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local image = "
+                   "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+                   "local view = image:view(64, 32, 128, 96);\n"
+                   "local info = view:getInfo();\n"
+                   "assert(info.w == 128 and info.h == 96);\n"
+                   "assert(info.pitch == image:getInfo().pitch);\n"
+                   "local inner = view:view(8, 8, 16, 16);\n"
+                   "view:flipVertical();\n"
+                   "image:free();\n"
+                   "collectgarbage();\n"
+                   "assert(inner:getInfo().w == 16);\n"
+                   "assert(view:toGLFormat():getInfo().w == 128);\n"
+                   "assert(not pcall(view.view, view, 100, 0, 29, 1));\n"
+                   "assert(not pcall(view.view, view, 0, 0, 0, 1));\n"))
+      << lua_tostring(L, -1);
+}
+
+TEST_F(LuaSDL2_Test, QOITest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  const auto path = std::filesystem::temp_directory_path() / "hello_test.qoi";
+  lua_pushstring(L, path.string().c_str());
+  lua_setglobal(L, "path");
+
+  const auto result = utils::dostring(
+      L, "local SDL_image = require('sdl2_image');\n"
+         "local image = "
+         "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+         "assert(image:saveQOI(path));\n"
+         "local qoi = SDL_image.load(path);\n"
+         "local info = qoi:getInfo();\n"
+         "assert(info.w == 1024 and info.h == 1024);\n"
+         "assert(info.format.BytesPerPixel == 4);\n"
+         "local file = io.open(path, 'rb');\n"
+         "local data = file:read('a');\n"
+         "file:close();\n"
+         "local decoded = SDL_image.loadFromString(data);\n"
+         "assert(decoded:getInfo().w == 1024);\n"
+         "assert(SDL_image.loadFromStringInto(data, decoded) == decoded);\n"
+         "local part = decoded:view(0, 0, 8, 8);\n"
+         "assert(SDL_image.loadFromStringInto(data, part) == nil);\n"
+         "assert(not pcall(SDL_image.loadFromString, decoded));\n"
+         "local cut = data:sub(1, 100);\n"
+         "assert(SDL_image.loadFromString(cut) == nil);\n"
+         "assert(not image:view(0, 0, 8, 8):toGLFormat()"
+         ":saveQOI('missing/test.qoi'));\n");
+  const std::string message = result == LUA_OK ? "" : lua_tostring(L, -1);
+  std::filesystem::remove(path);
+  ASSERT_EQ(LUA_OK, result) << message;
+}
+
+TEST_F(LuaSDL2_Test, LoadTGATest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  // TGA has no signature, so only the extension tells SDL_image the type
+  const auto path = std::filesystem::temp_directory_path() / "hello_test.tga";
+  {
+    const unsigned char tga[18 + 2 * 2 * 3] = {0, 0, 2, 0, 0, 0, 0, 0,  0,
+                                               0, 0, 0, 2, 0, 2, 0, 24, 0};
+    std::ofstream stream(path, std::ios::binary);
+    stream.write(reinterpret_cast<const char *>(tga), sizeof(tga));
+  }
+  lua_pushstring(L, path.string().c_str());
+  lua_setglobal(L, "path");
+
+  const auto result = utils::dostring(
+      L, "local SDL_image = require('sdl2_image');\n"
+         "local image = SDL_image.load(path);\n"
+         "assert(image and image:getInfo().w == 2);\n"
+         "local cache = SDL_image.newCache(1024);\n"
+         "assert(cache:load(path):getInfo().h == 2);\n");
+  const std::string message = result == LUA_OK ? "" : lua_tostring(L, -1);
+  std::filesystem::remove(path);
+  ASSERT_EQ(LUA_OK, result) << message;
+}
+
+TEST_F(LuaSDL2_Test, LazyLoadTest) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(LUA_OK,
+            utils::dostring(
+                L, "local SDL_image = require('sdl2_image');\n"
+                   "local path = '../../hello_host/assets/uv_checker.png';\n"
+                   "local probe = SDL_image.probe(path);\n"
+                   "assert(probe.type == 'png' and probe.channels == 4);\n"
+                   "assert(probe.w == 1024 and probe.h == 1024);\n"
+                   "assert(SDL_image.probe('missing.png') == nil);\n"
+                   "local lazy = SDL_image.loadLazy(path);\n"
+                   "local before = lazy:getInfo();\n"
+                   "assert(not lazy:isLoaded());\n"
+                   "assert(before.w == 1024 and before.pitch == 4096);\n"
+                   "lazy:flipVertical();\n"
+                   "assert(lazy:isLoaded());\n"
+                   "local after = lazy:getInfo();\n"
+                   "assert(after.format.format == before.format.format);\n"
+                   "SDL_image.loadLazy(path):free();\n"
+                   "local view = SDL_image.loadLazy(path):view(0, 0, 8, 8);\n"
+                   "assert(view:getInfo().w == 8);\n"))
+      << lua_tostring(L, -1);
+}
@@ -9,6 +9,7 @@ TEST_F(LuaSDL2_Test, TestSDLConstants) {
   TEST_LUA_CONSTANT("sdl2", "WINDOW_HIDDEN", SDL_WINDOW_HIDDEN);
   TEST_LUA_CONSTANT("sdl2", "WINDOWPOS_UNDEFINED", SDL_WINDOWPOS_UNDEFINED);
   TEST_LUA_CONSTANT("sdl2", "RENDERER_ACCELERATED", SDL_RENDERER_ACCELERATED);
+  TEST_LUA_CONSTANT("sdl2", "RENDERER_SOFTWARE", SDL_RENDERER_SOFTWARE);
   TEST_LUA_CONSTANT("sdl2", "QUIT", SDL_QUIT);
   TEST_LUA_CONSTANT("sdl2", "GL_CONTEXT_FLAGS", SDL_GL_CONTEXT_FLAGS);
   TEST_LUA_CONSTANT("sdl2", "GL_CONTEXT_PROFILE_MASK",
@@ -30,6 +31,29 @@ TEST_F(LuaSDL2_Test, TestGetError) {
       << "GetError did not return string: " << lua_typename(L, -1);
 }
 
+TEST_F(LuaSDL2_Test, TestSetHint) {
+  ASSERT_EQ(
+      utils::dostring(L, "local SDL = require('sdl2');"
+                         "assert(type(SDL.HINT_VIDEODRIVER) == 'string');"
+                         "return SDL.SetHint('SDL_HELLO_TEST_HINT', '1');"),
+      LUA_OK)
+      << lua_tostring(L, -1);
+  ASSERT_TRUE(lua_toboolean(L, -1));
+}
+
+TEST_F(LuaSDL2_Test, TestGetCurrentVideoDriver) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  ASSERT_EQ(utils::dostring(L, "local SDL = require('sdl2');"
+                               "return SDL.GetCurrentVideoDriver();"),
+            LUA_OK)
+      << lua_tostring(L, -1);
+  ASSERT_TRUE(lua_isstring(L, -1))
+      << "GetCurrentVideoDriver did not return string: "
+      << lua_typename(L, lua_type(L, -1));
+}
+
 TEST_F(LuaSDL2_Test, CreateWindow) {
 #if defined(__EMSCRIPTEN__)
   GTEST_SKIP() << "Not work for Emscripten";
@@ -109,6 +133,74 @@ TEST_F(LuaSDL2_Test, DestroyRenderer) {
   this->renderer = nullptr;
 }
 
+TEST_F(LuaSDL2_Test, TestSpriteBatch) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  initWindow();
+  initRenderer();
+  luaL_loadstring(
+      L, "local SDL = require('sdl2');\n"
+         "local SDL_image = require('sdl2_image');\n"
+         "local renderer = ...;\n"
+         "local surface = "
+         "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+         "local a = SDL.CreateTextureFromSurface(renderer, surface);\n"
+         "local b = SDL.CreateTextureFromSurface(renderer, surface);\n"
+         "assert(a ~= nil and b ~= nil, SDL.GetError());\n"
+         "local batch = SDL.CreateSpriteBatch(renderer);\n"
+         "batch:add(a, 0, 0, 16, 16);\n"
+         "batch:setColor(255, 0, 0);\n"
+         "batch:add(b, 16, 0, 16, 16, 0, 0, 0.5, 0.5);\n"
+         "assert(batch:addQuads(a, {32, 0, 16, 16, 0, 0, 1, 1}) == 1);\n"
+         "local packed = string.pack('ffffffff', 48, 0, 16, 16, 0, 0, 1, 1)"
+         ";\n"
+         "assert(batch:addQuads(b, packed:rep(2)) == 2);\n"
+         "assert(batch:getCount() == 5);\n"
+         "SDL.SetRenderDrawColor(renderer, 0, 0, 0);\n"
+         "SDL.RenderClear(renderer);\n"
+         "local sorted = batch:flush(true);\n"
+         "assert(batch:getCount() == 0);\n"
+         "batch:add(a, 0, 0, 16, 16);\n"
+         "batch:add(b, 0, 0, 16, 16);\n"
+         "batch:add(a, 0, 0, 16, 16);\n"
+         "local unsorted = batch:flush();\n"
+         "assert(not pcall(batch.addQuads, batch, a, {0, 0, 16, 16, 0, 0, "
+         "1, 'x'}));\n"
+         "assert(batch:getCount() == 0);\n"
+         "batch:add(a, 0, 0, 16, 16);\n"
+         "batch:add(b, 0, 0, 16, 16);\n"
+         "SDL.DestroyTexture(a);\n"
+         "local dropped = batch:flush();\n"
+         "SDL.RenderPresent(renderer);\n"
+         "SDL.DestroyTexture(b);\n"
+         "return sorted, unsorted, dropped;\n");
+  pushRenderer();
+  ASSERT_EQ(utils::docall(L, 1), LUA_OK) << lua_tostring(L, -1);
+  ASSERT_EQ(lua_tointeger(L, -3), 2);
+  ASSERT_EQ(lua_tointeger(L, -2), 3);
+  ASSERT_EQ(lua_tointeger(L, -1), 1);
+}
+
+TEST_F(LuaSDL2_Test, TestFailedToAddDestroyedTexture) {
+#if defined(__EMSCRIPTEN__)
+  GTEST_SKIP() << "Not work for Emscripten";
+#endif
+  initWindow();
+  initRenderer();
+  luaL_loadstring(
+      L, "local SDL = require('sdl2');\n"
+         "local SDL_image = require('sdl2_image');\n"
+         "local renderer = ...;\n"
+         "local surface = "
+         "SDL_image.load('../../hello_host/assets/uv_checker.png');\n"
+         "local texture = SDL.CreateTextureFromSurface(renderer, surface);\n"
+         "SDL.DestroyTexture(texture);\n"
+         "SDL.CreateSpriteBatch(renderer):add(texture, 0, 0, 16, 16);\n");
+  pushRenderer();
+  ASSERT_NE(utils::docall(L, 1), LUA_OK);
+}
+
 TEST_F(LuaSDL2_Test, TestPollEvent) {
 #if defined(__EMSCRIPTEN__)
   GTEST_SKIP() << "Not work for Emscripten";
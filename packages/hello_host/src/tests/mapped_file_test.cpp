@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include "../core/mapped_file.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace hello;
+
+namespace {
+std::string readAll(const std::string &path) {
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), {});
+}
+} // namespace
+
+TEST(MappedFile_Test, MapsWholeFile) {
+  const std::string path = "mapped_file_test.bin";
+  {
+    std::ofstream stream(path, std::ios::binary);
+    stream << "hello mapped file";
+  }
+
+  auto file = MappedFile::open(path);
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->getSize(), 17u);
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(file->getData()), 5),
+            "hello");
+
+  // writes are private to the process
+  file->getData()[0] = 'j';
+  EXPECT_EQ(file->getData()[0], 'j');
+  EXPECT_EQ(readAll(path), "hello mapped file");
+
+  file.reset();
+  std::remove(path.c_str());
+}
+
+TEST(MappedFile_Test, MissingAndEmptyFilesFail) {
+  EXPECT_EQ(MappedFile::open("does_not_exist.bin"), nullptr);
+
+  const std::string path = "mapped_file_empty.bin";
+  { std::ofstream stream(path, std::ios::binary); }
+  EXPECT_EQ(MappedFile::open(path), nullptr);
+  std::remove(path.c_str());
+}
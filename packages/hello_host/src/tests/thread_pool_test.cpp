@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include "../core/thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace hello;
+
+TEST(ThreadPool_Test, ParallelForVisitsEveryIndexOnce) {
+  std::vector<std::atomic<int>> visits(1000);
+  thread_pool::parallelFor(10, 1010, [&visits](int i) { ++visits[i - 10]; });
+  for (auto &v : visits) {
+    ASSERT_EQ(v.load(), 1);
+  }
+}
+
+TEST(ThreadPool_Test, ParallelForEmptyRange) {
+  auto called = false;
+  thread_pool::parallelFor(5, 5, [&called](int) { called = true; });
+  ASSERT_FALSE(called);
+}
+
+TEST(ThreadPool_Test, NestedParallelFor) {
+  std::atomic<int> total(0);
+  thread_pool::parallelFor(0, 16, [&total](int) {
+    thread_pool::parallelFor(0, 16, [&total](int) { ++total; });
+  });
+  ASSERT_EQ(total.load(), 256);
+}
+
+TEST(ThreadPool_Test, Submit) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  int done = 0;
+  for (int i = 0; i < 64; ++i) {
+    thread_pool::submit([&] {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++done;
+      cv.notify_all();
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&done] { return done == 64; });
+  ASSERT_EQ(done, 64);
+}
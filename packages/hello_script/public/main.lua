@@ -126,9 +126,8 @@ end
 SDL.GL_MakeCurrent(window, context)
 SDL.GL_SetSwapInterval(1)
 
-if not utils.isEmscripten() then
-    GL.loadGLLoader()
-end
+-- also loads the entry points past GL 3.0 / GLES3, on every platform
+GL.loadGLLoader()
 
 --- @type string[]
 local points = {}
@@ -260,6 +259,43 @@ GL.bindRenderbuffer(GL.RENDERBUFFER, renderbuffer);
 GL.bindFramebuffer(GL.FRAMEBUFFER, framebuffer);
 GL.bindTexture(GL.TEXTURE_2D, texBackBuffer);
 
+-- the frame never changes, so its passes are recorded once and replayed by
+-- GL.execute without crossing into Lua for every call
+local offscreenCommands = GL.newCommandList()
+offscreenCommands:bindFramebuffer(GL.FRAMEBUFFER, framebuffer)
+offscreenCommands:viewport(0, 0, bufferWidth, bufferHeight)
+offscreenCommands:clearColor(0.5, 0.5, 0.5, 1.0)
+offscreenCommands:clear(GL.COLOR_BUFFER_BIT | GL.DEPTH_BUFFER_BIT)
+offscreenCommands:useProgram(program)
+offscreenCommands:bindVertexArray(vao)
+offscreenCommands:activateTexture(GL.TEXTURE0)
+offscreenCommands:bindTexture(GL.TEXTURE_2D, texImage)
+offscreenCommands:uniform1i(0, 0)
+offscreenCommands:drawElements(GL.TRIANGLES, #indices // 2, GL.UNSIGNED_SHORT)
+offscreenCommands:bindVertexArray(0)
+
+local presentCommands = GL.newCommandList()
+presentCommands:bindFramebuffer(GL.FRAMEBUFFER, 0)
+presentCommands:viewport(0, 0, windowWidth, windowHeight)
+presentCommands:useProgram(program)
+presentCommands:bindVertexArray(vao)
+presentCommands:activateTexture(GL.TEXTURE0)
+presentCommands:bindTexture(GL.TEXTURE_2D, texBackBuffer)
+presentCommands:uniform1i(0, 0)
+presentCommands:drawElements(GL.TRIANGLES, #indices // 2, GL.UNSIGNED_SHORT)
+presentCommands:bindVertexArray(0)
+
+-- GPU time of each pass, reported every few seconds
+local gpuTimer = GL.newGpuTimer()
+local frameCount = 0
+
+local function reportGpuTimes()
+    for _, time in ipairs(gpuTimer:getTimes()) do
+        print(("gpu %s: %.3f ms (last %.3f ms)"):format(time.name,
+            time.average, time.last))
+    end
+end
+
 local function update()
     local events = collectEvents()
     for _, ev in ipairs(events) do
@@ -273,30 +309,21 @@ local function update()
     end
 
 
-    GL.bindFramebuffer(GL.FRAMEBUFFER, framebuffer);
-    GL.viewport(0, 0, bufferWidth, bufferHeight)
-    local clearColor = { 0.5, 0.5, 0.5, 1.0 }
-    GL.clearColor(table.unpack(clearColor))
-    GL.clear(GL.COLOR_BUFFER_BIT | GL.DEPTH_BUFFER_BIT)
-    GL.useProgram(program)
-    GL.bindVertexArray(vao);
-    GL.activateTexture(GL.TEXTURE0);
-    GL.bindTexture(GL.TEXTURE_2D, texImage);
-    GL.uniform1i(0, 0);
-    GL.drawElements(GL.TRIANGLES, #indices / 2, GL.UNSIGNED_SHORT)
-    GL.bindVertexArray(0);
-
-    GL.bindFramebuffer(GL.FRAMEBUFFER, 0);
-    GL.viewport(0, 0, windowWidth, windowHeight)
-    GL.useProgram(program)
-    GL.bindVertexArray(vao);
-    GL.activateTexture(GL.TEXTURE0);
-    GL.bindTexture(GL.TEXTURE_2D, texBackBuffer);
-    GL.uniform1i(0, 0);
-    GL.drawElements(GL.TRIANGLES, #indices / 2, GL.UNSIGNED_SHORT)
-    GL.bindVertexArray(0);
+    local timed = gpuTimer:beginPass("offscreen")
+    GL.execute(offscreenCommands)
+    if timed then gpuTimer:endPass() end
+
+    timed = gpuTimer:beginPass("present")
+    GL.execute(presentCommands)
+    if timed then gpuTimer:endPass() end
 
     SDL.GL_SwapWindow(window)
+
+    gpuTimer:collect()
+    frameCount = frameCount + 1
+    if frameCount % 300 == 0 then
+        reportGpuTimes()
+    end
 end
 
 local function finalize()
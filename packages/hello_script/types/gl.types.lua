@@ -128,6 +128,11 @@
 --- @field RGB5_A1 32855
 --- @field RGBA8 32856
 --- @field RGB10_A2 32857
+--- @field COMPRESSED_RGB_S3TC_DXT1_EXT 33776
+--- @field COMPRESSED_RGBA_S3TC_DXT5_EXT 33779
+--- @field COMPRESSED_RGBA_BPTC_UNORM 36492
+--- @field COMPRESSED_RGB8_ETC2 37492
+--- @field COMPRESSED_RGBA8_ETC2_EAC 37496
 --- @field UNSIGNED_SHORT_4_4_4_4 32819
 --- @field UNSIGNED_SHORT_5_5_5_1 32820
 --- @field TEXTURE_BINDING_3D 32874
@@ -224,6 +229,9 @@
 --- @field CURRENT_QUERY 34917
 --- @field QUERY_RESULT 34918
 --- @field QUERY_RESULT_AVAILABLE 34919
+--- @field TIME_ELAPSED 35007
+--- @field TIMESTAMP 36392
+--- @field GPU_DISJOINT 36795
 --- @field ARRAY_BUFFER 34962
 --- @field ELEMENT_ARRAY_BUFFER 34963
 --- @field ARRAY_BUFFER_BINDING 34964
@@ -317,6 +325,15 @@
 --- @field PIXEL_UNPACK_BUFFER 35052
 --- @field PIXEL_PACK_BUFFER_BINDING 35053
 --- @field PIXEL_UNPACK_BUFFER_BINDING 35055
+--- @field COPY_READ_BUFFER 36662
+--- @field COPY_WRITE_BUFFER 36663
+--- @field DRAW_INDIRECT_BUFFER 36671
+--- @field DRAW_INDIRECT_BUFFER_BINDING 36675
+--- @field UNIFORM_BUFFER 35345
+--- @field UNIFORM_BUFFER_BINDING 35368
+--- @field MAX_UNIFORM_BUFFER_BINDINGS 35375
+--- @field MAX_UNIFORM_BLOCK_SIZE 35376
+--- @field UNIFORM_BUFFER_OFFSET_ALIGNMENT 35380
 --- @field FLOAT_MAT2x3 35685
 --- @field FLOAT_MAT2x4 35686
 --- @field FLOAT_MAT3x2 35687
@@ -509,15 +526,47 @@
 --- @field texParameteri fun(target: integer, pname: integer, pvalue: integer)
 --- @field bindBuffer fun(target: integer, buffer: integer): integer
 --- @field bufferData fun(target: integer, buffer: Buffer, usage: integer)
+--- @field bufferSubData fun(target: integer, offset: integer, data: Buffer|GL_InstanceData|GL_UniformBlock|GL_DrawList|SDL_Surface, dataOffset: integer?, size: integer?)
+--- @field copyBufferSubData fun(readTarget: integer, writeTarget: integer, readOffset: integer, writeOffset: integer, size: integer)
+--- @field bindBufferBase fun(target: integer, index: integer, buffer: integer)
+--- @field bindBufferRange fun(target: integer, index: integer, buffer: integer, offset: integer, size: integer)
 --- @field genVertexArray fun(): integer
---- @field drawElements fun(mode: integer, count: integer, type: integer)
+--- @field drawElements fun(mode: integer, count: integer, type: integer, offset: integer?)
+--- @field drawElementsBaseVertex fun(mode: integer, count: integer, type: integer, offset: integer, baseVertex: integer)
+--- @field drawArraysInstanced fun(mode: integer, first: integer, count: integer, instanceCount: integer)
+--- @field drawElementsInstanced fun(mode: integer, count: integer, type: integer, offset: integer, instanceCount: integer)
+--- @field vertexAttribDivisor fun(index: integer, divisor: integer)
+--- @field multiDrawArrays fun(mode: integer, firsts: integer[], counts: integer[])
+--- @field multiDrawElements fun(mode: integer, counts: integer[], type: integer, offsets: integer[])
+--- @field drawArraysIndirect fun(mode: integer, offset: integer?)
+--- @field drawElementsIndirect fun(mode: integer, type: integer, offset: integer?)
+--- @field multiDrawArraysIndirect fun(mode: integer, offset: integer, drawCount: integer, stride: integer?)
+--- @field multiDrawElementsIndirect fun(mode: integer, type: integer, offset: integer, drawCount: integer, stride: integer?)
 --- @field bindVertexArray fun(buffer: integer)
 --- @field enableVertexAttribArray fun(index: integer)
 --- @field vertexAttribPointer fun(index: integer, size: integer, type: integer, normalized: integer, stride: integer)
 --- @field uniform1i fun(location: integer, v0: integer)
+--- @field uniform1f fun(location: integer, v0: number)
+--- @field uniform2f fun(location: integer, v0: number, v1: number)
+--- @field uniform3f fun(location: integer, v0: number, v1: number, v2: number)
+--- @field uniform4f fun(location: integer, v0: number, v1: number, v2: number, v3: number)
+--- @field getUniformBlockIndex fun(program: integer, name: string): integer?
+--- @field uniformBlockBinding fun(program: integer, blockIndex: integer, binding: integer)
+--- @field getInteger fun(pname: integer): integer
+--- @field flush fun()
+--- @field finish fun()
+--- @field genQuery fun(): integer
+--- @field deleteQuery fun(query: integer)
+--- @field beginQuery fun(target: integer, query: integer)
+--- @field endQuery fun(target: integer)
+--- @field queryCounter fun(query: integer, target: integer)
+--- @field getQueryObjectuiv fun(query: integer, pname: integer): integer
+--- @field getQueryObjectui64v fun(query: integer, pname: integer): integer
 --- @field loadGLLoader fun()
 --- @field genTexture fun(): integer
 --- @field texImage2D fun(target: integer, level: integer, internalformat: integer, width: integer, height: integer, border: integer, format: integer, type: integer, pixels: Buffer)
+--- @field texSubImage2D fun(target: integer, level: integer, xoffset: integer, yoffset: integer, width: integer, height: integer, format: integer, type: integer, pixels: Buffer|SDL_Surface)
+--- @field compressedTexImage2D fun(target: integer, level: integer, internalformat: integer, width: integer, height: integer, border: integer, data: string)
 --- @field bindTexture fun(target: integer, texture: integer)
 --- @field activateTexture fun(texture: integer)
 --- @field deleteTexture fun(texture: integer)
@@ -529,6 +578,144 @@
 --- @field deleteRenderbuffer fun(renderbuffer: integer)
 --- @field bindRenderbuffer fun(target: integer, buffer: integer)
 --- @field framebufferTexture2D fun(target: integer, attachment: integer, textarget: integer, texture: integer, level: integer)
+--- @field checkFramebufferStatus fun(target: integer): integer
+--- @field readPixels fun(x: integer, y: integer, width: integer, height: integer, format: integer, type: integer, offset: integer?): string?
+--- @field getBufferSubData fun(target: integer, offset: integer, size: integer): string
+--- @field newCommandList fun(): GL_CommandList
+--- @field execute fun(list: GL_CommandList)
+--- @field invalidateState fun()
+--- @field getStateStats fun(): GL_StateStats
+--- @field resetStateStats fun()
+--- @field newStreamBuffer fun(size: integer, target: integer?): GL_StreamBuffer
+--- @field getExtensions fun(): GL_Extensions
+--- @field newInstanceData fun(components: integer): GL_InstanceData
+--- @field newUniformLayout fun(members: [string, integer, integer?][]): GL_UniformLayout
+--- @field getUniformBlockLayout fun(program: integer, name: string): GL_UniformLayout?
+--- @field newGpuTimer fun(maxPending: integer?, window: integer?): GL_GpuTimer
+--- @field newDrawList fun(draws: GL_Draw[]?): GL_DrawList
+--- @field newReadback fun(count: integer?, encoding: "raw"|"qoi"|nil): GL_Readback
+
+--- @class GL_Extensions
+--- @field sync boolean
+--- @field bufferStorage boolean
+--- @field copyBuffer boolean
+--- @field baseVertex boolean
+--- @field instancing boolean
+--- @field uniformBuffer boolean
+--- @field timerQuery boolean
+--- @field drawIndirect boolean
+--- @field multiDrawIndirect boolean
+
+--- @class GL_StateStats
+--- @field forwarded integer
+--- @field filtered integer
+
+--- @class GL_CommandList
+--- @field clearColor fun(self: GL_CommandList, r: number, g: number, b: number, a: number)
+--- @field clearDepth fun(self: GL_CommandList, depth: number)
+--- @field clear fun(self: GL_CommandList, mask: integer)
+--- @field viewport fun(self: GL_CommandList, x: integer, y: integer, width: integer, height: integer)
+--- @field bindFramebuffer fun(self: GL_CommandList, target: integer, framebuffer: integer)
+--- @field bindBuffer fun(self: GL_CommandList, target: integer, buffer: integer)
+--- @field bindVertexArray fun(self: GL_CommandList, array: integer)
+--- @field useProgram fun(self: GL_CommandList, program: integer)
+--- @field activateTexture fun(self: GL_CommandList, texture: integer)
+--- @field bindTexture fun(self: GL_CommandList, target: integer, texture: integer)
+--- @field uniform1i fun(self: GL_CommandList, location: integer, v0: integer)
+--- @field uniform1f fun(self: GL_CommandList, location: integer, v0: number)
+--- @field uniform2f fun(self: GL_CommandList, location: integer, v0: number, v1: number)
+--- @field uniform3f fun(self: GL_CommandList, location: integer, v0: number, v1: number, v2: number)
+--- @field uniform4f fun(self: GL_CommandList, location: integer, v0: number, v1: number, v2: number, v3: number)
+--- @field drawArrays fun(self: GL_CommandList, mode: integer, first: integer, count: integer)
+--- @field drawElements fun(self: GL_CommandList, mode: integer, count: integer, type: integer, offset: integer?)
+--- @field reset fun(self: GL_CommandList)
+--- @field getCommandCount fun(self: GL_CommandList): integer
+--- @field getByteSize fun(self: GL_CommandList): integer
+
+--- @class GL_StreamBuffer
+--- @field write fun(self: GL_StreamBuffer, data: Buffer|GL_InstanceData|GL_UniformBlock|GL_DrawList|SDL_Surface, alignment: integer?): integer?, string?
+--- @field fence fun(self: GL_StreamBuffer)
+--- @field getBuffer fun(self: GL_StreamBuffer): integer
+--- @field getSize fun(self: GL_StreamBuffer): integer
+--- @field isPersistent fun(self: GL_StreamBuffer): boolean
+--- @field free fun(self: GL_StreamBuffer)
+
+--- @class GL_InstanceData
+--- @field add fun(self: GL_InstanceData, ...: number): integer
+--- @field set fun(self: GL_InstanceData, index: integer, component: integer, ...: number)
+--- @field setTransform fun(self: GL_InstanceData, index: integer, component: integer, x: number, y: number, z: number, qx: number?, qy: number?, qz: number?, qw: number?, sx: number?, sy: number?, sz: number?)
+--- @field resize fun(self: GL_InstanceData, count: integer)
+--- @field clear fun(self: GL_InstanceData)
+--- @field getCount fun(self: GL_InstanceData): integer
+--- @field getComponents fun(self: GL_InstanceData): integer
+--- @field getStride fun(self: GL_InstanceData): integer
+--- @field getByteSize fun(self: GL_InstanceData): integer
+--- @field upload fun(self: GL_InstanceData, target: integer, usage: integer?)
+--- @field free fun(self: GL_InstanceData)
+
+--- @class GL_UniformLayout
+--- @field getSize fun(self: GL_UniformLayout): integer
+--- @field getOffset fun(self: GL_UniformLayout, name: string): integer?
+--- @field newBlock fun(self: GL_UniformLayout): GL_UniformBlock
+--- @field free fun(self: GL_UniformLayout)
+
+--- @class GL_UniformBlock
+--- @field set fun(self: GL_UniformBlock, name: string, ...: number)
+--- @field setElement fun(self: GL_UniformBlock, name: string, element: integer, ...: number)
+--- @field getSize fun(self: GL_UniformBlock): integer
+--- @field upload fun(self: GL_UniformBlock, target: integer, usage: integer?)
+--- @field free fun(self: GL_UniformBlock)
+
+--- @class GL_PassTime
+--- @field name string
+--- @field last number
+--- @field average number
+--- @field samples integer
+
+--- @class GL_GpuTimer
+--- @field beginPass fun(self: GL_GpuTimer, name: string): boolean
+--- @field endPass fun(self: GL_GpuTimer)
+--- @field collect fun(self: GL_GpuTimer)
+--- @field reset fun(self: GL_GpuTimer)
+--- @field getPendingCount fun(self: GL_GpuTimer): integer
+--- @field getTimes fun(self: GL_GpuTimer): GL_PassTime[]
+--- @field free fun(self: GL_GpuTimer)
+
+--- @class GL_Draw
+--- @field [1] integer count
+--- @field [2] integer firstIndex
+--- @field [3] integer? baseVertex
+--- @field [4] integer? instanceCount
+--- @field bounds [number, number, number, number]?
+
+--- @class GL_DrawList
+--- @field add fun(self: GL_DrawList, count: integer, firstIndex: integer, baseVertex: integer?, instanceCount: integer?, baseInstance: integer?): integer
+--- @field setBounds fun(self: GL_DrawList, index: integer, x: number, y: number, z: number, radius: number)
+--- @field build fun(self: GL_DrawList, viewProjection: number[]?): integer
+--- @field draw fun(self: GL_DrawList, mode: integer, type: integer)
+--- @field clear fun(self: GL_DrawList)
+--- @field getCount fun(self: GL_DrawList): integer
+--- @field getDrawCount fun(self: GL_DrawList): integer
+--- @field getStride fun(self: GL_DrawList): integer
+--- @field getByteSize fun(self: GL_DrawList): integer
+--- @field upload fun(self: GL_DrawList, target: integer, usage: integer?)
+--- @field free fun(self: GL_DrawList)
+
+--- @class GL_ReadbackInfo
+--- @field id integer
+--- @field x integer
+--- @field y integer
+--- @field width integer
+--- @field height integer
+--- @field format integer
+--- @field type integer
+
+--- @class GL_Readback
+--- @field read fun(self: GL_Readback, x: integer, y: integer, width: integer, height: integer, format: integer?, type: integer?): integer?, string?
+--- @field collect fun(self: GL_Readback, fn: fun(pixels: string, info: GL_ReadbackInfo)): integer, string?
+--- @field getCount fun(self: GL_Readback): integer
+--- @field getPendingCount fun(self: GL_Readback): integer
+--- @field free fun(self: GL_Readback)
 
 --- @type gl
 local gl = require("opengl");
@@ -1,2 +1,22 @@
 --- @class SDL
 --- @field PIXELFORMAT_ABGR8888 376840196
+--- @field HINT_VIDEODRIVER string
+--- @field SetHint fun(name: string, value: string): boolean
+--- @field GetCurrentVideoDriver fun(): string?
+--- @field GL_SHARE_WITH_CURRENT_CONTEXT integer
+--- @field GL_DeleteContext fun(context: SDL_GL_Context)
+--- @field GL_SetRenderCallback fun(window: SDL_Window, context: SDL_GL_Context, render: fun(window: SDL_Window)?)
+--- @field RENDERER_SOFTWARE integer
+--- @field SetRenderDrawColor fun(renderer: SDL_Renderer, r: integer, g: integer, b: integer, a: integer?): integer
+--- @field RenderClear fun(renderer: SDL_Renderer): integer
+--- @field RenderPresent fun(renderer: SDL_Renderer)
+--- @field CreateTextureFromSurface fun(renderer: SDL_Renderer, surface: SDL_Surface): SDL_Texture?
+--- @field DestroyTexture fun(texture: SDL_Texture)
+--- @field CreateSpriteBatch fun(renderer: SDL_Renderer): SDL_SpriteBatch
+
+--- @class SDL_SpriteBatch
+--- @field setColor fun(self: SDL_SpriteBatch, r: integer, g: integer, b: integer, a: integer?)
+--- @field add fun(self: SDL_SpriteBatch, texture: SDL_Texture, x: number, y: number, w: number, h: number, u0: number?, v0: number?, u1: number?, v1: number?)
+--- @field addQuads fun(self: SDL_SpriteBatch, texture: SDL_Texture, quads: string|number[]): integer
+--- @field getCount fun(self: SDL_SpriteBatch): integer
+--- @field flush fun(self: SDL_SpriteBatch, sortByTexture: boolean?): integer?, string?
@@ -1,5 +1,66 @@
 --- @class SDL_image
 --- @field load fun(file: string): SDL_Surface
+--- @field loadFromString fun(data: string): SDL_Surface?
+--- @field loadFromStringInto fun(data: string, surface: SDL_Surface): SDL_Surface?
+--- @field loadAsync fun(file: string): SDL_Image_LoadFuture
+--- @field loadMany fun(files: string[]): SDL_Image_LoadBatch
+--- @field loadCached fun(file: string, directory: string, format: integer?): SDL_Surface?, boolean?
+--- @field newCache fun(budget: integer): SDL_Image_Cache
+--- @field newAtlas fun(width: integer, height: integer, options: SDL_Image_AtlasOptions?): SDL_Image_Atlas
+--- @field probe fun(file: string): SDL_Image_Probe?, string?
+--- @field loadLazy fun(file: string): SDL_Surface?, string?
+
+--- @class SDL_Image_Probe
+--- @field type "png"|"jpg"|"qoi"|"bmp"|"gif"|"webp"
+--- @field w integer
+--- @field h integer
+--- @field channels integer
+
+--- @class SDL_Image_LoadFuture
+--- @field isReady fun(self: SDL_Image_LoadFuture): boolean
+--- @field wait fun(self: SDL_Image_LoadFuture): SDL_Surface?, string?
+
+--- @class SDL_Image_LoadBatch
+--- @field next fun(self: SDL_Image_LoadBatch): integer?, SDL_Surface?, string?
+--- @field poll fun(self: SDL_Image_LoadBatch): integer?, SDL_Surface?, string?
+--- @field getRemaining fun(self: SDL_Image_LoadBatch): integer
+
+--- @class SDL_Image_CacheStats
+--- @field hits integer
+--- @field misses integer
+--- @field evictions integer
+--- @field bytes integer
+--- @field count integer
+--- @field budget integer
+
+--- surfaces from load are shared by every load of the same file, so their
+--- pixels are read-only
+--- @class SDL_Image_Cache
+--- @field load fun(self: SDL_Image_Cache, file: string): SDL_Surface?
+--- @field setBudget fun(self: SDL_Image_Cache, budget: integer)
+--- @field clear fun(self: SDL_Image_Cache)
+--- @field getStats fun(self: SDL_Image_Cache): SDL_Image_CacheStats
+
+--- @class SDL_Image_AtlasOptions
+--- @field padding integer?
+--- @field extrude integer?
+
+--- @class SDL_Image_AtlasRect
+--- @field page integer
+--- @field x integer
+--- @field y integer
+--- @field w integer
+--- @field h integer
+--- @field u0 number
+--- @field v0 number
+--- @field u1 number
+--- @field v1 number
+
+--- @class SDL_Image_Atlas
+--- @field add fun(self: SDL_Image_Atlas, surface: SDL_Surface): SDL_Image_AtlasRect
+--- @field addMany fun(self: SDL_Image_Atlas, surfaces: SDL_Surface[]): SDL_Image_AtlasRect[]
+--- @field getPage fun(self: SDL_Image_Atlas, index: integer): SDL_Surface
+--- @field getPageCount fun(self: SDL_Image_Atlas): integer
 
 --- @class SDL_Surface_Info_Format
 --- @field BitsPerPixel integer
@@ -15,6 +76,16 @@
 --- @class SDL_Surface
 --- @field getInfo fun(self: SDL_Surface): SDL_Surface_Info
 --- @field free fun(self: SDL_Surface)
+--- @field isLoaded fun(self: SDL_Surface): boolean
 --- @field lock fun(self: SDL_Surface)
 --- @field unlock fun(self: SDL_Surface)
 --- @field flipVertical fun(self: SDL_Surface)
+--- @field flipHorizontal fun(self: SDL_Surface)
+--- @field swizzle fun(self: SDL_Surface, order: string): integer
+--- @field premultiplyAlpha fun(self: SDL_Surface)
+--- @field srgbToLinear fun(self: SDL_Surface)
+--- @field generateMipmaps fun(self: SDL_Surface, options: { filter: "box"|"kaiser"|"lanczos"|nil, srgb: boolean?, levels: integer? }?): SDL_Surface[]
+--- @field view fun(self: SDL_Surface, x: integer, y: integer, w: integer, h: integer): SDL_Surface
+--- @field compress fun(self: SDL_Surface, format: "bc1"|"bc3"|"bc7"|"etc2"|"etc2_eac", options: { quality: "fast"|"normal"|"high"|nil }?): string
+--- @field saveQOI fun(self: SDL_Surface, file: string): boolean?, string?
+--- @field toGLFormat fun(self: SDL_Surface, format: integer?): SDL_Surface?, integer, integer, integer